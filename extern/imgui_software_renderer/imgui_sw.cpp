@@ -11,12 +11,22 @@
 
 #include <algorithm>
 #include <math.h>
+#include <stddef.h>
 #include <vector>
 #include <SDL.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// size of a tile in pixels
+#define IMGUI_SW_TILE_SIZE 128
+
+struct TileRenderer;
 
 struct ImGui_ImplSW_Data
 {
     SDL_Window*  Window;
+    TileRenderer* Tiles;
 
     ImGui_ImplSW_Data() { memset((void*)this, 0, sizeof(*this)); }
 };
@@ -31,6 +41,9 @@ struct PaintTarget
   uint32_t *pixels;
   int width;
   int height;
+  // area being painted (a tile) [min, max)
+  int min_x, min_y;
+  int max_x, max_y;
 };
 
 // ----------------------------------------------------------------------------
@@ -201,6 +214,51 @@ inline uint8_t sample_font_texture(const SWTexture &texture, int x, int y)
 
 inline uint32_t sample_texture(const SWTexture &texture, int x, int y) { return texture.pixels[x + y]; }
 
+// fills a span with an opaque color.
+static inline void fill_span(uint32_t* dest, int count, uint32_t color)
+{
+  for (int x = 0; x < count; x++) {
+    dest[x] = color;
+  }
+}
+
+// blends a uniform color over a span.
+static inline void blend_span(uint32_t* dest, int count, const ColorInt &color)
+{
+  if (color.a == 0) return;
+  if (color.a == 255) {
+    fill_span(dest, count, color.u32);
+    return;
+  }
+  int x = 0;
+#ifdef __SSE2__
+  {
+    // same arithmetic as blend(), four pixels at a time
+    const short ia = 255 - color.a;
+    const short termR = color.r * color.a + 255;
+    const short termG = color.g * color.a + 255;
+    const short termB = color.b * color.a + 255;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i src_term = _mm_set_epi16(0, termR, termG, termB, 0, termR, termG, termB);
+    const __m128i inv_alpha = _mm_set1_epi16(ia);
+    const __m128i alpha_mask = _mm_set1_epi32((int)0xff000000);
+    for (; x + 4 <= count; x += 4) {
+      __m128i d = _mm_loadu_si128((const __m128i*)(dest + x));
+      __m128i lo = _mm_unpacklo_epi8(d, zero);
+      __m128i hi = _mm_unpackhi_epi8(d, zero);
+      lo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(lo, inv_alpha), src_term), 8);
+      hi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(hi, inv_alpha), src_term), 8);
+      __m128i out = _mm_packus_epi16(lo, hi);
+      out = _mm_or_si128(_mm_and_si128(d, alpha_mask), _mm_andnot_si128(alpha_mask, out));
+      _mm_storeu_si128((__m128i*)(dest + x), out);
+    }
+  }
+#endif
+  for (; x < count; x++) {
+    dest[x] = blend(ColorInt(dest[x]), color);
+  }
+}
+
 static void paint_uniform_rectangle(const PaintTarget &target,
   const ImVec2 &min_f,
   const ImVec2 &max_f,
@@ -215,41 +273,15 @@ static void paint_uniform_rectangle(const PaintTarget &target,
   int max_x_i = (int)(max_f.x + 0.5f);
   int max_y_i = (int)(max_f.y + 0.5f);
 
-  // Clamp to render target:
-  min_x_i = std::max(min_x_i, 0);
-  min_y_i = std::max(min_y_i, 0);
-  max_x_i = std::min(max_x_i, target.width);
-  max_y_i = std::min(max_y_i, target.height);
-
-  if (color.a==255) {
-    // fast path if alpha blending is not necessary
-    for (int y = min_y_i; y < max_y_i; ++y) {
-      uint32_t* target_pixel = &target.pixels[y * target.width + min_x_i - 1];
-      for (int x = min_x_i; x < max_x_i; ++x) {
-        ++target_pixel;
-        *target_pixel = color.u32;
-      }
-    }
-  } else {
-    // We often blend the same colors over and over again, so optimize for this (saves 25% total cpu):
-    uint32_t last_target_pixel = target.pixels[min_y_i * target.width + min_x_i];
-    const ColorInt* lastColorRef = (const ColorInt*)(&last_target_pixel);
-    uint32_t last_output = blend(*lastColorRef, color);
+  // Clamp to tile:
+  min_x_i = std::max(min_x_i, target.min_x);
+  min_y_i = std::max(min_y_i, target.min_y);
+  max_x_i = std::min(max_x_i, target.max_x);
+  max_y_i = std::min(max_y_i, target.max_y);
+  if (min_x_i >= max_x_i || min_y_i >= max_y_i) return;
 
-    for (int y = min_y_i; y < max_y_i; ++y) {
-      uint32_t* target_pixel = &target.pixels[y * target.width + min_x_i - 1];
-      for (int x = min_x_i; x < max_x_i; ++x) {
-        ++target_pixel;
-        if (*target_pixel == last_target_pixel) {
-          *target_pixel = last_output;
-          continue;
-        }
-        last_target_pixel = *target_pixel;
-        const ColorInt* colorRef = (const ColorInt*)(target_pixel);
-        *target_pixel = blend(*colorRef, color);
-        last_output = *target_pixel;
-      }
-    }
+  for (int y = min_y_i; y < max_y_i; ++y) {
+    blend_span(&target.pixels[y * target.width + min_x_i], max_x_i - min_x_i, color);
   }
 }
 
@@ -308,18 +340,29 @@ static void paint_uniform_textured_rectangle(const PaintTarget &target,
   if (startY<0) startY=0;
   if (startY>texture.height-1) startY=texture.height-1;
 
-  int currentX = startX;
-  int currentY = startY * texture.width;
-
   float deltaX = delta_uv_per_pixel.x * texture.width;
   float deltaY = delta_uv_per_pixel.y * texture.height;
 
+  // Clip against tile. texture coordinates advance by one texel per pixel,
+  // so skip ahead by the part outside of it to get the same result as a full render.
+  int tile_min_x = std::max(min_x_i, target.min_x);
+  int tile_min_y = std::max(min_y_i, target.min_y);
+  int tile_max_x = std::min(max_x_i, target.max_x);
+  int tile_max_y = std::min(max_y_i, target.max_y);
+  if (tile_min_x >= tile_max_x || tile_min_y >= tile_max_y) return;
+
+  if (deltaX != 0) startX = std::min(startX + (tile_min_x - min_x_i), texture.width - 1);
+  if (deltaY != 0) startY = std::min(startY + (tile_min_y - min_y_i), texture.height - 1);
+
+  int currentX = startX;
+  int currentY = startY * texture.width;
+
   const ColorInt colorRef = ColorInt::bgra(min_v.col);
 
-  for (int y = min_y_i; y < max_y_i; ++y) {
+  for (int y = tile_min_y; y < tile_max_y; ++y) {
     currentX = startX;
-    uint32_t* target_pixel = &target.pixels[y * target.width - 1 + min_x_i];
-    for (int x = min_x_i; x < max_x_i; ++x) {
+    uint32_t* target_pixel = &target.pixels[y * target.width - 1 + tile_min_x];
+    for (int x = tile_min_x; x < tile_max_x; ++x) {
       ++target_pixel;
       const ColorInt* targetColorRef = (const ColorInt*)(target_pixel);
 
@@ -392,11 +435,12 @@ static void paint_triangle(const PaintTarget &target,
   int max_x_i = (int)(max_x_f + 1.0f);
   int max_y_i = (int)(max_y_f + 1.0f);
 
-  // Clip against render target:
-  min_x_i = std::max(min_x_i, 0);
-  min_y_i = std::max(min_y_i, 0);
-  max_x_i = std::min(max_x_i, target.width);
-  max_y_i = std::min(max_y_i, target.height);
+  // Clip against tile:
+  min_x_i = std::max(min_x_i, target.min_x);
+  min_y_i = std::max(min_y_i, target.min_y);
+  max_x_i = std::min(max_x_i, target.max_x);
+  max_y_i = std::min(max_y_i, target.max_y);
+  if (min_x_i >= max_x_i || min_y_i >= max_y_i) return;
 
   // ------------------------------------------------------------------------
   // Set up interpolation of barycentric coordinates:
@@ -449,11 +493,30 @@ static void paint_triangle(const PaintTarget &target,
   const ColorInt c1 = ColorInt::bgra(v1.col);
   const ColorInt c2 = ColorInt::bgra(v2.col);
 
-  // We often blend the same colors over and over again, so optimize for this (saves 10% total cpu):
-  uint32_t last_target_pixel = 0;
-  const ColorInt* lastColorRef = (const ColorInt*)(&last_target_pixel);
-  const ColorInt colorRef = ColorInt::bgra(v0.col);
-  uint32_t last_output = blend(*lastColorRef, colorRef);
+  if (has_uniform_color && !texture) {
+    // a triangle covers a single span in each row. find it and fill it in one go.
+    if (c0.a == 0) return;
+    for (int y = min_y_i; y < max_y_i; ++y) {
+      int span_start = -1;
+      int span_end = max_x_i;
+      for (int x = min_x_i; x < max_x_i; ++x) {
+        const auto p = Point{ kFixedBias * x + kFixedBias / 2, kFixedBias * y + kFixedBias / 2 };
+        const auto w0i = sign * orient2d(p1i, p2i, p) + bias0i;
+        const auto w1i = sign * orient2d(p2i, p0i, p) + bias1i;
+        const auto w2i = sign * orient2d(p0i, p1i, p) + bias2i;
+        const bool inside = (w0i >= 0 && w1i >= 0 && w2i >= 0);
+        if (span_start < 0) {
+          if (inside) span_start = x;
+        } else if (!inside) {
+          span_end = x;
+          break;
+        }
+      }
+      if (span_start < 0) continue;
+      blend_span(&target.pixels[y * target.width + span_start], span_end - span_start, c0);
+    }
+    return;
+  }
 
   for (int y = min_y_i; y < max_y_i; ++y) {
     auto bary = bary_current_row;
@@ -486,18 +549,6 @@ static void paint_triangle(const PaintTarget &target,
       }
       has_been_inside_this_row = true;
 
-
-      if (has_uniform_color && !texture) {
-        if (*target_pixel == last_target_pixel) {
-          *target_pixel = last_output;
-          continue;
-        }
-        last_target_pixel = *target_pixel;
-        *target_pixel = blend(*lastColorRef, colorRef);
-        last_output = *target_pixel;
-        continue;
-      }
-
       ColorInt src_color;
 
       if (has_uniform_color) {
@@ -532,7 +583,160 @@ static void paint_triangle(const PaintTarget &target,
   }
 }
 
-static void paint_draw_cmd(const PaintTarget &target,
+// ----------------------------------------------------------------------------
+// Tiled rendering:
+// draw commands are first turned into a list of primitives, which are then
+// binned into tiles. tiles are painted in parallel (if a job runner is set).
+// tiles whose primitives did not change since the last frame are skipped.
+
+enum PrimitiveType: unsigned char {
+  PRIM_RECT=0,
+  PRIM_TEXTURED_RECT,
+  PRIM_TRIANGLE
+};
+
+struct Primitive
+{
+  // rectangles use v0.pos/v1.pos as min/max and v0.col as color.
+  // textured rectangles use v0/v1 as min/max vertex.
+  ImDrawVert v0, v1, v2;
+  ImVec4 clip_rect;
+  const SWTexture* texture;
+  // everything above is hashed
+  uint64_t hash;
+  int min_x, min_y, max_x, max_y;
+  unsigned char type;
+};
+
+struct TileRenderer;
+
+struct Tile
+{
+  TileRenderer* parent;
+  int min_x, min_y, max_x, max_y;
+  std::vector<unsigned int> prims;
+  uint64_t hash, last_hash;
+};
+
+struct TileRenderer
+{
+  std::vector<Primitive> prims;
+  std::vector<Tile> tiles;
+  std::vector<void*> jobArgs;
+  std::vector<unsigned int> jobCosts;
+  uint32_t* pixels;
+  int width, height;
+  int tiles_x, tiles_y;
+  bool clear, valid;
+  uint32_t clear_color;
+  ImGui_ImplSW_JobRunner runner;
+  void* runner_user;
+
+  TileRenderer():
+    pixels(NULL),
+    width(0),
+    height(0),
+    tiles_x(0),
+    tiles_y(0),
+    clear(false),
+    valid(false),
+    clear_color(0),
+    runner(NULL),
+    runner_user(NULL) {}
+};
+
+static inline uint64_t hash_mix(uint64_t h, uint64_t v)
+{
+  h ^= v;
+  h *= 0x9e3779b97f4a7c15ULL;
+  return h ^ (h >> 32);
+}
+
+static void add_primitive(TileRenderer& r, Primitive& p)
+{
+  // clip against render target
+  p.min_x = std::max(p.min_x, 0);
+  p.min_y = std::max(p.min_y, 0);
+  p.max_x = std::min(p.max_x, r.width);
+  p.max_y = std::min(p.max_y, r.height);
+  if (p.min_x >= p.max_x || p.min_y >= p.max_y) return;
+
+  uint64_t h = 0xcbf29ce484222325ULL ^ p.type;
+  const unsigned char* data = (const unsigned char*)&p;
+  for (size_t i = 0; i + 8 <= offsetof(Primitive, hash); i += 8) {
+    uint64_t v;
+    memcpy(&v, data + i, 8);
+    h = hash_mix(h, v);
+  }
+  if (p.texture) h = hash_mix(h, p.texture->gen);
+  p.hash = h;
+
+  const unsigned int index = r.prims.size();
+  r.prims.push_back(p);
+
+  const int tx0 = p.min_x / IMGUI_SW_TILE_SIZE;
+  const int ty0 = p.min_y / IMGUI_SW_TILE_SIZE;
+  const int tx1 = (p.max_x - 1) / IMGUI_SW_TILE_SIZE;
+  const int ty1 = (p.max_y - 1) / IMGUI_SW_TILE_SIZE;
+  for (int ty = ty0; ty <= ty1; ty++) {
+    for (int tx = tx0; tx <= tx1; tx++) {
+      Tile& t = r.tiles[ty * r.tiles_x + tx];
+      t.prims.push_back(index);
+      t.hash = hash_mix(t.hash, h);
+    }
+  }
+}
+
+static void bin_rect(TileRenderer& r, const ImVec2& min, const ImVec2& max, ImU32 col)
+{
+  Primitive p;
+  memset((void*)&p, 0, sizeof(Primitive));
+  p.type = PRIM_RECT;
+  p.v0.pos = min;
+  p.v1.pos = max;
+  p.v0.col = col;
+  p.min_x = (int)(min.x + 0.5f);
+  p.min_y = (int)(min.y + 0.5f);
+  p.max_x = (int)(max.x + 0.5f);
+  p.max_y = (int)(max.y + 0.5f);
+  add_primitive(r, p);
+}
+
+static void bin_textured_rect(TileRenderer& r, const SWTexture* texture, const ImVec4& clip_rect, const ImDrawVert& min_v, const ImDrawVert& max_v)
+{
+  if (max_v.pos.x == min_v.pos.x || max_v.pos.y == min_v.pos.y) return;
+  Primitive p;
+  memset((void*)&p, 0, sizeof(Primitive));
+  p.type = PRIM_TEXTURED_RECT;
+  p.v0 = min_v;
+  p.v1 = max_v;
+  p.clip_rect = clip_rect;
+  p.texture = texture;
+  p.min_x = (int)std::max(min_v.pos.x, clip_rect.x);
+  p.min_y = (int)std::max(min_v.pos.y, clip_rect.y);
+  p.max_x = (int)(std::min(max_v.pos.x, clip_rect.z - 0.5f) + 1.0f);
+  p.max_y = (int)(std::min(max_v.pos.y, clip_rect.w - 0.5f) + 1.0f);
+  add_primitive(r, p);
+}
+
+static void bin_triangle(TileRenderer& r, const SWTexture* texture, const ImVec4& clip_rect, const ImDrawVert& v0, const ImDrawVert& v1, const ImDrawVert& v2)
+{
+  Primitive p;
+  memset((void*)&p, 0, sizeof(Primitive));
+  p.type = PRIM_TRIANGLE;
+  p.v0 = v0;
+  p.v1 = v1;
+  p.v2 = v2;
+  p.clip_rect = clip_rect;
+  p.texture = texture;
+  p.min_x = (int)std::max(min3(v0.pos.x, v1.pos.x, v2.pos.x), clip_rect.x);
+  p.min_y = (int)std::max(min3(v0.pos.y, v1.pos.y, v2.pos.y), clip_rect.y);
+  p.max_x = (int)(std::min(max3(v0.pos.x, v1.pos.x, v2.pos.x), clip_rect.z - 0.5f) + 1.0f);
+  p.max_y = (int)(std::min(max3(v0.pos.y, v1.pos.y, v2.pos.y), clip_rect.w - 0.5f) + 1.0f);
+  add_primitive(r, p);
+}
+
+static void bin_draw_cmd(TileRenderer& r,
   const ImDrawVert *vertices,
   const ImDrawIdx *idx_buffer,
   const ImDrawCmd &pcmd,
@@ -559,7 +763,7 @@ static void paint_draw_cmd(const PaintTarget &target,
         const bool has_texture = v0.uv != white_uv || v1.uv != white_uv || v2.uv != white_uv || v3.uv != white_uv;
 
         if (has_uniform_color && has_texture) {
-          paint_uniform_textured_rectangle(target, *texture, pcmd.ClipRect, v0, v2);
+          bin_textured_rect(r, texture, pcmd.ClipRect, v0, v2);
           i += 6;
           continue;
         }
@@ -604,20 +808,19 @@ static void paint_draw_cmd(const PaintTarget &target,
         }// Completely clipped
 
         if (has_uniform_color) {
-          const ColorInt colorRef = ColorInt::bgra(v0.col);
-          paint_uniform_rectangle(target, min, max, colorRef);
+          bin_rect(r, min, max, v0.col);
           i += 6;
           continue;
         }
       }
     }
 
-    paint_triangle(target, has_texture ? texture : nullptr, pcmd.ClipRect, v0, v1, v2);
+    bin_triangle(r, has_texture ? texture : nullptr, pcmd.ClipRect, v0, v1, v2);
     i += 3;
   }
 }
 
-static void paint_draw_list(const PaintTarget &target, const ImDrawList *cmd_list)
+static void bin_draw_list(TileRenderer& r, const ImDrawList *cmd_list)
 {
   const ImDrawIdx *idx_buffer = &cmd_list->IdxBuffer[0];
   const ImDrawVert *vertices = cmd_list->VtxBuffer.Data;
@@ -626,22 +829,104 @@ static void paint_draw_list(const PaintTarget &target, const ImDrawList *cmd_lis
   for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.size(); cmd_i++) {
     const ImDrawCmd &pcmd = cmd_list->CmdBuffer[cmd_i];
     if (pcmd.UserCallback) {
-      pcmd.UserCallback(cmd_list, &pcmd);
+      if (pcmd.UserCallback != ImDrawCallback_ResetRenderState) {
+        pcmd.UserCallback(cmd_list, &pcmd);
+      }
     } else {
-      paint_draw_cmd(target, vertices, idx_buffer, pcmd, white_uv);
+      bin_draw_cmd(r, vertices, idx_buffer, pcmd, white_uv);
     }
     idx_buffer += pcmd.ElemCount;
   }
+}
+
+static void paint_primitive(const PaintTarget &target, const Primitive& p)
+{
+  switch (p.type) {
+    case PRIM_RECT:
+      paint_uniform_rectangle(target, p.v0.pos, p.v1.pos, ColorInt::bgra(p.v0.col));
+      break;
+    case PRIM_TEXTURED_RECT:
+      paint_uniform_textured_rectangle(target, *p.texture, p.clip_rect, p.v0, p.v1);
+      break;
+    case PRIM_TRIANGLE:
+      paint_triangle(target, p.texture, p.clip_rect, p.v0, p.v1, p.v2);
+      break;
+  }
+}
+
+static void paint_tile(void* arg)
+{
+  Tile* t = (Tile*)arg;
+  TileRenderer* r = t->parent;
+  PaintTarget target{ r->pixels, r->width, r->height, t->min_x, t->min_y, t->max_x, t->max_y };
+
+  if (r->clear) {
+    for (int y = t->min_y; y < t->max_y; y++) {
+      fill_span(&r->pixels[y * r->width + t->min_x], t->max_x - t->min_x, r->clear_color);
+    }
+  }
+  for (unsigned int i: t->prims) {
+    paint_primitive(target, r->prims[i]);
   }
+}
 
-static void paint_imgui(uint32_t *pixels, ImDrawData *drawData, int fb_width, int fb_height)
+static void paint_imgui(TileRenderer& r, uint32_t *pixels, ImDrawData *drawData, int fb_width, int fb_height, bool clear, uint32_t clear_color)
 {
   if (fb_width <= 0 || fb_height <= 0) return;
 
-  PaintTarget target{ pixels, fb_width, fb_height };
+  // reset tiles if the render target changed
+  if (pixels != r.pixels || fb_width != r.width || fb_height != r.height) {
+    r.pixels = pixels;
+    r.width = fb_width;
+    r.height = fb_height;
+    r.tiles_x = (fb_width + IMGUI_SW_TILE_SIZE - 1) / IMGUI_SW_TILE_SIZE;
+    r.tiles_y = (fb_height + IMGUI_SW_TILE_SIZE - 1) / IMGUI_SW_TILE_SIZE;
+    r.tiles.resize(r.tiles_x * r.tiles_y);
+    for (int ty = 0; ty < r.tiles_y; ty++) {
+      for (int tx = 0; tx < r.tiles_x; tx++) {
+        Tile& t = r.tiles[ty * r.tiles_x + tx];
+        t.parent = &r;
+        t.min_x = tx * IMGUI_SW_TILE_SIZE;
+        t.min_y = ty * IMGUI_SW_TILE_SIZE;
+        t.max_x = std::min(t.min_x + IMGUI_SW_TILE_SIZE, fb_width);
+        t.max_y = std::min(t.min_y + IMGUI_SW_TILE_SIZE, fb_height);
+      }
+    }
+    r.valid = false;
+  }
+  // without a clear, what is drawn depends on the previous contents
+  if (!clear) r.valid = false;
+  r.clear = clear;
+  r.clear_color = clear_color;
+
+  r.prims.clear();
+  for (Tile& t: r.tiles) {
+    t.prims.clear();
+    t.hash = hash_mix(0x84222325cbf29ce4ULL, clear_color);
+  }
 
   for (int i = 0; i < drawData->CmdListsCount; ++i) {
-    paint_draw_list(target, drawData->CmdLists[i]);
+    bin_draw_list(r, drawData->CmdLists[i]);
+  }
+
+  // paint changed tiles
+  r.jobArgs.clear();
+  r.jobCosts.clear();
+  for (Tile& t: r.tiles) {
+    if (r.valid && t.hash == t.last_hash) continue;
+    t.last_hash = t.hash;
+    r.jobArgs.push_back(&t);
+    r.jobCosts.push_back(t.prims.size() + 1);
+  }
+  r.valid = clear;
+
+  if (r.jobArgs.empty()) return;
+  if (r.runner != NULL) {
+    r.runner(paint_tile, r.jobArgs.data(), r.jobCosts.data(), (int)r.jobArgs.size(), r.runner_user);
+  } else {
+    for (void* i: r.jobArgs) {
+      paint_tile(i);
+    }
   }
 }
 
@@ -658,6 +943,7 @@ bool ImGui_ImplSW_Init(SDL_Window* win) {
 
   ImGui_ImplSW_Data* bd = IM_NEW(ImGui_ImplSW_Data)();
   bd->Window = win;
+  bd->Tiles = new TileRenderer;
   io.BackendRendererUserData = (void*)bd;
   io.BackendRendererName = "imgui_sw";
   io.BackendFlags |= ImGuiBackendFlags_RendererHasTextures;
@@ -676,9 +962,28 @@ void ImGui_ImplSW_Shutdown() {
   io.BackendRendererName = nullptr;
   io.BackendRendererUserData = nullptr;
   io.BackendFlags &= ~ImGuiBackendFlags_RendererHasTextures;
+  delete bd->Tiles;
   IM_DELETE(bd);
 }
 
+void ImGui_ImplSW_SetJobRunner(ImGui_ImplSW_JobRunner runner, void* user) {
+  ImGui_ImplSW_Data* bd = ImGui_ImplSW_GetBackendData();
+  if (bd == nullptr) return;
+  bd->Tiles->runner = runner;
+  bd->Tiles->runner_user = user;
+}
+
+void ImGui_ImplSW_InvalidateTiles() {
+  ImGui_ImplSW_Data* bd = ImGui_ImplSW_GetBackendData();
+  if (bd == nullptr) return;
+  bd->Tiles->valid = false;
+}
+
+void ImGui_ImplSW_TouchTexture(SWTexture* tex) {
+  static unsigned int texGen = 0;
+  tex->gen = ++texGen;
+}
+
 void ImGui_ImplSW_NewFrame() {
   ImGui_ImplSW_Data* bd = ImGui_ImplSW_GetBackendData();
   // look I am USING THIS VARIABLE
@@ -687,7 +992,7 @@ void ImGui_ImplSW_NewFrame() {
   IM_ASSERT(bd != nullptr);
 }
 
-void ImGui_ImplSW_RenderDrawData(ImDrawData* draw_data) {
+void ImGui_ImplSW_RenderDrawData(ImDrawData* draw_data, bool clear, uint32_t clear_color) {
   ImGui_ImplSW_Data* bd = ImGui_ImplSW_GetBackendData();
   IM_ASSERT(bd != nullptr);
 
@@ -705,7 +1010,7 @@ void ImGui_ImplSW_RenderDrawData(ImDrawData* draw_data) {
   if (mustLock) {
     if (SDL_LockSurface(surf)!=0) return;
   }
-  paint_imgui((uint32_t*)surf->pixels,draw_data,surf->w,surf->h);
+  paint_imgui(*bd->Tiles,(uint32_t*)surf->pixels,draw_data,surf->w,surf->h,clear,clear_color);
   // 0xAARRGGBB
   if (mustLock) {
     SDL_UnlockSurface(surf);
@@ -725,6 +1030,7 @@ void ImGui_ImplSW_UpdateTexture(ImTextureData* tex) {
   if (tex->Status==ImTextureStatus_WantCreate) {
     SWTexture* t=new SWTexture(tex->Width,tex->Height,tex->Format==ImTextureFormat_Alpha8);
     memcpy(t->pixels,tex->GetPixels(),tex->GetSizeInBytes());
+    ImGui_ImplSW_TouchTexture(t);
 
     tex->SetTexID((ImTextureID)t);
     tex->SetStatus(ImTextureStatus_OK);
@@ -785,6 +1091,7 @@ void ImGui_ImplSW_UpdateTexture(ImTextureData* tex) {
         }
       }
     }
+    ImGui_ImplSW_TouchTexture(t);
 
     tex->SetStatus(ImTextureStatus_OK);
   } else if (tex->Status==ImTextureStatus_WantDestroy && tex->UnusedFrames>0) {
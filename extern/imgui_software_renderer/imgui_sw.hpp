@@ -25,18 +25,22 @@ struct SWTexture
   int width;
   int height;
   bool managed, isAlpha;
+  // changes whenever the contents change (see ImGui_ImplSW_TouchTexture)
+  unsigned int gen;
 
   SWTexture(uint32_t* pix, int w, int h, bool a=false):
     pixels(pix),
     width(w),
     height(h),
     managed(false),
-    isAlpha(a) {}
+    isAlpha(a),
+    gen(0) {}
   SWTexture(int w, int h, bool a=false):
     width(w),
     height(h),
     managed(true),
-    isAlpha(a) {
+    isAlpha(a),
+    gen(0) {
     pixels=new uint32_t[width*height];
     memset(pixels,0,width*height*sizeof(uint32_t));
   }
@@ -48,7 +52,19 @@ struct SWTexture
 IMGUI_IMPL_API bool     ImGui_ImplSW_Init(SDL_Window* win);
 IMGUI_IMPL_API void     ImGui_ImplSW_Shutdown();
 IMGUI_IMPL_API void     ImGui_ImplSW_NewFrame();
-IMGUI_IMPL_API void     ImGui_ImplSW_RenderDrawData(ImDrawData* draw_data);
+// clears the frame to clear_color (0xAARRGGBB) if clear is true.
+// tiles which didn't change since the last cleared frame are not painted again.
+IMGUI_IMPL_API void     ImGui_ImplSW_RenderDrawData(ImDrawData* draw_data, bool clear=false, uint32_t clear_color=0);
+
+// tiled rendering.
+// the job runner runs count jobs (possibly in parallel) and returns after all of them finish.
+// costs is an estimate of how long each job takes.
+typedef void (*ImGui_ImplSW_JobRunner)(void (*job)(void*), void** args, const unsigned int* costs, int count, void* user);
+IMGUI_IMPL_API void     ImGui_ImplSW_SetJobRunner(ImGui_ImplSW_JobRunner runner, void* user);
+// forces all tiles to be painted on the next frame
+IMGUI_IMPL_API void     ImGui_ImplSW_InvalidateTiles();
+// call after changing the contents of a texture
+IMGUI_IMPL_API void     ImGui_ImplSW_TouchTexture(SWTexture* tex);
 
 // Called by Init/NewFrame/Shutdown
 IMGUI_IMPL_API bool     ImGui_ImplSW_CreateDeviceObjects();
@@ -19,6 +19,7 @@
 
 #include "taAudio.h"
 #include "../ta-log.h"
+#include <chrono>
 
 void TAAudio::setSampleRateChangeCallback(void (*callback)(SampleRateChangeEvent)) {
   sampleRateChanged=callback;
@@ -71,7 +72,30 @@ TAAudio::~TAAudio() {
 }
 
 bool TAMidiIn::gather() {
-  return false;
+  unsigned int readPos=ringRead.load(std::memory_order_relaxed);
+  unsigned int writePos=ringWrite.load(std::memory_order_acquire);
+  while (readPos!=writePos) {
+    // leave the rest in the ring if the queue is full
+    if (!queue.push(ring[readPos])) break;
+    // release the SysEx buffer (if any) here rather than when the slot is reused
+    ring[readPos].sysExData.reset();
+    readPos=(readPos+1)%TA_MIDI_IN_RING_SIZE;
+  }
+  ringRead.store(readPos,std::memory_order_release);
+  return true;
+}
+
+bool TAMidiIn::pushMessage(const TAMidiMessage& what) {
+  unsigned int writePos=ringWrite.load(std::memory_order_relaxed);
+  unsigned int nextPos=(writePos+1)%TA_MIDI_IN_RING_SIZE;
+  if (nextPos==ringRead.load(std::memory_order_acquire)) return false;
+  ring[writePos]=what;
+  ringWrite.store(nextPos,std::memory_order_release);
+  return true;
+}
+
+double TAMidiIn::now() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
 bool TAMidiOut::send(const TAMidiMessage& what) {
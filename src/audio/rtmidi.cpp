@@ -43,34 +43,35 @@ String sanitizePortName(const String& name) {
 
 // --- IN ---
 
+// runs on the RtMidi thread. messages are timestamped on arrival and handed to
+// the audio thread through the ring (see TAMidiIn::gather()).
+static void _rtMidiInCallback(double delta, std::vector<unsigned char>* msg, void* user) {
+  TAMidiInRtMidi* instance=(TAMidiInRtMidi*)user;
+  if (msg==NULL) return;
+  if (msg->empty()) return;
+
+  // parse message
+  TAMidiMessage m;
+  m.time=TAMidiIn::now();
+  m.type=(*msg)[0];
+  if (m.type!=TA_MIDI_SYSEX && msg->size()>1) {
+    memcpy(m.data,msg->data()+1,MIN(msg->size()-1,7));
+  } else if (m.type==TA_MIDI_SYSEX) {
+    m.sysExData=std::shared_ptr<unsigned char>(new unsigned char[msg->size()],std::default_delete<unsigned char[]>());
+    m.sysExLen=msg->size();
+    memcpy(m.sysExData.get(),msg->data(),msg->size());
+  }
+  if (!instance->pushMessage(m)) {
+    instance->overflow=true;
+  }
+}
+
 bool TAMidiInRtMidi::gather() {
-  std::vector<unsigned char> msg;
   if (port==NULL) return false;
-  try {
-    while (true) {
-      TAMidiMessage m;
-      double t=port->getMessage(&msg);
-      if (msg.empty()) break;
-
-      // parse message
-      m.time=t;
-      m.type=msg[0];
-      if (m.type!=TA_MIDI_SYSEX && msg.size()>1) {
-        memcpy(m.data,msg.data()+1,MIN(msg.size()-1,7));
-      } else if (m.type==TA_MIDI_SYSEX) {
-        m.sysExData=std::shared_ptr<unsigned char>(new unsigned char[msg.size()],std::default_delete<unsigned char[]>());
-        m.sysExLen=msg.size();
-        logD("got a SysEx of length %ld!",msg.size());
-        memcpy(m.sysExData.get(),msg.data(),msg.size());
-      }
-      queue.push(m);
-    }
-  } catch (RtMidiError& e) {
-    logE("MIDI input error! %s",e.what());
-    closeDevice();
-    return false;
+  if (overflow.exchange(false)) {
+    logW("MIDI input ring overflow! some messages were lost.");
   }
-  return true;
+  return TAMidiIn::gather();
 }
 
 std::vector<String> TAMidiInRtMidi::listDevices() {
@@ -108,6 +109,7 @@ bool TAMidiInRtMidi::openDevice(String name) {
       if (portName==name) {
         logD("opening port %d...",i);
         port->openPort(i);
+        port->setCallback(_rtMidiInCallback,this);
         portOpen=true;
         break;
       }
@@ -126,6 +128,7 @@ bool TAMidiInRtMidi::closeDevice() {
   if (port==NULL) return false;
   if (!isOpen) return false;
   try {
+    port->cancelCallback();
     port->closePort();
   } catch (RtMidiError& e) {
     logW("could not close MIDI in device! %s",e.what());
@@ -24,6 +24,8 @@ class TAMidiInRtMidi: public TAMidiIn {
   RtMidiIn* port;
   bool isOpen;
   public:
+    // set by the MIDI thread when the ring is full
+    std::atomic<bool> overflow;
     bool gather();
     bool isDeviceOpen();
     bool openDevice(String name);
@@ -33,7 +35,8 @@ class TAMidiInRtMidi: public TAMidiIn {
     bool init();
     TAMidiInRtMidi():
       port(NULL),
-      isOpen(false) {}
+      isOpen(false),
+      overflow(false) {}
 };
 
 class TAMidiOutRtMidi: public TAMidiOut {
@@ -21,6 +21,7 @@
 #define _TAAUDIO_H
 #include "../ta-utils.h"
 #include <memory>
+#include <atomic>
 #include "../fixedQueue.h"
 #include "../pch.h"
 
@@ -107,7 +108,11 @@ enum TAMidiMessageTypes {
   TA_MIDI_RESET=0xff
 };
 
+// size of the lock-free ring between the MIDI thread and the audio thread
+#define TA_MIDI_IN_RING_SIZE 4096
+
 struct TAMidiMessage {
+  // arrival time in seconds (steady clock, see TAMidiIn::now()), or 0 if unknown
   double time;
   unsigned char type;
   unsigned char data[7];
@@ -137,9 +142,18 @@ struct TAMidiMessage {
 };
 
 class TAMidiIn {
+  // single-producer single-consumer ring filled by the MIDI thread
+  TAMidiMessage ring[TA_MIDI_IN_RING_SIZE];
+  std::atomic<unsigned int> ringRead, ringWrite;
   public:
     FixedQueue<TAMidiMessage,8192> queue;
+    // moves messages from the ring into the queue. called by the audio thread.
     virtual bool gather();
+    // pushes a message into the ring. called by the MIDI thread.
+    // returns false if the ring is full.
+    bool pushMessage(const TAMidiMessage& what);
+    // current time in seconds, using the same clock as TAMidiMessage::time.
+    static double now();
     bool next(TAMidiMessage& where);
     virtual bool isDeviceOpen();
     virtual bool openDevice(String name);
@@ -147,7 +161,9 @@ class TAMidiIn {
     virtual std::vector<String> listDevices();
     virtual bool init();
     virtual bool quit();
-    TAMidiIn() {
+    TAMidiIn():
+      ringRead(0),
+      ringWrite(0) {
     }
     virtual ~TAMidiIn();
 };
@@ -22,6 +22,8 @@
 #include "../baseutils.h"
 #include "../fileutils.h"
 #include <fmt/printf.h>
+#include <errno.h>
+#include <limits.h>
 
 #define REDUNDANCY_NUM_ATTEMPTS 5
 #define CHECK_BUF_SIZE 8192
@@ -62,7 +64,7 @@ bool DivConfig::save(const char* path, bool redundancy) {
     fputs("!DIV_CONFIG_START!\n",f);
   }
   for (auto& i: conf) {
-    String toWrite=fmt::sprintf("%s=%s\n",i.first,i.second);
+    String toWrite=fmt::sprintf("%s=%s\n",i.first,i.second.str);
     if (fwrite(toWrite.c_str(),1,toWrite.size(),f)!=toWrite.size()) {
       logW("could not write config file! %s",strerror(errno));
       reportError(fmt::sprintf("could not write config file! %s",strerror(errno)));
@@ -83,7 +85,7 @@ bool DivConfig::save(const char* path, bool redundancy) {
 String DivConfig::toString() {
   String ret;
   for (auto& i: conf) {
-    ret+=fmt::sprintf("%s=%s\n",i.first,i.second);
+    ret+=fmt::sprintf("%s=%s\n",i.first,i.second.str);
   }
   return ret;
 }
@@ -93,8 +95,44 @@ String DivConfig::toBase64() {
   return taEncodeBase64(data);
 }
 
-const std::map<String,String>& DivConfig::configMap() {
-  return conf;
+std::map<String,String> DivConfig::configMap() const {
+  std::map<String,String> ret;
+  for (auto& i: conf) {
+    ret[i.first]=i.second.str;
+  }
+  return ret;
+}
+
+// these follow the rules of std::stoi/stof/stod (without throwing)
+void DivConfigValue::parse() {
+  const char* s=str.c_str();
+  char* end=NULL;
+
+  errno=0;
+  long l=strtol(s,&end,10);
+  hasInt=(end!=s && errno!=ERANGE && l>=INT_MIN && l<=INT_MAX);
+  intVal=hasInt?(int)l:0;
+
+  errno=0;
+  float f=strtof(s,&end);
+  hasFloat=(end!=s && errno!=ERANGE);
+  floatVal=hasFloat?f:0.0f;
+
+  errno=0;
+  double d=strtod(s,&end);
+  hasDouble=(end!=s && errno!=ERANGE);
+  doubleVal=hasDouble?d:0.0;
+
+  if (str=="true") {
+    hasBool=true;
+    boolVal=true;
+  } else if (str=="false") {
+    hasBool=true;
+    boolVal=false;
+  } else {
+    hasBool=hasInt;
+    boolVal=(intVal!=0);
+  }
 }
 
 void DivConfig::parseLine(const char* line) {
@@ -115,7 +153,7 @@ void DivConfig::parseLine(const char* line) {
     }
   }
   if (keyOrValue) {
-    conf[key]=value;
+    conf[key]=DivConfigValue(value);
   }
 }
 
@@ -294,79 +332,53 @@ bool DivConfig::loadFromBase64(const char* buf) {
   return loadFromMemory(data.c_str());
 }
 
-bool DivConfig::getBool(String key, bool fallback) const {
+bool DivConfig::getBool(const char* key, bool fallback) const {
   auto val=conf.find(key);
   if (val!=conf.cend()) {
-    if (val->second=="true") {
-      return true;
-    } else if (val->second=="false") {
-      return false;
-    } else {
-      try {
-        int ret=std::stoi(val->second);
-        return (ret!=0);
-      } catch (std::out_of_range& e) {
-      } catch (std::invalid_argument& e) {
-      }
-    }
+    if (val->second.hasBool) return val->second.boolVal;
   }
   return fallback;
 }
 
-int DivConfig::getInt(String key, int fallback) const {
+int DivConfig::getInt(const char* key, int fallback) const {
   auto val=conf.find(key);
   if (val!=conf.cend()) {
-    try {
-      int ret=std::stoi(val->second);
-      return ret;
-    } catch (std::out_of_range& e) {
-    } catch (std::invalid_argument& e) {
-    }
+    if (val->second.hasInt) return val->second.intVal;
   }
   return fallback;
 }
 
-float DivConfig::getFloat(String key, float fallback) const {
+float DivConfig::getFloat(const char* key, float fallback) const {
   auto val=conf.find(key);
   if (val!=conf.cend()) {
-    try {
-      float ret=std::stof(val->second);
-      return ret;
-    } catch (std::out_of_range& e) {
-    } catch (std::invalid_argument& e) {
-    }
+    if (val->second.hasFloat) return val->second.floatVal;
   }
   return fallback;
 }
 
-double DivConfig::getDouble(String key, double fallback) const {
+double DivConfig::getDouble(const char* key, double fallback) const {
   auto val=conf.find(key);
   if (val!=conf.cend()) {
-    try {
-      double ret=std::stod(val->second);
-      return ret;
-    } catch (std::out_of_range& e) {
-    } catch (std::invalid_argument& e) {
-    }
+    if (val->second.hasDouble) return val->second.doubleVal;
   }
   return fallback;
 }
 
-String DivConfig::getString(String key, String fallback) const {
+String DivConfig::getString(const char* key, String fallback) const {
   auto val=conf.find(key);
   if (val!=conf.cend()) {
-    return val->second;
+    return val->second.str;
   }
   return fallback;
 }
 
-std::vector<int> DivConfig::getIntList(String key, std::initializer_list<int> fallback) const {
+std::vector<int> DivConfig::getIntList(const char* key, std::initializer_list<int> fallback) const {
   String next;
   std::vector<int> ret;
   auto val=conf.find(key);
   if (val!=conf.cend()) {
     try {
-      for (char i: val->second) {
+      for (char i: val->second.str) {
         if (i==',') {
           int num=std::stoi(next);
           ret.push_back(num);
@@ -388,13 +400,13 @@ std::vector<int> DivConfig::getIntList(String key, std::initializer_list<int> fa
   return fallback;
 }
 
-std::vector<String> DivConfig::getStringList(String key, std::initializer_list<String> fallback) const {
+std::vector<String> DivConfig::getStringList(const char* key, std::initializer_list<String> fallback) const {
   String next;
   std::vector<String> ret;
   auto val=conf.find(key);
   if (val!=conf.cend()) {
     try {
-      for (char i: val->second) {
+      for (char i: val->second.str) {
         if (i==',') {
           String result=taDecodeBase64(next);
           ret.push_back(result);
@@ -416,37 +428,37 @@ std::vector<String> DivConfig::getStringList(String key, std::initializer_list<S
   return fallback;
 }
 
-bool DivConfig::has(String key) const {
+bool DivConfig::has(const char* key) const {
   auto val=conf.find(key);
   return (val!=conf.cend());
 }
 
 void DivConfig::set(String key, bool value) {
   if (value) {
-    conf[key]="1";
+    conf[key]=DivConfigValue("1");
   } else {
-    conf[key]="0";
+    conf[key]=DivConfigValue("0");
   }
 }
 
 void DivConfig::set(String key, int value) {
-  conf[key]=fmt::sprintf("%d",value);
+  conf[key]=DivConfigValue(fmt::sprintf("%d",value));
 }
 
 void DivConfig::set(String key, float value) {
-  conf[key]=fmt::sprintf("%f",value);
+  conf[key]=DivConfigValue(fmt::sprintf("%f",value));
 }
 
 void DivConfig::set(String key, double value) {
-  conf[key]=fmt::sprintf("%f",value);
+  conf[key]=DivConfigValue(fmt::sprintf("%f",value));
 }
 
 void DivConfig::set(String key, const char* value) {
-  conf[key]=String(value);
+  conf[key]=DivConfigValue(String(value));
 }
 
 void DivConfig::set(String key, String value) {
-  conf[key]=value;
+  conf[key]=DivConfigValue(value);
 }
 
 void DivConfig::set(String key, const std::vector<int>& value) {
@@ -457,7 +469,7 @@ void DivConfig::set(String key, const std::vector<int>& value) {
     val+=fmt::sprintf("%d",i);
     comma=true;
   }
-  conf[key]=val;
+  conf[key]=DivConfigValue(val);
 }
 
 void DivConfig::set(String key, const std::vector<String>& value) {
@@ -468,7 +480,7 @@ void DivConfig::set(String key, const std::vector<String>& value) {
     val+=taEncodeBase64(i);
     comma=true;
   }
-  conf[key]=val;
+  conf[key]=DivConfigValue(val);
 }
 
 bool DivConfig::remove(String key) {
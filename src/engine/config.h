@@ -23,8 +23,43 @@
 #include "../ta-utils.h"
 #include <initializer_list>
 
+// a config value, along with its parsed forms.
+// values are parsed once when set, so that typed lookups don't parse text.
+struct DivConfigValue {
+  String str;
+  int intVal;
+  float floatVal;
+  double doubleVal;
+  bool boolVal;
+  bool hasInt, hasFloat, hasDouble, hasBool;
+
+  void parse();
+  DivConfigValue():
+    intVal(0),
+    floatVal(0.0f),
+    doubleVal(0.0),
+    boolVal(false),
+    hasInt(false),
+    hasFloat(false),
+    hasDouble(false),
+    hasBool(false) {}
+  DivConfigValue(const String& s):
+    str(s),
+    intVal(0),
+    floatVal(0.0f),
+    doubleVal(0.0),
+    boolVal(false),
+    hasInt(false),
+    hasFloat(false),
+    hasDouble(false),
+    hasBool(false) {
+    parse();
+  }
+};
+
 class DivConfig {
-  std::map<String,String> conf;
+  // transparent comparator, so that looking up a string literal doesn't construct a String
+  std::map<String,DivConfigValue,std::less<>> conf;
   void parseLine(const char* line);
   public:
     // config loading/saving
@@ -35,20 +70,45 @@ class DivConfig {
     String toBase64();
     bool save(const char* path, bool redundancy=false);
 
-    // get the map
-    const std::map<String,String>& configMap();
+    // get the map (as strings)
+    std::map<String,String> configMap() const;
 
     // get a config value
-    bool getBool(String key, bool fallback) const;
-    int getInt(String key, int fallback) const;
-    float getFloat(String key, float fallback) const;
-    double getDouble(String key, double fallback) const;
-    String getString(String key, String fallback) const;
-    std::vector<int> getIntList(String key, std::initializer_list<int> fallback) const;
-    std::vector<String> getStringList(String key, std::initializer_list<String> fallback) const;
+    bool getBool(const char* key, bool fallback) const;
+    int getInt(const char* key, int fallback) const;
+    float getFloat(const char* key, float fallback) const;
+    double getDouble(const char* key, double fallback) const;
+    String getString(const char* key, String fallback) const;
+    std::vector<int> getIntList(const char* key, std::initializer_list<int> fallback) const;
+    std::vector<String> getStringList(const char* key, std::initializer_list<String> fallback) const;
+
+    bool getBool(const String& key, bool fallback) const {
+      return getBool(key.c_str(),fallback);
+    }
+    int getInt(const String& key, int fallback) const {
+      return getInt(key.c_str(),fallback);
+    }
+    float getFloat(const String& key, float fallback) const {
+      return getFloat(key.c_str(),fallback);
+    }
+    double getDouble(const String& key, double fallback) const {
+      return getDouble(key.c_str(),fallback);
+    }
+    String getString(const String& key, String fallback) const {
+      return getString(key.c_str(),fallback);
+    }
+    std::vector<int> getIntList(const String& key, std::initializer_list<int> fallback) const {
+      return getIntList(key.c_str(),fallback);
+    }
+    std::vector<String> getStringList(const String& key, std::initializer_list<String> fallback) const {
+      return getStringList(key.c_str(),fallback);
+    }
 
     // check for existence
-    bool has(String key) const;
+    bool has(const char* key) const;
+    bool has(const String& key) const {
+      return has(key.c_str());
+    }
 
     // set a config value
     void set(String key, bool value);
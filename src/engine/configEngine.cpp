@@ -125,23 +125,23 @@ bool DivEngine::loadConf() {
   return conf.loadFromFile(configFile.c_str(),true,true);
 }
 
-bool DivEngine::getConfBool(String key, bool fallback) {
+bool DivEngine::getConfBool(const char* key, bool fallback) {
   return conf.getBool(key,fallback);
 }
 
-int DivEngine::getConfInt(String key, int fallback) {
+int DivEngine::getConfInt(const char* key, int fallback) {
   return conf.getInt(key,fallback);
 }
 
-float DivEngine::getConfFloat(String key, float fallback) {
+float DivEngine::getConfFloat(const char* key, float fallback) {
   return conf.getFloat(key,fallback);
 }
 
-double DivEngine::getConfDouble(String key, double fallback) {
+double DivEngine::getConfDouble(const char* key, double fallback) {
   return conf.getDouble(key,fallback);
 }
 
-String DivEngine::getConfString(String key, String fallback) {
+String DivEngine::getConfString(const char* key, String fallback) {
   return conf.getString(key,fallback);
 }
 
@@ -1214,6 +1214,11 @@ class DivDispatch {
     // skipRegisterWrites: set while the engine is "seeking" in the song. when set, you shouldn't write to registers.
     // dumpWrites: set when the engine wants to know what are we writing. used during register dump export (e.g. VGM).
     bool skipRegisterWrites, dumpWrites;
+    // insShadow: set when redundant instrument reloads may be skipped.
+    // - if a channel switches to an instrument with the same parameters as the one already loaded,
+    //   the platform may avoid rewriting those registers (e.g. commitState() in the FM platforms).
+    // - this can be disabled in the settings for compatibility testing.
+    bool insShadow;
   public:
     /**
      * the rate the samples are provided.
@@ -1483,6 +1488,11 @@ class DivDispatch {
      */
     virtual void setSkipRegisterWrites(bool value);
 
+    /**
+     * enable or disable skipping of redundant instrument reloads.
+     */
+    void setInsShadow(bool enable);
+
     /**
      * notify instrument change.
      */
@@ -1642,6 +1652,8 @@ class DivDispatch {
      */
     virtual void quit();
 
+    DivDispatch():
+      insShadow(true) {}
     virtual ~DivDispatch();
 };
 
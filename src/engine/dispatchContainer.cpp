@@ -107,6 +107,9 @@ void DivDispatchContainer::setRates(double gotRate) {
     blip_set_rates(bb[i],dispatch->rate,gotRate);
   }
   rateMemory=gotRate;
+
+  // the chip or output rate may have changed
+  if (reservedBufSize>0) reserve(reservedBufSize);
 }
 
 void DivDispatchContainer::setQuality(bool lowQual, bool dcHiPass) {
@@ -128,6 +131,17 @@ void DivDispatchContainer::grow(size_t size) {
   }
 }
 
+void DivDispatchContainer::reserve(unsigned int bufSize) {
+  reservedBufSize=bufSize;
+  if (dispatch==NULL || rateMemory<=0) return;
+  // worst case: a full audio buffer rendered in one go
+  size_t needed=(size_t)ceil((double)bufSize*(double)dispatch->rate/rateMemory)+256;
+  if (needed>bbInLen) {
+    logD("reserving %d samples for dispatch %p",(int)needed,(void*)this);
+    grow(needed);
+  }
+}
+
 #define CHECK_MISSING_BUFS \
   int outs=dispatch->getOutputCount(); \
  \
@@ -156,7 +170,7 @@ void DivDispatchContainer::grow(size_t size) {
 void DivDispatchContainer::acquire(size_t count) {
   CHECK_MISSING_BUFS;
 
-  if (dispatch->hasAcquireDirect()) {
+  if (dispatch->hasAcquireDirect() && !forceDense) {
     dispatch->acquireDirect(bb,count);
   } else {
     for (int i=0; i<DIV_MAX_OUTPUTS; i++) {
@@ -183,10 +197,19 @@ void DivDispatchContainer::flush(size_t offset, size_t count) {
   }
 }
 
+void DivDispatchContainer::updateRenderCost(int64_t nanos, size_t samples) {
+  if (samples<1) return;
+  int64_t cost=(nanos*1024)/(int64_t)samples;
+  if (cost<0) cost=0;
+  if (cost>0x3fffffff) cost=0x3fffffff;
+  // smooth it out
+  renderCost=(unsigned int)(((int64_t)renderCost*7+cost)>>3);
+}
+
 void DivDispatchContainer::fillBuf(size_t runtotal, size_t offset, size_t size) {
   CHECK_MISSING_BUFS;
 
-  if (!dispatch->hasAcquireDirect()) {
+  if (!dispatch->hasAcquireDirect() || forceDense) {
     if (dcOffCompensation && runtotal>0) {
       dcOffCompensation=false;
       if (hiPass) {
@@ -800,6 +823,7 @@ void DivDispatchContainer::init(DivSystem sys, DivEngine* eng, int chanCount, do
       break;
   }
   dispatch->init(eng,chanCount,gotRate,flags);
+  dispatch->setInsShadow(eng->getConfBool("insShadow",true));
 
   // initialize output buffers
   int outs=dispatch->getOutputCount();
@@ -209,6 +209,30 @@ void DivEngine::calcSongTimestamps() {
   }
 }
 
+void DivEngine::calcSongTimestampsPartial(int ordBegin, int ordEnd, int chanBegin, int chanEnd) {
+  if (curSubSong==NULL) return;
+  if (ordBegin<0) ordBegin=0;
+  if (ordEnd>=DIV_MAX_PATTERNS) ordEnd=DIV_MAX_PATTERNS-1;
+  if (chanBegin<0) chanBegin=0;
+  if (chanEnd>=song.chans) chanEnd=song.chans-1;
+
+  // a pattern may be used in more than one order, so mark every order using an edited pattern
+  bool changed[DIV_MAX_PATTERNS];
+  bool patChanged[DIV_MAX_PATTERNS];
+  memset(changed,0,DIV_MAX_PATTERNS*sizeof(bool));
+  for (int i=chanBegin; i<=chanEnd; i++) {
+    memset(patChanged,0,DIV_MAX_PATTERNS*sizeof(bool));
+    for (int j=ordBegin; j<=ordEnd; j++) {
+      patChanged[curSubSong->orders.ord[i][j]]=true;
+    }
+    for (int j=0; j<curSubSong->ordersLen; j++) {
+      if (patChanged[curSubSong->orders.ord[i][j]]) changed[j]=true;
+    }
+  }
+
+  curSubSong->calcTimestamps(song.chans,song.grooves,song.compatFlags.jumpTreatment,song.compatFlags.ignoreJumpAtEnd,song.compatFlags.brokenSpeedSel,song.compatFlags.delayBehavior,0,changed);
+}
+
 #define EXPORT_BUFSIZE 2048
 
 double DivEngine::benchmarkPlayback() {
@@ -279,8 +303,176 @@ double DivEngine::benchmarkWalk() {
   return t;
 }
 
+// compare two timestamp walks row by row. prints the first mismatch and returns false if there is one.
+static bool compareWalks(DivSongTimestamps& full, DivSongTimestamps& inc, int ordersLen, int patLen) {
+  for (int i=0; i<ordersLen; i++) {
+    for (int j=0; j<patLen; j++) {
+      TimeMicros a=full.getTimes(i,j);
+      TimeMicros b=inc.getTimes(i,j);
+      if (a.seconds!=b.seconds || a.micros!=b.micros) {
+        printf("  order %.2X row %d: full %d.%06d, incremental %d.%06d\n",i,j,a.seconds,a.micros,b.seconds,b.micros);
+        return false;
+      }
+    }
+    if (full.maxRow[i]!=inc.maxRow[i]) {
+      printf("  order %.2X: max row full %d, incremental %d\n",i,full.maxRow[i],inc.maxRow[i]);
+      return false;
+    }
+  }
+  if (full.totalTime.seconds!=inc.totalTime.seconds || full.totalTime.micros!=inc.totalTime.micros ||
+      full.totalTicks!=inc.totalTicks || full.totalRows!=inc.totalRows) {
+    printf("  totals: full %d.%06d (%d rows), incremental %d.%06d (%d rows)\n",full.totalTime.seconds,full.totalTime.micros,full.totalRows,inc.totalTime.seconds,inc.totalTime.micros,inc.totalRows);
+    return false;
+  }
+  if (full.isLoopDefined!=inc.isLoopDefined || full.isLoopable!=inc.isLoopable ||
+      full.loopStart.order!=inc.loopStart.order || full.loopStart.row!=inc.loopStart.row ||
+      full.loopEnd.order!=inc.loopEnd.order || full.loopEnd.row!=inc.loopEnd.row) {
+    printf("  loop: full %.2X:%d-%.2X:%d, incremental %.2X:%d-%.2X:%d\n",full.loopStart.order,full.loopStart.row,full.loopEnd.order,full.loopEnd.row,inc.loopStart.order,inc.loopStart.row,inc.loopEnd.order,inc.loopEnd.row);
+    return false;
+  }
+  return true;
+}
+
+bool DivEngine::checkWalk() {
+  // effects which change the flow of the song. one of these is placed in each order in turn.
+  const unsigned char testEffects[4][2]={
+    {0x0f,0x02}, // speed
+    {0x0d,0x00}, // pattern break
+    {0x0b,0x00}, // jump (value replaced below)
+    {0xff,0x00} // stop
+  };
+  bool ret=true;
+  int patLen=curSubSong->patLen;
+  int ordersLen=curSubSong->ordersLen;
+
+  calcSongTimestamps();
+  DivSongTimestamps orig=curSubSong->ts;
+
+  for (int i=0; i<ordersLen; i++) {
+    int chan=i%song.chans;
+    int row=(i*7)%patLen;
+    int col=curSubSong->pat[chan].effectCols-1;
+    DivPattern* p=curSubSong->pat[chan].getPattern(curSubSong->orders.ord[chan][i],true);
+    short oldFx=p->newData[row][DIV_PAT_FX(col)];
+    short oldFxVal=p->newData[row][DIV_PAT_FXVAL(col)];
+
+    // edit, then undo the edit. the incremental walk must match a full walk both times.
+    for (int step=0; step<2; step++) {
+      if (step==0) {
+        const unsigned char* fx=testEffects[i&3];
+        p->newData[row][DIV_PAT_FX(col)]=fx[0];
+        p->newData[row][DIV_PAT_FXVAL(col)]=(fx[0]==0x0b)?((i+1)%ordersLen):fx[1];
+      } else {
+        p->newData[row][DIV_PAT_FX(col)]=oldFx;
+        p->newData[row][DIV_PAT_FXVAL(col)]=oldFxVal;
+      }
+      calcSongTimestampsPartial(i,i,chan,chan);
+      DivSongTimestamps inc=curSubSong->ts;
+
+      // do a full walk without touching the cache of the incremental one
+      DivTimestampCache* cache=curSubSong->ts.cache;
+      curSubSong->ts.cache=NULL;
+      calcSongTimestamps();
+      DivSongTimestamps full=curSubSong->ts;
+      delete curSubSong->ts.cache;
+      curSubSong->ts.cache=cache;
+
+      if (!compareWalks(full,inc,ordersLen,patLen)) {
+        printf("[FAIL] incremental walk differs after %s effect %.2X in order %.2X, channel %d, row %d\n",(step==0)?"placing":"removing",testEffects[i&3][0],i,chan+1,row);
+        ret=false;
+      }
+    }
+  }
+
+  // leave the timestamps as they were
+  curSubSong->ts=orig;
+  calcSongTimestamps();
+
+  if (ret) printf("[RESULT] incremental walk matches the full walk in %d orders\n",ordersLen);
+  return ret;
+}
+
+#define BENCH_DIRECT_SECONDS 60
+// largest difference between acquireDirect() and acquire() output that is still considered a match
+#define BENCH_DIRECT_TOLERANCE 16
+
+double DivEngine::benchmarkDirect(bool* failed) {
+  float* outBuf[2];
+  outBuf[0]=new float[EXPORT_BUFSIZE];
+  outBuf[1]=new float[EXPORT_BUFSIZE];
+  std::vector<short> ref[DIV_MAX_OUTPUTS];
+  size_t maxLen=(size_t)(got.rate*BENCH_DIRECT_SECONDS);
+  double ret=0.0;
+  if (failed!=NULL) *failed=false;
+
+  for (int i=0; i<song.systemLen; i++) {
+    if (!disCont[i].dispatch->hasAcquireDirect()) continue;
+    int outs=disCont[i].dispatch->getOutputCount();
+    double t[2];
+    int maxDiff=0;
+    double sumDiff=0.0;
+    size_t diffCount=0;
+    size_t firstMismatch=SIZE_MAX;
+
+    // first pass renders with acquireDirect() and stores the output.
+    // second pass renders with acquire() and compares against it.
+    for (int pass=0; pass<2; pass++) {
+      disCont[i].forceDense=(pass==1);
+      curOrder=0;
+      prevOrder=0;
+      remainingLoops=1;
+      playSub(false);
+
+      size_t pos=0;
+      std::chrono::high_resolution_clock::time_point timeStart=std::chrono::high_resolution_clock::now();
+      while (playing && pos<maxLen) {
+        nextBuf(NULL,outBuf,0,2,EXPORT_BUFSIZE,true);
+        for (int j=0; j<outs; j++) {
+          short* out=disCont[i].bbOut[j];
+          if (out==NULL) continue;
+          if (pass==0) {
+            ref[j].insert(ref[j].end(),out,out+EXPORT_BUFSIZE);
+            continue;
+          }
+          for (size_t k=0; k<EXPORT_BUFSIZE; k++) {
+            if (pos+k>=ref[j].size()) break;
+            int diff=abs((int)out[k]-(int)ref[j][pos+k]);
+            if (diff>maxDiff) maxDiff=diff;
+            if (diff>BENCH_DIRECT_TOLERANCE && pos+k<firstMismatch) firstMismatch=pos+k;
+            sumDiff+=(double)diff*(double)diff;
+            diffCount++;
+          }
+        }
+        pos+=EXPORT_BUFSIZE;
+      }
+      std::chrono::high_resolution_clock::time_point timeEnd=std::chrono::high_resolution_clock::now();
+      t[pass]=(double)(std::chrono::duration_cast<std::chrono::microseconds>(timeEnd-timeStart).count())/1000000.0;
+    }
+    disCont[i].forceDense=false;
+    for (int j=0; j<DIV_MAX_OUTPUTS; j++) {
+      ref[j].clear();
+    }
+
+    printf("[RESULT] chip %d (%s): direct %fs dense %fs, max diff %d, RMS diff %f\n",i,getSystemName(song.system[i]),t[0],t[1],maxDiff,(diffCount>0)?sqrt(sumDiff/(double)diffCount):0.0);
+    if (maxDiff>BENCH_DIRECT_TOLERANCE) {
+      printf("[FAIL] chip %d (%s): output differs by more than %d (first at sample %d)\n",i,getSystemName(song.system[i]),BENCH_DIRECT_TOLERANCE,(int)firstMismatch);
+      if (failed!=NULL) *failed=true;
+    }
+    ret+=t[0];
+  }
+  if (playing) stop();
+
+  delete[] outBuf[0];
+  delete[] outBuf[1];
+
+  return ret;
+}
+
 void DivEngine::notifyInsChange(int ins) {
   BUSY_BEGIN;
+  if (ins>=0 && ins<(int)song.ins.size()) {
+    song.ins[ins]->invalidateView();
+  }
   for (int i=0; i<song.systemLen; i++) {
     disCont[i].dispatch->notifyInsChange(ins);
   }
@@ -401,6 +593,19 @@ int DivEngine::loadSampleROMs() {
   return error;
 }
 
+// below this many sample frames it is not worth starting threads to render samples
+#define RENDER_SAMPLES_PARALLEL_MIN 262144
+
+struct DivSampleRenderJob {
+  DivSample* sample;
+  unsigned int formatMask;
+};
+
+static void _renderSampleJob(void* j) {
+  DivSampleRenderJob* job=(DivSampleRenderJob*)j;
+  job->sample->render(job->formatMask);
+}
+
 void DivEngine::renderSamplesP(int whichSample) {
   BUSY_BEGIN;
   renderSamples(whichSample);
@@ -408,9 +613,7 @@ void DivEngine::renderSamplesP(int whichSample) {
 }
 
 void DivEngine::renderSamples(int whichSample) {
-  sPreview.sample=-1;
-  sPreview.pos=0;
-  sPreview.dir=false;
+  stopSamplePreviewNoLock();
 
   logD("rendering samples...");
 
@@ -424,8 +627,30 @@ void DivEngine::renderSamples(int whichSample) {
 
   // step 1: render samples
   if (whichSample==-1) {
+    // samples are independent, so render them in parallel if there is enough data
+    size_t totalLen=0;
     for (int i=0; i<song.sampleLen; i++) {
-      song.sample[i]->render(formatMask);
+      totalLen+=song.sample[i]->samples;
+    }
+    int threads=(int)std::thread::hardware_concurrency()-1;
+    if (threads>song.sampleLen-1) threads=song.sampleLen-1;
+    if (threads>0 && totalLen>=RENDER_SAMPLES_PARALLEL_MIN) {
+      logV("rendering %d samples (%d threads)",song.sampleLen,threads+1);
+      DivSampleRenderJob* jobs=new DivSampleRenderJob[song.sampleLen];
+      DivWorkPool pool(threads);
+      for (int i=0; i<song.sampleLen; i+=DIV_WORK_POOL_MAX_TASKS) {
+        for (int j=i; j<song.sampleLen && j<i+DIV_WORK_POOL_MAX_TASKS; j++) {
+          jobs[j].sample=song.sample[j];
+          jobs[j].formatMask=formatMask;
+          pool.push(_renderSampleJob,&jobs[j],song.sample[j]->samples);
+        }
+        pool.wait();
+      }
+      delete[] jobs;
+    } else {
+      for (int i=0; i<song.sampleLen; i++) {
+        song.sample[i]->render(formatMask);
+      }
     }
   } else if (whichSample>=0 && whichSample<song.sampleLen) {
     song.sample[whichSample]->render(formatMask);
@@ -1605,6 +1830,10 @@ DivDispatch* DivEngine::getDispatch(int index) {
   return disCont[index].dispatch;
 }
 
+int DivEngine::getPlayLoopCount() {
+  return totalLoops;
+}
+
 void DivEngine::setLoops(int loops) {
   remainingLoops=loops;
 }
@@ -1976,10 +2205,7 @@ unsigned int DivEngine::convertPanLinearToSplit(int val, unsigned char bits, int
 bool DivEngine::play() {
   BUSY_BEGIN_SOFT;
   curOrder=prevOrder;
-  sPreview.sample=-1;
-  sPreview.wave=-1;
-  sPreview.pos=0;
-  sPreview.dir=false;
+  previewPool.stopAll();
   shallStop=false;
   if (stepPlay==0) {
     freelance=false;
@@ -2073,10 +2299,7 @@ bool DivEngine::play() {
 
 bool DivEngine::playToRow(int row) {
   BUSY_BEGIN_SOFT;
-  sPreview.sample=-1;
-  sPreview.wave=-1;
-  sPreview.pos=0;
-  sPreview.dir=false;
+  previewPool.stopAll();
   freelance=false;
   playSub(false,row);
   for (int i=0; i<DIV_MAX_CHANS; i++) {
@@ -2135,10 +2358,7 @@ void DivEngine::stop() {
   curOrder=prevOrder;
   curRow=prevRow;
   remainingLoops=-1;
-  sPreview.sample=-1;
-  sPreview.wave=-1;
-  sPreview.pos=0;
-  sPreview.dir=false;
+  previewPool.stopAll();
   for (int i=0; i<song.systemLen; i++) {
     disCont[i].dispatch->notifyPlaybackStop();
   }
@@ -2353,118 +2573,111 @@ void DivEngine::noteToSplitNote(short note, short& outNote, short& outOctave) {
   }
 }
 
+double DivEngine::getSamplePreviewRateFor(int sample, int note) {
+  double rate=song.sample[sample]->centerRate;
+  if (note>=0) {
+    rate=(pow(2.0,(double)(note-60)/12.0)*((double)song.sample[sample]->centerRate)*0.0625);
+    if (rate<=0) rate=song.sample[sample]->centerRate;
+  }
+  return rate;
+}
+
 void DivEngine::previewSample(int sample, int note, int pStart, int pEnd) {
-  BUSY_BEGIN;
-  previewSampleNoLock(sample,note,pStart,pEnd);
-  BUSY_END;
+  if (sample<0 || sample>=(int)song.sample.size()) {
+    previewPool.post(DivPreviewCommand(DIV_PREVIEW_CMD_STOP_SAMPLE,-1,note,0.0));
+    return;
+  }
+  previewPool.post(DivPreviewCommand(DIV_PREVIEW_CMD_SAMPLE,sample,note,getSamplePreviewRateFor(sample,note),pStart,pEnd));
 }
 
 void DivEngine::stopSamplePreview() {
-  BUSY_BEGIN;
-  stopSamplePreviewNoLock();
-  BUSY_END;
+  previewPool.post(DivPreviewCommand(DIV_PREVIEW_CMD_STOP_ALL_SAMPLES,-1,-1,0.0));
+}
+
+void DivEngine::stopSamplePreview(int note) {
+  previewPool.post(DivPreviewCommand(DIV_PREVIEW_CMD_STOP_SAMPLE,-1,note,0.0));
 }
 
 void DivEngine::previewWave(int wave, int note) {
-  BUSY_BEGIN;
-  previewWaveNoLock(wave,note);
-  BUSY_END;
+  if (wave<0 || wave>=(int)song.wave.size()) {
+    previewPool.post(DivPreviewCommand(DIV_PREVIEW_CMD_STOP_WAVE,-1,note,0.0));
+    return;
+  }
+  if (song.wave[wave]->len<=0) {
+    return;
+  }
+  previewPool.post(DivPreviewCommand(DIV_PREVIEW_CMD_WAVE,wave,note,getWavePreviewRateFor(wave,note)));
 }
 
 void DivEngine::stopWavePreview() {
-  BUSY_BEGIN;
-  stopWavePreviewNoLock();
-  BUSY_END;
+  previewPool.post(DivPreviewCommand(DIV_PREVIEW_CMD_STOP_ALL_WAVES,-1,-1,0.0));
+}
+
+void DivEngine::stopWavePreview(int note) {
+  previewPool.post(DivPreviewCommand(DIV_PREVIEW_CMD_STOP_WAVE,-1,note,0.0));
+}
+
+double DivEngine::getWavePreviewRateFor(int wave, int note) {
+  return song.wave[wave]->len*((song.tuning*0.0625)*pow(2.0,(double)(note+3-60)/12.0));
 }
 
 void DivEngine::previewSampleNoLock(int sample, int note, int pStart, int pEnd) {
-  sPreview.pBegin=pStart;
-  sPreview.pEnd=pEnd;
-  sPreview.dir=false;
   if (sample<0 || sample>=(int)song.sample.size()) {
-    sPreview.sample=-1;
-    sPreview.pos=0;
-    sPreview.dir=false;
+    previewPool.execute(DivPreviewCommand(DIV_PREVIEW_CMD_STOP_SAMPLE,-1,note,0.0));
     return;
   }
-  blip_clear(samp_bb);
-  double rate=song.sample[sample]->centerRate;
-  if (note>=0) {
-    rate=(pow(2.0,(double)(note-60)/12.0)*((double)song.sample[sample]->centerRate)*0.0625);
-    if (rate<=0) rate=song.sample[sample]->centerRate;
-  }
-  if (rate<100) rate=100;
-  double rateOrig=rate;
-  sPreview.rateMul=1;
-  while (sPreview.rateMul<0x40000000 && rate<got.rate) {
-    sPreview.rateMul<<=1;
-    rate*=2.0;
-  }
-  blip_set_rates(samp_bb,rate,got.rate);
-  samp_prevSample=0;
-  sPreview.rate=rateOrig;
-  sPreview.pos=(sPreview.pBegin>=0)?sPreview.pBegin:0;
-  sPreview.posSub=0;
-  sPreview.sample=sample;
-  sPreview.wave=-1;
-  sPreview.dir=false;
+  previewPool.execute(DivPreviewCommand(DIV_PREVIEW_CMD_SAMPLE,sample,note,getSamplePreviewRateFor(sample,note),pStart,pEnd));
 }
 
 void DivEngine::stopSamplePreviewNoLock() {
-  sPreview.sample=-1;
-  sPreview.pos=0;
-  sPreview.dir=false;
+  DivPreviewCommand cmd(DIV_PREVIEW_CMD_STOP_ALL_SAMPLES,-1,-1,0.0);
+  previewPool.cancelPending(cmd);
+  previewPool.execute(cmd);
+}
+
+void DivEngine::stopSamplePreviewNoLock(int note) {
+  DivPreviewCommand cmd(DIV_PREVIEW_CMD_STOP_SAMPLE,-1,note,0.0);
+  previewPool.cancelPending(cmd);
+  previewPool.execute(cmd);
 }
 
 void DivEngine::previewWaveNoLock(int wave, int note) {
   if (wave<0 || wave>=(int)song.wave.size()) {
-    sPreview.wave=-1;
-    sPreview.pos=0;
-    sPreview.dir=false;
+    previewPool.execute(DivPreviewCommand(DIV_PREVIEW_CMD_STOP_WAVE,-1,note,0.0));
     return;
   }
   if (song.wave[wave]->len<=0) {
     return;
   }
-  blip_clear(samp_bb);
-  double rate=song.wave[wave]->len*((song.tuning*0.0625)*pow(2.0,(double)(note+3-60)/12.0));
-  if (rate<100) rate=100;
-  double rateOrig=rate;
-  sPreview.rateMul=1;
-  while (sPreview.rateMul<0x40000000 && rate<got.rate) {
-    sPreview.rateMul<<=1;
-    rate*=2.0;
-  }
-  blip_set_rates(samp_bb,rate,got.rate);
-  samp_prevSample=0;
-  sPreview.rate=rateOrig;
-  sPreview.pos=0;
-  sPreview.posSub=0;
-  sPreview.sample=-1;
-  sPreview.wave=wave;
-  sPreview.dir=false;
+  previewPool.execute(DivPreviewCommand(DIV_PREVIEW_CMD_WAVE,wave,note,getWavePreviewRateFor(wave,note)));
 }
 
 void DivEngine::stopWavePreviewNoLock() {
-  sPreview.wave=-1;
-  sPreview.pos=0;
-  sPreview.dir=false;
+  DivPreviewCommand cmd(DIV_PREVIEW_CMD_STOP_ALL_WAVES,-1,-1,0.0);
+  previewPool.cancelPending(cmd);
+  previewPool.execute(cmd);
+}
+
+void DivEngine::stopWavePreviewNoLock(int note) {
+  DivPreviewCommand cmd(DIV_PREVIEW_CMD_STOP_WAVE,-1,note,0.0);
+  previewPool.cancelPending(cmd);
+  previewPool.execute(cmd);
 }
 
 bool DivEngine::isPreviewingSample() {
-  return (sPreview.sample>=0 && sPreview.sample<(int)song.sample.size() && sPreview.pos!=sPreview.pEnd);
+  return previewPool.isPlayingSample((int)song.sample.size());
 }
 
 int DivEngine::getSamplePreviewSample() {
-  return sPreview.sample;
+  return previewPool.getSample();
 }
 
 int DivEngine::getSamplePreviewPos() {
-  return sPreview.pos;
+  return previewPool.getPos();
 }
 
 double DivEngine::getSamplePreviewRate() {
-  return sPreview.rate;
+  return previewPool.getRate();
 }
 
 double DivEngine::getCenterRate() {
@@ -3048,9 +3261,7 @@ int DivEngine::addSample() {
   sample->centerRate=getCenterRate();
   song.sample.push_back(sample);
   song.sampleLen=sampleCount+1;
-  sPreview.sample=-1;
-  sPreview.pos=0;
-  sPreview.dir=false;
+  stopSamplePreviewNoLock();
   checkAssetDir(song.sampleDir,song.sample.size());
   saveLock.unlock();
   renderSamples();
@@ -3077,9 +3288,7 @@ int DivEngine::addSamplePtr(DivSample* which) {
 }
 
 void DivEngine::delSampleUnsafe(int index, bool render) {
-  sPreview.sample=-1;
-  sPreview.pos=0;
-  sPreview.dir=false;
+  stopSamplePreviewNoLock();
   if (index>=0 && index<(int)song.sample.size()) {
     delete song.sample[index];
     song.sample.erase(song.sample.begin()+index);
@@ -3372,9 +3581,7 @@ bool DivEngine::moveWaveUp(int which) {
 bool DivEngine::moveSampleUp(int which) {
   if (which<1 || which>=(int)song.sample.size()) return false;
   BUSY_BEGIN;
-  sPreview.sample=-1;
-  sPreview.pos=0;
-  sPreview.dir=false;
+  stopSamplePreviewNoLock();
   DivSample* prev=song.sample[which];
   saveLock.lock();
   song.sample[which]=song.sample[which-1];
@@ -3418,9 +3625,7 @@ bool DivEngine::moveWaveDown(int which) {
 bool DivEngine::moveSampleDown(int which) {
   if (which<0 || which>=((int)song.sample.size())-1) return false;
   BUSY_BEGIN;
-  sPreview.sample=-1;
-  sPreview.pos=0;
-  sPreview.dir=false;
+  stopSamplePreviewNoLock();
   DivSample* prev=song.sample[which];
   saveLock.lock();
   song.sample[which]=song.sample[which+1];
@@ -3464,9 +3669,7 @@ bool DivEngine::swapWaves(int a, int b) {
 bool DivEngine::swapSamples(int a, int b) {
   if (a<0 || a>=(int)song.sample.size() || b<0 || b>=(int)song.sample.size()) return false;
   BUSY_BEGIN;
-  sPreview.sample=-1;
-  sPreview.pos=0;
-  sPreview.dir=false;
+  stopSamplePreviewNoLock();
   DivSample* temp=song.sample[a];
   saveLock.lock();
   song.sample[a]=song.sample[b];
@@ -3878,6 +4081,10 @@ bool DivEngine::switchMaster(bool full) {
     if (curFilePlayer!=NULL) {
       curFilePlayer->setOutputRate(got.rate);
     }
+    previewPool.setRate(got.rate);
+    // recreate the render pool (its settings may have changed) and buffers before
+    // the audio thread starts, so that it doesn't have to do it.
+    prepareAudioBuffers(MAX(got.bufsize,preparedBufSize));
     if (!output->setRun(true)) {
       logE("error while activating audio!");
       return false;
@@ -4035,9 +4242,48 @@ void DivEngine::initDispatch(bool isRender) {
     saveLock.unlock();
   }
   song.recalcChans();
+  prepareAudioBuffers(MAX(got.bufsize,preparedBufSize));
   BUSY_END;
 }
 
+void DivEngine::prepareAudioBuffers(unsigned int bufSize) {
+  if (bufSize<1) bufSize=1024;
+  logV("preparing audio buffers for size %d",bufSize);
+
+  if (renderPool==NULL) {
+    unsigned int howManyThreads=song.systemLen;
+    if (howManyThreads<2) howManyThreads=0;
+    if (howManyThreads>renderPoolThreads) howManyThreads=renderPoolThreads;
+    renderPool=new DivWorkPool(howManyThreads,true,renderPoolAffinity);
+  }
+
+  if (metroTickLen<bufSize) {
+    if (metroTick!=NULL) delete[] metroTick;
+    metroTick=new unsigned char[bufSize];
+    metroTickLen=bufSize;
+  }
+
+  if (metroBufLen<bufSize || metroBuf==NULL) {
+    if (metroBuf!=NULL) delete[] metroBuf;
+    metroBuf=new float[bufSize];
+    metroBufLen=bufSize;
+  }
+
+  if (filePlayerBufLen<bufSize) {
+    for (int i=0; i<DIV_MAX_OUTPUTS; i++) {
+      if (filePlayerBuf[i]!=NULL) delete[] filePlayerBuf[i];
+      filePlayerBuf[i]=new float[bufSize];
+    }
+    filePlayerBufLen=bufSize;
+  }
+
+  for (int i=0; i<song.systemLen; i++) {
+    disCont[i].reserve(bufSize);
+  }
+
+  preparedBufSize=bufSize;
+}
+
 void DivEngine::quitDispatch() {
   BUSY_BEGIN;
   logV("terminating dispatch...");
@@ -4125,6 +4371,7 @@ bool DivEngine::initAudioBackend() {
   if (previewVol<0.0f) previewVol=0.0f;
   if (previewVol>1.0f) previewVol=1.0f;
   renderPoolThreads=getConfInt("renderPoolThreads",0);
+  renderPoolAffinity=getConfBool("renderPoolAffinity",false);
 
   if (lowLatency) logI("using low latency mode.");
 
@@ -4307,10 +4554,10 @@ bool DivEngine::preInit(bool noSafeMode) {
   logI("Furnace version " DIV_VERSION ".");
 
   // register systems
-  if (!systemsRegistered) registerSystems();
+  registerSystems();
 
   // register ROM exports
-  if (!romExportsRegistered) registerROMExports();
+  registerROMExports();
 
   // TODO: re-enable with a better approach
   // see issue #1581
@@ -4356,6 +4603,17 @@ bool DivEngine::preInit(bool noSafeMode) {
   return wantSafe;
 }
 
+bool DivEngine::initEmbedded() {
+  // leave the configuration empty so that defaults are used
+  configLoaded=true;
+
+  registerSystems();
+  registerROMExports();
+
+  audioEngine=DIV_AUDIO_DUMMY;
+  return init();
+}
+
 void DivEngine::everythingOK() {
   // TODO: re-enable with a better approach
   // see issue #1581
@@ -4400,27 +4658,15 @@ bool DivEngine::init() {
     haveAudio=true;
   }
 
-  logV("creating blip_buf");
+  logV("creating preview pool (%f)",got.rate);
 
-  samp_bb=blip_new(32768);
-  if (samp_bb==NULL) {
-    logE("not enough memory!");
+  if (!previewPool.init(got.rate)) {
     return false;
   }
-  blip_set_dc(samp_bb,0);
-
-  samp_bbOut=new short[32768];
-
-  samp_bbIn=new short[32768];
-  samp_bbInLen=32768;
 
   metroBuf=new float[8192];
   metroBufLen=8192;
 
-  logV("setting blip rate of samp_bb (%f)",got.rate);
-  
-  blip_set_rates(samp_bb,44100,got.rate);
-
   for (int i=0; i<64; i++) {
     vibTable[i]=127*sin(((double)i/64.0)*(2*M_PI));
   }
@@ -4441,6 +4687,7 @@ bool DivEngine::init() {
   if (curFilePlayer!=NULL) {
     curFilePlayer->setOutputRate(got.rate);
   }
+  previewPool.setRate(got.rate);
 
   if (!haveAudio) {
     return false;
@@ -4473,10 +4720,12 @@ bool DivEngine::quit(bool saveConfig) {
     metroBuf=NULL;
     metroBufLen=0;
   }
+  preparedBufSize=0;
   if (curFilePlayer!=NULL) {
     delete curFilePlayer;
     curFilePlayer=NULL;
   }
+  previewPool.quit();
   if (yrw801ROM!=NULL) delete[] yrw801ROM;
   if (tg100ROM!=NULL) delete[] tg100ROM;
   if (mu5ROM!=NULL) delete[] mu5ROM;
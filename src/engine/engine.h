@@ -30,6 +30,7 @@
 #include "sysDef.h"
 #include "cmdStream.h"
 #include "filePlayer.h"
+#include "preview.h"
 #include "../audio/taAudio.h"
 #include "blip_buf.h"
 #include <functional>
@@ -156,6 +157,19 @@ struct DivAudioExportOptions {
   }
 };
 
+struct DivTextExportOptions {
+  bool separatePatterns;
+  // range of orders and channels to export (inclusive, -1 for all)
+  int orderBegin, orderEnd;
+  int chanBegin, chanEnd;
+  DivTextExportOptions():
+    separatePatterns(false),
+    orderBegin(-1),
+    orderEnd(-1),
+    chanBegin(-1),
+    chanEnd(-1) {}
+};
+
 #ifdef WITH_JSON
 struct DivJSONExportOptions {
   enum ExportFormat : unsigned char {
@@ -167,6 +181,9 @@ struct DivJSONExportOptions {
   bool jsonPretty;
   bool exportMetadata, exportChips, exportOrders, exportPatterns, exportInstruments, exportWaves, exportSamples, exportCompatFlags;
   bool optimizePatterns;
+  // range of orders and channels to export (inclusive, -1 for all)
+  int orderBegin, orderEnd;
+  int chanBegin, chanEnd;
   DivJSONExportOptions():
     format(EXPORT_JSON),
     jsonPretty(false),
@@ -178,7 +195,11 @@ struct DivJSONExportOptions {
     exportWaves(true),
     exportSamples(true),
     exportCompatFlags(false),
-    optimizePatterns(true) {}
+    optimizePatterns(true),
+    orderBegin(-1),
+    orderEnd(-1),
+    chanBegin(-1),
+    chanEnd(-1) {}
 };
 #endif
 
@@ -305,18 +326,32 @@ struct DivDispatchContainer {
   short* bbIn[DIV_MAX_OUTPUTS];
   short* bbOut[DIV_MAX_OUTPUTS];
   bool lowQuality, dcOffCompensation, hiPass;
+  // set when a command is sent to the dispatch. in low-latency mode, sub-ticks only tick dispatches with this set.
+  bool cmdPending;
+  // set when a macro or other tick-based process in the dispatch has a step due on sub-tick wakeClock.
+  bool wakePending;
+  unsigned int wakeClock;
+  // use acquire() even if the dispatch supports acquireDirect(). for A/B testing.
+  bool forceDense;
   double rateMemory;
 
   // used in multi-thread
   int cycles;
   unsigned int size;
+  // measured render cost (nanoseconds per 1024 samples, smoothed).
+  // used to balance dispatches between work threads.
+  unsigned int renderCost;
+  // the audio buffer size passed to reserve(). setRates() reserves again for it.
+  unsigned int reservedBufSize;
 
   void setRates(double gotRate);
   void setQuality(bool lowQual, bool dcHiPass);
   void grow(size_t size);
+  void reserve(unsigned int bufSize);
   void acquire(size_t count);
   void flush(size_t offset, size_t count);
   void fillBuf(size_t runtotal, size_t offset, size_t size);
+  void updateRenderCost(int64_t nanos, size_t samples);
   void clear();
   void init(DivSystem sys, DivEngine* eng, int chanCount, double gotRate, const DivConfig& flags, bool isRender=false);
   void quit();
@@ -330,9 +365,15 @@ struct DivDispatchContainer {
     lowQuality(false),
     dcOffCompensation(false),
     hiPass(true),
+    cmdPending(false),
+    wakePending(false),
+    wakeClock(0),
+    forceDense(false),
     rateMemory(0.0),
     cycles(0),
-    size(0) {
+    size(0),
+    renderCost(0),
+    reservedBufSize(0) {
     memset(bb,0,DIV_MAX_OUTPUTS*sizeof(blip_buffer_t*));
     memset(temp,0,DIV_MAX_OUTPUTS*sizeof(int));
     memset(prevSample,0,DIV_MAX_OUTPUTS*sizeof(int));
@@ -394,8 +435,6 @@ class DivEngine {
   bool midiIsDirect;
   bool midiIsDirectProgram;
   bool lowLatency;
-  bool systemsRegistered;
-  bool romExportsRegistered;
   bool hasLoadedSomething;
   bool midiOutClock;
   bool midiOutTime;
@@ -461,25 +500,7 @@ class DivEngine {
 
   DivCSPlayer* cmdStreamInt;
 
-  struct SamplePreview {
-    double rate;
-    int sample;
-    int wave;
-    int pos;
-    int pBegin, pEnd;
-    int rateMul, posSub;
-    bool dir;
-    SamplePreview():
-      rate(0.0),
-      sample(-1),
-      wave(-1),
-      pos(0),
-      pBegin(-1),
-      pEnd(-1),
-      rateMul(1),
-      posSub(0),
-      dir(false) {}
-  } sPreview;
+  DivPreviewPool previewPool;
 
   short vibTable[64];
   short tremTable[128];
@@ -489,12 +510,6 @@ class DivEngine {
   bool midiDebug;
   size_t midiAgeCounter;
 
-  blip_buffer_t* samp_bb;
-  size_t samp_bbInLen;
-  int samp_temp, samp_prevSample;
-  short* samp_bbIn;
-  short* samp_bbOut;
-
   unsigned char* metroTick;
   size_t metroTickLen;
   float* metroBuf;
@@ -515,10 +530,19 @@ class DivEngine {
   size_t totalProcessed;
 
   unsigned int renderPoolThreads;
+  bool renderPoolAffinity;
   DivWorkPool* renderPool;
 
+  // the audio buffer size that prepareAudioBuffers() last allocated for.
+  // nextBuf() splits larger buffers into chunks of this size.
+  unsigned int preparedBufSize;
+
   // MIDI stuff
   std::function<int(const TAMidiMessage&)> midiCallback=[](const TAMidiMessage&) -> int {return -3;};
+  // time (in seconds, see TAMidiIn::now()) which corresponds to the start of the current buffer.
+  double midiInBufStart;
+  // size of the current buffer.
+  unsigned int midiInBufSize;
 
   void processRowPre(int i);
   void processRow(int i, bool afterDelay);
@@ -527,6 +551,9 @@ class DivEngine {
   void performVGMWrite(SafeWriter* w, DivSystem sys, DivRegWrite& write, int streamOff, double* loopTimer, double* loopFreq, int* loopSample, bool* sampleDir, bool isSecond, int* pendingFreq, int* playingSample, int* setPos, unsigned int* sampleOff8, unsigned int* sampleLen8, size_t bankOffset, bool directStream, bool* sampleStoppable, bool dpcm07, DivDispatch** writeNES, int rateCorrection);
   // returns true if end of song.
   bool nextTick(bool noAccum=false, bool inhibitLowLat=false);
+  // process MIDI input events which are due at or before the given buffer position.
+  // if upTo is -1, process all of them.
+  void processMidiIn(int upTo=-1);
   bool perSystemEffect(int ch, unsigned char effect, unsigned char effectVal);
   bool perSystemPostEffect(int ch, unsigned char effect, unsigned char effectVal);
   bool perSystemPreEffect(int ch, unsigned char effect, unsigned char effectVal);
@@ -536,6 +563,10 @@ class DivEngine {
   void runMidiTime(int totalCycles=1);
   bool shallSwitchCores();
 
+  // allocate everything nextBuf() needs for buffers of up to bufSize samples.
+  // this includes the render pool, so that the audio thread does not allocate during playback.
+  void prepareAudioBuffers(unsigned int bufSize);
+
   void testFunction();
 
   bool loadDMF(unsigned char* file, size_t len);
@@ -581,8 +612,9 @@ class DivEngine {
   bool initAudioBackend();
   bool deinitAudioBackend(bool dueToSwitchMaster=false);
 
-  void registerSystems();
-  void registerROMExports();
+  // fill in sysDefs/romExportDefs. only called once (see registerSystems()).
+  static void initSystemDefs();
+  static void initROMExportDefs();
   void initSongWithDesc(const char* description, bool inBase64=true, bool oldVol=false);
 
   void exchangeIns(int one, int two);
@@ -606,6 +638,9 @@ class DivEngine {
 
   void swapSystemUnsafe(int src, int dest, bool preserveOrder=true);
 
+  // set up audio export state (used by saveAudio and export batches)
+  bool prepareAudioExport(const char* path, const DivAudioExportOptions& options);
+
   // add every export method here
   friend class DivROMExport;
   friend class DivExportAmigaValidation;
@@ -614,8 +649,15 @@ class DivEngine {
   friend class DivExportZSM;
   friend class DivExportiPod;
   friend class DivExportGRUB;
+  friend class DivAudioExportBatch;
 
   public:
+    // register the system and ROM export definitions.
+    // these tables are shared by all engine instances and are only filled in once,
+    // so these may be called from any thread.
+    static void registerSystems();
+    static void registerROMExports();
+
     DivSong song;
     DivOrders* curOrders;
     DivChannelData* curPat;
@@ -626,6 +668,11 @@ class DivEngine {
     float oscSize;
     int oscReadPos, oscWritePos;
     int tickMult;
+    // increased on every engine tick (including sub-ticks).
+    // used to count the sub-ticks elapsed since a dispatch was last ticked.
+    unsigned int subTickClock;
+    // the dispatch which is being ticked (-1 if none).
+    int tickingDispatch;
     int lastNBIns, lastNBOuts, lastNBSize;
     std::atomic<size_t> processTime;
 
@@ -683,9 +730,13 @@ class DivEngine {
     SafeWriter* saveCommand(DivCSProgress* progress=NULL, DivCSOptions options=DivCSOptions());
     // export to text
     SafeWriter* saveText(bool separatePatterns=true);
+    // export to text, writing to w as it goes (use SafeWriter::initStream() to write straight to a file)
+    bool saveText(SafeWriter* w, const DivTextExportOptions& options);
 #ifdef WITH_JSON
     // export to json
     SafeWriter* saveJSON(DivJSONExportOptions* options);
+    // export to json, writing to w as it goes (BSON/CBOR are still built in memory first)
+    bool saveJSON(SafeWriter* w, DivJSONExportOptions* options);
 #endif
     // export to an audio file
     bool saveAudio(const char* path, DivAudioExportOptions options);
@@ -720,6 +771,12 @@ class DivEngine {
     double benchmarkPlayback();
     double benchmarkSeek();
     double benchmarkWalk();
+    // places a flow effect in each order in turn and compares the incremental timestamp walk
+    // against a full walk after each edit. returns false on any mismatch.
+    bool checkWalk();
+    // renders each chip with acquireDirect() and acquire() and compares the results.
+    // if failed is not NULL, it is set to whether any chip differed by more than the tolerance.
+    double benchmarkDirect(bool* failed=NULL);
 
     // returns the minimum VGM version which may carry the specified system, or 0 if none.
     int minVGMVersion(DivSystem which);
@@ -734,11 +791,11 @@ class DivEngine {
     bool loadConf();
 
     // get a config value
-    bool getConfBool(String key, bool fallback);
-    int getConfInt(String key, int fallback);
-    float getConfFloat(String key, float fallback);
-    double getConfDouble(String key, double fallback);
-    String getConfString(String key, String fallback);
+    bool getConfBool(const char* key, bool fallback);
+    int getConfInt(const char* key, int fallback);
+    float getConfFloat(const char* key, float fallback);
+    double getConfDouble(const char* key, double fallback);
+    String getConfString(const char* key, String fallback);
 
     // get config object
     DivConfig& getConfObject();
@@ -780,6 +837,10 @@ class DivEngine {
     // calculate all song timestamps
     void calcSongTimestamps();
 
+    // recalculate song timestamps after an edit to the patterns in the given region.
+    // only the part of the song which may be affected is walked again.
+    void calcSongTimestampsPartial(int ordBegin, int ordEnd, int chanBegin, int chanEnd);
+
     // play (returns whether successful)
     bool play();
 
@@ -808,20 +869,34 @@ class DivEngine {
     void setSamplePreviewVol(float vol);
 
     // trigger sample preview
+    // this does not lock the engine. the preview starts on the next audio buffer.
     void previewSample(int sample, int note=-1, int pStart=-1, int pEnd=-1);
+    // stop all sample previews, or only the one playing note
     void stopSamplePreview();
+    void stopSamplePreview(int note);
 
     // trigger wave preview
+    // this does not lock the engine. the preview starts on the next audio buffer.
     void previewWave(int wave, int note);
+    // stop all wave previews, or only the one playing note
     void stopWavePreview();
+    void stopWavePreview(int note);
 
-    // trigger sample preview
+    // get the playback rate of a sample/wave preview
+    double getSamplePreviewRateFor(int sample, int note);
+    double getWavePreviewRateFor(int wave, int note);
+
+    // trigger sample preview immediately
+    // only use with the engine locked!
+    // stopping also drops queued previews which have not started yet
     void previewSampleNoLock(int sample, int note=-1, int pStart=-1, int pEnd=-1);
     void stopSamplePreviewNoLock();
+    void stopSamplePreviewNoLock(int note);
 
     // trigger wave preview
     void previewWaveNoLock(int wave, int note);
     void stopWavePreviewNoLock();
+    void stopWavePreviewNoLock(int note);
 
     // get config path
     String getConfigPath();
@@ -917,6 +992,10 @@ class DivEngine {
     // map volume to gain
     float getGain(int ch, int vol);
 
+    // in low-latency mode, request the dispatch being ticked to be ticked again after the given number of sub-ticks.
+    // used by macros and other tick-based processes to step at their own phase rather than on song ticks.
+    void wakeDispatchIn(int subTicks);
+
     // get max frequency/period of a channel
     unsigned int getMaxFreqChan(int ch);
 
@@ -986,6 +1065,9 @@ class DivEngine {
     // is exporting
     bool isExporting();
 
+    // get how many times the song has looped since playback started
+    int getPlayLoopCount();
+
     // get how many loops is left
     void getLoopsLeft(int& loops);
 
@@ -1362,6 +1444,10 @@ class DivEngine {
     // initialize the engine.
     bool init();
 
+    // initialize the engine for embedding (see src/lib/furnace.h).
+    // this does not read the configuration or write a log file, and uses the dummy audio output.
+    bool initEmbedded();
+
     // confirm that the engine is running (delete safe mode file).
     void everythingOK();
 
@@ -1400,8 +1486,6 @@ class DivEngine {
       midiIsDirect(false),
       midiIsDirectProgram(false),
       lowLatency(false),
-      systemsRegistered(false),
-      romExportsRegistered(false),
       hasLoadedSomething(false),
       midiOutClock(false),
       midiOutTime(false),
@@ -1470,12 +1554,6 @@ class DivEngine {
       midiPoly(true),
       midiDebug(false),
       midiAgeCounter(0),
-      samp_bb(NULL),
-      samp_bbInLen(0),
-      samp_temp(0),
-      samp_prevSample(0),
-      samp_bbIn(NULL),
-      samp_bbOut(NULL),
       metroTick(NULL),
       metroTickLen(0),
       metroBuf(NULL),
@@ -1493,7 +1571,11 @@ class DivEngine {
       curFilePlayerTrail(0),
       totalProcessed(0),
       renderPoolThreads(0),
+      renderPoolAffinity(false),
       renderPool(NULL),
+      preparedBufSize(0),
+      midiInBufStart(0.0),
+      midiInBufSize(0),
       curOrders(NULL),
       curPat(NULL),
       tempIns(NULL),
@@ -1501,6 +1583,8 @@ class DivEngine {
       oscReadPos(0),
       oscWritePos(0),
       tickMult(1),
+      subTickClock(0),
+      tickingDispatch(-1),
       lastNBIns(0),
       lastNBOuts(0),
       lastNBSize(0),
@@ -1513,19 +1597,12 @@ class DivEngine {
       memset(vibTable,0,64*sizeof(short));
       memset(tremTable,0,128*sizeof(short));
       memset(effectSlotMap,-1,4096*sizeof(short));
-      memset(sysDefs,0,DIV_MAX_CHIP_DEFS*sizeof(void*));
-      memset(romExportDefs,0,DIV_ROM_MAX*sizeof(void*));
       memset(walked,0,8192);
       memset(oscBuf,0,DIV_MAX_OUTPUTS*(sizeof(float*)));
       memset(exportChannelMask,1,DIV_MAX_CHANS*sizeof(bool));
       memset(chipPeak,0,DIV_MAX_CHIPS*DIV_MAX_OUTPUTS*sizeof(float));
       memset(filePlayerBuf,0,DIV_MAX_OUTPUTS*sizeof(float));
 
-      for (int i=0; i<DIV_MAX_CHIP_DEFS; i++) {
-        sysFileMapFur[i]=DIV_SYSTEM_NULL;
-        sysFileMapDMF[i]=DIV_SYSTEM_NULL;
-      }
-
       changeSong(0);
     }
 };
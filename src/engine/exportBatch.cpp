@@ -0,0 +1,304 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2026 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "exportBatch.h"
+#include "workPool.h"
+#include "../ta-log.h"
+#include "../fileutils.h"
+
+static void _runExportJob(void* arg) {
+  DivAudioExportJob* job=(DivAudioExportJob*)arg;
+  job->parent->runJob(job);
+}
+
+int DivAudioExportBatch::addSong(const String& path) {
+  FILE* f=ps_fopen(path.c_str(),"rb");
+  if (f==NULL) {
+    logE("export batch: could not open %s! (%s)",path,strerror(errno));
+    return -1;
+  }
+  if (fseek(f,0,SEEK_END)!=0) {
+    logE("export batch: could not seek to end of %s!",path);
+    fclose(f);
+    return -1;
+  }
+  ssize_t len=ftell(f);
+  if (len<1 || len==(SIZE_MAX>>1)) {
+    logE("export batch: %s is empty or has an invalid size!",path);
+    fclose(f);
+    return -1;
+  }
+  if (fseek(f,0,SEEK_SET)!=0) {
+    logE("export batch: could not seek to beginning of %s!",path);
+    fclose(f);
+    return -1;
+  }
+  unsigned char* buf=new unsigned char[len];
+  if (fread(buf,1,len,f)!=(size_t)len) {
+    logE("export batch: could not read %s!",path);
+    delete[] buf;
+    fclose(f);
+    return -1;
+  }
+  fclose(f);
+
+  songs.push_back(DivAudioExportSong(path,buf,len));
+  return (int)songs.size()-1;
+}
+
+int DivAudioExportBatch::addSong(const String& name, const unsigned char* data, size_t len) {
+  unsigned char* buf=new unsigned char[len];
+  memcpy(buf,data,len);
+  songs.push_back(DivAudioExportSong(name,buf,len));
+  return (int)songs.size()-1;
+}
+
+void DivAudioExportBatch::addJob(int song, int subSong, const String& path, const DivAudioExportOptions& options) {
+  jobs.push_back(new DivAudioExportJob(this,song,subSong,path,options));
+}
+
+void DivAudioExportBatch::runJob(DivAudioExportJob* job) {
+  if (stopExport) {
+    job->error="aborted";
+    job->state=DIV_EXPORT_JOB_FAILED;
+    jobsDone++;
+    return;
+  }
+  if (job->song<0 || job->song>=(int)songs.size()) {
+    job->error="invalid song";
+    job->state=DIV_EXPORT_JOB_FAILED;
+    jobsDone++;
+    return;
+  }
+  DivAudioExportSong& s=songs[job->song];
+  job->state=DIV_EXPORT_JOB_RUNNING;
+  logD("export batch: %s (sub-song %d) -> %s",s.name,job->subSong,job->path);
+
+  // set up a headless engine like initEmbedded() does.
+  // system definitions are shared and have been registered by the main engine already.
+  DivEngine* w=new DivEngine;
+  w->conf=conf;
+  w->configLoaded=true;
+  w->audioEngine=DIV_AUDIO_DUMMY;
+
+  // the engine takes ownership of the buffer
+  unsigned char* data=new unsigned char[s.len];
+  memcpy(data,s.data,s.len);
+  if (!w->load(data,s.len,s.name.c_str())) {
+    logE("export batch: could not load %s! (%s)",s.name,w->getLastError());
+    job->error=w->getLastError();
+    job->state=DIV_EXPORT_JOB_FAILED;
+    delete w;
+    jobsDone++;
+    return;
+  }
+  if (!w->init()) {
+    logE("export batch: could not initialize engine for %s!",s.name);
+    job->error="could not initialize engine";
+    job->state=DIV_EXPORT_JOB_FAILED;
+    w->quit(false);
+    delete w;
+    jobsDone++;
+    return;
+  }
+
+  if (job->subSong<0 || job->subSong>=(int)w->song.subsong.size()) {
+    logE("export batch: %s has no sub-song %d!",s.name,job->subSong);
+    job->error="invalid sub-song";
+    job->state=DIV_EXPORT_JOB_FAILED;
+    w->quit(false);
+    delete w;
+    jobsDone++;
+    return;
+  }
+  w->changeSongP(job->subSong);
+
+  if (!w->prepareAudioExport(job->path.c_str(),job->options)) {
+    job->error="could not begin export";
+    job->state=DIV_EXPORT_JOB_FAILED;
+    w->quit(false);
+    delete w;
+    jobsDone++;
+    return;
+  }
+
+  // calculate the expected length for progress (see FurnaceGUI::exportAudio)
+  w->calcSongTimestamps();
+  DivSongTimestamps& ts=w->curSubSong->ts;
+  double songLength=ts.totalTime.toDouble();
+  if (ts.isLoopable) {
+    int totalLoops=0;
+    w->getTotalLoops(totalLoops);
+    songLength+=(songLength-ts.loopStartTime.toDouble())*totalLoops;
+    songLength+=job->options.fadeOut;
+  }
+  int totalFiles=0;
+  w->getTotalAudioFiles(totalFiles);
+
+  bool aborted;
+  jobLock.lock();
+  job->songLength=songLength;
+  job->length=songLength*totalFiles;
+  job->worker=w;
+  aborted=stopExport;
+  jobLock.unlock();
+
+  if (!aborted) w->runExportThread();
+
+  jobLock.lock();
+  job->worker=NULL;
+  aborted=stopExport;
+  jobLock.unlock();
+
+  w->quit(false);
+  delete w;
+
+  if (aborted) {
+    job->error="aborted";
+    job->state=DIV_EXPORT_JOB_FAILED;
+  } else {
+    job->state=DIV_EXPORT_JOB_DONE;
+  }
+  jobsDone++;
+}
+
+void DivAudioExportBatch::run() {
+  int threads=maxThreads-1;
+  if (threads>(int)jobs.size()-1) threads=jobs.size()-1;
+  if (threads<0) threads=0;
+  logI("export batch: %d jobs (%d threads)",(int)jobs.size(),threads+1);
+  DivWorkPool pool(threads);
+  for (size_t i=0; i<jobs.size(); i+=DIV_WORK_POOL_MAX_TASKS) {
+    for (size_t j=i; j<jobs.size() && j<i+DIV_WORK_POOL_MAX_TASKS; j++) {
+      pool.push(_runExportJob,jobs[j]);
+    }
+    pool.wait();
+  }
+  logI("export batch: done!");
+}
+
+bool DivAudioExportBatch::go() {
+  if (thread!=NULL) return false;
+  if (jobs.empty()) return false;
+  stopExport=false;
+  jobsDone=0;
+  try {
+    thread=new std::thread(&DivAudioExportBatch::run,this);
+  } catch (std::system_error& e) {
+    logE("could not start export batch thread! %s",e.what());
+    thread=NULL;
+    return false;
+  }
+  return true;
+}
+
+void DivAudioExportBatch::wait() {
+  if (thread!=NULL) {
+    thread->join();
+    delete thread;
+    thread=NULL;
+  }
+}
+
+void DivAudioExportBatch::abort() {
+  jobLock.lock();
+  stopExport=true;
+  for (DivAudioExportJob* i: jobs) {
+    if (i->worker!=NULL) {
+      i->worker->stopExport=true;
+      i->worker->stop();
+    }
+  }
+  jobLock.unlock();
+}
+
+bool DivAudioExportBatch::isRunning() {
+  return thread!=NULL && jobsDone<(int)jobs.size();
+}
+
+bool DivAudioExportBatch::hasFailed() {
+  for (DivAudioExportJob* i: jobs) {
+    if (i->state==DIV_EXPORT_JOB_FAILED) return true;
+  }
+  return false;
+}
+
+int DivAudioExportBatch::getJobCount() {
+  return (int)jobs.size();
+}
+
+int DivAudioExportBatch::getJobsDone() {
+  return jobsDone;
+}
+
+DivAudioExportJobProgress DivAudioExportBatch::getProgress(int index) {
+  DivAudioExportJobProgress ret;
+  ret.state=DIV_EXPORT_JOB_PENDING;
+  ret.amount=0.0f;
+  if (index<0 || index>=(int)jobs.size()) return ret;
+
+  DivAudioExportJob* job=jobs[index];
+  ret.name=job->path;
+  ret.state=(DivAudioExportJobStates)job->state.load();
+  if (ret.state==DIV_EXPORT_JOB_DONE) {
+    ret.amount=1.0f;
+  } else if (ret.state==DIV_EXPORT_JOB_RUNNING) {
+    jobLock.lock();
+    DivEngine* w=job->worker;
+    if (w!=NULL && job->length>0.0) {
+      int curFile=0;
+      double curTime=0.0;
+      w->lockEngine([w,&curFile,&curTime]() {
+        w->getCurFileIndex(curFile);
+        curTime=w->getCurTime().toDouble();
+      });
+      ret.amount=(curTime+job->songLength*curFile)/job->length;
+    }
+    jobLock.unlock();
+    if (ret.amount<0.0f) ret.amount=0.0f;
+    if (ret.amount>1.0f) ret.amount=1.0f;
+  }
+  return ret;
+}
+
+DivAudioExportBatch::DivAudioExportBatch(DivEngine* eng, int threads):
+  thread(NULL),
+  stopExport(false),
+  jobsDone(0),
+  maxThreads(threads) {
+  if (eng!=NULL) conf=eng->conf;
+  // each job already runs on its own thread
+  conf.set("renderPoolThreads",0);
+  if (maxThreads<1) maxThreads=std::thread::hardware_concurrency();
+  if (maxThreads<1) maxThreads=1;
+}
+
+DivAudioExportBatch::~DivAudioExportBatch() {
+  abort();
+  wait();
+  for (DivAudioExportJob* i: jobs) {
+    delete i;
+  }
+  jobs.clear();
+  for (DivAudioExportSong& i: songs) {
+    delete[] i.data;
+  }
+  songs.clear();
+}
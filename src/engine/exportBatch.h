@@ -0,0 +1,151 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2026 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef _EXPORTBATCH_H
+#define _EXPORTBATCH_H
+
+#include "engine.h"
+#include <atomic>
+#include <mutex>
+
+enum DivAudioExportJobStates {
+  DIV_EXPORT_JOB_PENDING=0,
+  DIV_EXPORT_JOB_RUNNING,
+  DIV_EXPORT_JOB_DONE,
+  DIV_EXPORT_JOB_FAILED
+};
+
+struct DivAudioExportJobProgress {
+  String name;
+  DivAudioExportJobStates state;
+  float amount;
+};
+
+struct DivAudioExportSong {
+  String name;
+  unsigned char* data;
+  size_t len;
+  DivAudioExportSong(String n, unsigned char* d, size_t l):
+    name(n),
+    data(d),
+    len(l) {}
+};
+
+class DivAudioExportBatch;
+
+struct DivAudioExportJob {
+  DivAudioExportBatch* parent;
+  int song, subSong;
+  String path;
+  DivAudioExportOptions options;
+
+  // only valid while the job is running (guarded by the batch's jobLock)
+  DivEngine* worker;
+  // expected length in seconds (all files)
+  double length;
+  double songLength;
+  std::atomic<int> state;
+  String error;
+
+  DivAudioExportJob(DivAudioExportBatch* p, int so, int sub, String pa, const DivAudioExportOptions& o):
+    parent(p),
+    song(so),
+    subSong(sub),
+    path(pa),
+    options(o),
+    worker(NULL),
+    length(0.0),
+    songLength(0.0),
+    state(DIV_EXPORT_JOB_PENDING) {}
+};
+
+/**
+ * exports several (song, sub-song, options) jobs at once.
+ * each job runs on its own headless engine instance, so the engine that created the batch
+ * keeps playing, and jobs are spread over a bounded number of threads.
+ */
+class DivAudioExportBatch {
+  DivConfig conf;
+  std::vector<DivAudioExportSong> songs;
+  std::vector<DivAudioExportJob*> jobs;
+  std::mutex jobLock;
+  std::thread* thread;
+  std::atomic<bool> stopExport;
+  std::atomic<int> jobsDone;
+  int maxThreads;
+
+  void run();
+  public:
+    void runJob(DivAudioExportJob* job);
+
+    /**
+     * add a song from a file.
+     * @return the song index, or -1 if the file could not be read.
+     */
+    int addSong(const String& path);
+
+    /**
+     * add a song from memory (e.g. from saveFur()). the data is copied.
+     * @return the song index.
+     */
+    int addSong(const String& name, const unsigned char* data, size_t len);
+
+    /**
+     * add a job. do not call after go().
+     * @param song the song index returned by addSong().
+     * @param subSong the sub-song to export.
+     * @param path the output path.
+     */
+    void addJob(int song, int subSong, const String& path, const DivAudioExportOptions& options);
+
+    /**
+     * start exporting in the background.
+     */
+    bool go();
+
+    /**
+     * wait for all jobs to finish.
+     */
+    void wait();
+
+    /**
+     * stop jobs which haven't started yet, and halt running ones.
+     */
+    void abort();
+
+    bool isRunning();
+    bool hasFailed();
+    int getJobCount();
+    int getJobsDone();
+
+    /**
+     * get the progress of a job.
+     */
+    DivAudioExportJobProgress getProgress(int index);
+
+    /**
+     * @param eng the engine to take the configuration (e.g. emulation cores) from.
+     * @param threads the maximum number of jobs to run at once, or 0 for as many as there are CPU cores.
+     */
+    DivAudioExportBatch(DivEngine* eng, int threads=0);
+    ~DivAudioExportBatch();
+};
+
+#endif
@@ -18,9 +18,12 @@
  */
 
 #include "engine.h"
+#include <mutex>
 
 DivROMExportDef* DivEngine::romExportDefs[DIV_ROM_MAX];
 
+static std::once_flag romExportDefsOnce;
+
 const DivROMExportDef* DivEngine::getROMExportDef(DivROMExportOptions opt) {
   return romExportDefs[opt];
 }
@@ -71,6 +74,10 @@ bool DivEngine::isROMExportViable(DivROMExportOptions opt)
 }
 
 void DivEngine::registerROMExports() {
+  std::call_once(romExportDefsOnce,initROMExportDefs);
+}
+
+void DivEngine::initROMExportDefs() {
   logD("registering ROM exports...");
 
   romExportDefs[DIV_ROM_AMIGA_VALIDATION]=new DivROMExportDef(
@@ -19,6 +19,72 @@
 
 #include "fileOpsCommon.h"
 
+void DivSampleDecodeQueue::runJob(void* job) {
+  Job* j=(Job*)job;
+  if (j->parent->cancelled.load(std::memory_order_acquire)) return;
+  j->func();
+}
+
+void DivSampleDecodeQueue::add(std::function<void()> job, unsigned int cost) {
+  jobs.push_back(Job(this,job,cost));
+}
+
+void DivSampleDecodeQueue::run() {
+  int threads=(int)std::thread::hardware_concurrency()-1;
+  if (threads>(int)jobs.size()-1) threads=jobs.size()-1;
+  if (threads<0) threads=0;
+  logV("decoding %d samples (%d threads)",(int)jobs.size(),threads+1);
+  DivWorkPool pool(threads);
+  for (size_t i=0; i<jobs.size(); i+=DIV_WORK_POOL_MAX_TASKS) {
+    if (cancelled.load(std::memory_order_acquire)) break;
+    for (size_t j=i; j<jobs.size() && j<i+DIV_WORK_POOL_MAX_TASKS; j++) {
+      pool.push(runJob,&jobs[j],jobs[j].cost);
+    }
+    pool.wait();
+  }
+}
+
+void DivSampleDecodeQueue::start() {
+  if (thread!=NULL) return;
+  if (jobs.empty()) return;
+  cancelled=false;
+  try {
+    thread=new std::thread(&DivSampleDecodeQueue::run,this);
+  } catch (std::system_error& e) {
+    logW("could not start sample decode thread! %s",e.what());
+    thread=NULL;
+    run();
+    jobs.clear();
+  }
+}
+
+void DivSampleDecodeQueue::finish() {
+  if (thread!=NULL) {
+    thread->join();
+    delete thread;
+    thread=NULL;
+  } else if (!jobs.empty()) {
+    // never started
+    cancelled=false;
+    run();
+  }
+  jobs.clear();
+}
+
+void DivSampleDecodeQueue::cancel() {
+  cancelled=true;
+  if (thread!=NULL) {
+    thread->join();
+    delete thread;
+    thread=NULL;
+  }
+  jobs.clear();
+}
+
+DivSampleDecodeQueue::~DivSampleDecodeQueue() {
+  cancel();
+}
+
 bool DivEngine::load(unsigned char* f, size_t slen, const char* nameHint) {
   unsigned char* file;
   size_t len;
@@ -29,7 +95,7 @@ bool DivEngine::load(unsigned char* f, size_t slen, const char* nameHint) {
     return false;
   }
 
-  if (!systemsRegistered) registerSystems();
+  registerSystems();
 
   // step 0: get extension of file
   String extS;
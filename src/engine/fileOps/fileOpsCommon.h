@@ -20,8 +20,11 @@
 #include "../dataErrors.h"
 #include "../engine.h"
 #include "../../ta-log.h"
+#include "../workPool.h"
 #include <zlib.h>
 #include <fmt/printf.h>
+#include <functional>
+#include <atomic>
 
 #define DIV_READ_SIZE 131072
 
@@ -40,6 +43,58 @@ struct InflateBlock {
   }
 };
 
+/**
+ * runs sample decoding jobs on a work pool in the background, so that samples can be decoded
+ * while the rest of the module (patterns and so on) is read.
+ * each job must only touch its own sample, and the file buffer must stay alive until finish().
+ */
+class DivSampleDecodeQueue {
+  struct Job {
+    DivSampleDecodeQueue* parent;
+    std::function<void()> func;
+    unsigned int cost;
+    Job(DivSampleDecodeQueue* p, std::function<void()> f, unsigned int c):
+      parent(p),
+      func(f),
+      cost(c) {}
+  };
+  std::vector<Job> jobs;
+  std::thread* thread;
+  // set by cancel(). jobs which haven't started yet are skipped.
+  std::atomic<bool> cancelled;
+
+  static void runJob(void* job);
+  void run();
+  public:
+    /**
+     * add a job. do not call after start().
+     * @param job the job.
+     * @param cost an estimate of the job's cost (e.g. sample length).
+     */
+    void add(std::function<void()> job, unsigned int cost);
+
+    /**
+     * start running the jobs in the background.
+     */
+    void start();
+
+    /**
+     * wait for all jobs to finish (running them now if start() was not called).
+     */
+    void finish();
+
+    /**
+     * drop all jobs. jobs which haven't started yet are skipped, and those which are running are waited for.
+     * call this before freeing the file buffer on error.
+     */
+    void cancel();
+
+    DivSampleDecodeQueue():
+      thread(NULL),
+      cancelled(false) {}
+    ~DivSampleDecodeQueue();
+};
+
 struct NotZlibException {
   int what;
   NotZlibException(int w):
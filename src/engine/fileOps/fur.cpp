@@ -2490,6 +2490,34 @@ SafeWriter* DivEngine::saveFur(bool notPrimary) {
     song.version=DIV_ENGINE_VERSION;
   }
 
+  // serialize a snapshot of the song, so that editing and playback don't have to wait for us
+  DivSong* snapshot=song.makeSnapshot(false);
+  std::vector<DivSample*> liveSamples=song.sample;
+  saveLock.unlock();
+
+  // sample data can be large, so it is copied one sample at a time to keep each lock short
+  bool samplesChanged=false;
+  for (size_t i=0; i<liveSamples.size(); i++) {
+    saveLock.lock();
+    if (song.sample.size()!=liveSamples.size() || song.sample[i]!=liveSamples[i]) {
+      samplesChanged=true;
+      saveLock.unlock();
+      break;
+    }
+    song.sample[i]->copyOn(snapshot->sample[i]);
+    saveLock.unlock();
+  }
+  if (samplesChanged) {
+    // a sample was added or removed in the meantime. start over with the lock held throughout.
+    logD("samples changed while saving. taking the snapshot again.");
+    snapshot->unload();
+    delete snapshot;
+    saveLock.lock();
+    snapshot=song.makeSnapshot(true);
+    saveLock.unlock();
+  }
+  DivSong& ds=*snapshot;
+
   SafeWriter* w=new SafeWriter;
   w->init();
   /// HEADER
@@ -2513,9 +2541,9 @@ SafeWriter* DivEngine::saveFur(bool notPrimary) {
   // low short is pattern number
   std::vector<PatToWrite> patsToWrite;
   if (getConfInt("saveUnusedPatterns",0)==1) {
-    for (int i=0; i<song.chans; i++) {
-      for (size_t j=0; j<song.subsong.size(); j++) {
-        DivSubSong* subs=song.subsong[j];
+    for (int i=0; i<ds.chans; i++) {
+      for (size_t j=0; j<ds.subsong.size(); j++) {
+        DivSubSong* subs=ds.subsong[j];
         for (int k=0; k<DIV_MAX_PATTERNS; k++) {
           if (subs->pat[i].data[k]==NULL) continue;
           patsToWrite.push_back(PatToWrite(j,i,k));
@@ -2524,9 +2552,9 @@ SafeWriter* DivEngine::saveFur(bool notPrimary) {
     }
   } else {
     bool alreadyAdded[DIV_MAX_PATTERNS];
-    for (int i=0; i<song.chans; i++) {
-      for (size_t j=0; j<song.subsong.size(); j++) {
-        DivSubSong* subs=song.subsong[j];
+    for (int i=0; i<ds.chans; i++) {
+      for (size_t j=0; j<ds.subsong.size(); j++) {
+        DivSubSong* subs=ds.subsong[j];
         memset(alreadyAdded,0,DIV_MAX_PATTERNS*sizeof(bool));
         for (int k=0; k<subs->ordersLen; k++) {
           if (alreadyAdded[subs->orders.ord[i][k]]) continue;
@@ -2543,53 +2571,53 @@ SafeWriter* DivEngine::saveFur(bool notPrimary) {
   w->writeI(0);
 
   // song information
-  w->writeString(song.name,false);
-  w->writeString(song.author,false);
-  w->writeString(song.systemName,false);
-  w->writeString(song.category,false);
-  w->writeString(song.nameJ,false);
-  w->writeString(song.authorJ,false);
-  w->writeString(song.systemNameJ,false);
-  w->writeString(song.categoryJ,false);
-  w->writeF(song.tuning);
-  w->writeC(song.autoSystem);
+  w->writeString(ds.name,false);
+  w->writeString(ds.author,false);
+  w->writeString(ds.systemName,false);
+  w->writeString(ds.category,false);
+  w->writeString(ds.nameJ,false);
+  w->writeString(ds.authorJ,false);
+  w->writeString(ds.systemNameJ,false);
+  w->writeString(ds.categoryJ,false);
+  w->writeF(ds.tuning);
+  w->writeC(ds.autoSystem);
 
   // system definition
-  w->writeF(song.masterVol);
-  w->writeS(song.chans);
-  w->writeS(song.systemLen);
-
-  for (int i=0; i<song.systemLen; i++) {
-    w->writeS(systemToFileFur(song.system[i]));
-    w->writeS(song.systemChans[i]);
-    w->writeF(song.systemVol[i]);
-    w->writeF(song.systemPan[i]);
-    w->writeF(song.systemPanFR[i]);
+  w->writeF(ds.masterVol);
+  w->writeS(ds.chans);
+  w->writeS(ds.systemLen);
+
+  for (int i=0; i<ds.systemLen; i++) {
+    w->writeS(systemToFileFur(ds.system[i]));
+    w->writeS(ds.systemChans[i]);
+    w->writeF(ds.systemVol[i]);
+    w->writeF(ds.systemPan[i]);
+    w->writeF(ds.systemPanFR[i]);
   }
 
   // patchbay
-  w->writeI(song.patchbay.size());
-  for (unsigned int i: song.patchbay) {
+  w->writeI(ds.patchbay.size());
+  for (unsigned int i: ds.patchbay) {
     w->writeI(i);
   }
-  w->writeC(song.patchbayAuto);
+  w->writeC(ds.patchbayAuto);
 
   /// song elements
   // sub-songs
-  if (!song.subsong.empty()) {
+  if (!ds.subsong.empty()) {
     w->writeC(0x01);
-    w->writeI(song.subsong.size());
+    w->writeI(ds.subsong.size());
     sng2PtrSeek=w->tell();
-    for (size_t i=0; i<song.subsong.size(); i++) {
+    for (size_t i=0; i<ds.subsong.size(); i++) {
       w->writeI(0);
     }
   }
   // chip flags
   if (true) {
     w->writeC(0x02);
-    w->writeI(song.systemLen);
+    w->writeI(ds.systemLen);
     flagPtrSeek=w->tell();
-    for (int i=0; i<song.systemLen; i++) {
+    for (int i=0; i<ds.systemLen; i++) {
       w->writeI(0);
     }
   }
@@ -2603,29 +2631,29 @@ SafeWriter* DivEngine::saveFur(bool notPrimary) {
     w->writeI(0);
   }
   // instruments
-  if (!song.ins.empty()) {
+  if (!ds.ins.empty()) {
     w->writeC(0x04);
-    w->writeI(song.ins.size());
+    w->writeI(ds.ins.size());
     ins2PtrSeek=w->tell();
-    for (size_t i=0; i<song.ins.size(); i++) {
+    for (size_t i=0; i<ds.ins.size(); i++) {
       w->writeI(0);
     }
   }
   // wavetables
-  if (!song.wave.empty()) {
+  if (!ds.wave.empty()) {
     w->writeC(0x05);
-    w->writeI(song.wave.size());
+    w->writeI(ds.wave.size());
     wavePtrSeek=w->tell();
-    for (size_t i=0; i<song.wave.size(); i++) {
+    for (size_t i=0; i<ds.wave.size(); i++) {
       w->writeI(0);
     }
   }
   // samples
-  if (!song.sample.empty()) {
+  if (!ds.sample.empty()) {
     w->writeC(0x06);
-    w->writeI(song.sample.size());
+    w->writeI(ds.sample.size());
     smp2PtrSeek=w->tell();
-    for (size_t i=0; i<song.sample.size(); i++) {
+    for (size_t i=0; i<ds.sample.size(); i++) {
       w->writeI(0);
     }
   }
@@ -2639,25 +2667,25 @@ SafeWriter* DivEngine::saveFur(bool notPrimary) {
     }
   }
   // compat flags
-  if (!song.compatFlags.areDefaults()) {
+  if (!ds.compatFlags.areDefaults()) {
     w->writeC(0x08);
     w->writeI(1);
     cflgPtrSeek=w->tell();
     w->writeI(0);
   }
   // song comments
-  if (!song.notes.empty()) {
+  if (!ds.notes.empty()) {
     w->writeC(0x09);
     w->writeI(1);
     cmntPtrSeek=w->tell();
     w->writeI(0);
   }
   // groove patterns
-  if (!song.grooves.empty()) {
+  if (!ds.grooves.empty()) {
     w->writeC(0x0a);
-    w->writeI(song.grooves.size());
+    w->writeI(ds.grooves.size());
     grovPtrSeek=w->tell();
-    for (size_t i=0; i<song.grooves.size(); i++) {
+    for (size_t i=0; i<ds.grooves.size(); i++) {
       w->writeI(0);
     }
   }
@@ -2670,16 +2698,16 @@ SafeWriter* DivEngine::saveFur(bool notPrimary) {
   w->seek(0,SEEK_END);
 
   /// SUBSONGS
-  subSongPtr.reserve(song.subsong.size());
-  for (size_t i=0; i<song.subsong.size(); i++) {
+  subSongPtr.reserve(ds.subsong.size());
+  for (size_t i=0; i<ds.subsong.size(); i++) {
     subSongPtr.push_back(w->tell());
-    song.subsong[i]->putData(w,song.chans);
+    ds.subsong[i]->putData(w,ds.chans);
   }
 
   /// CHIP FLAGS
-  sysFlagsPtr.reserve(song.systemLen);
-  for (int i=0; i<song.systemLen; i++) {
-    String data=song.systemFlags[i].toString();
+  sysFlagsPtr.reserve(ds.systemLen);
+  for (int i=0; i<ds.systemLen; i++) {
+    String data=ds.systemFlags[i].toString();
     if (data.empty()) {
       sysFlagsPtr.push_back(0);
       continue;
@@ -2699,19 +2727,19 @@ SafeWriter* DivEngine::saveFur(bool notPrimary) {
   }
 
   /// COMPAT FLAGS
-  if (!song.compatFlags.areDefaults()) {
+  if (!ds.compatFlags.areDefaults()) {
     compatFlagPtr=w->tell();
-    song.compatFlags.putData(w);
+    ds.compatFlags.putData(w);
   }
 
   /// SONG COMMENTS
-  if (!song.notes.empty()) {
+  if (!ds.notes.empty()) {
     commentPtr=w->tell();
     w->write("CMNT",4);
     blockStartSeek=w->tell();
     w->writeI(0);
 
-    w->writeString(song.notes,false);
+    w->writeString(ds.notes,false);
 
     blockEndSeek=w->tell();
     w->seek(blockStartSeek,SEEK_SET);
@@ -2721,38 +2749,38 @@ SafeWriter* DivEngine::saveFur(bool notPrimary) {
 
   /// ASSET DIRECTORIES
   assetDirPtr[0]=w->tell();
-  putAssetDirData(w,song.insDir);
+  putAssetDirData(w,ds.insDir);
   assetDirPtr[1]=w->tell();
-  putAssetDirData(w,song.waveDir);
+  putAssetDirData(w,ds.waveDir);
   assetDirPtr[2]=w->tell();
-  putAssetDirData(w,song.sampleDir);
+  putAssetDirData(w,ds.sampleDir);
 
   /// GROOVES
-  for (DivGroovePattern& i: song.grooves) {
+  for (DivGroovePattern& i: ds.grooves) {
     groovePtr.push_back(w->tell());
     i.putData(w);
   }
 
   /// INSTRUMENT
-  insPtr.reserve(song.insLen);
-  for (int i=0; i<song.insLen; i++) {
-    DivInstrument* ins=song.ins[i];
+  insPtr.reserve(ds.insLen);
+  for (int i=0; i<ds.insLen; i++) {
+    DivInstrument* ins=ds.ins[i];
     insPtr.push_back(w->tell());
     ins->putInsData2(w,false);
   }
 
   /// WAVETABLE
-  wavePtr.reserve(song.waveLen);
-  for (int i=0; i<song.waveLen; i++) {
-    DivWavetable* wave=song.wave[i];
+  wavePtr.reserve(ds.waveLen);
+  for (int i=0; i<ds.waveLen; i++) {
+    DivWavetable* wave=ds.wave[i];
     wavePtr.push_back(w->tell());
     wave->putWaveData(w);
   }
 
   /// SAMPLE
-  samplePtr.reserve(song.sampleLen);
-  for (int i=0; i<song.sampleLen; i++) {
-    DivSample* sample=song.sample[i];
+  samplePtr.reserve(ds.sampleLen);
+  for (int i=0; i<ds.sampleLen; i++) {
+    DivSample* sample=ds.sample[i];
     samplePtr.push_back(w->tell());
     sample->putSampleData(w);
   }
@@ -2760,7 +2788,7 @@ SafeWriter* DivEngine::saveFur(bool notPrimary) {
   /// PATTERN
   patPtr.reserve(patsToWrite.size());
   for (PatToWrite& i: patsToWrite) {
-    DivPattern* pat=song.subsong[i.subsong]->pat[i.chan].getPattern(i.pat,false);
+    DivPattern* pat=ds.subsong[i.subsong]->pat[i.chan].getPattern(i.pat,false);
     patPtr.push_back(w->tell());
 
     w->write("PATN",4);
@@ -2774,7 +2802,7 @@ SafeWriter* DivEngine::saveFur(bool notPrimary) {
 
     unsigned char emptyRows=0;
 
-    for (int j=0; j<song.subsong[i.subsong]->patLen; j++) {
+    for (int j=0; j<ds.subsong[i.subsong]->patLen; j++) {
       unsigned char mask=0;
       unsigned char finalNote=255;
       unsigned short effectMask=0;
@@ -2796,7 +2824,7 @@ SafeWriter* DivEngine::saveFur(bool notPrimary) {
       if (finalNote!=255) mask|=1; // note
       if (pat->newData[j][DIV_PAT_INS]!=-1) mask|=2; // instrument
       if (pat->newData[j][DIV_PAT_VOL]!=-1) mask|=4; // volume
-      for (int k=0; k<song.subsong[i.subsong]->pat[i.chan].effectCols*2; k+=2) {
+      for (int k=0; k<ds.subsong[i.subsong]->pat[i.chan].effectCols*2; k+=2) {
         if (k==0) {
           if (pat->newData[j][DIV_PAT_FX(0)+k]!=-1) mask|=8;
           if (pat->newData[j][DIV_PAT_FXVAL(0)+k]!=-1) mask|=16;
@@ -2877,14 +2905,14 @@ SafeWriter* DivEngine::saveFur(bool notPrimary) {
   // sub-songs
   if (sng2PtrSeek) {
     w->seek(sng2PtrSeek,SEEK_SET);
-    for (size_t i=0; i<song.subsong.size(); i++) {
+    for (size_t i=0; i<ds.subsong.size(); i++) {
       w->writeI(subSongPtr[i]);
     }
   }
   // chip flags
   if (flagPtrSeek) {
     w->seek(flagPtrSeek,SEEK_SET);
-    for (int i=0; i<song.systemLen; i++) {
+    for (int i=0; i<ds.systemLen; i++) {
       w->writeI(sysFlagsPtr[i]);
     }
   }
@@ -2941,7 +2969,8 @@ SafeWriter* DivEngine::saveFur(bool notPrimary) {
     }
   }
 
-  saveLock.unlock();
+  snapshot->unload();
+  delete snapshot;
   return w;
 }
 
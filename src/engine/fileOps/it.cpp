@@ -204,6 +204,7 @@ bool DivEngine::loadIT(unsigned char* file, size_t len) {
   memset(doesPanbrello,0,64*sizeof(bool));
   
   SafeReader reader=SafeReader(file,len);
+  DivSampleDecodeQueue decodeQueue;
   warnings="";
 
   memset(chanPan,0,64);
@@ -738,117 +739,124 @@ bool DivEngine::loadIT(unsigned char* file, size_t len) {
 
       logV("reading sample data (%d)",s->samples);
 
-      if (flags&8) { // compressed sample
-        unsigned int ret=0;
-        logV("decompression begin... (%d)",s->samples);
-        if (flags&4) {
-          logW("STEREO!");
-          if (s->depth==DIV_SAMPLE_DEPTH_16BIT) {
-            logV("16-bit");
-            short* outData=new short[s->samples*2];
-            ret=it_decompress16(outData,s->samples,&file[reader.tell()],len-reader.tell(),(convert&4)?1:0,(flags&4)?2:1);
-            for (unsigned int i=0; i<s->samples; i++) {
-              s->data16[i]=(outData[i<<1]+outData[1+(i<<1)])>>1;
+      // decode the sample in the background while the rest of the module is read
+      size_t dataPos=reader.tell();
+      decodeQueue.add([=]() mutable {
+        SafeReader reader=SafeReader(file,len);
+        reader.seek(dataPos,SEEK_SET);
+
+        if (flags&8) { // compressed sample
+          unsigned int ret=0;
+          logV("decompression begin... (%d)",s->samples);
+          if (flags&4) {
+            logW("STEREO!");
+            if (s->depth==DIV_SAMPLE_DEPTH_16BIT) {
+              logV("16-bit");
+              short* outData=new short[s->samples*2];
+              ret=it_decompress16(outData,s->samples,&file[reader.tell()],len-reader.tell(),(convert&4)?1:0,(flags&4)?2:1);
+              for (unsigned int i=0; i<s->samples; i++) {
+                s->data16[i]=(outData[i<<1]+outData[1+(i<<1)])>>1;
+              }
+              delete[] outData;
+            } else {
+              logV("8-bit");
+              signed char* outData=new signed char[s->samples*2];
+              ret=it_decompress8(outData,s->samples,&file[reader.tell()],len-reader.tell(),(convert&4)?1:0,(flags&4)?2:1);
+              for (unsigned int i=0; i<s->samples; i++) {
+                s->data8[i]=(outData[i<<1]+outData[1+(i<<1)])>>1;
+              }
+              delete[] outData;
             }
-            delete[] outData;
           } else {
-            logV("8-bit");
-            signed char* outData=new signed char[s->samples*2];
-            ret=it_decompress8(outData,s->samples,&file[reader.tell()],len-reader.tell(),(convert&4)?1:0,(flags&4)?2:1);
-            for (unsigned int i=0; i<s->samples; i++) {
-              s->data8[i]=(outData[i<<1]+outData[1+(i<<1)])>>1;
+            if (s->depth==DIV_SAMPLE_DEPTH_16BIT) {
+              logV("16-bit");
+              ret=it_decompress16(s->data16,s->samples,&file[reader.tell()],len-reader.tell(),(convert&4)?1:0,(flags&4)?2:1);
+            } else {
+              logV("8-bit");
+              ret=it_decompress8(s->data8,s->samples,&file[reader.tell()],len-reader.tell(),(convert&4)?1:0,(flags&4)?2:1);
             }
-            delete[] outData;
           }
+          logV("got: %d",ret);
         } else {
-          if (s->depth==DIV_SAMPLE_DEPTH_16BIT) {
-            logV("16-bit");
-            ret=it_decompress16(s->data16,s->samples,&file[reader.tell()],len-reader.tell(),(convert&4)?1:0,(flags&4)?2:1);
-          } else {
-            logV("8-bit");
-            ret=it_decompress8(s->data8,s->samples,&file[reader.tell()],len-reader.tell(),(convert&4)?1:0,(flags&4)?2:1);
-          }
-        }
-        logV("got: %d",ret);
-      } else {
-        try {
-          if (s->depth==DIV_SAMPLE_DEPTH_16BIT) {
-            if (flags&4) { // downmix stereo
-              for (unsigned int i=0; i<s->samples; i++) {
-                short l;
-                if (convert&2) {
-                  l=reader.readS_BE();
-                } else {
-                  l=reader.readS();
-                }
-                if (!(convert&1)) {
-                  l^=0x8000;
+          try {
+            if (s->depth==DIV_SAMPLE_DEPTH_16BIT) {
+              if (flags&4) { // downmix stereo
+                for (unsigned int i=0; i<s->samples; i++) {
+                  short l;
+                  if (convert&2) {
+                    l=reader.readS_BE();
+                  } else {
+                    l=reader.readS();
+                  }
+                  if (!(convert&1)) {
+                    l^=0x8000;
+                  }
+                  s->data16[i]=l;
                 }
-                s->data16[i]=l;
-              }
-              for (unsigned int i=0; i<s->samples; i++) {
-                short r;
-                if (convert&2) {
-                  r=reader.readS_BE();
-                } else {
-                  r=reader.readS();
+                for (unsigned int i=0; i<s->samples; i++) {
+                  short r;
+                  if (convert&2) {
+                    r=reader.readS_BE();
+                  } else {
+                    r=reader.readS();
+                  }
+                  if (!(convert&1)) {
+                    r^=0x8000;
+                  }
+                  s->data16[i]=(s->data16[i]+r)>>1;
                 }
-                if (!(convert&1)) {
-                  r^=0x8000;
+              } else {
+                for (unsigned int i=0; i<s->samples; i++) {
+                  if (convert&2) {
+                    s->data16[i]=reader.readS_BE()^((convert&1)?0:0x8000);
+                  } else {
+                    s->data16[i]=reader.readS()^((convert&1)?0:0x8000);
+                  }
                 }
-                s->data16[i]=(s->data16[i]+r)>>1;
               }
             } else {
-              for (unsigned int i=0; i<s->samples; i++) {
-                if (convert&2) {
-                  s->data16[i]=reader.readS_BE()^((convert&1)?0:0x8000);
-                } else {
-                  s->data16[i]=reader.readS()^((convert&1)?0:0x8000);
+              if (flags&4) { // downmix stereo
+                for (unsigned int i=0; i<s->samples; i++) {
+                  signed char l=reader.readC();
+                  if (!(convert&1)) {
+                    l^=0x80;
+                  }
+                  s->data8[i]=l;
                 }
-              }
-            }
-          } else {
-            if (flags&4) { // downmix stereo
-              for (unsigned int i=0; i<s->samples; i++) {
-                signed char l=reader.readC();
-                if (!(convert&1)) {
-                  l^=0x80;
+                for (unsigned int i=0; i<s->samples; i++) {
+                  signed char r=reader.readC();
+                  if (!(convert&1)) {
+                    r^=0x80;
+                  }
+                  s->data8[i]=(s->data8[i]+r)>>1;
                 }
-                s->data8[i]=l;
-              }
-              for (unsigned int i=0; i<s->samples; i++) {
-                signed char r=reader.readC();
-                if (!(convert&1)) {
-                  r^=0x80;
+              } else {
+                for (unsigned int i=0; i<s->samples; i++) {
+                  s->data8[i]=reader.readC()^((convert&1)?0:0x80);
                 }
-                s->data8[i]=(s->data8[i]+r)>>1;
-              }
-            } else {
-              for (unsigned int i=0; i<s->samples; i++) {
-                s->data8[i]=reader.readC()^((convert&1)?0:0x80);
               }
             }
+          } catch (EndOfFileException& e) {
+            logW("premature end of file...");
           }
-        } catch (EndOfFileException& e) {
-          logW("premature end of file...");
         }
-      }
 
-      // scale sample if necessary
-      if (s->samples>0) {
-        if (sampleVol>64) sampleVol=64;
-        if (sampleVol<64) {
-          // convert to 16-bit
-          if (s->depth==DIV_SAMPLE_DEPTH_8BIT) {
-            s->convert(DIV_SAMPLE_DEPTH_16BIT,0);
-          }
+        // scale sample if necessary
+        if (s->samples>0) {
+          if (sampleVol>64) sampleVol=64;
+          if (sampleVol<64) {
+            // convert to 16-bit
+            if (s->depth==DIV_SAMPLE_DEPTH_8BIT) {
+              s->convert(DIV_SAMPLE_DEPTH_16BIT,0);
+            }
 
-          // then scale
-          for (unsigned int i=0; i<s->samples; i++) {
-            s->data16[i]=(s->data16[i]*sampleVol)>>6;
+            // then scale
+            for (unsigned int i=0; i<s->samples; i++) {
+              s->data16[i]=(s->data16[i]*sampleVol)>>6;
+            }
           }
         }
-      }
+      },s->samples);
 
       // does the song not use instruments?
       // create instrument then
@@ -863,6 +871,8 @@ bool DivEngine::loadIT(unsigned char* file, size_t len) {
       ds.sample.push_back(s);
     }
 
+    decodeQueue.start();
+
     // scan pattern data for effect use
     int maxChan=0;
     for (int i=0; i<patCount; i++) {
@@ -887,6 +897,7 @@ bool DivEngine::loadIT(unsigned char* file, size_t len) {
       if (!reader.seek(patPtr[i],SEEK_SET)) {
         logE("premature end of file!");
         lastError="incomplete file";
+        decodeQueue.cancel();
         delete[] file;
         return false;
       }
@@ -899,6 +910,7 @@ bool DivEngine::loadIT(unsigned char* file, size_t len) {
       if (patRows>DIV_MAX_ROWS) {
         logE("too many rows! %d",patRows);
         lastError="too many rows";
+        decodeQueue.cancel();
         delete[] file;
         return false;
       }
@@ -1106,6 +1118,7 @@ bool DivEngine::loadIT(unsigned char* file, size_t len) {
       if (!reader.seek(patPtr[i],SEEK_SET)) {
         logE("premature end of file!");
         lastError="incomplete file";
+        decodeQueue.cancel();
         delete[] file;
         return false;
       }
@@ -1118,6 +1131,7 @@ bool DivEngine::loadIT(unsigned char* file, size_t len) {
       if (patRows>DIV_MAX_ROWS) {
         logE("too many rows! %d",patRows);
         lastError="too many rows";
+        decodeQueue.cancel();
         delete[] file;
         return false;
       }
@@ -1700,6 +1714,9 @@ bool DivEngine::loadIT(unsigned char* file, size_t len) {
       }
     }
 
+    // wait for samples
+    decodeQueue.finish();
+
     if (active) quitDispatch();
     BUSY_BEGIN_SOFT;
     saveLock.lock();
@@ -1720,9 +1737,12 @@ bool DivEngine::loadIT(unsigned char* file, size_t len) {
   } catch (EndOfFileException& e) {
     //logE("premature end of file!");
     lastError="incomplete file";
+    // samples may still be decoding
+    decodeQueue.cancel();
   } catch (InvalidHeaderException& e) {
     //logE("invalid header!");
     lastError="invalid header!";
+    decodeQueue.cancel();
   }
   return success;
 }
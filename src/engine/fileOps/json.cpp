@@ -19,6 +19,7 @@
 
 #include "fileOpsCommon.h"
 #include "nlohmann/json.hpp"
+#include <functional>
 
 using JSON = nlohmann::json;
 
@@ -29,9 +30,164 @@ JSON serializeWavetable(DivWavetable* wave);
 JSON serializeSample(DivSample* sample);
 JSON serializeCompatFlags(DivCompatFlags* flags);
 
+// writes JSON to a SafeWriter piece by piece, so that the whole document doesn't have to be in memory.
+// the output is the same as JSON::dump(), which means object keys must be written in sorted order.
+class DivJSONStream {
+  SafeWriter* w;
+  bool pretty;
+  // whether the object/array at each depth has no members yet
+  std::vector<bool> isEmpty;
+
+  void newLine() {
+    if (!pretty) return;
+    w->writeText("\n");
+    w->writeText(String(isEmpty.size()*2,' '));
+  }
+  void next() {
+    if (!isEmpty.back()) w->writeC(',');
+    isEmpty.back()=false;
+    newLine();
+  }
+  public:
+    void begin(char c) {
+      w->writeC(c);
+      isEmpty.push_back(true);
+    }
+    void end(char c) {
+      bool wasEmpty=isEmpty.back();
+      isEmpty.pop_back();
+      if (!wasEmpty) newLine();
+      w->writeC(c);
+    }
+    void key(const String& k) {
+      next();
+      w->writeText(JSON(k).dump());
+      w->writeText(pretty?": ":":");
+    }
+    void value(const JSON& j) {
+      if (!pretty) {
+        w->writeText(j.dump());
+        return;
+      }
+      // indent nested lines to the current depth
+      String dump=j.dump(2);
+      String indent="\n"+String(isEmpty.size()*2,' ');
+      size_t pos=0;
+      while (true) {
+        size_t nl=dump.find('\n',pos);
+        if (nl==String::npos) break;
+        w->write(dump.c_str()+pos,nl-pos);
+        w->writeText(indent);
+        pos=nl+1;
+      }
+      w->write(dump.c_str()+pos,dump.size()-pos);
+    }
+    void element(const JSON& j) {
+      next();
+      value(j);
+    }
+    // start an array element which is then written with begin() or object()
+    void element() {
+      next();
+    }
+    // write an object, streaming the members in `streamed` (which must not be in obj) at their sorted position
+    void object(const JSON& obj, const std::map<String,std::function<void()>>& streamed) {
+      begin('{');
+      auto s=streamed.cbegin();
+      for (auto& i: obj.items()) {
+        for (; s!=streamed.cend() && s->first<i.key(); s++) {
+          key(s->first);
+          s->second();
+        }
+        key(i.key());
+        value(i.value());
+      }
+      for (; s!=streamed.cend(); s++) {
+        key(s->first);
+        s->second();
+      }
+      end('}');
+    }
+    DivJSONStream(SafeWriter* writer, bool p):
+      w(writer),
+      pretty(p) {}
+};
+
+// fill in everything about a sub-song but the patterns
+static void serializeSubSong(JSON& subsong, DivSubSong* s, DivJSONExportOptions* options, int ordBegin, int ordEnd, int chanBegin, int chanEnd, bool ranged) {
+  subsong["name"]=s->name;
+  subsong["tickRate"]=s->hz;
+  subsong["speeds"]={};
+  for (int j=0; j<s->speeds.len; j++)
+    subsong["speeds"].push_back(s->speeds.val[j]);
+  subsong["virtualTempo"]={s->virtualTempoN,s->virtualTempoD};
+  subsong["patternLength"]=s->patLen;
+  subsong["orderLength"]=s->ordersLen;
+  subsong["highlights"]={s->hilightA,s->hilightB};
+  if (ranged) {
+    subsong["exportedOrders"]={ordBegin,ordEnd};
+    subsong["exportedChannels"]={chanBegin,chanEnd};
+  }
+
+  if (options->exportOrders) subsong["orders"]={};
+  subsong["channelData"]={};
+  for (int j=chanBegin; j<=chanEnd; j++) {
+    if (options->exportOrders) {
+      JSON order;
+      for (int k=ordBegin; k<=ordEnd; k++) {
+        order.push_back(s->orders.ord[j][k]);
+      }
+      subsong["orders"].push_back(order);
+    }
+
+    JSON chanData;
+    chanData["effectColumns"]=s->pat[j].effectCols;
+    chanData["show"]["pattern"]=s->chanShow[j];
+    chanData["show"]["chanOsc"]=s->chanShowChanOsc[j];
+    chanData["collapse"]=s->chanCollapse[j];
+    chanData["name"]=s->chanName[j];
+    chanData["shortName"]=s->chanShortName[j];
+    unsigned int color=s->chanColor[j];
+    if (color) {
+      chanData["color"]["r"]=(color)&255;
+      chanData["color"]["g"]=(color>>8)&255;
+      chanData["color"]["b"]=(color>>16)&255;
+      chanData["color"]["a"]=(color>>24)&255;
+    }
+    subsong["channelData"].push_back(chanData);
+  }
+  subsong["notes"]=s->notes;
+}
+
+// serialize a pattern of a channel, or null if it isn't used in the exported range
+static JSON serializeChannelPattern(DivSubSong* s, int chan, int index, DivJSONExportOptions* options, int ordBegin, int ordEnd, bool ranged) {
+  if (ranged) {
+    bool used=false;
+    for (int k=ordBegin; k<=ordEnd; k++) {
+      if (s->orders.ord[chan][k]==index) {
+        used=true;
+        break;
+      }
+    }
+    if (!used) return {};
+  }
+  return serializePattern(s->pat[chan].getPattern(index,false),s->patLen,s->pat[chan].effectCols,options->optimizePatterns);
+}
+
 SafeWriter* DivEngine::saveJSON(DivJSONExportOptions* options) {
+  SafeWriter* w=new SafeWriter;
+  w->init();
+  saveJSON(w,options);
+  if (w->tell()==0) {
+    lastError="empty file";
+  }
+  return w;
+}
+
+bool DivEngine::saveJSON(SafeWriter* w, DivJSONExportOptions* options) {
   saveLock.lock();
 
+  // everything but instruments, wavetables, samples and sub-songs
   JSON json;
 
   if (options->exportMetadata) {
@@ -83,81 +239,6 @@ SafeWriter* DivEngine::saveJSON(DivJSONExportOptions* options) {
     }
   }
 
-  json["subsongs"]={};
-
-  if (options->exportInstruments) {
-    json["instruments"]={};
-    for (int j=0; j<song.insLen; j++) {
-      json["instruments"].push_back(serializeInstrument(getIns(j)));
-    }
-  }
-  if (options->exportWaves) {
-    json["wavetables"]={};
-    for (int j=0; j<song.waveLen; j++) {
-      json["wavetables"].push_back(serializeWavetable(getWave(j)));
-    }
-  }
-  if (options->exportSamples) {
-    json["samples"]={};
-    for (int j=0; j<song.sampleLen; j++) {
-      json["samples"].push_back(serializeSample(getSample(j)));
-    }
-  }
-
-  for (size_t i=0; i<song.subsong.size(); i++) {
-    JSON subsong;
-    DivSubSong* s=song.subsong[i];
-    subsong["name"]=s->name;
-    subsong["tickRate"]=s->hz;
-    subsong["speeds"]={};
-    for (int j=0; j<s->speeds.len; j++)
-      subsong["speeds"].push_back(s->speeds.val[j]);
-    subsong["virtualTempo"]={s->virtualTempoN,s->virtualTempoD};
-    subsong["patternLength"]=s->patLen;
-    subsong["orderLength"]=s->ordersLen;
-    subsong["highlights"]={s->hilightA,s->hilightB};
-
-    if (options->exportOrders) subsong["orders"]={};
-    if (options->exportPatterns) subsong["patterns"]={};
-    subsong["channelData"]={};
-    for (int j=0; j<song.chans; j++) {
-      if (options->exportOrders || options->exportPatterns) {
-        JSON order;
-        JSON patterns;
-        if (options->exportOrders) for (int k=0; k<s->ordersLen; k++) {
-           order.push_back(s->orders.ord[j][k]);
-        }
-        if (options->exportPatterns) for (int k=0; k<DIV_MAX_PATTERNS; k++) {
-          patterns.push_back(serializePattern(s->pat[j].getPattern(k,false),s->patLen,s->pat[j].effectCols,options->optimizePatterns));
-        }
-        if (options->exportOrders) subsong["orders"].push_back(order);
-        if (options->exportPatterns) {
-          subsong["patterns"].push_back(patterns);
-          subsong["patternLength"]=s->patLen;
-        }
-      }
-
-      JSON chanData;
-      chanData["effectColumns"]=s->pat[j].effectCols;
-      chanData["show"]["pattern"]=s->chanShow[j];
-      chanData["show"]["chanOsc"]=s->chanShowChanOsc[j];
-      chanData["collapse"]=s->chanCollapse[j];
-      chanData["name"]=s->chanName[j];
-      chanData["shortName"]=s->chanShortName[j];
-      unsigned int color=s->chanColor[j];
-      if (color) {
-        chanData["color"]["r"]=(color)&255;
-        chanData["color"]["g"]=(color>>8)&255;
-        chanData["color"]["b"]=(color>>16)&255;
-        chanData["color"]["a"]=(color>>24)&255;
-      }
-      subsong["channelData"].push_back(chanData);
-    }
-    subsong["notes"]=s->notes;
-
-    json["subsongs"].push_back(subsong);
-  }
-
   json["assetDirs"]={};
   JSON dir;
   if (!song.insDir.empty()) for (DivAssetDir& i:song.insDir) {
@@ -187,36 +268,117 @@ SafeWriter* DivEngine::saveJSON(DivJSONExportOptions* options) {
 
   if (options->exportCompatFlags) json["compatFlags"]=serializeCompatFlags(&song.compatFlags);
 
-  SafeWriter* w=new SafeWriter;
-  w->init();
-  switch (options->format) {
-    case DivJSONExportOptions::EXPORT_BSON: {
+  // export range
+  int chanBegin=MAX(0,MIN(options->chanBegin,song.chans-1));
+  int chanEnd=(options->chanEnd<0)?(song.chans-1):MIN(options->chanEnd,song.chans-1);
+
+  if (options->format==DivJSONExportOptions::EXPORT_JSON) {
+    // stream the large parts
+    DivJSONStream out(w,options->jsonPretty);
+    std::map<String,std::function<void()>> streamed;
+
+    if (options->exportInstruments) streamed["instruments"]=[&]() {
+      out.begin('[');
+      for (int j=0; j<song.insLen; j++) {
+        out.element(serializeInstrument(getIns(j)));
+      }
+      out.end(']');
+    };
+    if (options->exportWaves) streamed["wavetables"]=[&]() {
+      out.begin('[');
+      for (int j=0; j<song.waveLen; j++) {
+        out.element(serializeWavetable(getWave(j)));
+      }
+      out.end(']');
+    };
+    if (options->exportSamples) streamed["samples"]=[&]() {
+      out.begin('[');
+      for (int j=0; j<song.sampleLen; j++) {
+        out.element(serializeSample(getSample(j)));
+      }
+      out.end(']');
+    };
+    streamed["subsongs"]=[&]() {
+      out.begin('[');
+      for (DivSubSong* s: song.subsong) {
+        int ordBegin=MAX(0,MIN(options->orderBegin,s->ordersLen-1));
+        int ordEnd=(options->orderEnd<0)?(s->ordersLen-1):MIN(options->orderEnd,s->ordersLen-1);
+        bool ranged=(ordBegin>0 || ordEnd<s->ordersLen-1 || chanBegin>0 || chanEnd<song.chans-1);
+        JSON subsong;
+        serializeSubSong(subsong,s,options,ordBegin,ordEnd,chanBegin,chanEnd,ranged);
+
+        std::map<String,std::function<void()>> subStreamed;
+        if (options->exportPatterns) subStreamed["patterns"]=[&]() {
+          out.begin('[');
+          for (int j=chanBegin; j<=chanEnd; j++) {
+            out.element();
+            out.begin('[');
+            for (int k=0; k<DIV_MAX_PATTERNS; k++) {
+              out.element(serializeChannelPattern(s,j,k,options,ordBegin,ordEnd,ranged));
+            }
+            out.end(']');
+          }
+          out.end(']');
+        };
+        out.element();
+        out.object(subsong,subStreamed);
+      }
+      out.end(']');
+    };
+
+    out.object(json,streamed);
+  } else {
+    // BSON and CBOR need the whole document
+    if (options->exportInstruments) {
+      json["instruments"]={};
+      for (int j=0; j<song.insLen; j++) {
+        json["instruments"].push_back(serializeInstrument(getIns(j)));
+      }
+    }
+    if (options->exportWaves) {
+      json["wavetables"]={};
+      for (int j=0; j<song.waveLen; j++) {
+        json["wavetables"].push_back(serializeWavetable(getWave(j)));
+      }
+    }
+    if (options->exportSamples) {
+      json["samples"]={};
+      for (int j=0; j<song.sampleLen; j++) {
+        json["samples"].push_back(serializeSample(getSample(j)));
+      }
+    }
+
+    json["subsongs"]={};
+    for (DivSubSong* s: song.subsong) {
+      int ordBegin=MAX(0,MIN(options->orderBegin,s->ordersLen-1));
+      int ordEnd=(options->orderEnd<0)?(s->ordersLen-1):MIN(options->orderEnd,s->ordersLen-1);
+      bool ranged=(ordBegin>0 || ordEnd<s->ordersLen-1 || chanBegin>0 || chanEnd<song.chans-1);
+      JSON subsong;
+      serializeSubSong(subsong,s,options,ordBegin,ordEnd,chanBegin,chanEnd,ranged);
+      if (options->exportPatterns) {
+        subsong["patterns"]={};
+        for (int j=chanBegin; j<=chanEnd; j++) {
+          JSON patterns;
+          for (int k=0; k<DIV_MAX_PATTERNS; k++) {
+            patterns.push_back(serializeChannelPattern(s,j,k,options,ordBegin,ordEnd,ranged));
+          }
+          subsong["patterns"].push_back(patterns);
+        }
+      }
+      json["subsongs"].push_back(subsong);
+    }
+
+    if (options->format==DivJSONExportOptions::EXPORT_BSON) {
       std::vector<uint8_t> bsonDump=JSON::to_bson(json);
       w->write(bsonDump.data(),bsonDump.size());
-      break;
-    }
-    case DivJSONExportOptions::EXPORT_CBOR: {
+    } else {
       std::vector<uint8_t> cborDump=JSON::to_cbor(json);
       w->write(cborDump.data(),cborDump.size());
-      break;
-    }
-    case DivJSONExportOptions::EXPORT_JSON:
-    default: {
-      String dump;
-      if (options->jsonPretty) {
-        dump=json.dump(2);
-      } else {
-        dump=json.dump();
-      }
-      w->writeText(dump);
-      break;
     }
   }
-  if (w->tell()==0) {
-    lastError="empty file";
-  }
+
   saveLock.unlock();
-  return w;
+  return !w->hasFailed();
 }
 
 JSON serializePattern(DivPattern* pat, int rows, int effectCols, bool optimize) {
@@ -79,10 +79,20 @@ void writeTextMacro(SafeWriter* w, DivInstrumentMacro& m, const char* name, bool
 }
 
 SafeWriter* DivEngine::saveText(bool separatePatterns) {
-  saveLock.lock();
+  DivTextExportOptions options;
+  options.separatePatterns=separatePatterns;
 
   SafeWriter* w=new SafeWriter;
   w->init();
+  saveText(w,options);
+  return w;
+}
+
+bool DivEngine::saveText(SafeWriter* w, const DivTextExportOptions& options) {
+  saveLock.lock();
+
+  int chanBegin=MAX(0,MIN(options.chanBegin,song.chans-1));
+  int chanEnd=(options.chanEnd<0)?(song.chans-1):MIN(options.chanEnd,song.chans-1);
 
   w->writeText(fmt::sprintf("# Furnace Text Export\n\ngenerated by Furnace %s (%d)\n\n# Song Information\n\n",DIV_VERSION,DIV_ENGINE_VERSION));
   w->writeText(fmt::sprintf("- name: %s\n",song.name));
@@ -297,27 +307,33 @@ SafeWriter* DivEngine::saveText(bool separatePatterns) {
     w->writeText("\n");
     w->writeText(fmt::sprintf("- virtual tempo: %d/%d\n",s->virtualTempoN,s->virtualTempoD));
     w->writeText(fmt::sprintf("- pattern length: %d\n",s->patLen));
+
+    int ordBegin=MAX(0,MIN(options.orderBegin,s->ordersLen-1));
+    int ordEnd=(options.orderEnd<0)?(s->ordersLen-1):MIN(options.orderEnd,s->ordersLen-1);
+    if (ordBegin>0 || ordEnd<s->ordersLen-1 || chanBegin>0 || chanEnd<song.chans-1) {
+      w->writeText(fmt::sprintf("- exported range: orders %.2X-%.2X, channels %d-%d\n",ordBegin,ordEnd,chanBegin+1,chanEnd+1));
+    }
     w->writeText(fmt::sprintf("\norders:\n```\n"));
 
-    for (int j=0; j<s->ordersLen; j++) {
+    for (int j=ordBegin; j<=ordEnd; j++) {
       w->writeText(fmt::sprintf("%.2X |",j));
-      for (int k=0; k<song.chans; k++) {
+      for (int k=chanBegin; k<=chanEnd; k++) {
         w->writeText(fmt::sprintf(" %.2X",s->orders.ord[k][j]));
       }
       w->writeText("\n");
     }
     w->writeText("```\n\n## Patterns\n\n");
 
-    if (separatePatterns) {
+    if (options.separatePatterns) {
       w->writeText("TODO: separate patterns\n\n");
     } else {
-      for (int j=0; j<s->ordersLen; j++) {
+      for (int j=ordBegin; j<=ordEnd; j++) {
         w->writeText(fmt::sprintf("----- ORDER %.2X\n",j));
 
         for (int k=0; k<s->patLen; k++) {
           w->writeText(fmt::sprintf("%.2X ",k));
 
-          for (int l=0; l<song.chans; l++) {
+          for (int l=chanBegin; l<=chanEnd; l++) {
             DivPattern* p=s->pat[l].getPattern(s->orders.ord[l][j],false);
             short note, octave;
             noteToSplitNote(p->newData[k][DIV_PAT_NOTE],note,octave);
@@ -375,5 +391,5 @@ SafeWriter* DivEngine::saveText(bool separatePatterns) {
   }
 
   saveLock.unlock();
-  return w;
+  return !w->hasFailed();
 }
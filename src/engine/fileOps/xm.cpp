@@ -187,6 +187,7 @@ bool DivEngine::loadXM(unsigned char* file, size_t len) {
   bool doesPanbrello[128];
 
   SafeReader reader=SafeReader(file,len);
+  DivSampleDecodeQueue decodeQueue;
   warnings="";
 
   memset(sampleVol,0,256*256);
@@ -711,20 +712,31 @@ bool DivEngine::loadXM(unsigned char* file, size_t len) {
         for (int j=0; j<sampleCount; j++) {
           DivSample* s=toAdd[j];
 
+          // skip the sample data now and decode it in the background
+          size_t dataPos=reader.tell();
+          size_t dataLen=(s->depth==DIV_SAMPLE_DEPTH_16BIT)?(s->samples*2):s->samples;
+          if (!reader.seek(dataLen,SEEK_CUR)) {
+            throw EndOfFileException(&reader,reader.size());
+          }
+
           // load sample data
-          if (s->depth==DIV_SAMPLE_DEPTH_16BIT) {
-            short next=0;
-            for (unsigned int i=0; i<s->samples; i++) {
-              next+=reader.readS();
-              s->data16[i]=next;
-            }
-          } else {
-            signed char next=0;
-            for (unsigned int i=0; i<s->samples; i++) {
-              next+=reader.readC();
-              s->data8[i]=next;
+          decodeQueue.add([=]() {
+            SafeReader reader=SafeReader(file,len);
+            reader.seek(dataPos,SEEK_SET);
+            if (s->depth==DIV_SAMPLE_DEPTH_16BIT) {
+              short next=0;
+              for (unsigned int i=0; i<s->samples; i++) {
+                next+=reader.readS();
+                s->data16[i]=next;
+              }
+            } else {
+              signed char next=0;
+              for (unsigned int i=0; i<s->samples; i++) {
+                next+=reader.readC();
+                s->data8[i]=next;
+              }
             }
-          }
+          },s->samples);
         }
 
         for (DivSample* i: toAdd) {
@@ -752,6 +764,8 @@ bool DivEngine::loadXM(unsigned char* file, size_t len) {
       return false;
     }
 
+    decodeQueue.start();
+
     // read patterns
     logD("reading patterns...");
     for (unsigned short i=0; i<patCount; i++) {
@@ -829,6 +843,7 @@ bool DivEngine::loadXM(unsigned char* file, size_t len) {
       if (packType!=0) {
         logE("unknown packing type %d!",packType);
         lastError="unknown packing type";
+        decodeQueue.cancel();
         ds.unload();
         delete[] file;
         XM_FINISH;
@@ -843,6 +858,7 @@ bool DivEngine::loadXM(unsigned char* file, size_t len) {
       if (totalRows>256) {
         logE("too many rows! %d",totalRows);
         lastError="too many rows";
+        decodeQueue.cancel();
         delete[] file;
         XM_FINISH;
         return false;
@@ -857,6 +873,7 @@ bool DivEngine::loadXM(unsigned char* file, size_t len) {
       if (!reader.seek(headerSeek,SEEK_SET)) {
         logE("premature end of file!");
         lastError="incomplete file";
+        decodeQueue.cancel();
         delete[] file;
         XM_FINISH;
         return false;
@@ -1357,12 +1374,16 @@ bool DivEngine::loadXM(unsigned char* file, size_t len) {
       if (!reader.seek(packedSeek,SEEK_SET)) {
         logE("premature end of file!");
         lastError="incomplete file";
+        decodeQueue.cancel();
         delete[] file;
         XM_FINISH;
         return false;
       }
     }
 
+    // wait for samples
+    decodeQueue.finish();
+
     ds.sampleLen=ds.sample.size();
     if (ds.sampleLen>32768) {
       logE("too many samples!");
@@ -1397,9 +1418,12 @@ bool DivEngine::loadXM(unsigned char* file, size_t len) {
   } catch (EndOfFileException& e) {
     //logE("premature end of file!");
     lastError="incomplete file";
+    // samples may still be decoding
+    decodeQueue.cancel();
   } catch (InvalidHeaderException& e) {
     //logE("invalid header!");
     lastError="invalid header!";
+    decodeQueue.cancel();
   }
   XM_FINISH;
   return success;
@@ -1122,6 +1122,7 @@ int DivInstrument::undo() {
   undoHist.pop_back();
   // logI("DivInstrument::undo (%u off, %u size)", step->podPatch.offset, step->podPatch.size);
   step->applyAndReverse(this);
+  invalidateView();
 
   // make room
   if (redoHist.size()>=redoHist.capacity()) {
@@ -1141,6 +1142,7 @@ int DivInstrument::redo() {
   redoHist.pop_back();
   // logI("DivInstrument::redo (%u off, %u size)", step->podPatch.offset, step->podPatch.size);
   step->applyAndReverse(this);
+  invalidateView();
 
   // make room
   if (undoHist.size()>=undoHist.capacity()) {
@@ -4624,7 +4626,8 @@ DivInstrument::~DivInstrument() {
   }
 }
 
-DivInstrument::DivInstrument( const DivInstrument& ins ) {
+DivInstrument::DivInstrument( const DivInstrument& ins ):
+  viewGen(1) {
   // undo/redo history is specifically not copied
   *(DivInstrumentPOD*)this=ins;
   name=ins.name;
@@ -4634,5 +4637,74 @@ DivInstrument& DivInstrument::operator=( const DivInstrument& ins ) {
   // undo/redo history is specifically not copied
   *(DivInstrumentPOD*)this=ins;
   name=ins.name;
+  invalidateView();
   return *this;
 }
+
+#define VIEW_MACRO(m,t) \
+  if ((m).len>0) { \
+    view.macros[view.macroCount].offset=(unsigned int)((unsigned char*)&(m)-(unsigned char*)&std); \
+    view.macros[view.macroCount].type=(t); \
+    DivMacroStruct::compile(m,view.macros[view.macroCount++]); \
+  }
+
+DivInstrumentView& DivInstrument::getView() {
+  // if the view gets invalidated during the rebuild, the generation won't
+  // match afterwards and it will be rebuilt again on the next call.
+  unsigned int gen=viewGen.load(std::memory_order_acquire);
+  if (view.gen==gen) return view;
+  view.macroCount=0;
+
+  // the order matters! DivMacroInt runs macros in this order.
+  VIEW_MACRO(std.volMacro,DIV_MACRO_VOL);
+  VIEW_MACRO(std.arpMacro,DIV_MACRO_ARP);
+  VIEW_MACRO(std.dutyMacro,DIV_MACRO_DUTY);
+  VIEW_MACRO(std.waveMacro,DIV_MACRO_WAVE);
+  VIEW_MACRO(std.pitchMacro,DIV_MACRO_PITCH);
+  VIEW_MACRO(std.ex1Macro,DIV_MACRO_EX1);
+  VIEW_MACRO(std.ex2Macro,DIV_MACRO_EX2);
+  VIEW_MACRO(std.ex3Macro,DIV_MACRO_EX3);
+  VIEW_MACRO(std.algMacro,DIV_MACRO_ALG);
+  VIEW_MACRO(std.fbMacro,DIV_MACRO_FB);
+  VIEW_MACRO(std.fmsMacro,DIV_MACRO_FMS);
+  VIEW_MACRO(std.amsMacro,DIV_MACRO_AMS);
+  VIEW_MACRO(std.panLMacro,DIV_MACRO_PAN_LEFT);
+  VIEW_MACRO(std.panRMacro,DIV_MACRO_PAN_RIGHT);
+  VIEW_MACRO(std.phaseResetMacro,DIV_MACRO_PHASE_RESET);
+  VIEW_MACRO(std.ex4Macro,DIV_MACRO_EX4);
+  VIEW_MACRO(std.ex5Macro,DIV_MACRO_EX5);
+  VIEW_MACRO(std.ex6Macro,DIV_MACRO_EX6);
+  VIEW_MACRO(std.ex7Macro,DIV_MACRO_EX7);
+  VIEW_MACRO(std.ex8Macro,DIV_MACRO_EX8);
+  VIEW_MACRO(std.ex9Macro,DIV_MACRO_EX9);
+  VIEW_MACRO(std.ex10Macro,DIV_MACRO_EX10);
+
+  for (int i=0; i<4; i++) {
+    DivInstrumentSTD::OpMacro& m=std.opMacros[i];
+    VIEW_MACRO(m.amMacro,DIV_MACRO_OP_AM+(i<<5));
+    VIEW_MACRO(m.arMacro,DIV_MACRO_OP_AR+(i<<5));
+    VIEW_MACRO(m.drMacro,DIV_MACRO_OP_DR+(i<<5));
+    VIEW_MACRO(m.multMacro,DIV_MACRO_OP_MULT+(i<<5));
+    VIEW_MACRO(m.rrMacro,DIV_MACRO_OP_RR+(i<<5));
+    VIEW_MACRO(m.slMacro,DIV_MACRO_OP_SL+(i<<5));
+    VIEW_MACRO(m.tlMacro,DIV_MACRO_OP_TL+(i<<5));
+    VIEW_MACRO(m.dt2Macro,DIV_MACRO_OP_DT2+(i<<5));
+    VIEW_MACRO(m.rsMacro,DIV_MACRO_OP_RS+(i<<5));
+    VIEW_MACRO(m.dtMacro,DIV_MACRO_OP_DT+(i<<5));
+    VIEW_MACRO(m.d2rMacro,DIV_MACRO_OP_D2R+(i<<5));
+    VIEW_MACRO(m.ssgMacro,DIV_MACRO_OP_SSG+(i<<5));
+    VIEW_MACRO(m.damMacro,DIV_MACRO_OP_DAM+(i<<5));
+    VIEW_MACRO(m.dvbMacro,DIV_MACRO_OP_DVB+(i<<5));
+    VIEW_MACRO(m.egtMacro,DIV_MACRO_OP_EGT+(i<<5));
+    VIEW_MACRO(m.kslMacro,DIV_MACRO_OP_KSL+(i<<5));
+    VIEW_MACRO(m.susMacro,DIV_MACRO_OP_SUS+(i<<5));
+    VIEW_MACRO(m.vibMacro,DIV_MACRO_OP_VIB+(i<<5));
+    VIEW_MACRO(m.wsMacro,DIV_MACRO_OP_WS+(i<<5));
+    VIEW_MACRO(m.ksrMacro,DIV_MACRO_OP_KSR+(i<<5));
+  }
+
+  view.gen=gen;
+  return view;
+}
+
+#undef VIEW_MACRO
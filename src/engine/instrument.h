@@ -26,6 +26,7 @@
 #include "../pch.h"
 #include "../fixedQueue.h"
 #include <initializer_list>
+#include <atomic>
 
 struct DivSong;
 struct DivInstrument;
@@ -1144,13 +1145,65 @@ struct DivInstrumentUndoStep {
   bool makeUndoPatch(size_t processTime_, const DivInstrument* pre, const DivInstrument* post);
 };
 
+// 22 common macros plus 20 per operator
+#define DIV_INS_VIEW_MAX_MACROS (22+4*20)
+
+// compact view of an instrument, used when starting a note.
+// each DivInstrumentMacro takes over 1KB, so checking the length of every macro in the
+// instrument on each note touches a lot of memory. this lists the non-empty ones instead,
+// along with the macro parameters needed to start them (compiled by DivMacroStruct::compile()).
+// it is rebuilt on demand after the instrument changes (see DivInstrument::getView()).
+struct DivInstrumentView {
+  struct Macro {
+    // offset of the macro within DivInstrumentSTD
+    unsigned int offset;
+    // macro type (as passed to DivMacroInt::structByType())
+    unsigned char type;
+    // kind of macro (0: sequence, 1: ADSR, 2: LFO)
+    unsigned char kind;
+    bool activeRelease, lfoDir, hasRelease;
+    unsigned int mode;
+    // starting position (ADSR/LFO only)
+    int initPos;
+  };
+  unsigned char macroCount;
+  // the DivInstrument::viewGen this was built from (0 if never built)
+  unsigned int gen;
+  Macro macros[DIV_INS_VIEW_MAX_MACROS];
+
+  DivInstrumentView():
+    macroCount(0),
+    gen(0) {}
+};
+
 struct DivInstrument: DivInstrumentPOD {
   String name;
 
   DivInstrumentTemp temp;
 
+  // not copied along with the instrument.
+  DivInstrumentView view;
+  // bumped on every invalidateView(). the GUI may invalidate the view while the
+  // engine is rebuilding it, so a plain flag could be overwritten by the rebuild.
+  std::atomic<unsigned int> viewGen;
+
+  /**
+   * get the compact view of this instrument, rebuilding it if necessary.
+   * only call from the engine thread.
+   */
+  DivInstrumentView& getView();
+
+  /**
+   * mark the compact view as outdated. call this after altering macros.
+   * may be called from any thread.
+   */
+  void invalidateView() {
+    viewGen.fetch_add(1,std::memory_order_acq_rel);
+  }
+
   DivInstrument():
-    name("") {
+    name(""),
+    viewGen(1) {
       // clear and construct DivInstrumentPOD so it doesn't have any garbage in the padding
       memset((unsigned char*)(DivInstrumentPOD*)this,0,sizeof(DivInstrumentPOD));
       new ((DivInstrumentPOD*)this) DivInstrumentPOD;
@@ -45,39 +45,63 @@
 #define LFO_LOOP source.val[14]
 #define LFO_GLOBAL source.val[15]
 
-void DivMacroStruct::prepare(DivInstrumentMacro& source, DivEngine* e) {
-  has=had=actualHad=will=true;
-  mode=source.mode;
-  type=(source.open>>1)&3;
-  activeRelease=source.open&8;
-  linger=(source.macroType==DIV_MACRO_VOL && e->song.compatFlags.volMacroLinger);
-  lfoDir=false;
-
-  if (type==1) {
-    pos=ADSR_BOTTOM;
+void DivMacroStruct::compile(const DivInstrumentMacro& source, DivInstrumentView::Macro& out) {
+  out.mode=source.mode;
+  out.kind=(source.open>>1)&3;
+  out.activeRelease=source.open&8;
+  out.lfoDir=false;
+  // the state is always reset before prepare(), so a position of 0 means "leave as is"
+  out.initPos=0;
+
+  if (out.kind==1) {
+    out.initPos=ADSR_BOTTOM;
     // if the bottom is higher than the top, set the fractional part to max.
     if (ADSR_LOW>ADSR_HIGH) {
-      pos|=0xff;
+      out.initPos|=0xff;
     }
-  } else if (type==2) {
-    // this will be pre-computed on compilation.
+  } else if (out.kind==2) {
     switch (LFO_WAVE&3) {
       case 0: // triangle
         if (LFO_PHASE&512) {
-          pos=ADSR_TOP+(((ADSR_BOTTOM-ADSR_TOP)*(LFO_PHASE&511))>>9);
+          out.initPos=ADSR_TOP+(((ADSR_BOTTOM-ADSR_TOP)*(LFO_PHASE&511))>>9);
         } else {
-          pos=ADSR_BOTTOM+(((ADSR_TOP-ADSR_BOTTOM)*LFO_PHASE)>>9);
+          out.initPos=ADSR_BOTTOM+(((ADSR_TOP-ADSR_BOTTOM)*LFO_PHASE)>>9);
         }
-        lfoDir=LFO_PHASE&512;
+        out.lfoDir=LFO_PHASE&512;
         break;
       case 1: // saw
-        pos=ADSR_BOTTOM+(((ADSR_TOP-ADSR_BOTTOM)*LFO_PHASE)>>10);
+        out.initPos=ADSR_BOTTOM+(((ADSR_TOP-ADSR_BOTTOM)*LFO_PHASE)>>10);
         break;
       case 2: // pulse
-        pos=LFO_PHASE<<6;
+        out.initPos=LFO_PHASE<<6;
         break;
     }
   }
+
+  // check ADSR mode
+  if ((source.open&6)==2) {
+    out.hasRelease=(ADSR_RR>0);
+  } else {
+    out.hasRelease=(source.rel<source.len);
+  }
+}
+
+void DivMacroStruct::prepare(const DivInstrumentView::Macro& compiled, DivEngine* e) {
+  has=had=actualHad=will=true;
+  mode=compiled.mode;
+  type=compiled.kind;
+  activeRelease=compiled.activeRelease;
+  linger=(compiled.type==DIV_MACRO_VOL && e->song.compatFlags.volMacroLinger);
+  lfoDir=compiled.lfoDir;
+  if (type!=0) pos=compiled.initPos;
+}
+
+void DivMacroStruct::prepare(DivInstrumentMacro& source, DivEngine* e) {
+  DivInstrumentView::Macro compiled;
+  compiled.offset=0;
+  compiled.type=source.macroType;
+  compile(source,compiled);
+  prepare(compiled,e);
 }
 
 void DivMacroStruct::doMacro(DivInstrumentMacro& source, bool released, bool tick) {
@@ -294,18 +318,43 @@ void DivMacroStruct::doMacro(DivInstrumentMacro& source, bool released, bool tic
 void DivMacroInt::next() {
   if (ins==NULL) return;
   // run macros
-  // TODO: potentially get rid of list to avoid allocations
-  subTick--;
-  for (size_t i=0; i<macroListLen; i++) {
-    if (macroList[i]!=NULL && macroSource[i]!=NULL) {
-      macroList[i]->doMacro(*macroSource[i],released,subTick==0);
+  // the dispatch is not ticked on idle sub-ticks, so count how many have passed since the last call.
+  int elapsed=1;
+  if (e!=NULL) {
+    elapsed=(int)(e->subTickClock-lastSubTickClock);
+    lastSubTickClock=e->subTickClock;
+    if (elapsed<1) elapsed=1;
+  }
+  subTick-=elapsed;
+  if (subTick<=0) {
+    for (size_t i=0; i<macroListLen; i++) {
+      macroList[i].state->doMacro(*macroList[i].source,released,true);
+    }
+    subTickIdle=false;
+  } else if (!subTickIdle) {
+    // in low-latency mode most engine ticks are not song ticks.
+    // doMacro() would only clear "had" on those, so do it once and skip the rest.
+    for (size_t i=0; i<macroListLen; i++) {
+      macroList[i].state->had=false;
     }
+    subTickIdle=true;
   }
   if (subTick<=0) {
     if (e==NULL) {
       subTick=1;
     } else {
-      subTick=e->tickMult;
+      subTick+=e->tickMult;
+      if (subTick<=0) subTick=e->tickMult;
+    }
+  }
+  // make sure the dispatch is ticked when the next step is due, so that macros keep their
+  // phase relative to the note rather than waiting for the next song tick.
+  if (e!=NULL) {
+    for (size_t i=0; i<macroListLen; i++) {
+      if (macroList[i].state->has || macroList[i].state->actualHad) {
+        e->wakeDispatchIn(subTick);
+        break;
+      }
     }
   }
 }
@@ -444,6 +493,7 @@ void DivMacroInt::restart(unsigned char id) {
 
   macroState->init();
   macroState->prepare(*macro,e);
+  subTickIdle=false;
 }
 
 #undef CONSIDER_OP
@@ -457,174 +507,35 @@ void DivMacroInt::setEngine(DivEngine* eng) {
   e=eng;
 }
 
-#define ADD_MACRO(m,s) \
-  if (!m.masked) { \
-    macroList[macroListLen]=&m; \
-    macroSource[macroListLen++]=&s; \
-  }
-
 void DivMacroInt::init(DivInstrument* which) {
   ins=which;
   // initialize
   for (size_t i=0; i<macroListLen; i++) {
-    if (macroList[i]!=NULL) macroList[i]->init();
+    macroList[i].state->init();
   }
   macroListLen=0;
   subTick=1;
+  subTickIdle=false;
+  // the first step happens on the next call
+  if (e!=NULL) lastSubTickClock=e->subTickClock-1;
 
   hasRelease=false;
   released=false;
 
   if (ins==NULL) return;
 
-  // prepare common macro
-  if (ins->std.volMacro.len>0) {
-    ADD_MACRO(vol,ins->std.volMacro);
-  }
-  if (ins->std.arpMacro.len>0) {
-    ADD_MACRO(arp,ins->std.arpMacro);
-  }
-  if (ins->std.dutyMacro.len>0) {
-    ADD_MACRO(duty,ins->std.dutyMacro);
-  }
-  if (ins->std.waveMacro.len>0) {
-    ADD_MACRO(wave,ins->std.waveMacro);
-  }
-  if (ins->std.pitchMacro.len>0) {
-    ADD_MACRO(pitch,ins->std.pitchMacro);
-  }
-  if (ins->std.ex1Macro.len>0) {
-    ADD_MACRO(ex1,ins->std.ex1Macro);
-  }
-  if (ins->std.ex2Macro.len>0) {
-    ADD_MACRO(ex2,ins->std.ex2Macro);
-  }
-  if (ins->std.ex3Macro.len>0) {
-    ADD_MACRO(ex3,ins->std.ex3Macro);
-  }
-  if (ins->std.algMacro.len>0) {
-    ADD_MACRO(alg,ins->std.algMacro);
-  }
-  if (ins->std.fbMacro.len>0) {
-    ADD_MACRO(fb,ins->std.fbMacro);
-  }
-  if (ins->std.fmsMacro.len>0) {
-    ADD_MACRO(fms,ins->std.fmsMacro);
-  }
-  if (ins->std.amsMacro.len>0) {
-    ADD_MACRO(ams,ins->std.amsMacro);
-  }
-
-  if (ins->std.panLMacro.len>0) {
-    ADD_MACRO(panL,ins->std.panLMacro);
-  }
-  if (ins->std.panRMacro.len>0) {
-    ADD_MACRO(panR,ins->std.panRMacro);
-  }
-  if (ins->std.phaseResetMacro.len>0) {
-    ADD_MACRO(phaseReset,ins->std.phaseResetMacro);
-  }
-  if (ins->std.ex4Macro.len>0) {
-    ADD_MACRO(ex4,ins->std.ex4Macro);
-  }
-  if (ins->std.ex5Macro.len>0) {
-    ADD_MACRO(ex5,ins->std.ex5Macro);
-  }
-  if (ins->std.ex6Macro.len>0) {
-    ADD_MACRO(ex6,ins->std.ex6Macro);
-  }
-  if (ins->std.ex7Macro.len>0) {
-    ADD_MACRO(ex7,ins->std.ex7Macro);
-  }
-  if (ins->std.ex8Macro.len>0) {
-    ADD_MACRO(ex8,ins->std.ex8Macro);
-  }
-  if (ins->std.ex9Macro.len>0) {
-    ADD_MACRO(ex9,ins->std.ex9Macro);
-  }
-  if (ins->std.ex10Macro.len>0) {
-    ADD_MACRO(ex10,ins->std.ex10Macro);
-  }
-
-  // prepare FM operator macros
-  for (int i=0; i<4; i++) {
-    DivInstrumentSTD::OpMacro& m=ins->std.opMacros[i];
-    IntOp& o=op[i];
-    if (m.amMacro.len>0) {
-      ADD_MACRO(o.am,m.amMacro);
-    }
-    if (m.arMacro.len>0) {
-      ADD_MACRO(o.ar,m.arMacro);
-    }
-    if (m.drMacro.len>0) {
-      ADD_MACRO(o.dr,m.drMacro);
-    }
-    if (m.multMacro.len>0) {
-      ADD_MACRO(o.mult,m.multMacro);
-    }
-    if (m.rrMacro.len>0) {
-      ADD_MACRO(o.rr,m.rrMacro);
-    }
-    if (m.slMacro.len>0) {
-      ADD_MACRO(o.sl,m.slMacro);
-    }
-    if (m.tlMacro.len>0) {
-      ADD_MACRO(o.tl,m.tlMacro);
-    }
-    if (m.dt2Macro.len>0) {
-      ADD_MACRO(o.dt2,m.dt2Macro);
-    }
-    if (m.rsMacro.len>0) {
-      ADD_MACRO(o.rs,m.rsMacro);
-    }
-    if (m.dtMacro.len>0) {
-      ADD_MACRO(o.dt,m.dtMacro);
-    }
-    if (m.d2rMacro.len>0) {
-      ADD_MACRO(o.d2r,m.d2rMacro);
-    }
-    if (m.ssgMacro.len>0) {
-      ADD_MACRO(o.ssg,m.ssgMacro);
-    }
-
-    if (m.damMacro.len>0) {
-      ADD_MACRO(o.dam,m.damMacro);
-    }
-    if (m.dvbMacro.len>0) {
-      ADD_MACRO(o.dvb,m.dvbMacro);
-    }
-    if (m.egtMacro.len>0) {
-      ADD_MACRO(o.egt,m.egtMacro);
-    }
-    if (m.kslMacro.len>0) {
-      ADD_MACRO(o.ksl,m.kslMacro);
-    }
-    if (m.susMacro.len>0) {
-      ADD_MACRO(o.sus,m.susMacro);
-    }
-    if (m.vibMacro.len>0) {
-      ADD_MACRO(o.vib,m.vibMacro);
-    }
-    if (m.wsMacro.len>0) {
-      ADD_MACRO(o.ws,m.wsMacro);
-    }
-    if (m.ksrMacro.len>0) {
-      ADD_MACRO(o.ksr,m.ksrMacro);
-    }
-  }
-
-  for (size_t i=0; i<macroListLen; i++) {
-    if (macroSource[i]!=NULL) {
-      macroList[i]->prepare(*macroSource[i],e);
-      // check ADSR mode
-      if ((macroSource[i]->open&6)==2) {
-        if (macroSource[i]->val[8]>0) {
-          hasRelease=true;
-        }
-      } else if (macroSource[i]->rel<macroSource[i]->len) {
-        hasRelease=true;
-      }
-    }
+  // only look at the macros which are in use, and start them from their compiled
+  // parameters (see DivInstrumentView)
+  DivInstrumentView& view=ins->getView();
+  for (int i=0; i<view.macroCount; i++) {
+    const DivInstrumentView::Macro& compiled=view.macros[i];
+    DivMacroStruct* state=structByType(compiled.type);
+    if (state==NULL) continue;
+    if (state->masked) continue;
+    state->prepare(compiled,e);
+    if (compiled.hasRelease) hasRelease=true;
+    macroList[macroListLen].state=state;
+    macroList[macroListLen++].source=(DivInstrumentMacro*)((unsigned char*)&ins->std+compiled.offset);
   }
 }
 
@@ -84,6 +84,18 @@ struct DivMacroStruct {
     // TODO: test whether this breaks anything?
     val=0;
   }
+  /**
+   * compile the parameters needed to start a macro.
+   * this is done when the instrument view is built (see DivInstrument::getView()).
+   * @param source the source macro.
+   * @param out where to put them. offset and type are left untouched.
+   */
+  static void compile(const DivInstrumentMacro& source, DivInstrumentView::Macro& out);
+  /**
+   * initialize state from a compiled macro.
+   * called on note on.
+   */
+  void prepare(const DivInstrumentView::Macro& compiled, DivEngine* e);
   /**
    * initialize state.
    * called on macro restart.
@@ -109,6 +121,15 @@ struct DivMacroStruct {
     macroType(mType) {}
 };
 
+/**
+ * an entry in the macro run list.
+ * state and source are kept together so that next() walks a single array.
+ */
+struct DivMacroListEntry {
+  DivMacroStruct* state;
+  DivInstrumentMacro* source;
+};
+
 /**
  * this is the macro interpreter. it runs macros.
  * normally there's one per dispatch channel.
@@ -119,15 +140,19 @@ class DivMacroInt {
   // the related instrument.
   DivInstrument* ins;
   // list of macros to run. populated during note on.
-  DivMacroStruct* macroList[128];
-  // sources of macros to run.
-  DivInstrumentMacro* macroSource[128];
+  // only non-empty, unmasked macros are added, so no entry is ever NULL.
+  DivMacroListEntry macroList[128];
   // number of macros to process.
   size_t macroListLen;
   // the current "sub-tick". in low-latency mode, this counts how many engine ticks remain until the next song tick.
   int subTick;
+  // value of DivEngine::subTickClock on the last call to next().
+  unsigned int lastSubTickClock;
   // whether note/macro release occurred.
   bool released;
+  // set after the first sub-tick following a song tick.
+  // at that point all "had" flags are clear and further sub-ticks have nothing to do.
+  bool subTickIdle;
   public:
     // each DivMacroInt defines macro states for all macros.
     // this is done for convenience. not all macros may be running.
@@ -225,7 +250,9 @@ class DivMacroInt {
       ins(NULL),
       macroListLen(0),
       subTick(1),
+      lastSubTickClock(0),
       released(false),
+      subTickIdle(false),
       vol(DIV_MACRO_VOL),
       arp(DIV_MACRO_ARP),
       duty(DIV_MACRO_DUTY),
@@ -249,8 +276,7 @@ class DivMacroInt {
       ex9(DIV_MACRO_EX9),
       ex10(DIV_MACRO_EX10),
       hasRelease(false) {
-      memset(macroList,0,128*sizeof(void*));
-      memset(macroSource,0,128*sizeof(void*));
+      memset(macroList,0,128*sizeof(DivMacroListEntry));
     }
 };
 
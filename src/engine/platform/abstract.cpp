@@ -165,6 +165,10 @@ void DivDispatch::setSkipRegisterWrites(bool value) {
   skipRegisterWrites=value;
 }
 
+void DivDispatch::setInsShadow(bool enable) {
+  insShadow=enable;
+}
+
 void DivDispatch::notifyInsChange(int ins) {
 
 }
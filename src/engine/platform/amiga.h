@@ -21,7 +21,7 @@
 #define _AMIGA_H
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "../waveSynth.h"
 
 class DivPlatformAmiga: public DivDispatch {
@@ -123,13 +123,8 @@ class DivPlatformAmiga: public DivDispatch {
 
   int sep1, sep2;
 
-  struct QueuedWrite {
-    unsigned short addr;
-    unsigned short val;
-    QueuedWrite(): addr(0), val(9) {}
-    QueuedWrite(unsigned short a, unsigned short v): addr(a), val(v) {}
-  };
-  FixedQueue<QueuedWrite,512> writes;
+  typedef DivQueuedWrite<unsigned short,unsigned short> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,512> writes;
 
   friend void putDispatchChip(void*,int);
   friend void putDispatchChan(void*,int,int);
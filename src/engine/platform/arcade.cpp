@@ -51,6 +51,27 @@ const char** DivPlatformArcade::getRegisterSheet() {
   return regCheatSheetOPM;
 }
 
+// run the Nuked-OPM core for a number of slots (4 cycles each) without writing to it.
+void DivPlatformArcade::clockNuked(int slots, int* o) {
+  for (int i=0; i<slots; i++) {
+    OPM_Clock(&fm,NULL,NULL,NULL,NULL);
+    OPM_Clock(&fm,NULL,NULL,NULL,NULL);
+    OPM_Clock(&fm,NULL,NULL,NULL,NULL);
+    OPM_Clock(&fm,o,NULL,NULL,NULL);
+  }
+}
+
+// how many of the remaining slots in this sample can be clocked before the queue has to be checked again.
+inline int DivPlatformArcade::nukedBatchLen(int left) {
+  // delay only goes down once per sample
+  if (delay>0 || writes.empty()) return left;
+  if (fm.write_busy) {
+    // the chip stays busy for at least 31-write_busy_cnt more cycles (see OPM_DoIO())
+    return MIN(left,1+(31-(int)fm.write_busy_cnt)/4);
+  }
+  return 1;
+}
+
 void DivPlatformArcade::acquire_nuked(short** buf, size_t len) {
   thread_local int o[2];
 
@@ -60,27 +81,32 @@ void DivPlatformArcade::acquire_nuked(short** buf, size_t len) {
 
   for (size_t h=0; h<len; h++) {
     if (delay>0) delay--;
-    for (int i=0; i<8; i++) {
-      if (delay<=0 && !writes.empty() && !fm.write_busy) {
-        QueuedWrite& w=writes.front();
-        if (w.addr==0xfffffffe) {
-          delay=w.val*2;
-          writes.pop_front();
-        } else if (w.addrOrVal) {
-          OPM_Write(&fm,1,w.val);
-          regPool[w.addr&0xff]=w.val;
-          //printf("write: %x = %.2x\n",w.addr,w.val);
-          writes.pop_front();
-        } else {
-          OPM_Write(&fm,0,w.addr);
-          w.addrOrVal=true;
+    // nothing can be written during this sample, so clock the chip without looking at the queue
+    bool queueIdle=(writes.idle(delay,1)>0);
+    if (queueIdle) {
+      clockNuked(8,o);
+    } else {
+      for (int i=0; i<8;) {
+        if (delay<=0 && !writes.empty() && !fm.write_busy) {
+          QueuedWrite& w=writes.front();
+          if (w.addr==0xfffffffe) {
+            delay=w.val*2;
+            writes.pop_front();
+          } else if (w.addrOrVal) {
+            OPM_Write(&fm,1,w.val);
+            regPool[w.addr&0xff]=w.val;
+            //printf("write: %x = %.2x\n",w.addr,w.val);
+            writes.pop_front();
+          } else {
+            OPM_Write(&fm,0,w.addr);
+            w.addrOrVal=true;
+          }
         }
-      }
 
-      OPM_Clock(&fm,NULL,NULL,NULL,NULL);
-      OPM_Clock(&fm,NULL,NULL,NULL,NULL);
-      OPM_Clock(&fm,NULL,NULL,NULL,NULL);
-      OPM_Clock(&fm,o,NULL,NULL,NULL);
+        int slots=nukedBatchLen(8-i);
+        clockNuked(slots,o);
+        i+=slots;
+      }
     }
 
     for (int i=0; i<8; i++) {
@@ -546,8 +572,12 @@ void DivPlatformArcade::muteChannel(int ch, bool mute) {
 }
 
 void DivPlatformArcade::commitState(int ch, DivInstrument* ins) {
+  // the registers only have to be rewritten if the parameters differ from the ones already loaded
+  bool reload=chan[ch].insChanged;
   if (chan[ch].insChanged) {
+    if (insShadow && chan[ch].stateLoaded && chan[ch].state==ins->fm) reload=false;
     chan[ch].state=ins->fm;
+    chan[ch].stateLoaded=true;
     chan[ch].opMask=
       (chan[ch].state.op[0].enable?1:0)|
       (chan[ch].state.op[2].enable?2:0)|
@@ -561,15 +591,16 @@ void DivPlatformArcade::commitState(int ch, DivInstrument* ins) {
     if (!op.enable) {
       rWrite(baseAddr+ADDR_TL,127|(op.ksr?128:0));
     } else if (KVS(ch,i)) {
+      // this also depends on the volume, so it is written regardless of reload
       if (!chan[ch].active || chan[ch].insChanged) {
         rWrite(baseAddr+ADDR_TL,(127-VOL_SCALE_LOG_BROKEN(127-op.tl,chan[ch].outVol&0x7f,127))|(op.ksr?128:0));
       }
     } else {
-      if (chan[ch].insChanged) {
+      if (reload) {
         rWrite(baseAddr+ADDR_TL,op.tl|(op.ksr?128:0));
       }
     }
-    if (chan[ch].insChanged) {
+    if (reload) {
       rWrite(baseAddr+ADDR_MULT_DT,(op.mult&15)|(dtTable[op.dt&7]<<4));
       rWrite(baseAddr+ADDR_RS_AR,(op.ar&31)|(op.rs<<6));
       rWrite(baseAddr+ADDR_AM_DR,(op.dr&31)|(op.am<<7));
@@ -577,7 +608,7 @@ void DivPlatformArcade::commitState(int ch, DivInstrument* ins) {
       rWrite(baseAddr+ADDR_SL_RR,(op.rr&15)|(op.sl<<4));
     }
   }
-  if (chan[ch].insChanged) {
+  if (reload) {
     if (isMuted[ch]) {
       rWrite(chanOffs[ch]+ADDR_LR_FB_ALG,(chan[ch].state.alg&7)|(chan[ch].state.fb<<3));
     } else {
@@ -998,6 +1029,7 @@ int DivPlatformArcade::dispatch(DivCommand c) {
 
 void DivPlatformArcade::forceIns() {
   for (int i=0; i<8; i++) {
+    chan[i].stateLoaded=false;
     for (int j=0; j<4; j++) {
       unsigned short baseAddr=chanOffs[i]|opOffs[j];
       DivInstrumentFM::Operator op=chan[i].state.op[j];
@@ -71,6 +71,8 @@ class DivPlatformArcade: public DivPlatformOPM {
     int toFreq(int freq);
     void commitState(int ch, DivInstrument* ins);
 
+    void clockNuked(int slots, int* o);
+    inline int nukedBatchLen(int left);
     void acquire_nuked(short** buf, size_t len);
     void acquire_ymfm(short** buf, size_t len);
     void acquire_lle(short** buf, size_t len);
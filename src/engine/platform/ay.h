@@ -20,7 +20,7 @@
 #ifndef _AY_H
 #define _AY_H
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "sound/ay8910.h"
 extern "C" {
 #include "sound/atomicssg/ssg.h"
@@ -107,14 +107,8 @@ class DivPlatformAY8910: public DivDispatch {
     };
     Channel chan[3];
     bool isMuted[3];
-    struct QueuedWrite {
-      unsigned short addr;
-      unsigned char val;
-      bool addrOrVal;
-      QueuedWrite(): addr(0), val(0), addrOrVal(false) {}
-      QueuedWrite(unsigned short a, unsigned char v): addr(a), val(v), addrOrVal(false) {}
-    };
-    FixedQueue<QueuedWrite,128> writes;
+    typedef DivQueuedWrite<unsigned short,unsigned char> QueuedWrite;
+    DivRegWriteQueue<QueuedWrite,128> writes;
     ay8910_device* ay;
     DivDispatchOscBuffer* oscBuf[3];
     DivPitchTable pitchTable;
@@ -20,7 +20,7 @@
 #ifndef _AY8930_H
 #define _AY8930_H
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "sound/ay8910.h"
 
 class DivPlatformAY8930: public DivDispatch {
@@ -95,14 +95,8 @@ class DivPlatformAY8930: public DivDispatch {
     };
     Channel chan[3];
     bool isMuted[3];
-    struct QueuedWrite {
-      unsigned short addr;
-      unsigned char val;
-      bool addrOrVal;
-      QueuedWrite(): addr(0), val(0), addrOrVal(false) {}
-      QueuedWrite(unsigned short a, unsigned char v): addr(a), val(v), addrOrVal(false) {}
-    };
-    FixedQueue<QueuedWrite,128> writes;
+    typedef DivQueuedWrite<unsigned short,unsigned char> QueuedWrite;
+    DivRegWriteQueue<QueuedWrite,128> writes;
     ay8930_device* ay;
     DivDispatchOscBuffer* oscBuf[3];
     DivPitchTable pitchTable;
@@ -22,7 +22,7 @@
 
 #include "../dispatch.h"
 #include "sound/c140_c219.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 
 class DivPlatformC140: public DivDispatch {
   struct Channel: public SharedChannel {
@@ -65,14 +65,8 @@ class DivPlatformC140: public DivDispatch {
 
   unsigned char* sampleMem;
   size_t sampleMemLen;
-  struct QueuedWrite {
-    unsigned short addr;
-    unsigned char val;
-    bool addrOrVal;
-    QueuedWrite(): addr(0), val(0), addrOrVal(false) {}
-    QueuedWrite(unsigned short a, unsigned char v): addr(a), val(v), addrOrVal(false) {}
-  };
-  FixedQueue<QueuedWrite,2048> writes;
+  typedef DivQueuedWrite<unsigned short,unsigned char> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,2048> writes;
   struct c140_t c140;
   struct c219_t c219;
   DivMemoryComposition memCompo;
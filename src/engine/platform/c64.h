@@ -21,7 +21,7 @@
 #define _C64_H
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "sound/c64/sid.h"
 #include "sound/c64_fp/SID.h"
 #include "sound/c64_d/dsid.h"
@@ -76,13 +76,8 @@ class DivPlatformC64: public DivDispatch {
   float fakeLow[4];
   float fakeBand[4];
   float fakeCutTable[2048];
-  struct QueuedWrite {
-      unsigned char addr;
-      unsigned char val;
-      QueuedWrite(): addr(0), val(0) {}
-      QueuedWrite(unsigned char a, unsigned char v): addr(a), val(v) {}
-  };
-  FixedQueue<QueuedWrite,128> writes;
+  typedef DivQueuedWrite<unsigned char,unsigned char> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,128> writes;
   DivPitchTable pitchTable;
   DivPitchTableManager samplePitchTable;
 
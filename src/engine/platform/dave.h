@@ -21,7 +21,7 @@
 #define _DAVE_H
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "sound/dave/dave.hpp"
 
 class DivPlatformDave: public DivDispatch {
@@ -56,13 +56,8 @@ class DivPlatformDave: public DivDispatch {
   Channel chan[6];
   DivDispatchOscBuffer* oscBuf[6];
   bool isMuted[6];
-  struct QueuedWrite {
-    unsigned char addr;
-    unsigned char val;
-    QueuedWrite(): addr(0), val(9) {}
-    QueuedWrite(unsigned char a, unsigned char v): addr(a), val(v) {}
-  };
-  FixedQueue<QueuedWrite,512> writes;
+  typedef DivQueuedWrite<unsigned char,unsigned char> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,512> writes;
   DivPitchTable pitchTable;
   DivPitchTableManager samplePitchTable;
   bool writeControl;
@@ -18,7 +18,7 @@
  */
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "../../../extern/ESFMu/esfm.h"
 
 // ESFM register address space technically spans 0x800 (2048) bytes,
@@ -130,7 +130,7 @@ class DivPlatformESFM: public DivDispatch {
       QueuedWrite(): addr(0), val(0), addrOrVal(false) {}
       QueuedWrite(unsigned short a, unsigned char v): addr(a), val(v), addrOrVal(false) {}
     };
-  FixedQueue<QueuedWrite,2048> writes;
+  DivRegWriteQueue<QueuedWrite,2048> writes;
   esfm_chip chip;
   DivPitchTable pitchTable;
   short oldOut[2];
@@ -22,7 +22,7 @@
 
 #include "../dispatch.h"
 #include "../instrument.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 
 #define KVS(x,y) ((chan[x].state.op[y].kvs==2 && isOutput[chan[x].state.alg][y]) || chan[x].state.op[y].kvs==1)
 
@@ -56,6 +56,9 @@ class DivPlatformFMBase: public DivDispatch {
       unsigned char opMask;
       signed char konCycles;
       bool hardReset, opMaskChanged;
+      // whether the registers hold the parameters in state.
+      // cleared on reset and forceIns() so that the next commit writes everything.
+      bool stateLoaded;
 
       FMChannel(bool linear):
         SharedChannel(0,linear),
@@ -65,7 +68,8 @@ class DivPlatformFMBase: public DivDispatch {
         opMask(15),
         konCycles(0),
         hardReset(false),
-        opMaskChanged(false) {}
+        opMaskChanged(false),
+        stateLoaded(false) {}
     };
 
     struct FMChannelStereo: public FMChannel {
@@ -84,7 +88,7 @@ class DivPlatformFMBase: public DivDispatch {
       QueuedWrite(unsigned int a, unsigned char v): addr(a), val(v), addrOrVal(false), urgent(false) {}
       QueuedWrite(unsigned int a, unsigned char v, bool u): addr(a), val(v), addrOrVal(false), urgent(u) {}
     };
-    FixedQueue<QueuedWrite,2048> writes;
+    DivRegWriteQueue<QueuedWrite,2048> writes;
 
     unsigned char lastBusy;
     int delay;
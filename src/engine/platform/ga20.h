@@ -21,7 +21,7 @@
 #define _GA20_H
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "../macroInt.h"
 #include "sound/ga20/iremga20.h"
 
@@ -46,15 +46,8 @@ class DivPlatformGA20: public DivDispatch, public iremga20_intf {
   Channel chan[4];
   DivDispatchOscBuffer* oscBuf[4];
   bool isMuted[4];
-  struct QueuedWrite {
-    unsigned char addr;
-    unsigned char val;
-    QueuedWrite(): addr(0), val(0) {}
-    QueuedWrite(unsigned char a, unsigned char v):
-      addr(a),
-      val(v) {}
-  };
-  FixedQueue<QueuedWrite,256> writes;
+  typedef DivQueuedWrite<unsigned char,unsigned char> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,256> writes;
   unsigned int* sampleOffGA20;
   bool* sampleLoaded;
   DivPitchTableManager samplePitchTable;
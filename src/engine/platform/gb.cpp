@@ -86,6 +86,44 @@ void DivPlatformGB::acquire(short** buf, size_t len) {
   }
 }
 
+void DivPlatformGB::acquireDirect(blip_buffer_t** bb, size_t len) {
+  for (int i=0; i<4; i++) {
+    oscBuf[i]->begin(len);
+  }
+  for (size_t i=0; i<len; i++) {
+    if (!writes.empty()) {
+      QueuedWrite& w=writes.front();
+      GB_apu_write(gb,w.addr,w.val);
+      writes.pop();
+    }
+
+    GB_advance_cycles(gb,coreQuality);
+    const int out[2]={
+      gb->apu_output.final_sample.left,
+      gb->apu_output.final_sample.right
+    };
+    if (dcOffPending) {
+      // the first sample after a reset sets the DC offset
+      dcOffPending=false;
+      lastOut[0]=out[0];
+      lastOut[1]=out[1];
+    }
+    for (int j=0; j<2; j++) {
+      if (out[j]!=lastOut[j]) {
+        blip_add_delta(bb[j],i,out[j]-lastOut[j]);
+        lastOut[j]=out[j];
+      }
+    }
+
+    for (int j=0; j<4; j++) {
+      oscBuf[j]->putSample(i,(gb->apu_output.current_sample[j].left+gb->apu_output.current_sample[j].right)<<6);
+    }
+  }
+  for (int i=0; i<4; i++) {
+    oscBuf[i]->end(len);
+  }
+}
+
 void DivPlatformGB::updateWave() {
   if (doubleWave) {
     rWrite(0x1a,0x40); // select 1 -> write to bank 0
@@ -179,6 +217,11 @@ static unsigned char noiseTable[256]={
 };
 
 void DivPlatformGB::tick(bool sysTick) {
+  // sub-ticks elapsed since the last call
+  int elapsed=(int)(parent->subTickClock-lastSubTickClock);
+  lastSubTickClock=parent->subTickClock;
+  if (elapsed<1) elapsed=1;
+
   if (antiClickEnabled && sysTick && chan[2].freq>0) {
     antiClickPeriodCount+=((chipClock>>1)/MAX(parent->getCurHz(),1.0f));
     antiClickWavePos+=antiClickPeriodCount/chan[2].freq;
@@ -268,8 +311,10 @@ void DivPlatformGB::tick(bool sysTick) {
       }
     }
     // run hardware sequence
+    // (the wait time is counted in sub-ticks, which may have passed without a tick)
     if (chan[i].active) {
-      if (--chan[i].hwSeqDelay<=0) {
+      if (chan[i].hwSeqDelay>0) chan[i].hwSeqDelay-=elapsed;
+      if (chan[i].hwSeqDelay<=0) {
         chan[i].hwSeqDelay=0;
         DivInstrument* ins=parent->getIns(chan[i].ins,DIV_INS_GB);
         int hwSeqCount=0;
@@ -314,7 +359,10 @@ void DivPlatformGB::tick(bool sysTick) {
           if (leave) break;
           hwSeqCount++;
         }
+        // continue on the next sub-tick if we ran out of commands for this one
+        if (hwSeqCount>=4) parent->wakeDispatchIn(1);
       }
+      if (chan[i].hwSeqDelay>0) parent->wakeDispatchIn(chan[i].hwSeqDelay);
     }
 
     if (chan[i].sweepChanged) {
@@ -650,6 +698,7 @@ int DivPlatformGB::getRegisterPoolSize() {
 }
 
 void DivPlatformGB::reset() {
+  lastSubTickClock=parent->subTickClock;
   for (int i=0; i<4; i++) {
     chan[i]=DivPlatformGB::Channel(parent->song.compatFlags.linearPitch);
     chan[i].pitchTable=&pitchTable;
@@ -676,12 +725,19 @@ void DivPlatformGB::reset() {
   antiClickWavePos=0;
   doubleWave=false;
   lastDoubleWave=false;
+  lastOut[0]=0;
+  lastOut[1]=0;
+  dcOffPending=getDCOffRequired() && parent->getConfBool("audioHiPass",true);
 }
 
 int DivPlatformGB::getPortaFloor(int ch) {
   return 84;
 }
 
+bool DivPlatformGB::hasAcquireDirect() {
+  return true;
+}
+
 int DivPlatformGB::getOutputCount() {
   return 2;
 }
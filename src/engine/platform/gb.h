@@ -23,7 +23,7 @@
 #include "../dispatch.h"
 #include "../waveSynth.h"
 #include "sound/gb/gb.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 
 class DivPlatformGB: public DivDispatch {
   struct Channel: public SharedChannel {
@@ -56,6 +56,8 @@ class DivPlatformGB: public DivDispatch {
   Channel chan[4];
   DivDispatchOscBuffer* oscBuf[4];
   bool isMuted[4];
+  int lastOut[2];
+  bool dcOffPending;
   bool antiClickEnabled;
   bool invertWave;
   bool enoughAlready;
@@ -63,16 +65,12 @@ class DivPlatformGB: public DivDispatch {
   bool lastDoubleWave;
   unsigned char lastPan;
   DivWaveSynth ws;
-  struct QueuedWrite {
-    unsigned char addr;
-    unsigned char val;
-    QueuedWrite(): addr(0), val(0) {}
-    QueuedWrite(unsigned char a, unsigned char v): addr(a), val(v) {}
-  };
-  FixedQueue<QueuedWrite,256> writes;
+  typedef DivQueuedWrite<unsigned char,unsigned char> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,256> writes;
   DivPitchTable pitchTable;
 
   int antiClickPeriodCount, antiClickWavePos;
+  unsigned int lastSubTickClock;
 
   int coreQuality;
   GB_gameboy_t* gb;
@@ -85,6 +83,7 @@ class DivPlatformGB: public DivDispatch {
   friend void putDispatchChan(void*,int,int);
   public:
     void acquire(short** buf, size_t len);
+    void acquireDirect(blip_buffer_t** bb, size_t len);
     int dispatch(DivCommand c);
     SharedChannel* getChanState(int chan);
     DivMacroInt* getChanMacroInt(int ch);
@@ -98,6 +97,7 @@ class DivPlatformGB: public DivDispatch {
     void muteChannel(int ch, bool mute);
     int getPortaFloor(int ch);
     int getOutputCount();
+    bool hasAcquireDirect();
     bool getDCOffRequired();
     void notifyInsChange(int ins);
     void notifyWaveChange(int wave);
@@ -135,8 +135,45 @@ void DivPlatformGenesis::processDAC(int iRate) {
   }
 }
 
+// run the Nuked-OPN2 core for a number of cycles (slots) without writing to it, accumulating its output.
+void DivPlatformGenesis::clockNuked(int start, int cycles, int* os) {
+  short o[2];
+  if (chipType==2) {
+    for (int i=start; i<start+cycles; i++) {
+      OPN2_Clock(&fm,o);
+      os[0]+=CLAMP(o[0],-8192,8191);
+      os[1]+=CLAMP(o[1],-8192,8191);
+      nukedChOut[i]=fm.ch_out[i];
+    }
+  } else {
+    for (int i=start; i<start+cycles; i++) {
+      OPN2_Clock(&fm,o);
+      os[0]+=o[0];
+      os[1]+=o[1];
+      nukedChOut[i]=fm.ch_out[i];
+    }
+  }
+}
+
+// how many of the remaining cycles in this sample can be clocked before the queue has to be checked again.
+inline int DivPlatformGenesis::nukedBatchLen(int left) {
+  if (writes.empty()) {
+    // only a pending DAC write may be queued
+    return (dacWrite<0)?left:1;
+  }
+  QueuedWrite& w=writes.front();
+  if (delay>0 && !w.urgent) {
+    // delay only goes down once per sample
+    return (dacWrite<0)?left:1;
+  }
+  if (w.addr!=0xfffffffe && !w.addrOrVal && fm.write_busy) {
+    // the chip stays busy for at least this many cycles (see OPN2_DoIO())
+    return MIN(left,32-(int)fm.write_busy_cnt);
+  }
+  return 1;
+}
+
 void DivPlatformGenesis::acquire_nuked(short** buf, size_t len) {
-  thread_local short o[2];
   thread_local int os[2];
 
   for (int i=0; i<7; i++) {
@@ -149,19 +186,44 @@ void DivPlatformGenesis::acquire_nuked(short** buf, size_t len) {
     if (delay>0) delay--;
 
     os[0]=0; os[1]=0;
-    for (int i=0; i<6; i++) {
-      if (!writes.empty()) {
-        QueuedWrite& w=writes.front();
-        if (delay<=0 || w.urgent) {
-          if (w.addr==0xfffffffe) {
-            delay=w.val*3;
-            writes.pop_front();
-          } else if (w.addrOrVal) {
-            //logV("%.3x=%.2x",w.addr,w.val);
-            OPN2_Write(&fm,0x1+((w.addr>>8)<<1),w.val);
-            regPool[w.addr&0x1ff]=w.val;
-            writes.pop_front();
-
+    // nothing can be written during this sample, so clock the chip without looking at the queue
+    bool queueIdle=(dacWrite<0 && writes.idle(delay,1)>0 && (writes.empty() || !writes.front().urgent));
+    if (queueIdle) {
+      if (writes.empty()) {
+        canWriteDAC=true;
+        flushFirst=false;
+      }
+      clockNuked(0,6,os);
+    } else {
+      for (int i=0; i<6;) {
+        if (!writes.empty()) {
+          QueuedWrite& w=writes.front();
+          if (delay<=0 || w.urgent) {
+            if (w.addr==0xfffffffe) {
+              delay=w.val*3;
+              writes.pop_front();
+            } else if (w.addrOrVal) {
+              //logV("%.3x=%.2x",w.addr,w.val);
+              OPN2_Write(&fm,0x1+((w.addr>>8)<<1),w.val);
+              regPool[w.addr&0x1ff]=w.val;
+              writes.pop_front();
+
+              if (dacWrite>=0) {
+                if (!canWriteDAC) {
+                  canWriteDAC=true;
+                } else {
+                  urgentWrite(0x2a,dacWrite);
+                  dacWrite=-1;
+                  canWriteDAC=writes.empty();
+                }
+              }
+            } else {
+              if (fm.write_busy==0) {
+                OPN2_Write(&fm,0x0+((w.addr>>8)<<1),w.addr);
+                w.addrOrVal=true;
+              }
+            }
+          } else {
             if (dacWrite>=0) {
               if (!canWriteDAC) {
                 canWriteDAC=true;
@@ -171,59 +233,39 @@ void DivPlatformGenesis::acquire_nuked(short** buf, size_t len) {
                 canWriteDAC=writes.empty();
               }
             }
-          } else {
-            if (fm.write_busy==0) {
-              OPN2_Write(&fm,0x0+((w.addr>>8)<<1),w.addr);
-              w.addrOrVal=true;
-            }
           }
         } else {
+          canWriteDAC=true;
           if (dacWrite>=0) {
-            if (!canWriteDAC) {
-              canWriteDAC=true;
-            } else {
-              urgentWrite(0x2a,dacWrite);
-              dacWrite=-1;
-              canWriteDAC=writes.empty();
-            }
+            urgentWrite(0x2a,dacWrite);
+            dacWrite=-1;
           }
+          flushFirst=false;
         }
-      } else {
-        canWriteDAC=true;
-        if (dacWrite>=0) {
-          urgentWrite(0x2a,dacWrite);
-          dacWrite=-1;
-        }
-        flushFirst=false;
-      }
-      
-      OPN2_Clock(&fm,o);
-      if (chipType==2) {
-        os[0]+=CLAMP(o[0],-8192,8191);
-        os[1]+=CLAMP(o[1],-8192,8191);
-      } else {
-        os[0]+=o[0];
-        os[1]+=o[1];
+
+        int cycles=nukedBatchLen(6-i);
+        clockNuked(i,cycles,os);
+        i+=cycles;
       }
-      //OPN2_Write(&fm,0,0);
-      if (i==5) {
-        if (fm.dacen) {
-          if (softPCM) {
-            oscBuf[5]->putSample(h,chan[5].dacOutput<<6);
-            oscBuf[6]->putSample(h,chan[6].dacOutput<<6);
-          } else {
-            oscBuf[i]->putSample(h,((fm.dacdata^0x100)-0x100)<<6);
-            oscBuf[6]->putSample(h,0);
-          }
-        } else {
-          oscBuf[i]->putSample(h,CLAMP(fm.ch_out[i]<<(chipType==2?1:6),-32768,32767));
-          oscBuf[6]->putSample(h,0);
-        }
+    }
+
+    // slot 5 is the last one, so the DAC state is still the one it was clocked with
+    for (int i=0; i<5; i++) {
+      oscBuf[i]->putSample(h,CLAMP(nukedChOut[i]<<(chipType==2?1:6),-32768,32767));
+    }
+    if (fm.dacen) {
+      if (softPCM) {
+        oscBuf[5]->putSample(h,chan[5].dacOutput<<6);
+        oscBuf[6]->putSample(h,chan[6].dacOutput<<6);
       } else {
-        oscBuf[i]->putSample(h,CLAMP(fm.ch_out[i]<<(chipType==2?1:6),-32768,32767));
+        oscBuf[5]->putSample(h,((fm.dacdata^0x100)-0x100)<<6);
+        oscBuf[6]->putSample(h,0);
       }
+    } else {
+      oscBuf[5]->putSample(h,CLAMP(nukedChOut[5]<<(chipType==2?1:6),-32768,32767));
+      oscBuf[6]->putSample(h,0);
     }
-    
+
     if (chipType!=2) os[0]=(os[0]<<5);
     if (os[0]<-32768) os[0]=-32768;
     if (os[0]>32767) os[0]=32767;
@@ -405,6 +447,48 @@ inline void DivPlatformGenesis::acquire276OscSub(int h) {
   }
 }
 
+// run the YMF276-LLE core for a number of cycles (two clock edges each), accumulating its output.
+// a write set up by the caller is only held during the first half of the first cycle.
+void DivPlatformGenesis::clock276(int cycles, int h, int& sumL, int& sumR, int& sampleL, int& sampleR) {
+  int accL=sumL;
+  int accR=sumR;
+
+  for (int c=0; c<cycles; c++) {
+    FMOPN2_Clock(&fm_276,0);
+    accL+=fm_276.out_l;
+    accR+=fm_276.out_r;
+    fm_276.input.wr=0;
+
+    acquire276OscSub(h);
+
+    FMOPN2_Clock(&fm_276,1);
+    accL+=fm_276.out_l;
+    accR+=fm_276.out_r;
+
+    acquire276OscSub(h);
+
+    if (chipType==2) {
+      if (!o_bco && fm_276.o_bco) {
+        dacShifter=(dacShifter<<1)|fm_276.o_so;
+
+        if (o_lro!=fm_276.o_lro) {
+          if (o_lro) {
+            sampleL=dacShifter;
+          } else {
+            sampleR=dacShifter;
+          }
+        }
+
+        o_lro=fm_276.o_lro;
+      }
+      o_bco=fm_276.o_bco;
+    }
+  }
+
+  sumL=accL;
+  sumR=accR;
+}
+
 // thanks LTVA
 void DivPlatformGenesis::acquire_nuked276(short** buf, size_t len) {
   for (int i=0; i<7; i++) {
@@ -440,127 +524,12 @@ void DivPlatformGenesis::acquire_nuked276(short** buf, size_t len) {
           fm_276.input.address=w.addr<0x100?0:2;
           fm_276.input.data=w.addr&0xff;
           fm_276.input.wr=1;
-          FMOPN2_Clock(&fm_276,0);
-          sum_l+=fm_276.out_l;
-          sum_r+=fm_276.out_r;
-
-          acquire276OscSub(h);
-
-          fm_276.input.wr=0;
-          FMOPN2_Clock(&fm_276,1);
-          sum_l+=fm_276.out_l;
-          sum_r+=fm_276.out_r;
-
-          acquire276OscSub(h);
-
-          if (chipType==2) {
-            if (!o_bco && fm_276.o_bco) {
-              dacShifter=(dacShifter<<1)|fm_276.o_so;
-
-              if (o_lro!=fm_276.o_lro) {
-                if (o_lro)
-                  sample_l=dacShifter;
-                else
-                  sample_r=dacShifter;
-              }
-
-              o_lro=fm_276.o_lro;
-            }
-            o_bco=fm_276.o_bco;
-          }
-
-          for (int c=0; c<17; c++) {
-            FMOPN2_Clock(&fm_276,0);
-            sum_l+=fm_276.out_l;
-            sum_r+=fm_276.out_r;
-
-            acquire276OscSub(h);
-
-            FMOPN2_Clock(&fm_276,1);
-            sum_l+=fm_276.out_l;
-            sum_r+=fm_276.out_r;
-
-            acquire276OscSub(h);
-
-            if (chipType==2) {
-              if (!o_bco && fm_276.o_bco) {
-                dacShifter=(dacShifter<<1)|fm_276.o_so;
-
-                if (o_lro!=fm_276.o_lro) {
-                  if (o_lro)
-                    sample_l=dacShifter;
-                  else
-                    sample_r=dacShifter;
-                }
-
-                o_lro=fm_276.o_lro;
-              }
-              o_bco=fm_276.o_bco;
-            }
-          }
+          clock276(18,h,sum_l,sum_r,sample_l,sample_r);
 
           fm_276.input.address=w.addr<0x100?1:3;
           fm_276.input.data=w.val;
           fm_276.input.wr=1;
-          FMOPN2_Clock(&fm_276,0);
-          sum_l+=fm_276.out_l;
-          sum_r+=fm_276.out_r;
-          fm_276.input.wr=0;
-
-          acquire276OscSub(h);
-
-          FMOPN2_Clock(&fm_276,1);
-          sum_l+=fm_276.out_l;
-          sum_r+=fm_276.out_r;
-
-          acquire276OscSub(h);
-
-          if (chipType==2) {
-            if (!o_bco && fm_276.o_bco) {
-              dacShifter=(dacShifter<<1)|fm_276.o_so;
-
-              if (o_lro!=fm_276.o_lro) {
-                if (o_lro)
-                  sample_l=dacShifter;
-                else
-                  sample_r=dacShifter;
-              }
-
-              o_lro=fm_276.o_lro;
-            }
-            o_bco=fm_276.o_bco;
-          }
-
-          for (int c=0; c<83; c++) {
-            FMOPN2_Clock(&fm_276,0);
-            sum_l+=fm_276.out_l;
-            sum_r+=fm_276.out_r;
-
-            acquire276OscSub(h);
-
-            FMOPN2_Clock(&fm_276,1);
-            sum_l+=fm_276.out_l;
-            sum_r+=fm_276.out_r;
-
-            acquire276OscSub(h);
-
-            if (chipType==2) {
-              if (!o_bco && fm_276.o_bco) {
-                dacShifter=(dacShifter<<1)|fm_276.o_so;
-
-                if (o_lro!=fm_276.o_lro) {
-                  if (o_lro) {
-                    sample_l=dacShifter;
-                  } else {
-                    sample_r=dacShifter;
-                  }
-                }
-
-                o_lro=fm_276.o_lro;
-              }
-              o_bco=fm_276.o_bco;
-            }
-          }
+          clock276(84,h,sum_l,sum_r,sample_l,sample_r);
 
           regPool[w.addr&0x1ff]=w.val;
           writes.pop_front();
@@ -597,35 +566,7 @@ void DivPlatformGenesis::acquire_nuked276(short** buf, size_t len) {
       flushFirst=false;
     }
 
-    for (int j=0; j<(was_reg_write?(144-83-19):144); j++) {
-      FMOPN2_Clock(&fm_276,0);
-      sum_l+=fm_276.out_l;
-      sum_r+=fm_276.out_r;
-
-      acquire276OscSub(h);
-
-      FMOPN2_Clock(&fm_276,1);
-      sum_l+=fm_276.out_l;
-      sum_r+=fm_276.out_r;
-
-      acquire276OscSub(h);
-
-      if (chipType==2) {
-        if (!o_bco && fm_276.o_bco) {
-          dacShifter=(dacShifter<<1)|fm_276.o_so;
-
-          if (o_lro!=fm_276.o_lro) {
-            if (o_lro)
-              sample_l=dacShifter;
-            else
-              sample_r=dacShifter;
-          }
-
-          o_lro=fm_276.o_lro;
-        }
-        o_bco=fm_276.o_bco;
-      }
-    }
+    clock276(was_reg_write?(144-83-19):144,h,sum_l,sum_r,sample_l,sample_r);
 
     if (chipType==2) {
       buf[0][h]=sample_l;
@@ -998,8 +939,12 @@ void DivPlatformGenesis::muteChannel(int ch, bool mute) {
 }
 
 void DivPlatformGenesis::commitState(int ch, DivInstrument* ins) {
+  // the registers only have to be rewritten if the parameters differ from the ones already loaded
+  bool reload=chan[ch].insChanged;
   if (chan[ch].insChanged) {
+    if (insShadow && chan[ch].stateLoaded && chan[ch].state==ins->fm) reload=false;
     chan[ch].state=ins->fm;
+    chan[ch].stateLoaded=true;
     chan[ch].opMask=
       (chan[ch].state.op[0].enable?1:0)|
       (chan[ch].state.op[2].enable?2:0)|
@@ -1014,16 +959,17 @@ void DivPlatformGenesis::commitState(int ch, DivInstrument* ins) {
       rWrite(baseAddr+ADDR_TL,127);
     } else {
       if (KVS(ch,i)) {
+        // this also depends on the volume, so it is written regardless of reload
         if (!chan[ch].active || chan[ch].insChanged) {
           rWrite(baseAddr+ADDR_TL,127-VOL_SCALE_LOG_BROKEN(127-op.tl,chan[ch].outVol&0x7f,127));
         }
       } else {
-        if (chan[ch].insChanged) {
+        if (reload) {
           rWrite(baseAddr+ADDR_TL,op.tl);
         }
       }
     }
-    if (chan[ch].insChanged) {
+    if (reload) {
       rWrite(baseAddr+ADDR_MULT_DT,(op.mult&15)|(dtTable[op.dt&7]<<4));
       rWrite(baseAddr+ADDR_RS_AR,(op.ar&31)|(op.rs<<6));
       rWrite(baseAddr+ADDR_AM_DR,(op.dr&31)|(op.am<<7));
@@ -1032,7 +978,7 @@ void DivPlatformGenesis::commitState(int ch, DivInstrument* ins) {
       rWrite(baseAddr+ADDR_SSG,op.ssgEnv&15);
     }
   }
-  if (chan[ch].insChanged) {
+  if (reload) {
     rWrite(chanOffs[ch]+ADDR_FB_ALG,(chan[ch].state.alg&7)|(chan[ch].state.fb<<3));
     rWrite(chanOffs[ch]+ADDR_LRAF,(IS_REALLY_MUTED(ch)?0:(chan[ch].pan<<6))|(chan[ch].state.fms&7)|((chan[ch].state.ams&3)<<4));
   }
@@ -1598,6 +1544,7 @@ int DivPlatformGenesis::dispatch(DivCommand c) {
 
 void DivPlatformGenesis::forceIns() {
   for (int i=0; i<6; i++) {
+    chan[i].stateLoaded=false;
     for (int j=0; j<4; j++) {
       unsigned short baseAddr=chanOffs[i]|opOffs[j];
       DivInstrumentFM::Operator& op=chan[i].state.op[j];
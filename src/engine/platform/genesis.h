@@ -77,6 +77,9 @@ class DivPlatformGenesis: public DivPlatformOPN {
     unsigned char chipType;
     short dacWrite;
 
+    // channel outputs of the current Nuked-OPN2 sample (one per slot)
+    short nukedChOut[6];
+
     int lleCycle;
     int llePrevCycle;
     int lleOscData[6];
@@ -93,6 +96,9 @@ class DivPlatformGenesis: public DivPlatformOPN {
     inline void processDAC(int iRate);
     inline void commitState(int ch, DivInstrument* ins);
     inline void acquire276OscSub(int h);
+    void clock276(int cycles, int h, int& sumL, int& sumR, int& sampleL, int& sampleR);
+    void clockNuked(int start, int cycles, int* os);
+    inline int nukedBatchLen(int left);
     void acquire_nuked(short** buf, size_t len);
     void acquire_nuked276(short** buf, size_t len);
     void acquire_ymfm(short** buf, size_t len);
@@ -31,6 +31,8 @@ void DivPlatformGenesisExt::commitStateExt(int ch, DivInstrument* ins) {
   int ordch=orderedOps[ch];
 
   if (opChan[ch].insChanged) {
+    // the channel now holds a mix of instruments
+    chan[extChanOffs].stateLoaded=false;
     chan[extChanOffs].state.alg=ins->fm.alg;
     if (ch==0 || fbAllOps) {
       chan[extChanOffs].state.fb=ins->fm.fb;
@@ -752,6 +754,7 @@ void DivPlatformGenesisExt::tick(bool sysTick) {
 
 void DivPlatformGenesisExt::forceIns() {
   for (int i=0; i<6; i++) {
+    chan[i].stateLoaded=false;
     for (int j=0; j<4; j++) {
       unsigned short baseAddr=chanOffs[i]|opOffs[j];
       DivInstrumentFM::Operator& op=chan[i].state.op[j];
@@ -21,7 +21,7 @@
 #define _K007232_H
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "../macroInt.h"
 #include "vgsound_emu/src/k007232/k007232.hpp"
 
@@ -54,15 +54,8 @@ class DivPlatformK007232: public DivDispatch, public k007232_intf {
   DivDispatchOscBuffer* oscBuf[2];
   int lastOut[2];
   bool isMuted[2];
-  struct QueuedWrite {
-    unsigned short addr;
-    unsigned char val;
-    QueuedWrite(): addr(0), val(0) {}
-    QueuedWrite(unsigned short a, unsigned char v):
-      addr(a),
-      val(v) {}
-  };
-  FixedQueue<QueuedWrite,256> writes;
+  typedef DivQueuedWrite<unsigned short,unsigned char> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,256> writes;
   DivPitchTableManager samplePitchTable;
   unsigned int* sampleOffK007232;
   bool* sampleLoaded;
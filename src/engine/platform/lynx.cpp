@@ -181,6 +181,42 @@ void DivPlatformLynx::acquire(short** buf, size_t len) {
   }
 }
 
+void DivPlatformLynx::acquireDirect(blip_buffer_t** bb, size_t len) {
+  thread_local int chanBuf[4];
+  short out[2];
+
+  for (int i=0; i<4; i++) {
+    oscBuf[i]->begin(len);
+  }
+
+  for (size_t h=0; h<len; h++) {
+    processDAC(rate);
+
+    while (!writes.empty()) {
+      QueuedWrite& w=writes.front();
+      mikey->write(w.addr,w.val);
+      writes.pop_front();
+    }
+
+    mikey->sampleAudio(&out[0],&out[1],1,chanBuf);
+
+    for (int i=0; i<2; i++) {
+      if (out[i]!=lastOut[i]) {
+        blip_add_delta(bb[i],h,out[i]-lastOut[i]);
+        lastOut[i]=out[i];
+      }
+    }
+
+    for (int i=0; i<4; i++) {
+      oscBuf[i]->putSample(h,chanBuf[i]);
+    }
+  }
+
+  for (int i=0; i<4; i++) {
+    oscBuf[i]->end(len);
+  }
+}
+
 void DivPlatformLynx::fillStream(std::vector<DivDelayedWrite>& stream, int sRate, size_t len) {
   writes.clear();
   for (size_t i=0; i<len; i++) {
@@ -482,6 +518,10 @@ void DivPlatformLynx::muteChannel(int ch, bool mute) {
   if (chan[ch].active) WRITE_VOLUME(ch,(isMuted[ch]?0:(chan[ch].outVol&127)));
 }
 
+bool DivPlatformLynx::hasAcquireDirect() {
+  return true;
+}
+
 int DivPlatformLynx::getOutputCount() {
   return 2;
 }
@@ -541,6 +581,8 @@ int DivPlatformLynx::getRegisterPoolSize()
 
 void DivPlatformLynx::reset() {
   mikey=std::make_unique<Lynx::Mikey>(rate);
+  lastOut[0]=0;
+  lastOut[1]=0;
 
   for (int i=0; i<4; i++) {
     chan[i]=DivPlatformLynx::Channel(parent->song.compatFlags.linearPitch);
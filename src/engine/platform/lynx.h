@@ -21,6 +21,7 @@
 #define _LYNX_H
 
 #include "../dispatch.h"
+#include "regWriteQueue.h"
 #include "sound/lynx/Mikey.hpp"
 
 class DivPlatformLynx: public DivDispatch {
@@ -66,15 +67,11 @@ class DivPlatformLynx: public DivDispatch {
   Channel chan[4];
   DivDispatchOscBuffer* oscBuf[4];
   bool isMuted[4];
+  int lastOut[2];
   bool tuned;
   std::unique_ptr<Lynx::Mikey> mikey;  
-  struct QueuedWrite {
-    unsigned char addr;
-    unsigned char val;
-    QueuedWrite(): addr(0), val(9) {}
-    QueuedWrite(unsigned char a, unsigned char v): addr(a), val(v) {}
-  };
-  FixedQueue<QueuedWrite,512> writes;
+  typedef DivQueuedWrite<unsigned char,unsigned char> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,512> writes;
   DivPitchTable pitchTable;
   DivPitchTableManager samplePitchTable;
   friend void putDispatchChip(void*,int);
@@ -83,6 +80,7 @@ class DivPlatformLynx: public DivDispatch {
   void processDAC(int sRate);
   public:
     void acquire(short** buf, size_t len);
+    void acquireDirect(blip_buffer_t** bb, size_t len);
     void fillStream(std::vector<DivDelayedWrite>& stream, int sRate, size_t len);
     int dispatch(DivCommand c);
     SharedChannel* getChanState(int chan);
@@ -97,6 +95,7 @@ class DivPlatformLynx: public DivDispatch {
     void tick(bool sysTick=true);
     void muteChannel(int ch, bool mute);
     int getOutputCount();
+    bool hasAcquireDirect();
     bool hasSoftPan(int ch);
     bool keyOffAffectsArp(int ch);
     bool keyOffAffectsPorta(int ch);
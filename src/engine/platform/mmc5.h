@@ -21,6 +21,7 @@
 #define _MMC5_H
 
 #include "../dispatch.h"
+#include "regWriteQueue.h"
 
 class DivPlatformMMC5: public DivDispatch {
   struct Channel: public SharedChannel {
@@ -38,13 +39,8 @@ class DivPlatformMMC5: public DivDispatch {
   Channel chan[5];
   DivDispatchOscBuffer* oscBuf[3];
   bool isMuted[5];
-  struct QueuedWrite {
-      unsigned short addr;
-      unsigned char val;
-      QueuedWrite(): addr(0), val(0) {}
-      QueuedWrite(unsigned short a, unsigned char v): addr(a), val(v) {}
-  };
-  FixedQueue<QueuedWrite,128> writes;
+  typedef DivQueuedWrite<unsigned short,unsigned char> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,128> writes;
   DivPitchTable pitchTable;
   DivPitchTableManager samplePitchTable;
   int dacPeriod, dacRate;
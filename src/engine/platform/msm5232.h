@@ -21,7 +21,7 @@
 #define _MSM5232_H
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "sound/oki/msm5232.h"
 
 class DivPlatformMSM5232: public DivDispatch {
@@ -45,13 +45,8 @@ class DivPlatformMSM5232: public DivDispatch {
   unsigned char groupControl[2];
   unsigned char groupAR[2];
   unsigned char groupDR[2];
-  struct QueuedWrite {
-    unsigned char addr;
-    unsigned char val;
-    QueuedWrite(): addr(0), val(0) {}
-    QueuedWrite(unsigned char a, unsigned char v): addr(a), val(v) {}
-  };
-  FixedQueue<QueuedWrite,256> writes;
+  typedef DivQueuedWrite<unsigned char,unsigned char> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,256> writes;
 
   int cycles, curChan, delay, detune, clockDriftAccum;
   unsigned int clockDriftLFOPos, clockDriftLFOSpeed;
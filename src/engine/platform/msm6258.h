@@ -21,7 +21,7 @@
 #define _MSM6258_H
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "sound/oki/okim6258.h"
 
 class DivPlatformMSM6258: public DivDispatch {
@@ -37,13 +37,8 @@ class DivPlatformMSM6258: public DivDispatch {
     Channel chan[1];
     DivDispatchOscBuffer* oscBuf[1];
     bool isMuted[1];
-    struct QueuedWrite {
-      unsigned short addr;
-      unsigned char val;
-      QueuedWrite(): addr(0), val(0) {}
-      QueuedWrite(unsigned short a, unsigned char v): addr(a), val(v) {}
-    };
-    FixedQueue<QueuedWrite,256> writes;
+    typedef DivQueuedWrite<unsigned short,unsigned char> QueuedWrite;
+    DivRegWriteQueue<QueuedWrite,256> writes;
     okim6258_device* msm;
 
     unsigned char msmPan, msmDivider, rateSel, msmClock, clockSel;
@@ -21,7 +21,7 @@
 #define _MSM6295_H
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "vgsound_emu/src/msm6295/msm6295.hpp"
 
 class DivPlatformMSM6295: public DivDispatch, public vgsound_emu_mem_intf {
@@ -45,7 +45,7 @@ class DivPlatformMSM6295: public DivDispatch, public vgsound_emu_mem_intf {
         val(v),
         delay(d) {}
     };
-    FixedQueue<QueuedWrite,256> writes;
+    DivRegWriteQueue<QueuedWrite,256> writes;
     msm6295_core msm;
 
     unsigned char* adpcmMem;
@@ -21,7 +21,7 @@
 #define _MULTIPCM_H
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "sound/ymf278b/ymf278.h"
 
 class DivYMW258MemoryInterface: public MemoryInterface {
@@ -66,14 +66,8 @@ class DivPlatformMultiPCM: public DivDispatch {
     Channel chan[28];
     DivDispatchOscBuffer* oscBuf[28];
     bool isMuted[28];
-    struct QueuedWrite {
-      unsigned int addr;
-      unsigned char val;
-      bool addrOrVal;
-      QueuedWrite(): addr(0), val(0), addrOrVal(false) {}
-      QueuedWrite(unsigned int a, unsigned char v): addr(a), val(v), addrOrVal(false) {}
-    };
-    FixedQueue<QueuedWrite,4096> writes;
+    typedef DivQueuedWrite<unsigned int,unsigned char> QueuedWrite;
+    DivRegWriteQueue<QueuedWrite,4096> writes;
     DivPitchTableManager samplePitchTable;
 
     unsigned char* pcmMem;
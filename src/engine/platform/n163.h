@@ -21,7 +21,7 @@
 #define _N163_H
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "../waveSynth.h"
 #include "vgsound_emu/src/n163/n163.hpp"
 
@@ -59,7 +59,7 @@ class DivPlatformN163: public DivDispatch {
     QueuedWrite(): addr(0), val(0), mask(~0) {}
     QueuedWrite(unsigned char a, unsigned char v, unsigned char m=~0): addr(a), val(v), mask(m) {}
   };
-  FixedQueue<QueuedWrite,2048> writes;
+  DivRegWriteQueue<QueuedWrite,2048> writes;
   DivPitchTable pitchTable;
   unsigned char initChanMax;
   unsigned char chanMax;
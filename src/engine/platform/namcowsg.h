@@ -21,7 +21,7 @@
 #define _NAMCOWSG_H
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "../waveSynth.h"
 #include "sound/namco.h"
 
@@ -42,13 +42,8 @@ class DivPlatformNamcoWSG: public DivDispatch {
   Channel chan[8];
   DivDispatchOscBuffer* oscBuf[8];
   bool isMuted[8];
-  struct QueuedWrite {
-    unsigned short addr;
-    unsigned char val;
-    QueuedWrite(): addr(0), val(0) {}
-    QueuedWrite(unsigned short a, unsigned char v): addr(a), val(v) {}
-  };
-  FixedQueue<QueuedWrite,256> writes;
+  typedef DivQueuedWrite<unsigned short,unsigned char> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,256> writes;
   DivPitchTable pitchTable;
 
   namco_audio_device* namco;
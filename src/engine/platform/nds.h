@@ -21,6 +21,7 @@
 #define _NDS_H
 
 #include "../dispatch.h"
+#include "regWriteQueue.h"
 #ifdef ORIG_NDS_CORE
 #include "sound/nds_unopt.hpp"
 #else
@@ -63,7 +64,7 @@ class DivPlatformNDS: public DivDispatch, public nds_sound_intf {
     QueuedWrite(): addr(0), size(0), val(0) {}
     QueuedWrite(unsigned short a, unsigned char s, unsigned int v): addr(a), size(s), val(v) {}
   };
-  FixedQueue<QueuedWrite,2048> writes;
+  DivRegWriteQueue<QueuedWrite,2048> writes;
   DivPitchTable pitchTable;
   DivPitchTableManager samplePitchTable;
 
@@ -24,7 +24,7 @@
 
 #include "sound/nes_nsfplay/nes_apu.h"
 #include "sound/nes_nsfplay/5e01_apu.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 
 class DivPlatformNES: public DivDispatch {
   struct Channel: public SharedChannel {
@@ -44,13 +44,8 @@ class DivPlatformNES: public DivDispatch {
   Channel chan[5];
   DivDispatchOscBuffer* oscBuf[5];
   bool isMuted[5];
-  struct QueuedWrite {
-      unsigned short addr;
-      unsigned char val;
-      QueuedWrite(): addr(0), val(0) {}
-      QueuedWrite(unsigned short a, unsigned char v): addr(a), val(v) {}
-  };
-  FixedQueue<QueuedWrite,128> writes;
+  typedef DivQueuedWrite<unsigned short,unsigned char> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,128> writes;
   DivPitchTable pitchTable;
   DivPitchTableManager samplePitchTable;
   int dacPeriod, dacRate, dpcmPos;
@@ -21,7 +21,7 @@
 #define _OPL_H
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "../../../extern/opl/opl3.h"
 #include "../../../extern/Nuked-OPL2-Lite/opl2.h"
 #include "../../../extern/Nuked-CQM/cqm.h"
@@ -97,14 +97,8 @@ class DivPlatformOPL: public DivDispatch {
     Channel chan[44];
     DivDispatchOscBuffer* oscBuf[44];
     bool isMuted[44];
-    struct QueuedWrite {
-      unsigned int addr;
-      unsigned char val;
-      bool addrOrVal;
-      QueuedWrite(): addr(0), val(0), addrOrVal(false) {}
-      QueuedWrite(unsigned int a, unsigned char v): addr(a), val(v), addrOrVal(false) {}
-    };
-    FixedQueue<QueuedWrite,4096> writes;
+    typedef DivQueuedWrite<unsigned int,unsigned char> QueuedWrite;
+    DivRegWriteQueue<QueuedWrite,4096> writes;
 
     unsigned int dacVal;
     unsigned int dacVal2;
@@ -43,9 +43,28 @@ const unsigned char visMapOPLL[9]={
   6, 7, 8, 3, 4, 5, 0, 1, 2
 };
 
+// run the Nuked-OPLL core for a number of cycles without writing to it, accumulating its output.
+void DivPlatformOPLL::clockNuked(int cycles, size_t h, int& os) {
+  int o[2];
+  int acc=os;
+  // only writes change this
+  bool perCycleOsc=(vrc7 || (fm.rm_enable&0x20));
+
+  for (int i=0; i<cycles; i++) {
+    OPLL_Clock(&fm,o);
+    unsigned char nextOut=cycleMapOPLL[fm.cycles];
+    if ((nextOut>=6 && properDrums) || !isMuted[nextOut]) {
+      acc+=(o[0]+o[1]);
+      if (perCycleOsc) oscBuf[nextOut]->putSample(h,(o[0]+o[1])<<6);
+    } else {
+      if (perCycleOsc) oscBuf[nextOut]->putSample(h,0);
+    }
+  }
+  os=acc;
+}
+
 void DivPlatformOPLL::acquire_nuked(short** buf, size_t len) {
-  thread_local int o[2];
-  thread_local int os;
+  int os;
 
   for (int i=0; i<11; i++) {
     oscBuf[i]->begin(len);
@@ -53,7 +72,13 @@ void DivPlatformOPLL::acquire_nuked(short** buf, size_t len) {
 
   for (size_t h=0; h<len; h++) {
     os=0;
-    for (int i=0; i<9; i++) {
+    if (writes.empty()) {
+      clockNuked(9,h,os);
+    } else if (delay>=9) {
+      // no write will happen during this sample
+      delay-=9;
+      clockNuked(9,h,os);
+    } else for (int i=0; i<9; i++) {
       if (!writes.empty() && --delay<0) {
         // 84 is safe value
         QueuedWrite& w=writes.front();
@@ -70,15 +95,8 @@ void DivPlatformOPLL::acquire_nuked(short** buf, size_t len) {
           delay=3;
         }
       }
-      
-      OPLL_Clock(&fm,o);
-      unsigned char nextOut=cycleMapOPLL[fm.cycles];
-      if ((nextOut>=6 && properDrums) || !isMuted[nextOut]) {
-        os+=(o[0]+o[1]);
-        if (vrc7 || (fm.rm_enable&0x20)) oscBuf[nextOut]->putSample(h,(o[0]+o[1])<<6);
-      } else {
-        if (vrc7 || (fm.rm_enable&0x20)) oscBuf[nextOut]->putSample(h,0);
-      }
+
+      clockNuked(1,h,os);
     }
     if (!(vrc7 || (fm.rm_enable&0x20))) for (int i=0; i<9; i++) {
       unsigned char ch=visMapOPLL[i];
@@ -21,7 +21,7 @@
 #define _OPLL_H
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 
 extern "C" {
 #include "../../../extern/Nuked-OPLL/opll.h"
@@ -45,14 +45,8 @@ class DivPlatformOPLL: public DivDispatch {
     Channel chan[11];
     bool isMuted[11];
     DivDispatchOscBuffer* oscBuf[11];
-    struct QueuedWrite {
-      unsigned short addr;
-      unsigned char val;
-      bool addrOrVal;
-      QueuedWrite(): addr(0), val(0), addrOrVal(false) {}
-      QueuedWrite(unsigned short a, unsigned char v): addr(a), val(v), addrOrVal(false) {}
-    };
-    FixedQueue<QueuedWrite,512> writes;
+    typedef DivQueuedWrite<unsigned short,unsigned char> QueuedWrite;
+    DivRegWriteQueue<QueuedWrite,512> writes;
     opll_t fm;
     OPLL* fm_emu;
     DivPitchTable pitchTable;
@@ -87,6 +81,7 @@ class DivPlatformOPLL: public DivDispatch {
     friend void putDispatchChip(void*,int);
     friend void putDispatchChan(void*,int,int);
 
+    void clockNuked(int cycles, size_t h, int& os);
     void acquire_nuked(short** buf, size_t len);
     void acquire_ymfm(short** buf, size_t len);
     void acquire_emu(short** buf, size_t len);
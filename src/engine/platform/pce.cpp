@@ -98,12 +98,10 @@ void DivPlatformPCE::acquireDirect(blip_buffer_t** bb, size_t len) {
   pce->ResetTS(pos);
 
   // flush the write queue
-  while (!writes.empty()) {
-    QueuedWrite w=writes.front();
+  writes.flush([this,pos](QueuedWrite& w) {
     pce->Write(pos,w.addr,w.val);
     regPool[w.addr&0x0f]=w.val;
-    writes.pop();
-  }
+  });
 
   // begin the buffer filling process
   for (size_t h=0; h<len;) {
@@ -176,12 +174,10 @@ void DivPlatformPCE::acquireDirect(blip_buffer_t** bb, size_t len) {
 
     // flush register writes
     // the emulator's Write function will run the output as needed
-    while (!writes.empty()) {
-      QueuedWrite w=writes.front();
+    writes.flush([this,pos](QueuedWrite& w) {
       pce->Write(pos,w.addr,w.val);
       regPool[w.addr&0x0f]=w.val;
-      writes.pop();
-    }
+    });
 
     // move the position in our buffer
     h+=advance;
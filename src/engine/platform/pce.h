@@ -23,7 +23,7 @@
 #define _PCE_H
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "../waveSynth.h"
 #include "sound/pce_psg.h"
 
@@ -100,13 +100,8 @@ class DivPlatformPCE: public DivDispatch {
   bool updateLFO;
   // most chips don't allow us to make more than one write per sample or cycle.
   // we employ a queue to work around this.
-  struct QueuedWrite {
-    unsigned char addr;
-    unsigned char val;
-    QueuedWrite(): addr(0), val(9) {}
-    QueuedWrite(unsigned char a, unsigned char v): addr(a), val(v) {}
-  };
-  FixedQueue<QueuedWrite,512> writes;
+  typedef DivQueuedWrite<unsigned char,unsigned char> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,512> writes;
   // this provides pitch calculation. it is used in normal mode.
   DivPitchTable pitchTable;
   // this pitch table manager delivers pitch tables in sample mode.
@@ -86,6 +86,47 @@ void DivPlatformPET::acquire(short** buf, size_t len) {
   oscBuf->end(len);
 }
 
+void DivPlatformPET::acquireDirect(blip_buffer_t** bb, size_t len) {
+  bool hwSROutput=((regPool[11]>>2)&7)==4;
+  oscBuf->begin(len);
+  if (chan[0].enable) {
+    int reload=regPool[8]*2+4;
+    if (!hwSROutput) {
+      reload+=regPool[9]*512;
+    }
+    for (size_t h=0; h<len; h++) {
+      // skip ahead to the next shift
+      int advance=MAX(chan[0].cnt,0)/SAMP_DIVIDER;
+      if (advance>=(int)(len-h)) {
+        chan[0].cnt-=(int)(len-h)*SAMP_DIVIDER;
+        break;
+      }
+      chan[0].cnt-=advance*SAMP_DIVIDER;
+      h+=advance;
+
+      chan[0].out=(chan[0].sreg&1)*32767;
+      chan[0].sreg=(chan[0].sreg>>1)|((chan[0].sreg&1)<<7);
+      chan[0].cnt+=reload-SAMP_DIVIDER;
+
+      if (chan[0].out!=lastOut) {
+        blip_add_delta(bb[0],h,chan[0].out-lastOut);
+        lastOut=chan[0].out;
+      }
+      oscBuf->putSample(h,chan[0].out);
+    }
+    // emulate driver writes to PCR
+    if (!hwSROutput) regPool[12]=chan[0].out?0xe0:0xc0;
+  } else {
+    chan[0].out=0;
+    if (lastOut!=0) {
+      blip_add_delta(bb[0],0,-lastOut);
+      lastOut=0;
+    }
+    oscBuf->putSample(0,0);
+  }
+  oscBuf->end(len);
+}
+
 void DivPlatformPET::writeOutVol() {
   if (chan[0].active && !isMuted && chan[0].outVol>0) {
     chan[0].enable=true;
@@ -287,11 +328,16 @@ int DivPlatformPET::getRegisterPoolSize() {
 void DivPlatformPET::reset() {
   memset(regPool,0,16);
   chan[0]=Channel();
+  lastOut=0;
   chan[0].pitchTable=&pitchTable;
   chan[0].std.setEngine(parent);
   rWrite(10,chan[0].wave);
 }
 
+bool DivPlatformPET::hasAcquireDirect() {
+  return true;
+}
+
 int DivPlatformPET::getOutputCount() {
   return 1;
 }
@@ -41,12 +41,14 @@ class DivPlatformPET: public DivDispatch {
   DivDispatchOscBuffer* oscBuf;
   DivPitchTable pitchTable;
   bool isMuted;
+  int lastOut;
 
   unsigned char regPool[16];
   friend void putDispatchChip(void*,int);
   friend void putDispatchChan(void*,int,int);
   public:
     void acquire(short** buf, size_t len);
+    void acquireDirect(blip_buffer_t** bb, size_t len);
     int dispatch(DivCommand c);
     SharedChannel* getChanState(int chan);
     DivMacroInt* getChanMacroInt(int ch);
@@ -61,6 +63,7 @@ class DivPlatformPET: public DivDispatch {
     void notifyPitchTable(int sample=-1);
     unsigned int getMaxFreq(int ch);
     int getOutputCount();
+    bool hasAcquireDirect();
     void poke(unsigned int addr, unsigned short val);
     void poke(std::vector<DivRegWrite>& wlist);
     const char** getRegisterSheet();
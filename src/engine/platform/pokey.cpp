@@ -73,6 +73,14 @@ void DivPlatformPOKEY::acquire(short** buf, size_t len) {
   }
 }
 
+void DivPlatformPOKEY::acquireDirect(blip_buffer_t** bb, size_t len) {
+  if (useAltASAP) {
+    acquireASAP(bb[0],len);
+  } else {
+    acquireMZ(bb[0],len);
+  }
+}
+
 void DivPlatformPOKEY::acquireMZ(short* buf, size_t len) {
   for (int i=0; i<4; i++) {
     oscBuf[i]->begin(len);
@@ -102,6 +110,40 @@ void DivPlatformPOKEY::acquireMZ(short* buf, size_t len) {
   }
 }
 
+void DivPlatformPOKEY::acquireMZ(blip_buffer_t* bb, size_t len) {
+  for (int i=0; i<4; i++) {
+    oscBuf[i]->begin(len);
+  }
+
+  for (size_t h=0; h<len; h++) {
+    while (!writes.empty()) {
+      QueuedWrite w=writes.front();
+      Update_pokey_sound_mz(&pokey,w.addr,w.val,0);
+      regPool[w.addr&0x0f]=w.val;
+      writes.pop();
+    }
+
+    short out;
+    mzpokeysnd_process_16(&pokey,&out,1);
+    if (out!=lastOut) {
+      blip_add_delta(bb,h,out-lastOut);
+      lastOut=out;
+    }
+
+    if (++oscBufDelay>=14) {
+      oscBufDelay=0;
+      oscBuf[0]->putSample(h,pokey.outvol_0<<10);
+      oscBuf[1]->putSample(h,pokey.outvol_1<<10);
+      oscBuf[2]->putSample(h,pokey.outvol_2<<10);
+      oscBuf[3]->putSample(h,pokey.outvol_3<<10);
+    }
+  }
+
+  for (int i=0; i<4; i++) {
+    oscBuf[i]->end(len);
+  }
+}
+
 void DivPlatformPOKEY::acquireASAP(short* buf, size_t len) {
   thread_local short oscB[4];
 
@@ -133,6 +175,42 @@ void DivPlatformPOKEY::acquireASAP(short* buf, size_t len) {
   }
 }
 
+void DivPlatformPOKEY::acquireASAP(blip_buffer_t* bb, size_t len) {
+  thread_local short oscB[4];
+
+  while (!writes.empty()) {
+    QueuedWrite w=writes.front();
+    altASAP.write(w.addr, w.val);
+    writes.pop();
+  }
+
+  for (int i=0; i<4; i++) {
+    oscBuf[i]->begin(len);
+  }
+
+  for (size_t h=0; h<len; h++) {
+    int out;
+    if (++oscBufDelay>=2) {
+      oscBufDelay=0;
+      out=altASAP.sampleAudio(oscB);
+
+      for (int i=0; i<4; i++) {
+        oscBuf[i]->putSample(h,oscB[i]);
+      }
+    } else {
+      out=altASAP.sampleAudio();
+    }
+    if (out!=lastOut) {
+      blip_add_delta(bb,h,out-lastOut);
+      lastOut=out;
+    }
+  }
+
+  for (int i=0; i<4; i++) {
+    oscBuf[i]->end(len);
+  }
+}
+
 void DivPlatformPOKEY::tick(bool sysTick) {
   for (int i=0; i<4; i++) {
     chan[i].std.next();
@@ -468,6 +546,7 @@ int DivPlatformPOKEY::getRegisterPoolSize() {
 
 void DivPlatformPOKEY::reset() {
   while (!writes.empty()) writes.pop();
+  lastOut=0;
   memset(regPool,0,16);
   for (int i=0; i<4; i++) {
     chan[i]=DivPlatformPOKEY::Channel(parent->song.compatFlags.linearPitch);
@@ -490,6 +569,10 @@ void DivPlatformPOKEY::reset() {
   skctlChanged=true;
 }
 
+bool DivPlatformPOKEY::hasAcquireDirect() {
+  return true;
+}
+
 bool DivPlatformPOKEY::keyOffAffectsArp(int ch) {
   return true;
 }
@@ -21,7 +21,7 @@
 #define _POKEY_H
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 
 extern "C" {
 #include "sound/pokey/mzpokeysnd.h"
@@ -42,13 +42,9 @@ class DivPlatformPOKEY: public DivDispatch {
   Channel chan[4];
   DivDispatchOscBuffer* oscBuf[4];
   bool isMuted[4];
-  struct QueuedWrite {
-    unsigned char addr;
-    unsigned char val;
-    QueuedWrite(): addr(0), val(0) {}
-    QueuedWrite(unsigned char a, unsigned char v): addr(a), val(v) {}
-  };
-  FixedQueue<QueuedWrite,128> writes;
+  int lastOut;
+  typedef DivQueuedWrite<unsigned char,unsigned char> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,128> writes;
   DivPitchTable pitchTable;
   unsigned char audctl, skctl;
   bool audctlChanged, skctlChanged;
@@ -63,6 +59,9 @@ class DivPlatformPOKEY: public DivDispatch {
     void acquire(short** buf, size_t len);
     void acquireMZ(short* buf, size_t len);
     void acquireASAP(short* buf, size_t len);
+    void acquireDirect(blip_buffer_t** bb, size_t len);
+    void acquireMZ(blip_buffer_t* bb, size_t len);
+    void acquireASAP(blip_buffer_t* bb, size_t len);
     int dispatch(DivCommand c);
     SharedChannel* getChanState(int chan);
     DivMacroInt* getChanMacroInt(int ch);
@@ -71,6 +70,7 @@ class DivPlatformPOKEY: public DivDispatch {
     unsigned char* getRegisterPool();
     int getRegisterPoolSize();
     void reset();
+    bool hasAcquireDirect();
     void forceIns();
     void tick(bool sysTick=true);
     void muteChannel(int ch, bool mute);
@@ -55,6 +55,44 @@ void DivPlatformPV1000::acquire(short** buf, size_t len) {
   }
 }
 
+void DivPlatformPV1000::acquireDirect(blip_buffer_t** bb, size_t len) {
+  for (int i=0; i<3; i++) {
+    oscBuf[i]->begin(len);
+  }
+
+  for (size_t h=0; h<len; h++) {
+    int advance=len-h;
+    if (d65010g031.ctrl&2) {
+      for (int i=0; i<3; i++) {
+        if (d65010g031.square[i].period==0) continue;
+        const int remain=d65010g031.square[i].period-d65010g031.square[i].counter;
+        if (remain<advance) advance=remain;
+      }
+    }
+    // the first sample after a reset sets the DC offset
+    if (dcOffPending) advance=1;
+    if (advance<1) advance=1;
+    int out=d65010g031_sound_tick(&d65010g031,advance);
+
+    h+=advance-1;
+
+    if (dcOffPending) {
+      dcOffPending=false;
+      lastOut=out;
+    } else if (out!=lastOut) {
+      blip_add_delta(bb[0],h,out-lastOut);
+      lastOut=out;
+    }
+    for (int i=0; i<3; i++) {
+      oscBuf[i]->putSample(h,MAX(d65010g031.out[i]<<2,0));
+    }
+  }
+
+  for (int i=0; i<3; i++) {
+    oscBuf[i]->end(len);
+  }
+}
+
 void DivPlatformPV1000::tick(bool sysTick) {
   for (int i=0; i<3; i++) {
     chan[i].std.next();
@@ -258,6 +296,12 @@ void DivPlatformPV1000::reset() {
   rWrite(1,0x3f);
   rWrite(2,0x3f);
   rWrite(3,2);
+  lastOut=0;
+  dcOffPending=parent->getConfBool("audioHiPass",true);
+}
+
+bool DivPlatformPV1000::hasAcquireDirect() {
+  return true;
 }
 
 int DivPlatformPV1000::getOutputCount() {
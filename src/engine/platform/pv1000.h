@@ -32,6 +32,8 @@ class DivPlatformPV1000: public DivDispatch {
   DivDispatchOscBuffer* oscBuf[3];
   bool isMuted[3];
   DivPitchTable pitchTable;
+  int lastOut;
+  bool dcOffPending;
 
   unsigned char regPool[4];
   d65010g031_t d65010g031;
@@ -39,6 +41,7 @@ class DivPlatformPV1000: public DivDispatch {
   friend void putDispatchChan(void*,int,int);
   public:
     void acquire(short** buf, size_t len);
+    void acquireDirect(blip_buffer_t** bb, size_t len);
     int dispatch(DivCommand c);
     SharedChannel* getChanState(int chan);
     DivMacroInt* getChanMacroInt(int ch);
@@ -54,6 +57,7 @@ class DivPlatformPV1000: public DivDispatch {
     void notifyPitchTable(int sample=-1);
     unsigned int getMaxFreq(int ch);
     int getOutputCount();
+    bool hasAcquireDirect();
     void poke(unsigned int addr, unsigned short val);
     void poke(std::vector<DivRegWrite>& wlist);
     const char** getRegisterSheet();
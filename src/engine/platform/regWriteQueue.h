@@ -0,0 +1,63 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2026 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _REGWRITEQUEUE_H
+#define _REGWRITEQUEUE_H
+
+#include "../../fixedQueue.h"
+
+// a register write, as queued by rWrite().
+// addrOrVal is used by chips with separate address and data ports. it is set once the address was written.
+template<typename A, typename V> struct DivQueuedWrite {
+  A addr;
+  V val;
+  bool addrOrVal;
+  DivQueuedWrite(): addr(0), val(0), addrOrVal(false) {}
+  DivQueuedWrite(A a, V v): addr(a), val(v), addrOrVal(false) {}
+};
+
+// queue of register writes, filled in tick() and issued in acquire().
+// T is the write type (usually DivQueuedWrite).
+template<typename T, size_t items> struct DivRegWriteQueue: public FixedQueue<T,items> {
+  /**
+   * issue all queued writes in order and empty the queue.
+   * @param write a function which takes a write.
+   */
+  template<typename F> void flush(F write) {
+    while (!this->empty()) {
+      write(this->front());
+      this->pop();
+    }
+  }
+
+  /**
+   * get how many steps may run before the queue needs attention again.
+   * per-cycle cores use this to clock the chip in a tight loop instead of checking the queue on every cycle.
+   * @param delay steps left until the front write is due (cycles or samples, depending on the platform).
+   * @param max the number of steps to run.
+   * @return max if the queue is empty, or the smaller of delay and max otherwise.
+   */
+  int idle(int delay, int max) {
+    if (this->empty()) return max;
+    if (delay<=0) return 0;
+    return (delay<max)?delay:max;
+  }
+};
+
+#endif
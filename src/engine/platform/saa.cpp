@@ -57,7 +57,7 @@ const char** DivPlatformSAA1099::getRegisterSheet() {
   return regCheatSheetSAA;
 }
 
-void DivPlatformSAA1099::acquire_saaSound(short** buf, size_t len) {
+void DivPlatformSAA1099::render_saaSound(size_t len) {
   if (saaBufLen<len*2) {
     saaBufLen=len*2;
     for (int i=0; i<2; i++) {
@@ -78,6 +78,10 @@ void DivPlatformSAA1099::acquire_saaSound(short** buf, size_t len) {
   for (int i=0; i<6; i++) {
     oscBuf[i]->end(len);
   }
+}
+
+void DivPlatformSAA1099::acquire_saaSound(short** buf, size_t len) {
+  render_saaSound(len);
 #ifdef TA_BIG_ENDIAN
   for (size_t i=0; i<len; i++) {
     buf[0][i]=(short)((((unsigned short)saaBuf[0][i<<1])<<8)|(((unsigned short)saaBuf[0][i<<1])>>8));
@@ -91,10 +95,31 @@ void DivPlatformSAA1099::acquire_saaSound(short** buf, size_t len) {
 #endif
 }
 
+void DivPlatformSAA1099::acquire_saaSound(blip_buffer_t** bb, size_t len) {
+  render_saaSound(len);
+  for (size_t i=0; i<len; i++) {
+    for (int j=0; j<2; j++) {
+#ifdef TA_BIG_ENDIAN
+      const int out=(short)((((unsigned short)saaBuf[0][j+(i<<1)])<<8)|(((unsigned short)saaBuf[0][j+(i<<1)])>>8));
+#else
+      const int out=saaBuf[0][j+(i<<1)];
+#endif
+      if (out!=lastOut[j]) {
+        blip_add_delta(bb[j],i,out-lastOut[j]);
+        lastOut[j]=out;
+      }
+    }
+  }
+}
+
 void DivPlatformSAA1099::acquire(short** buf, size_t len) {
   acquire_saaSound(buf,len);
 }
 
+void DivPlatformSAA1099::acquireDirect(blip_buffer_t** bb, size_t len) {
+  acquire_saaSound(bb,len);
+}
+
 inline unsigned char applyPan(unsigned char vol, unsigned char pan) {
   return ((vol*(pan>>4))/15)|(((vol*(pan&15))/15)<<4);
 }
@@ -382,6 +407,8 @@ int DivPlatformSAA1099::getRegisterPoolSize() {
 
 void DivPlatformSAA1099::reset() {
   while (!writes.empty()) writes.pop();
+  lastOut[0]=0;
+  lastOut[1]=0;
   memset(regPool,0,32);
   saa_saaSound->Clear();
   for (int i=0; i<6; i++) {
@@ -417,6 +444,10 @@ void DivPlatformSAA1099::reset() {
   rWrite(0x1c,1);
 }
 
+bool DivPlatformSAA1099::hasAcquireDirect() {
+  return true;
+}
+
 int DivPlatformSAA1099::getOutputCount() {
   return 2;
 }
@@ -21,7 +21,7 @@
 #define _SAA_H
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "../../../extern/SAASound/src/SAASound.h"
 
 class DivPlatformSAA1099: public DivDispatch {
@@ -40,14 +40,9 @@ class DivPlatformSAA1099: public DivDispatch {
     Channel chan[6];
     DivDispatchOscBuffer* oscBuf[6];
     bool isMuted[6];
-    struct QueuedWrite {
-      unsigned short addr;
-      unsigned char val;
-      bool addrOrVal;
-      QueuedWrite(): addr(0), val(0), addrOrVal(false) {}
-      QueuedWrite(unsigned short a, unsigned char v): addr(a), val(v), addrOrVal(false) {}
-    };
-    FixedQueue<QueuedWrite,256> writes;
+    int lastOut[2];
+    typedef DivQueuedWrite<unsigned short,unsigned char> QueuedWrite;
+    DivRegWriteQueue<QueuedWrite,256> writes;
     DivPitchTable pitchTable;
     int coreQuality;
     CSAASound* saa_saaSound;
@@ -67,10 +62,13 @@ class DivPlatformSAA1099: public DivDispatch {
     friend void putDispatchChip(void*,int);
     friend void putDispatchChan(void*,int,int);
 
+    void render_saaSound(size_t len);
     void acquire_saaSound(short** buf, size_t len);
+    void acquire_saaSound(blip_buffer_t** bb, size_t len);
   
   public:
     void acquire(short** buf, size_t len);
+    void acquireDirect(blip_buffer_t** bb, size_t len);
     int dispatch(DivCommand c);
     SharedChannel* getChanState(int chan);
     DivMacroInt* getChanMacroInt(int ch);
@@ -84,6 +82,7 @@ class DivPlatformSAA1099: public DivDispatch {
     void muteChannel(int ch, bool mute);
     void setFlags(const DivConfig& flags);
     int getOutputCount();
+    bool hasAcquireDirect();
     bool hasSoftPan(int ch);
     int getPortaFloor(int ch);
     bool keyOffAffectsArp(int ch);
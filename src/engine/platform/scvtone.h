@@ -21,7 +21,7 @@
 #define _SCV_TONE_H
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "sound/upd1771.h"
 
 class DivPlatformSCV: public DivDispatch {
@@ -38,13 +38,8 @@ class DivPlatformSCV: public DivDispatch {
   Channel chan[4];
   DivDispatchOscBuffer* oscBuf[4];
   bool isMuted[4];
-  struct QueuedWrite {
-    unsigned char addr;
-    unsigned char val;
-    QueuedWrite(): addr(0), val(9) {}
-    QueuedWrite(unsigned char a, unsigned char v): addr(a), val(v) {}
-  };
-  FixedQueue<QueuedWrite,512> writes;
+  typedef DivQueuedWrite<unsigned char,unsigned char> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,512> writes;
   DivPitchTable pitchTable, wavePitchTable;
 
   int curChan;
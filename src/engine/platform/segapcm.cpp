@@ -25,6 +25,12 @@
 
 #define rWrite(a,v) if (!skipRegisterWrites) {writes.push(QueuedWrite(a,v)); if (dumpWrites) {addWrite(a,v);} }
 #define chWrite(c,a,v) rWrite(((isDiscrete?0x40:0)|((c)<<3))+(a),v)
+// only writes if the value differs from the last one (when insShadow is enabled)
+#define chWriteShadow(c,a,v) \
+  if (!insShadow || chan[c].regShadow[a]!=(v)) { \
+    chWrite(c,a,v); \
+    if (!skipRegisterWrites) chan[c].regShadow[a]=(v); \
+  }
 #define bankWrite(c,v,b) rWrite(((isDiscrete?0x40:0)|((c)<<3))+(0x86),v+((b)<<(bankShift)))
 
 #define CHIP_FREQBASE 32768
@@ -148,14 +154,14 @@ void DivPlatformSegaPCM::tick(bool sysTick) {
           bankWrite(i,3,((actualPos>>16)));
           chWrite(i,0x84,(actualPos)&0xff);
           chWrite(i,0x85,(actualPos>>8)&0xff);
-          chWrite(i,6,sampleEndSegaPCM[chan[i].pcm.sample]);
+          chWriteShadow(i,6,sampleEndSegaPCM[chan[i].pcm.sample]);
           if (!s->isLoopable()) {
             bankWrite(i,2,(actualPos>>16));
           } else {
             int loopPos=(sampleOffSegaPCM[chan[i].pcm.sample]&0xffff)+loopStart;
             logV("sampleOff: %x loopPos: %x",actualPos,loopPos);
-            chWrite(i,4,loopPos&0xff);
-            chWrite(i,5,(loopPos>>8)&0xff);
+            chWriteShadow(i,4,loopPos&0xff);
+            chWriteShadow(i,5,(loopPos>>8)&0xff);
             bankWrite(i,0,(actualPos>>16));
           }
         }
@@ -347,6 +353,7 @@ int DivPlatformSegaPCM::dispatch(DivCommand c) {
 void DivPlatformSegaPCM::forceIns() {
   for (int i=0; i<maxChans; i++) {
     chan[i].insChanged=true;
+    memset(chan[i].regShadow,-1,sizeof(chan[i].regShadow));
 
     chWrite(i,2,chan[i].chVolL);
     chWrite(i,3,chan[i].chVolR);
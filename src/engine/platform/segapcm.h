@@ -23,7 +23,7 @@
 #include "../dispatch.h"
 #include "../instrument.h"
 #include "sound/segapcm.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 
 class DivPlatformSegaPCM: public DivDispatch {
   protected:
@@ -32,6 +32,9 @@ class DivPlatformSegaPCM: public DivDispatch {
       unsigned char chVolL, chVolR;
       unsigned char chPanL, chPanR;
       int macroVolMul;
+      // last values written to the end/loop registers (-1 if unknown).
+      // used to skip rewriting them when the same sample is triggered again.
+      short regShadow[8];
 
       struct PCMChannel {
         int sample;
@@ -49,20 +52,16 @@ class DivPlatformSegaPCM: public DivDispatch {
         chPanL(127),
         chPanR(127),
         macroVolMul(64),
-        pcm(PCMChannel()) {}
+        pcm(PCMChannel()) {
+        memset(regShadow,-1,sizeof(regShadow));
+      }
     };
     Channel chan[16];
     DivDispatchOscBuffer* oscBuf[16];
     unsigned char* sampleMem;
     size_t sampleMemLen;
-    struct QueuedWrite {
-      unsigned short addr;
-      unsigned char val;
-      bool addrOrVal;
-      QueuedWrite(): addr(0), val(0), addrOrVal(false) {}
-      QueuedWrite(unsigned short a, unsigned char v): addr(a), val(v), addrOrVal(false) {}
-    };
-    FixedQueue<QueuedWrite,1024> writes;
+    typedef DivQueuedWrite<unsigned short,unsigned char> QueuedWrite;
+    DivRegWriteQueue<QueuedWrite,1024> writes;
     segapcm_device pcm;
     DivPitchTableManager samplePitchTable;
     int delay;
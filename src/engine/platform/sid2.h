@@ -21,7 +21,7 @@
 #define _SID2_H
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "sound/sid2/sid.h"
 
 class DivPlatformSID2: public DivDispatch {
@@ -70,13 +70,8 @@ class DivPlatformSID2: public DivDispatch {
   float fakeLow[3];
   float fakeBand[3];
   float fakeCutTable[4096];
-  struct QueuedWrite {
-      unsigned char addr;
-      unsigned char val;
-      QueuedWrite(): addr(0), val(0) {}
-      QueuedWrite(unsigned char a, unsigned char v): addr(a), val(v) {}
-  };
-  FixedQueue<QueuedWrite,128> writes;
+  typedef DivQueuedWrite<unsigned char,unsigned char> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,128> writes;
   DivPitchTable pitchTable;
 
   unsigned char writeOscBuf;
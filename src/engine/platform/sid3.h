@@ -21,7 +21,7 @@
 #define _SID3_H
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "../waveSynth.h"
 #include "sound/sid3.h"
 
@@ -223,13 +223,8 @@ class DivPlatformSID3: public DivDispatch {
   };
   Channel chan[SID3_NUM_CHANNELS];
   DivDispatchOscBuffer* oscBuf[SID3_NUM_CHANNELS];
-  struct QueuedWrite {
-      unsigned short addr;
-      unsigned char val;
-      QueuedWrite(): addr(0), val(0) {}
-      QueuedWrite(unsigned short a, unsigned char v): addr(a), val(v) {}
-  };
-  FixedQueue<QueuedWrite,SID3_NUM_REGISTERS * 4> writes;
+  typedef DivQueuedWrite<unsigned short,unsigned char> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,SID3_NUM_REGISTERS * 4> writes;
   DivWaveSynth ws;
   DivPitchTable pitchTable;
   DivPitchTableManager samplePitchTable;
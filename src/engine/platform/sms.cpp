@@ -121,8 +121,7 @@ void DivPlatformSMS::acquire_nuked(short** buf, size_t len) {
 void DivPlatformSMS::acquire_mame(blip_buffer_t** bb, size_t len) {
   thread_local short outs[2];
 
-  while (!writes.empty()) {
-    QueuedWrite w=writes.front();
+  writes.flush([this](QueuedWrite& w) {
     if (stereo && (w.addr==1))
       sn->stereo_w(w.val);
     else if (w.addr==0) {
@@ -130,9 +129,7 @@ void DivPlatformSMS::acquire_mame(blip_buffer_t** bb, size_t len) {
     }
 
     poolWrite(w.addr,w.val);
-
-    writes.pop();
-  }
+  });
 
   for (int i=0; i<4; i++) {
     oscBuf[i]->begin(len);
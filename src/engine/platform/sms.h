@@ -25,7 +25,7 @@
 extern "C" {
   #include "../../../extern/Nuked-PSG/ympsg.h"
 }
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 
 class DivPlatformSMS: public DivDispatch {
   struct Channel: public SharedChannel {
@@ -56,14 +56,8 @@ class DivPlatformSMS: public DivDispatch {
   bool easyNoise;
   sn76496_base_device* sn;
   ympsg_t sn_nuked;
-  struct QueuedWrite {
-    unsigned short addr;
-    unsigned char val;
-    bool addrOrVal;
-    QueuedWrite(): addr(0), val(0), addrOrVal(false) {}
-    QueuedWrite(unsigned short a, unsigned char v): addr(a), val(v), addrOrVal(false) {}
-  };
-  FixedQueue<QueuedWrite,128> writes;
+  typedef DivQueuedWrite<unsigned short,unsigned char> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,128> writes;
   DivPitchTable tonePitchTable, noisePitchTable;
   friend void putDispatchChip(void*,int);
   friend void putDispatchChan(void*,int,int);
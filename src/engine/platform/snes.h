@@ -22,7 +22,7 @@
 
 #include "../dispatch.h"
 #include "../waveSynth.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "sound/snes/SPC_DSP.h"
 
 class DivPlatformSNES: public DivDispatch {
@@ -88,7 +88,7 @@ class DivPlatformSNES: public DivDispatch {
     QueuedWrite(): addr(0), val(0), delay(0), padding(0) {}
     QueuedWrite(unsigned char a, unsigned char v, unsigned char d=0): addr(a), val(v), delay(d), padding(0) {}
   };
-  FixedQueue<QueuedWrite,256> writes;
+  DivRegWriteQueue<QueuedWrite,256> writes;
 
   signed char sampleMem[65536];
   signed char copyOfSampleMem[65536];
@@ -66,6 +66,11 @@ void DivPlatformSoundUnit::writeControlUpper(int ch) {
 }
 
 void DivPlatformSoundUnit::tick(bool sysTick) {
+  // sub-ticks elapsed since the last call
+  int elapsed=(int)(parent->subTickClock-lastSubTickClock);
+  lastSubTickClock=parent->subTickClock;
+  if (elapsed<1) elapsed=1;
+
   for (int i=0; i<8; i++) {
     chan[i].std.next();
     if (sysTick) {
@@ -154,8 +159,10 @@ void DivPlatformSoundUnit::tick(bool sysTick) {
     }
 
     // run hardware sequence
+    // (the wait time is counted in sub-ticks, which may have passed without a tick)
     if (chan[i].active) {
-      if (--chan[i].hwSeqDelay<=0) {
+      if (chan[i].hwSeqDelay>0) chan[i].hwSeqDelay-=elapsed;
+      if (chan[i].hwSeqDelay<=0) {
         chan[i].hwSeqDelay=0;
         DivInstrument* ins=parent->getIns(chan[i].ins,DIV_INS_SU);
         int hwSeqCount=0;
@@ -222,7 +229,10 @@ void DivPlatformSoundUnit::tick(bool sysTick) {
           if (leave) break;
           hwSeqCount++;
         }
+        // continue on the next sub-tick if we ran out of commands for this one
+        if (hwSeqCount>=8) parent->wakeDispatchIn(1);
       }
+      if (chan[i].hwSeqDelay>0) parent->wakeDispatchIn(chan[i].hwSeqDelay);
     }
 
     if (chan[i].freqChanged || chan[i].keyOn || chan[i].keyOff) {
@@ -582,6 +592,7 @@ int DivPlatformSoundUnit::getRegisterPoolSize() {
 }
 
 void DivPlatformSoundUnit::reset() {
+  lastSubTickClock=parent->subTickClock;
   while (!writes.empty()) writes.pop();
   memset(regPool,0,128);
   for (int i=0; i<8; i++) {
@@ -21,7 +21,7 @@
 #define _SU_H
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "sound/su.h"
 
 class DivPlatformSoundUnit: public DivDispatch {
@@ -82,13 +82,8 @@ class DivPlatformSoundUnit: public DivDispatch {
   Channel chan[8];
   DivDispatchOscBuffer* oscBuf[8];
   bool isMuted[8];
-  struct QueuedWrite {
-    unsigned char addr;
-    unsigned char val;
-    QueuedWrite(): addr(0), val(0) {}
-    QueuedWrite(unsigned char a, unsigned char v): addr(a), val(v) {}
-  };
-  FixedQueue<QueuedWrite,512> writes;
+  typedef DivQueuedWrite<unsigned char,unsigned char> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,512> writes;
   DivPitchTable pitchTable;
   DivPitchTableManager samplePitchTable;
   DivPitchTable roleSwitchedPitchTable;
@@ -102,6 +97,7 @@ class DivPlatformSoundUnit: public DivDispatch {
   bool* sampleLoaded;
 
   int cycles, curChan, delay, sysIDCache;
+  unsigned int lastSubTickClock;
   short tempL;
   short tempR;
   unsigned char lfoMode, lfoSpeed;
@@ -102,6 +102,59 @@ void DivPlatformSupervision::acquire(short** buf, size_t len) {
   }
 }
 
+void DivPlatformSupervision::acquireDirect(blip_buffer_t** bb, size_t len) {
+  int mask_bits=0;
+  for (int i=0; i<4; i++) {
+    mask_bits |= isMuted[i]?0:8>>i;
+  }
+  supervision_set_mute_mask(&svision,mask_bits);
+
+  for (int i=0; i<4; i++) {
+    oscBuf[i]->begin(len);
+  }
+
+  for (size_t h=0; h<len; h++) {
+    while (!writes.empty()) {
+      QueuedWrite w=writes.front();
+      supervision_memorymap_registers_write(&svision,w.addr|0x2000,w.val);
+      regPool[w.addr&0x3f]=w.val;
+      writes.pop();
+    }
+
+    unsigned char s[6];
+    supervision_sound_stream_update(&svision,s,2);
+    int out[2]={
+      (((int)s[0])-128)*256,
+      (((int)s[1])-128)*256
+    };
+
+    for (int i=0; i<4; i++) {
+      oscBuf[i]->putSample(h,CLAMP(((int)s[2+i])<<8,-32768,32767));
+    }
+
+    for (int i=0; i<2; i++) {
+      out[i]=CLAMP((out[i]>>1)+(out[i]>>2),-32768,32767);
+    }
+
+    if (dcOffPending) {
+      // the first sample after a reset sets the DC offset
+      dcOffPending=false;
+      lastOut[0]=out[0];
+      lastOut[1]=out[1];
+    }
+    for (int i=0; i<2; i++) {
+      if (out[i]!=lastOut[i]) {
+        blip_add_delta(bb[i],h,out[i]-lastOut[i]);
+        lastOut[i]=out[i];
+      }
+    }
+  }
+
+  for (int i=0; i<4; i++) {
+    oscBuf[i]->end(len);
+  }
+}
+
 void DivPlatformSupervision::tick(bool sysTick) {
   for (int i=0; i<4; i++) {
     chan[i].std.next();
@@ -483,6 +536,13 @@ void DivPlatformSupervision::reset() {
   memset(noiseReg,0,3*sizeof(unsigned char));
   noiseReg[2]=0xff;
   sampleOffset=0;
+  lastOut[0]=0;
+  lastOut[1]=0;
+  dcOffPending=parent->getConfBool("audioHiPass",true);
+}
+
+bool DivPlatformSupervision::hasAcquireDirect() {
+  return true;
 }
 
 int DivPlatformSupervision::getOutputCount() {
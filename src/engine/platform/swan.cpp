@@ -59,43 +59,47 @@ const char** DivPlatformSwan::getRegisterSheet() {
 }
 
 // asiekierka
+void DivPlatformSwan::runSample() {
+  // PCM
+  if (pcm && dacSample!=-1) {
+    dacPeriod+=dacRate;
+    while (dacPeriod>=rate) {
+      DivSample* s=parent->getSample(dacSample);
+      if (s->samples<=0 || dacPos>=s->samples) {
+        dacSample=-1;
+        dacPeriod=0;
+        break;
+      }
+      rWrite(0x09,(unsigned char)s->data8[dacPos++]+0x80);
+      if (s->isLoopable() && dacPos>=(unsigned int)s->loopEnd) {
+        dacPos=s->loopStart;
+      } else if (dacPos>=s->samples) {
+        dacSample=-1;
+      }
+      dacPeriod-=rate;
+    }
+  }
+
+  // Register writes 
+  while (!writes.empty()) {
+    QueuedWrite w=writes.front();
+    if (w.addr < 0x40) {
+      swan_sound_out(&ws, w.addr|0x80, w.val);
+    } else {
+      ws.wave_ram[w.addr & 0x3f] = w.val;
+      regPool[w.addr]=w.val;
+    }
+    writes.pop();
+  }
+}
+
 void DivPlatformSwan::acquire(short** buf, size_t len) {
   for (int i=0; i<4; i++) {
     oscBuf[i]->begin(len);
   }
 
   for (size_t h=0; h<len; h++) {
-    // PCM
-    if (pcm && dacSample!=-1) {
-      dacPeriod+=dacRate;
-      while (dacPeriod>=rate) {
-        DivSample* s=parent->getSample(dacSample);
-        if (s->samples<=0 || dacPos>=s->samples) {
-          dacSample=-1;
-          dacPeriod=0;
-          break;
-        }
-        rWrite(0x09,(unsigned char)s->data8[dacPos++]+0x80);
-        if (s->isLoopable() && dacPos>=(unsigned int)s->loopEnd) {
-          dacPos=s->loopStart;
-        } else if (dacPos>=s->samples) {
-          dacSample=-1;
-        }
-        dacPeriod-=rate;
-      }
-    }
-
-    // Register writes 
-    while (!writes.empty()) {
-      QueuedWrite w=writes.front();
-      if (w.addr < 0x40) {
-        swan_sound_out(&ws, w.addr|0x80, w.val);
-      } else {
-        ws.wave_ram[w.addr & 0x3f] = w.val;
-        regPool[w.addr]=w.val;
-      }
-      writes.pop();
-    }
+    runSample();
 
     swan_sound_tick(&ws, chipClock / rate);
     swan_sound_sample(&ws);
@@ -122,6 +126,47 @@ void DivPlatformSwan::acquire(short** buf, size_t len) {
   }
 }
 
+void DivPlatformSwan::acquireDirect(blip_buffer_t** bb, size_t len) {
+  for (int i=0; i<4; i++) {
+    oscBuf[i]->begin(len);
+  }
+
+  for (size_t h=0; h<len; h++) {
+    runSample();
+
+    swan_sound_tick(&ws, chipClock / rate);
+    swan_sound_sample(&ws);
+
+    for (int i = 0; i < 4; i++) {
+      if (isMuted[i]) {
+        oscBuf[i]->putSample(h, 0);
+      } else {
+        oscBuf[i]->putSample(h, (ws.ch_output_left[i] + ws.ch_output_right[i]) << 5);
+      }
+    }
+
+    if (stereo) {
+      const int out[2]={ws.output_left,ws.output_right};
+      for (int i=0; i<2; i++) {
+        if (out[i]!=lastOut[i]) {
+          blip_add_delta(bb[i],h,out[i]-lastOut[i]);
+          lastOut[i]=out[i];
+        }
+      }
+    } else {
+      const int out=((int)ws.output_speaker-0x80)<<8;
+      if (out!=lastOut[0]) {
+        blip_add_delta(bb[0],h,out-lastOut[0]);
+        lastOut[0]=out;
+      }
+    }
+  }
+
+  for (int i=0; i<4; i++) {
+    oscBuf[i]->end(len);
+  }
+}
+
 void DivPlatformSwan::updateWave(int ch) {
   unsigned char addr=0x40+ch*16;
   for (int i=0; i<16; i++) {
@@ -562,6 +607,8 @@ int DivPlatformSwan::getRegisterPoolSize() {
 
 void DivPlatformSwan::reset() {
   while (!writes.empty()) writes.pop();
+  lastOut[0]=0;
+  lastOut[1]=0;
   while (!postDACWrites.empty()) postDACWrites.pop();
   memset(regPool,0,sizeof(regPool));
   for (int i=0; i<4; i++) {
@@ -590,6 +637,10 @@ void DivPlatformSwan::reset() {
   rWrite(0x11,0x0f); // enable speakers, minimum headphone volume 
 }
 
+bool DivPlatformSwan::hasAcquireDirect() {
+  return true;
+}
+
 int DivPlatformSwan::getOutputCount() {
   return (stereo)?2:1;
 }
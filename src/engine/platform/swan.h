@@ -24,6 +24,7 @@
 #include "../waveSynth.h"
 #include "sound/swan.h"
 #include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 
 class DivPlatformSwan: public DivDispatch {
   struct Channel: public SharedChannel {
@@ -38,6 +39,7 @@ class DivPlatformSwan: public DivDispatch {
   Channel chan[4];
   DivDispatchOscBuffer* oscBuf[4];
   bool isMuted[4];
+  int lastOut[2];
   bool stereo;
   bool pcm, sweep, setPos;
   unsigned char noise;
@@ -46,13 +48,8 @@ class DivPlatformSwan: public DivDispatch {
   int dacSample;
 
   unsigned char regPool[0x80];
-  struct QueuedWrite {
-    unsigned char addr;
-    unsigned char val;
-    QueuedWrite(): addr(0), val(0) {}
-    QueuedWrite(unsigned char a, unsigned char v): addr(a), val(v) {}
-  };
-  FixedQueue<QueuedWrite,256> writes;
+  typedef DivQueuedWrite<unsigned char,unsigned char> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,256> writes;
   FixedQueue<DivRegWrite,2048> postDACWrites;
   DivPitchTable pitchTable;
   DivPitchTableManager samplePitchTable;
@@ -62,10 +59,12 @@ class DivPlatformSwan: public DivDispatch {
   void updateWave(int ch);
   void calcAndWriteOutVol(int ch, int env);
   void writeOutVol(int ch);
+  void runSample();
   friend void putDispatchChip(void*,int);
   friend void putDispatchChan(void*,int,int);
   public:
     void acquire(short** buf, size_t len);
+    void acquireDirect(blip_buffer_t** bb, size_t len);
     int dispatch(DivCommand c);
     SharedChannel* getChanState(int chan);
     DivMacroInt* getChanMacroInt(int ch);
@@ -84,6 +83,7 @@ class DivPlatformSwan: public DivDispatch {
     void notifyPitchTable(int sample=-1);
     unsigned int getMaxFreq(int ch);
     int getOutputCount();
+    bool hasAcquireDirect();
     bool hasSoftPan(int ch);
     void poke(unsigned int addr, unsigned short val);
     void poke(std::vector<DivRegWrite>& wlist);
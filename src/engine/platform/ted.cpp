@@ -62,6 +62,34 @@ void DivPlatformTED::acquire(short** buf, size_t len) {
   }
 }
 
+void DivPlatformTED::acquireDirect(blip_buffer_t** bb, size_t len) {
+  for (int i=0; i<2; i++) {
+    oscBuf[i]->begin(len);
+  }
+
+  for (size_t h=0; h<len; h++) {
+    while (!writes.empty()) {
+      QueuedWrite w=writes.front();
+      ted_sound_machine_store(&ted,w.addr,w.val);
+      regPool[(w.addr-0x0e)&7]=w.val;
+      writes.pop();
+    }
+
+    short out;
+    ted_sound_machine_calculate_samples(&ted,&out,1,1);
+    if (out!=lastOut) {
+      blip_add_delta(bb[0],h,out-lastOut);
+      lastOut=out;
+    }
+    oscBuf[0]->putSample(h,(ted.voice0_output_enabled && ted.voice0_sign)?(ted.volume<<1):0);
+    oscBuf[1]->putSample(h,(ted.voice1_output_enabled && ((ted.noise && (!(ted.noise_shift_register&1))) || (!ted.noise && ted.voice1_sign)))?(ted.volume<<1):0);
+  }
+
+  for (int i=0; i<2; i++) {
+    oscBuf[i]->end(len);
+  }
+}
+
 void DivPlatformTED::tick(bool sysTick) {
   bool resetPhase=false;
 
@@ -302,6 +330,7 @@ int DivPlatformTED::getRegisterPoolSize() {
 
 void DivPlatformTED::reset() {
   writes.clear();
+  lastOut=0;
   memset(regPool,0,8);
   for (int i=0; i<2; i++) {
     chan[i]=DivPlatformTED::Channel(parent->song.compatFlags.linearPitch);
@@ -319,6 +348,10 @@ void DivPlatformTED::reset() {
   chanOrder[1]=1;
 }
 
+bool DivPlatformTED::hasAcquireDirect() {
+  return true;
+}
+
 int DivPlatformTED::getOutputCount() {
   return 1;
 }
@@ -21,7 +21,7 @@
 #define _TED_H
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "sound/ted-sound.h"
 
 class DivPlatformTED: public DivDispatch {
@@ -35,13 +35,9 @@ class DivPlatformTED: public DivDispatch {
   Channel chan[2];
   DivDispatchOscBuffer* oscBuf[2];
   bool isMuted[2];
-  struct QueuedWrite {
-    unsigned char addr;
-    unsigned char val;
-    QueuedWrite(): addr(0), val(0) {}
-    QueuedWrite(unsigned char a, unsigned char v): addr(a), val(v) {}
-  };
-  FixedQueue<QueuedWrite,64> writes;
+  int lastOut;
+  typedef DivQueuedWrite<unsigned char,unsigned char> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,64> writes;
   DivPitchTable pitchTable;
 
   struct plus4_sound_s ted;
@@ -54,6 +50,7 @@ class DivPlatformTED: public DivDispatch {
   friend void putDispatchChan(void*,int,int);
   public:
     void acquire(short** buf, size_t len);
+    void acquireDirect(blip_buffer_t** bb, size_t len);
     int dispatch(DivCommand c);
     bool isVolGlobal();
     SharedChannel* getChanState(int chan);
@@ -66,6 +63,7 @@ class DivPlatformTED: public DivDispatch {
     void tick(bool sysTick=true);
     void muteChannel(int ch, bool mute);
     int getOutputCount();
+    bool hasAcquireDirect();
     bool keyOffAffectsArp(int ch);
     void setFlags(const DivConfig& flags);
     void notifyInsDeletion(void* ins);
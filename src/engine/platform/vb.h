@@ -21,7 +21,7 @@
 #define _PLATFORM_VB_H
 
 #include "../dispatch.h"
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "../waveSynth.h"
 #include "sound/vsu.h"
 
@@ -51,13 +51,8 @@ class DivPlatformVB: public DivDispatch {
   bool isMuted[6];
   bool antiClickEnabled, screwThis;
   DivPitchTable pitchTable;
-  struct QueuedWrite {
-    unsigned short addr;
-    unsigned char val;
-    QueuedWrite(): addr(0), val(0) {}
-    QueuedWrite(unsigned short a, unsigned char v): addr(a), val(v) {}
-  };
-  FixedQueue<QueuedWrite,2048> writes;
+  typedef DivQueuedWrite<unsigned short,unsigned char> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,2048> writes;
   unsigned char lastPan;
 
   int cycles, curChan, delay;
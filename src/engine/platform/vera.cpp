@@ -57,6 +57,54 @@ const char** DivPlatformVERA::getRegisterSheet() {
 }
 
 // TODO: possible sample offset latency...
+void DivPlatformVERA::feedPCM(DivSample* s) {
+  if (s->samples>0 && chan[16].pcm.pos<s->samples) {
+    while (pcm_is_fifo_almost_empty(pcm)) {
+      short tmp_l=0;
+      short tmp_r=0;
+      if (!isMuted[16]) {
+        // TODO stereo samples once DivSample has a support for it
+        if (chan[16].pcm.depth16) {
+          if (chan[16].pcm.pos<s->samples) {
+            tmp_l=s->data16[chan[16].pcm.pos];
+          } else {
+            tmp_l=0;
+          }
+          tmp_r=tmp_l;
+        } else {
+          if (chan[16].pcm.pos<s->samples) {
+            tmp_l=s->data8[chan[16].pcm.pos];
+          } else {
+            tmp_l=0;
+          }
+          tmp_r=tmp_l;
+        }
+        if (!(chan[16].pan&1)) tmp_l=0;
+        if (!(chan[16].pan&2)) tmp_r=0;
+      }
+      if (chan[16].pcm.depth16) {
+        rWritePCMData(tmp_l&0xff);
+        rWritePCMData((tmp_l>>8)&0xff);
+        rWritePCMData(tmp_r&0xff);
+        rWritePCMData((tmp_r>>8)&0xff);
+      } else {
+        rWritePCMData(tmp_l&0xff);
+        rWritePCMData(tmp_r&0xff);
+      }
+      chan[16].pcm.pos++;
+      if (s->isLoopable() && chan[16].pcm.pos>=(unsigned int)s->loopEnd) {
+        chan[16].pcm.pos=s->loopStart;
+      } else if (chan[16].pcm.pos>=s->samples) {
+        chan[16].pcm.sample=-1;
+        break;
+      }
+    }
+  } else {
+    // just let the buffer run out
+    chan[16].pcm.sample=-1;
+  }
+}
+
 void DivPlatformVERA::acquire(short** buf, size_t len) {
   for (int i=0; i<17; i++) {
     oscBuf[i]->begin(len);
@@ -69,51 +117,7 @@ void DivPlatformVERA::acquire(short** buf, size_t len) {
   size_t lenCopy=len;
   DivSample* s=parent->getSample(chan[16].pcm.sample);
   while (lenCopy>0) {
-    if (s->samples>0 && chan[16].pcm.pos<s->samples) {
-      while (pcm_is_fifo_almost_empty(pcm)) {
-        short tmp_l=0;
-        short tmp_r=0;
-        if (!isMuted[16]) {
-          // TODO stereo samples once DivSample has a support for it
-          if (chan[16].pcm.depth16) {
-            if (chan[16].pcm.pos<s->samples) {
-              tmp_l=s->data16[chan[16].pcm.pos];
-            } else {
-              tmp_l=0;
-            }
-            tmp_r=tmp_l;
-          } else {
-            if (chan[16].pcm.pos<s->samples) {
-              tmp_l=s->data8[chan[16].pcm.pos];
-            } else {
-              tmp_l=0;
-            }
-            tmp_r=tmp_l;
-          }
-          if (!(chan[16].pan&1)) tmp_l=0;
-          if (!(chan[16].pan&2)) tmp_r=0;
-        }
-        if (chan[16].pcm.depth16) {
-          rWritePCMData(tmp_l&0xff);
-          rWritePCMData((tmp_l>>8)&0xff);
-          rWritePCMData(tmp_r&0xff);
-          rWritePCMData((tmp_r>>8)&0xff);
-        } else {
-          rWritePCMData(tmp_l&0xff);
-          rWritePCMData(tmp_r&0xff);
-        }
-        chan[16].pcm.pos++;
-        if (s->isLoopable() && chan[16].pcm.pos>=(unsigned int)s->loopEnd) {
-          chan[16].pcm.pos=s->loopStart;
-        } else if (chan[16].pcm.pos>=s->samples) {
-          chan[16].pcm.sample=-1;
-          break;
-        }
-      }
-    } else {
-      // just let the buffer run out
-      chan[16].pcm.sample=-1;
-    }
+    feedPCM(s);
     int curLen=MIN(lenCopy,128);
     memset(whyCallItBuf,0,sizeof(whyCallItBuf));
     pcm_render(pcm,whyCallItBuf[2],whyCallItBuf[3],curLen);
@@ -141,7 +145,52 @@ void DivPlatformVERA::acquire(short** buf, size_t len) {
   }
 }
 
+void DivPlatformVERA::acquireDirect(blip_buffer_t** bb, size_t len) {
+  for (int i=0; i<17; i++) {
+    oscBuf[i]->begin(len);
+  }
+
+  short whyCallItBuf[4][128];
+  size_t pos=0;
+  size_t lenCopy=len;
+  DivSample* s=parent->getSample(chan[16].pcm.sample);
+  while (lenCopy>0) {
+    feedPCM(s);
+    int curLen=MIN(lenCopy,128);
+    memset(whyCallItBuf,0,sizeof(whyCallItBuf));
+    pcm_render(pcm,whyCallItBuf[2],whyCallItBuf[3],curLen);
+    for (int i=0; i<curLen; i++) {
+      psg_render(psg,&whyCallItBuf[0][i],&whyCallItBuf[1][i],1);
+      for (int j=0; j<2; j++) {
+        const int out=(short)(((int)whyCallItBuf[j][i]+whyCallItBuf[2+j][i])/2);
+        if (out!=lastOut[j]) {
+          blip_add_delta(bb[j],pos,out-lastOut[j]);
+          lastOut[j]=out;
+        }
+      }
+
+      for (int j=0; j<16; j++) {
+        oscBuf[j]->putSample(pos,psg->channels[j].lastOut);
+      }
+
+      int pcmOut=(whyCallItBuf[2][i]+whyCallItBuf[3][i])>>1;
+      if (pcmOut<-32768) pcmOut=-32768;
+      if (pcmOut>32767) pcmOut=32767;
+      oscBuf[16]->putSample(pos,pcmOut);
+
+      pos++;
+    }
+    lenCopy-=curLen;
+  }
+
+  for (int i=0; i<17; i++) {
+    oscBuf[i]->end(len);
+  }
+}
+
 void DivPlatformVERA::reset() {
+  lastOut[0]=0;
+  lastOut[1]=0;
   for (int i=0; i<17; i++) {
     chan[i]=Channel();
     chan[i].std.setEngine(parent);
@@ -489,6 +538,10 @@ float DivPlatformVERA::getPostAmp() {
   return 4.0f;
 }
 
+bool DivPlatformVERA::hasAcquireDirect() {
+  return true;
+}
+
 int DivPlatformVERA::getOutputCount() {
   return 2;
 }
@@ -51,17 +51,21 @@ class DivPlatformVERA: public DivDispatch {
     Channel chan[17];
     DivDispatchOscBuffer* oscBuf[17];
     bool isMuted[17];
+    int lastOut[2];
     unsigned char regPool[69];
     DivPitchTable pitchTable;
     DivPitchTableManager samplePitchTable;
     struct VERA_PSG* psg;
     struct VERA_PCM* pcm;
+
+    void feedPCM(DivSample* s);
   
     friend void putDispatchChip(void*,int);
     friend void putDispatchChan(void*,int,int);
   
   public:
     void acquire(short** buf, size_t len);
+    void acquireDirect(blip_buffer_t** bb, size_t len);
     int dispatch(DivCommand c);
     SharedChannel* getChanState(int chan);
     DivMacroInt* getChanMacroInt(int ch);
@@ -79,6 +83,7 @@ class DivPlatformVERA: public DivDispatch {
     unsigned int getMaxFreq(int ch);
     float getPostAmp();
     int getOutputCount();
+    bool hasAcquireDirect();
     void poke(unsigned int addr, unsigned short val);
     void poke(std::vector<DivRegWrite>& wlist);
     const char** getRegisterSheet();
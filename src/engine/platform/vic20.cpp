@@ -40,36 +40,38 @@ const char** DivPlatformVIC20::getRegisterSheet() {
   return regCheatSheetVIC;
 }
 
-void DivPlatformVIC20::acquire(short** buf, size_t len) {
+void DivPlatformVIC20::runWaveWrite() {
   const unsigned char loadFreq[3] = {0x7e, 0x7d, 0x7b};
   const unsigned char wavePatterns[16] = {
     0b0,     0b10,    0b100,   0b110,   0b1000,  0b1010,   0b1011,   0b1110,
     0b10010, 0b10100, 0b10110, 0b11000, 0b11010, 0b100100, 0b101010, 0b101100
   };
 
+  hasWaveWrite=false;
+  for (int i=0; i<3; i++) {
+    if (chan[i].waveWriteCycle>=0) {
+      if (chan[i].waveWriteCycle>=16*7) {
+        // empty shift register first
+        rWrite(10+i,126);
+      } else if (chan[i].waveWriteCycle>=16) {
+        unsigned bit=8-(chan[i].waveWriteCycle/16);
+        rWrite(10+i,loadFreq[i]|((wavePatterns[chan[i].wave]<<bit)&0x80));
+      } else {
+        rWrite(10+i,255-chan[i].freq);
+      }
+      chan[i].waveWriteCycle-=SAMP_DIVIDER;
+      hasWaveWrite=true;
+    }
+  }
+}
+
+void DivPlatformVIC20::acquire(short** buf, size_t len) {
   for (int i=0; i<4; i++) {
     oscBuf[i]->begin(len);
   }
 
   for (size_t h=0; h<len; h++) {
-    if (hasWaveWrite) {
-      hasWaveWrite=false;
-      for (int i=0; i<3; i++) {
-        if (chan[i].waveWriteCycle>=0) {
-          if (chan[i].waveWriteCycle>=16*7) {
-            // empty shift register first
-            rWrite(10+i,126);
-          } else if (chan[i].waveWriteCycle>=16) {
-            unsigned bit=8-(chan[i].waveWriteCycle/16);
-            rWrite(10+i,loadFreq[i]|((wavePatterns[chan[i].wave]<<bit)&0x80));
-          } else {
-            rWrite(10+i,255-chan[i].freq);
-          }
-          chan[i].waveWriteCycle-=SAMP_DIVIDER;
-          hasWaveWrite=true;
-        }
-      }
-    }
+    if (hasWaveWrite) runWaveWrite();
     short samp;
     vic_sound_machine_calculate_samples(vic,&samp,1,1,0,SAMP_DIVIDER);
     buf[0][h]=samp;
@@ -83,6 +85,29 @@ void DivPlatformVIC20::acquire(short** buf, size_t len) {
   }
 }
 
+void DivPlatformVIC20::acquireDirect(blip_buffer_t** bb, size_t len) {
+  for (int i=0; i<4; i++) {
+    oscBuf[i]->begin(len);
+  }
+
+  for (size_t h=0; h<len; h++) {
+    if (hasWaveWrite) runWaveWrite();
+    short samp;
+    vic_sound_machine_calculate_samples(vic,&samp,1,1,0,SAMP_DIVIDER);
+    if (samp!=lastOut) {
+      blip_add_delta(bb[0],h,samp-lastOut);
+      lastOut=samp;
+    }
+    for (int i=0; i<4; i++) {
+      oscBuf[i]->putSample(h,vic->ch[i].out?(vic->volume<<11):0);
+    }
+  }
+
+  for (int i=0; i<4; i++) {
+    oscBuf[i]->end(len);
+  }
+}
+
 void DivPlatformVIC20::calcAndWriteOutVol(int ch, int env) {
   chan[ch].outVol=MIN(chan[ch].vol*env/15,15);
   writeOutVol(ch);
@@ -327,6 +352,7 @@ int DivPlatformVIC20::getRegisterPoolSize() {
 
 void DivPlatformVIC20::reset() {
   memset(regPool,0,16);
+  lastOut=0;
   for (int i=0; i<4; i++) {
     chan[i]=Channel();
     chan[i].pitchTable=&pitchTable;
@@ -340,6 +366,10 @@ void DivPlatformVIC20::reset() {
   vic_sound_clock(vic,4);
 }
 
+bool DivPlatformVIC20::hasAcquireDirect() {
+  return true;
+}
+
 int DivPlatformVIC20::getOutputCount() {
   return 1;
 }
@@ -38,15 +38,18 @@ class DivPlatformVIC20: public DivDispatch {
   DivPitchTable pitchTable;
   bool isMuted[4];
   bool hasWaveWrite;
+  int lastOut;
   bool filterOff;
 
   unsigned char regPool[16];
   sound_vic20_t* vic;
   void updateWave(int ch);
+  void runWaveWrite();
   friend void putDispatchChip(void*,int);
   friend void putDispatchChan(void*,int,int);
   public:
     void acquire(short** buf, size_t len);
+    void acquireDirect(blip_buffer_t** bb, size_t len);
     int dispatch(DivCommand c);
     bool isVolGlobal();
     SharedChannel* getChanState(int chan);
@@ -63,6 +66,7 @@ class DivPlatformVIC20: public DivDispatch {
     void notifyPitchTable(int sample=-1);
     unsigned int getMaxFreq(int ch);
     int getOutputCount();
+    bool hasAcquireDirect();
     void poke(unsigned int addr, unsigned short val);
     void poke(std::vector<DivRegWrite>& wlist);
     const char** getRegisterSheet();
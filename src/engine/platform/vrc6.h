@@ -20,7 +20,7 @@
 #ifndef _VRC6_H
 #define _VRC6_H
 
-#include "../../fixedQueue.h"
+#include "regWriteQueue.h"
 #include "../dispatch.h"
 #include "vgsound_emu/src/vrcvi/vrcvi.hpp"
 
@@ -46,13 +46,8 @@ class DivPlatformVRC6: public DivDispatch, public vrcvi_intf {
   Channel chan[3];
   DivDispatchOscBuffer* oscBuf[3];
   bool isMuted[3];
-  struct QueuedWrite {
-    unsigned short addr;
-    unsigned char val;
-    QueuedWrite(): addr(0), val(0) {}
-    QueuedWrite(unsigned short a, unsigned char v): addr(a), val(v) {}
-  };
-  FixedQueue<QueuedWrite,64> writes;
+  typedef DivQueuedWrite<unsigned short,unsigned char> QueuedWrite;
+  DivRegWriteQueue<QueuedWrite,64> writes;
   DivPitchTable pitchTable, sawPitchTable;
   DivPitchTableManager samplePitchTable;
   vrcvi_core vrc6;
@@ -29,6 +29,7 @@
 #include "engine.h"
 #include "workPool.h"
 #include "../ta-log.h"
+#include "../rtAlloc.h"
 #include <math.h>
 
 // go to next order
@@ -520,9 +521,22 @@ int DivEngine::dispatchCmd(DivCommand c) {
   c.chan=song.dispatchChanOfChan[c.dis];
 
   // dispatch command to chip dispatch
+  disCont[song.dispatchOfChan[c.dis]].cmdPending=true;
   return disCont[song.dispatchOfChan[c.dis]].dispatch->dispatch(c);
 }
 
+void DivEngine::wakeDispatchIn(int subTicks) {
+  if (tickingDispatch<0 || tickMult<=1) return;
+  if (subTicks<1) subTicks=1;
+  DivDispatchContainer& dc=disCont[tickingDispatch];
+  unsigned int when=subTickClock+subTicks;
+  // keep the earliest request
+  if (!dc.wakePending || (int)(when-dc.wakeClock)<0) {
+    dc.wakeClock=when;
+    dc.wakePending=true;
+  }
+}
+
 // this function handles per-chip normal effects
 bool DivEngine::perSystemEffect(int ch, unsigned char effect, unsigned char effectVal) {
   // don't process invalid chips
@@ -2097,6 +2111,7 @@ bool DivEngine::nextTick(bool noAccum, bool inhibitLowLat) {
   } else {
     tickMult=1;
   }
+  subTickClock++;
 
   // set the number of samples between ticks (or sub-ticks in low-latency mode)
   cycles=got.rate/(divider*tickMult);
@@ -2667,10 +2682,7 @@ bool DivEngine::nextTick(bool noAccum, bool inhibitLowLat) {
     extValuePresent=false;
     stepPlay=0;
     remainingLoops=-1;
-    sPreview.sample=-1;
-    sPreview.wave=-1;
-    sPreview.pos=0;
-    sPreview.dir=false;
+    previewPool.execute(DivPreviewCommand());
     ret=true;
     shallStop=false;
     shallStopSched=false;
@@ -2686,7 +2698,21 @@ bool DivEngine::nextTick(bool noAccum, bool inhibitLowLat) {
   }
 
   // tick all chip dispatches (the argument determines whether it is a system tick or a sub-tick)
-  for (int i=0; i<song.systemLen; i++) disCont[i].dispatch->tick(subticks==tickMult);
+  // on a sub-tick, only the dispatches which received a command (e.g. a note played live) or have
+  // a macro step due (see wakeDispatchIn()) are ticked.
+  // macros and other tick-based processes catch up on the sub-ticks they missed (see subTickClock).
+  bool sysTick=(subticks==tickMult);
+  for (int i=0; i<song.systemLen; i++) {
+    DivDispatchContainer& dc=disCont[i];
+    bool wake=dc.wakePending && (int)(subTickClock-dc.wakeClock)>=0;
+    if (sysTick || dc.cmdPending || wake) {
+      dc.cmdPending=false;
+      dc.wakePending=false;
+      tickingDispatch=i;
+      dc.dispatch->tick(sysTick);
+      tickingDispatch=-1;
+    }
+  }
 
   // update playback time
   if (!freelance) {
@@ -2896,63 +2922,19 @@ void _runDispatch2(void* d) {
 
 }
 
-// this fills the audio buffer and runs tbe engine.
-// called by the audio backend and during audio export.
-void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsigned int size, bool calledFromExport) {
-  // clear the output
-  if (out!=NULL) {
-    for (int i=0; i<outChans; i++) {
-      memset(out[i],0,size*sizeof(float));
-    }
-  }
-
-  // quit if we're in the audio thread and currently exporting
-  if (exporting && !calledFromExport) {
-    return;
-  }
-
-  // check the mutex.
-  // soft-locking happens when synchronizedSoft is called.
-  if (softLocked) {
-    // in this case we just return
-    if (!isBusy.try_lock()) {
-      logV("audio is soft-locked (%d)",softLockCount++);
-      return;
-    }
-  } else {
-    isBusy.lock();
-  }
-  // debug information
-  lastNBIns=inChans;
-  lastNBOuts=outChans;
-  lastNBSize=size;
-
-  // don't fill a buffer if the size is 0
-  if (!size) {
-    logW("nextBuf called with size 0!");
-    isBusy.unlock();
-    return;
-  }
-  lastLoopPos=-1;
-
-  if (!calledFromExport) {
-    got.bufsize=size;
-  }
-
-  // this is used to calculate audio load
-  std::chrono::steady_clock::time_point ts_processBegin=std::chrono::steady_clock::now();
-
-  // set up the render thread pool
-  if (renderPool==NULL) {
-    unsigned int howManyThreads=song.systemLen;
-    if (howManyThreads<2) howManyThreads=0;
-    if (howManyThreads>renderPoolThreads) howManyThreads=renderPoolThreads;
-    renderPool=new DivWorkPool(howManyThreads);
-  }
-
-  // process MIDI input events
-  if (output) if (output->midiIn) while (!output->midiIn->queue.empty()) {
+// applies queued MIDI input events.
+// called by nextBuf() before each tick, so that events land close to where they arrived.
+void DivEngine::processMidiIn(int upTo) {
+  if (!output) return;
+  if (output->midiIn==NULL) return;
+  while (!output->midiIn->queue.empty()) {
     TAMidiMessage& msg=output->midiIn->queue.front();
+    // stop if this event belongs to a later position in the buffer
+    if (upTo>=0 && msg.time>0.0 && got.rate>0) {
+      double pos=(msg.time-midiInBufStart)*got.rate;
+      if (pos>=(double)midiInBufSize) pos=midiInBufSize-1;
+      if (pos>(double)upTo) break;
+    }
     // print MIDI events if MIDI debug is enabled
     if (midiDebug) {
       if (msg.type==TA_MIDI_SYSEX) {
@@ -3028,161 +3010,103 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
     //logD("%.2x",msg.type);
     output->midiIn->queue.pop();
   }
+}
 
-  // process sample/wave preview (not during audio export)
-  if (((sPreview.sample>=0 && sPreview.sample<(int)song.sample.size()) || (sPreview.wave>=0 && sPreview.wave<(int)song.wave.size())) && !exporting) {
-    // we use blip_buf to pitch the sample
-    unsigned int samp_bbOff=0;
-    // if there are samples, flush them (this can happen when the playback
-    // rate is less than the output rate)
-    unsigned int prevAvail=blip_samples_avail(samp_bb);
-    if (prevAvail>size) prevAvail=size;
-    if (prevAvail>0) {
-      blip_read_samples(samp_bb,samp_bbOut,prevAvail,0);
-      samp_bbOff=prevAvail;
-    }
-    // prepare to fill the buffer
-    size_t prevtotal=blip_clocks_needed(samp_bb,size-prevAvail);
-
-    // play the sample
-    if (sPreview.sample>=0 && sPreview.sample<(int)song.sample.size()) {
-      DivSample* s=song.sample[sPreview.sample];
-
-      for (size_t i=0; i<prevtotal; i++) {
-        if (sPreview.pos>=(int)s->samples || (sPreview.pEnd>=0 && sPreview.pos>=sPreview.pEnd)) {
-          // zero if out of bounds
-          samp_temp=0;
-        } else {
-          // fetch sample
-          samp_temp=s->data16[sPreview.pos];
-          if (--sPreview.posSub<=0) {
-            sPreview.posSub=sPreview.rateMul;
-            if (sPreview.dir) {
-              sPreview.pos--;
-            } else {
-              sPreview.pos++;
-            }
-          }
-        }
-        // insert sample
-        blip_add_delta(samp_bb,i,samp_temp-samp_prevSample);
-        samp_prevSample=samp_temp;
-
-        // check playback direction and move needle
-        if (sPreview.dir) { // backward
-          if (sPreview.pos<s->loopStart || (sPreview.pBegin>=0 && sPreview.pos<sPreview.pBegin)) {
-            if (s->isLoopable() && sPreview.pos<s->loopEnd) {
-              switch (s->loopMode) {
-                case DivSampleLoopMode::DIV_SAMPLE_LOOP_FORWARD:
-                  sPreview.pos=s->loopStart;
-                  sPreview.dir=false;
-                  break;
-                case DivSampleLoopMode::DIV_SAMPLE_LOOP_BACKWARD:
-                  sPreview.pos=s->loopEnd-1;
-                  sPreview.dir=true;
-                  break;
-                case DivSampleLoopMode::DIV_SAMPLE_LOOP_PINGPONG:
-                  sPreview.pos=s->loopStart;
-                  sPreview.dir=false;
-                  break;
-                default:
-                  break;
-              }
-            }
-          }
-        } else { // forward
-          if (sPreview.pos>=s->loopEnd || (sPreview.pEnd>=0 && sPreview.pos>=sPreview.pEnd)) {
-            if (s->isLoopable() && sPreview.pos>=s->loopStart) {
-              switch (s->loopMode) {
-                case DivSampleLoopMode::DIV_SAMPLE_LOOP_FORWARD:
-                  sPreview.pos=s->loopStart;
-                  sPreview.dir=false;
-                  break;
-                case DivSampleLoopMode::DIV_SAMPLE_LOOP_BACKWARD:
-                  sPreview.pos=s->loopEnd-1;
-                  sPreview.dir=true;
-                  break;
-                case DivSampleLoopMode::DIV_SAMPLE_LOOP_PINGPONG:
-                  sPreview.pos=s->loopEnd-1;
-                  sPreview.dir=true;
-                  break;
-                default:
-                  break;
-              }
-            }
-          }
-        }
-      }
-      if (sPreview.dir) { // backward
-        if (sPreview.pos<=s->loopStart || (sPreview.pBegin>=0 && sPreview.pos<=sPreview.pBegin)) {
-          if (s->isLoopable() && sPreview.pos>=s->loopStart) {
-            switch (s->loopMode) {
-              case DivSampleLoopMode::DIV_SAMPLE_LOOP_FORWARD:
-                sPreview.pos=s->loopStart;
-                sPreview.dir=false;
-                break;
-              case DivSampleLoopMode::DIV_SAMPLE_LOOP_BACKWARD:
-                sPreview.pos=s->loopEnd-1;
-                sPreview.dir=true;
-                break;
-              case DivSampleLoopMode::DIV_SAMPLE_LOOP_PINGPONG:
-                sPreview.pos=s->loopStart;
-                sPreview.dir=false;
-                break;
-              default:
-                break;
-            }
-          } else if (sPreview.pos<0) {
-            sPreview.sample=-1;
-          }
-        }
-      } else { // forward
-        if (sPreview.pos>=s->loopEnd || (sPreview.pEnd>=0 && sPreview.pos>=sPreview.pEnd)) {
-          if (s->isLoopable() && sPreview.pos>=s->loopStart) {
-            switch (s->loopMode) {
-              case DivSampleLoopMode::DIV_SAMPLE_LOOP_FORWARD:
-                sPreview.pos=s->loopStart;
-                sPreview.dir=false;
-                break;
-              case DivSampleLoopMode::DIV_SAMPLE_LOOP_BACKWARD:
-                sPreview.pos=s->loopEnd-1;
-                sPreview.dir=true;
-                break;
-              case DivSampleLoopMode::DIV_SAMPLE_LOOP_PINGPONG:
-                sPreview.pos=s->loopEnd-1;
-                sPreview.dir=true;
-                break;
-              default:
-                break;
-            }
-          } else if (sPreview.pos>=(int)s->samples) {
-            sPreview.sample=-1;
-          }
-        }
+// this fills the audio buffer and runs tbe engine.
+// called by the audio backend and during audio export.
+void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsigned int size, bool calledFromExport) {
+  // clear the output
+  if (out!=NULL) {
+    for (int i=0; i<outChans; i++) {
+      memset(out[i],0,size*sizeof(float));
+    }
+  }
+
+  // quit if we're in the audio thread and currently exporting
+  if (exporting && !calledFromExport) {
+    return;
+  }
+
+  // if the buffer is larger than the one prepareAudioBuffers() set up for, render it in
+  // chunks instead of reallocating here.
+  if (preparedBufSize>0 && size>preparedBufSize) {
+    float* inChunk[DIV_MAX_OUTPUTS];
+    float* outChunk[DIV_MAX_OUTPUTS];
+    int inChunkChans=MIN(inChans,DIV_MAX_OUTPUTS);
+    int outChunkChans=MIN(outChans,DIV_MAX_OUTPUTS);
+    for (unsigned int pos=0; pos<size; pos+=preparedBufSize) {
+      unsigned int chunkSize=MIN(size-pos,preparedBufSize);
+      if (in!=NULL) {
+        for (int i=0; i<inChunkChans; i++) inChunk[i]=in[i]+pos;
       }
-    } else if (sPreview.wave>=0 && sPreview.wave<(int)song.wave.size()) {
-      DivWavetable* wave=song.wave[sPreview.wave];
-      for (size_t i=0; i<prevtotal; i++) {
-        if (wave->max<=0) {
-          samp_temp=0;
-        } else {
-          samp_temp=((MIN(wave->data[sPreview.pos],wave->max)<<14)/wave->max)-8192;
-        }
-        if (--sPreview.posSub<=0) {
-          sPreview.posSub=sPreview.rateMul;
-          if (++sPreview.pos>=wave->len) {
-            sPreview.pos=0;
-          }
-        }
-        blip_add_delta(samp_bb,i,samp_temp-samp_prevSample);
-        samp_prevSample=samp_temp;
+      if (out!=NULL) {
+        for (int i=0; i<outChunkChans; i++) outChunk[i]=out[i]+pos;
       }
+      nextBuf((in==NULL)?NULL:inChunk,(out==NULL)?NULL:outChunk,inChunkChans,outChunkChans,chunkSize,calledFromExport);
+    }
+    if (!calledFromExport) {
+      got.bufsize=size;
     }
+    return;
+  }
 
-    blip_end_frame(samp_bb,prevtotal);
-    blip_read_samples(samp_bb,samp_bbOut+samp_bbOff,size-samp_bbOff,0);
+  // check the mutex.
+  // soft-locking happens when synchronizedSoft is called.
+  if (softLocked) {
+    // in this case we just return
+    if (!isBusy.try_lock()) {
+      logV("audio is soft-locked (%d)",softLockCount++);
+      return;
+    }
   } else {
-    memset(samp_bbOut,0,size*sizeof(short));
+    isBusy.lock();
+  }
+  // log allocations from here on if the real-time allocation guard is enabled
+  TARealTimeGuard rtGuard;
+  // debug information
+  lastNBIns=inChans;
+  lastNBOuts=outChans;
+  lastNBSize=size;
+
+  // don't fill a buffer if the size is 0
+  if (!size) {
+    logW("nextBuf called with size 0!");
+    isBusy.unlock();
+    return;
+  }
+  lastLoopPos=-1;
+
+  if (!calledFromExport) {
+    got.bufsize=size;
+  }
+
+  // this is used to calculate audio load
+  std::chrono::steady_clock::time_point ts_processBegin=std::chrono::steady_clock::now();
+
+  // the render thread pool and buffers are set up by prepareAudioBuffers() in initDispatch().
+  // without them there is nothing we can render.
+  if (renderPool==NULL) {
+    logW("nextBuf called before the audio buffers were prepared!");
+    isBusy.unlock();
+    return;
+  }
+
+  // process MIDI input events
+  // events are timestamped on arrival and placed at their position in the buffer that
+  // has elapsed since the last call (one buffer of latency, but no jitter).
+  // they are applied right before the tick at or after that position (see processMidiIn()).
+  if (got.rate>0) {
+    midiInBufStart=std::chrono::duration<double>(ts_processBegin.time_since_epoch()).count()-(double)size/got.rate;
+  }
+  midiInBufSize=size;
+  // if we are not playing, apply everything now (a note may start the engine)
+  if (!playing || halted) processMidiIn();
+
+  // process sample/wave preview (not during audio export)
+  if (!exporting) {
+    previewPool.render(song.sample,song.wave,size,renderPool);
+  } else {
+    previewPool.silence(size);
   }
 
   // process audio (run the engine)
@@ -3194,13 +3118,6 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
       disCont[i].runPos=0;
     }
 
-    // resize the metronome tick buffer if necessary
-    if (metroTickLen<size) {
-      if (metroTick!=NULL) delete[] metroTick;
-      metroTick=new unsigned char[size];
-      metroTickLen=size;
-    }
-
     // reset the metronome tick buffer
     memset(metroTick,0,size);
 
@@ -3221,6 +3138,8 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
       // 2. check whether we gonna tick
       if (cycles<=0) {
         // we have to tick
+        // apply MIDI input events which are due by now
+        processMidiIn(bufferPos);
         if (nextTick()) {
           /*totalTicks=0;
           totalSeconds=0;*/
@@ -3280,6 +3199,7 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
             disCont[i].size=size;
             renderPool->push([](void* d) {
               DivDispatchContainer* dc=(DivDispatchContainer*)d;
+              std::chrono::steady_clock::time_point renderStart=std::chrono::steady_clock::now();
 
               int lastAvail=blip_samples_avail(dc->bb[0]);
               if (lastAvail>0) {
@@ -3302,9 +3222,10 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
               }
               dc->acquire(total);
               dc->fillBuf(total,dc->runPos,dc->cycles);
+              dc->updateRenderCost(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-renderStart).count(),dc->cycles);
               // advance run position
               dc->runPos+=dc->cycles;
-            },&disCont[i]);
+            },&disCont[i],disCont[i].renderCost);
           }
           renderPool->wait();
           runLeftG-=cycles;
@@ -3317,6 +3238,7 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
             disCont[i].cycles=runLeftG;
             renderPool->push([](void* d) {
               DivDispatchContainer* dc=(DivDispatchContainer*)d;
+              std::chrono::steady_clock::time_point renderStart=std::chrono::steady_clock::now();
 
               int lastAvail=blip_samples_avail(dc->bb[0]);
               if (lastAvail>0) {
@@ -3338,7 +3260,8 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
               }
               dc->acquire(total);
               dc->fillBuf(total,dc->runPos,dc->cycles);
-            },&disCont[i]);
+              dc->updateRenderCost(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-renderStart).count(),dc->cycles);
+            },&disCont[i],disCont[i].renderCost);
           }
           // at this point runLeftG will be zero and we can break out of the loop
           runLeftG=0;
@@ -3375,15 +3298,10 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
     renderPool->wait();
   }
 
+  // apply the remaining MIDI input events (they will take effect on the next tick)
+  processMidiIn();
+
   // process file player
-  // resize file player audio buffer if necessary
-  if (filePlayerBufLen<size) {
-    for (int i=0; i<DIV_MAX_OUTPUTS; i++) {
-      if (filePlayerBuf[i]!=NULL) delete[] filePlayerBuf[i];
-      filePlayerBuf[i]=new float[size];
-    }
-    filePlayerBufLen=size;
-  }
   if (curFilePlayer!=NULL && !exporting) {
     curFilePlayer->mix(filePlayerBuf,outChans,size);
   } else {
@@ -3393,13 +3311,6 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
   }
 
   // process metronome
-  // resize the metronome's audio buffer if necessary
-  if (metroBufLen<size || metroBuf==NULL) {
-    if (metroBuf!=NULL) delete[] metroBuf;
-    metroBuf=new float[size];
-    metroBufLen=size;
-  }
-
   memset(metroBuf,0,metroBufLen*sizeof(float));
 
   // insert metronome ticks
@@ -3492,8 +3403,9 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
         }
       } else if (srcPortSet==0xffd) {
         // sample preview
+        const short* previewOut=previewPool.getOut();
         for (size_t j=0; j<size; j++) {
-          out[destSubPort][j]+=previewVol*(samp_bbOut[j]/32768.0);
+          out[destSubPort][j]+=previewVol*(previewOut[j]/32768.0);
         }
       } else if (srcPortSet==0xffe && playing && !halted) {
         // metronome
@@ -0,0 +1,448 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2026 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "preview.h"
+#include "../ta-log.h"
+#include <string.h>
+
+void _previewRenderVoice(void* v) {
+  DivPreviewVoice* voice=(DivPreviewVoice*)v;
+  voice->parent->renderVoice(voice);
+}
+
+void DivPreviewPool::renderVoice(DivPreviewVoice* v) {
+  size_t size=curSize;
+  int temp=0;
+  // we use blip_buf to pitch the sample
+  unsigned int bbOff=0;
+  // if there are samples, flush them (this can happen when the playback
+  // rate is less than the output rate)
+  unsigned int prevAvail=blip_samples_avail(v->bb);
+  if (prevAvail>size) prevAvail=size;
+  if (prevAvail>0) {
+    blip_read_samples(v->bb,v->out,prevAvail,0);
+    bbOff=prevAvail;
+  }
+  // prepare to fill the buffer
+  size_t prevtotal=blip_clocks_needed(v->bb,size-prevAvail);
+
+  // play the sample
+  if (v->sample>=0 && v->sample<(int)curSamples->size()) {
+    DivSample* s=(*curSamples)[v->sample];
+
+    for (size_t i=0; i<prevtotal; i++) {
+      if (v->pos>=(int)s->samples || (v->pEnd>=0 && v->pos>=v->pEnd)) {
+        // zero if out of bounds
+        temp=0;
+      } else {
+        // fetch sample
+        temp=s->data16[v->pos];
+        if (--v->posSub<=0) {
+          v->posSub=v->rateMul;
+          if (v->dir) {
+            v->pos--;
+          } else {
+            v->pos++;
+          }
+        }
+      }
+      // insert sample
+      blip_add_delta(v->bb,i,temp-v->prevSample);
+      v->prevSample=temp;
+
+      // check playback direction and move needle
+      if (v->dir) { // backward
+        if (v->pos<s->loopStart || (v->pBegin>=0 && v->pos<v->pBegin)) {
+          if (s->isLoopable() && v->pos<s->loopEnd) {
+            switch (s->loopMode) {
+              case DivSampleLoopMode::DIV_SAMPLE_LOOP_FORWARD:
+                v->pos=s->loopStart;
+                v->dir=false;
+                break;
+              case DivSampleLoopMode::DIV_SAMPLE_LOOP_BACKWARD:
+                v->pos=s->loopEnd-1;
+                v->dir=true;
+                break;
+              case DivSampleLoopMode::DIV_SAMPLE_LOOP_PINGPONG:
+                v->pos=s->loopStart;
+                v->dir=false;
+                break;
+              default:
+                break;
+            }
+          }
+        }
+      } else { // forward
+        if (v->pos>=s->loopEnd || (v->pEnd>=0 && v->pos>=v->pEnd)) {
+          if (s->isLoopable() && v->pos>=s->loopStart) {
+            switch (s->loopMode) {
+              case DivSampleLoopMode::DIV_SAMPLE_LOOP_FORWARD:
+                v->pos=s->loopStart;
+                v->dir=false;
+                break;
+              case DivSampleLoopMode::DIV_SAMPLE_LOOP_BACKWARD:
+                v->pos=s->loopEnd-1;
+                v->dir=true;
+                break;
+              case DivSampleLoopMode::DIV_SAMPLE_LOOP_PINGPONG:
+                v->pos=s->loopEnd-1;
+                v->dir=true;
+                break;
+              default:
+                break;
+            }
+          }
+        }
+      }
+    }
+    if (v->dir) { // backward
+      if (v->pos<=s->loopStart || (v->pBegin>=0 && v->pos<=v->pBegin)) {
+        if (s->isLoopable() && v->pos>=s->loopStart) {
+          switch (s->loopMode) {
+            case DivSampleLoopMode::DIV_SAMPLE_LOOP_FORWARD:
+              v->pos=s->loopStart;
+              v->dir=false;
+              break;
+            case DivSampleLoopMode::DIV_SAMPLE_LOOP_BACKWARD:
+              v->pos=s->loopEnd-1;
+              v->dir=true;
+              break;
+            case DivSampleLoopMode::DIV_SAMPLE_LOOP_PINGPONG:
+              v->pos=s->loopStart;
+              v->dir=false;
+              break;
+            default:
+              break;
+          }
+        } else if (v->pos<0) {
+          v->sample=-1;
+        }
+      }
+    } else { // forward
+      if (v->pos>=s->loopEnd || (v->pEnd>=0 && v->pos>=v->pEnd)) {
+        if (s->isLoopable() && v->pos>=s->loopStart) {
+          switch (s->loopMode) {
+            case DivSampleLoopMode::DIV_SAMPLE_LOOP_FORWARD:
+              v->pos=s->loopStart;
+              v->dir=false;
+              break;
+            case DivSampleLoopMode::DIV_SAMPLE_LOOP_BACKWARD:
+              v->pos=s->loopEnd-1;
+              v->dir=true;
+              break;
+            case DivSampleLoopMode::DIV_SAMPLE_LOOP_PINGPONG:
+              v->pos=s->loopEnd-1;
+              v->dir=true;
+              break;
+            default:
+              break;
+          }
+        } else if (v->pos>=(int)s->samples) {
+          v->sample=-1;
+        }
+      }
+    }
+  } else if (v->wave>=0 && v->wave<(int)curWaves->size()) {
+    DivWavetable* wave=(*curWaves)[v->wave];
+    for (size_t i=0; i<prevtotal; i++) {
+      if (wave->max<=0) {
+        temp=0;
+      } else {
+        temp=((MIN(wave->data[v->pos],wave->max)<<14)/wave->max)-8192;
+      }
+      if (--v->posSub<=0) {
+        v->posSub=v->rateMul;
+        if (++v->pos>=wave->len) {
+          v->pos=0;
+        }
+      }
+      blip_add_delta(v->bb,i,temp-v->prevSample);
+      v->prevSample=temp;
+    }
+  }
+
+  blip_end_frame(v->bb,prevtotal);
+  blip_read_samples(v->bb,v->out+bbOff,size-bbOff,0);
+}
+
+DivPreviewVoice* DivPreviewPool::allocVoice(bool isWave, int note) {
+  DivPreviewVoice* oldest=NULL;
+  // retrigger a voice playing the same note
+  for (int i=0; i<DIV_MAX_PREVIEW_VOICES; i++) {
+    DivPreviewVoice* v=&voices[i];
+    if (!v->isActive()) continue;
+    if ((v->wave>=0)==isWave && v->note==note) return v;
+  }
+  // otherwise find a free voice, or steal the oldest one
+  for (int i=0; i<DIV_MAX_PREVIEW_VOICES; i++) {
+    DivPreviewVoice* v=&voices[i];
+    if (!v->isActive()) return v;
+    if (oldest==NULL || (ageCounter-v->age)>(ageCounter-oldest->age)) oldest=v;
+  }
+  return oldest;
+}
+
+bool DivPreviewPool::post(const DivPreviewCommand& cmd) {
+  unsigned int w=queueWrite.load(std::memory_order_relaxed);
+  if (w-queueRead.load(std::memory_order_acquire)>=DIV_PREVIEW_QUEUE_SIZE) {
+    logW("preview queue full!");
+    return false;
+  }
+  queue[w%DIV_PREVIEW_QUEUE_SIZE]=cmd;
+  queueWrite.store(w+1,std::memory_order_release);
+  return true;
+}
+
+void DivPreviewPool::execute(const DivPreviewCommand& cmd) {
+  switch (cmd.cmd) {
+    case DIV_PREVIEW_CMD_SAMPLE:
+    case DIV_PREVIEW_CMD_WAVE: {
+      bool isWave=(cmd.cmd==DIV_PREVIEW_CMD_WAVE);
+      if (cmd.index<0) break;
+      DivPreviewVoice* v=allocVoice(isWave,cmd.note);
+      if (v==NULL) break;
+      if (isWave && lastSampleVoice>=0 && v==&voices[lastSampleVoice]) lastSampleVoice=-1;
+
+      double rate=cmd.rate;
+      if (rate<100) rate=100;
+      v->rateMul=1;
+      while (v->rateMul<0x40000000 && rate<outRate) {
+        v->rateMul<<=1;
+        rate*=2.0;
+      }
+      blip_clear(v->bb);
+      blip_set_rates(v->bb,rate,outRate);
+      v->prevSample=0;
+      v->rate=cmd.rate;
+      v->note=cmd.note;
+      v->pBegin=cmd.pBegin;
+      v->pEnd=cmd.pEnd;
+      v->pos=(!isWave && v->pBegin>=0)?v->pBegin:0;
+      v->posSub=0;
+      v->sample=isWave?-1:cmd.index;
+      v->wave=isWave?cmd.index:-1;
+      v->dir=false;
+      v->age=ageCounter++;
+      if (!isWave) lastSampleVoice=v-voices;
+      break;
+    }
+    case DIV_PREVIEW_CMD_STOP_SAMPLE:
+      for (int i=0; i<DIV_MAX_PREVIEW_VOICES; i++) {
+        if (voices[i].sample>=0 && voices[i].note==cmd.note) voices[i].stop();
+      }
+      break;
+    case DIV_PREVIEW_CMD_STOP_WAVE:
+      for (int i=0; i<DIV_MAX_PREVIEW_VOICES; i++) {
+        if (voices[i].wave>=0 && voices[i].note==cmd.note) voices[i].stop();
+      }
+      break;
+    case DIV_PREVIEW_CMD_STOP_ALL_SAMPLES:
+      for (int i=0; i<DIV_MAX_PREVIEW_VOICES; i++) {
+        if (voices[i].sample>=0) voices[i].stop();
+      }
+      break;
+    case DIV_PREVIEW_CMD_STOP_ALL_WAVES:
+      for (int i=0; i<DIV_MAX_PREVIEW_VOICES; i++) {
+        if (voices[i].wave>=0) voices[i].stop();
+      }
+      break;
+    case DIV_PREVIEW_CMD_STOP_ALL:
+      for (int i=0; i<DIV_MAX_PREVIEW_VOICES; i++) {
+        voices[i].stop();
+      }
+      break;
+  }
+}
+
+void DivPreviewPool::cancelPending(const DivPreviewCommand& stop) {
+  // the audio thread only reads the queue with the engine locked, and the
+  // GUI thread never writes to a slot before queueWrite
+  unsigned int r=queueRead.load(std::memory_order_acquire);
+  unsigned int w=queueWrite.load(std::memory_order_acquire);
+  for (; r!=w; r++) {
+    DivPreviewCommand& c=queue[r%DIV_PREVIEW_QUEUE_SIZE];
+    bool cancel=false;
+    switch (stop.cmd) {
+      case DIV_PREVIEW_CMD_STOP_SAMPLE:
+        cancel=(c.cmd==DIV_PREVIEW_CMD_SAMPLE && c.note==stop.note);
+        break;
+      case DIV_PREVIEW_CMD_STOP_WAVE:
+        cancel=(c.cmd==DIV_PREVIEW_CMD_WAVE && c.note==stop.note);
+        break;
+      case DIV_PREVIEW_CMD_STOP_ALL_SAMPLES:
+        cancel=(c.cmd==DIV_PREVIEW_CMD_SAMPLE);
+        break;
+      case DIV_PREVIEW_CMD_STOP_ALL_WAVES:
+        cancel=(c.cmd==DIV_PREVIEW_CMD_WAVE);
+        break;
+      case DIV_PREVIEW_CMD_STOP_ALL:
+        cancel=(c.cmd==DIV_PREVIEW_CMD_SAMPLE || c.cmd==DIV_PREVIEW_CMD_WAVE);
+        break;
+      default:
+        break;
+    }
+    // a negative index turns it into a no-op
+    if (cancel) c.index=-1;
+  }
+}
+
+void DivPreviewPool::stopAll() {
+  queueRead.store(queueWrite.load(std::memory_order_acquire),std::memory_order_release);
+  execute(DivPreviewCommand());
+}
+
+void DivPreviewPool::render(std::vector<DivSample*>& samples, std::vector<DivWavetable*>& waves, size_t size, DivWorkPool* pool) {
+  // run pending commands
+  unsigned int r=queueRead.load(std::memory_order_relaxed);
+  unsigned int w=queueWrite.load(std::memory_order_acquire);
+  while (r!=w) {
+    execute(queue[r%DIV_PREVIEW_QUEUE_SIZE]);
+    r++;
+  }
+  queueRead.store(r,std::memory_order_release);
+
+  if (size>DIV_PREVIEW_BUF_SIZE) size=DIV_PREVIEW_BUF_SIZE;
+  curSamples=&samples;
+  curWaves=&waves;
+  curSize=size;
+
+  // stop voices whose sample/wave no longer exists
+  DivPreviewVoice* active[DIV_MAX_PREVIEW_VOICES];
+  int activeCount=0;
+  for (int i=0; i<DIV_MAX_PREVIEW_VOICES; i++) {
+    DivPreviewVoice* v=&voices[i];
+    if (v->sample>=(int)samples.size() || v->wave>=(int)waves.size()) {
+      v->stop();
+    }
+    if (v->isActive()) active[activeCount++]=v;
+  }
+
+  // render voices (in parallel if there's more than one)
+  if (pool!=NULL && activeCount>1) {
+    for (int i=0; i<activeCount; i++) {
+      pool->push(_previewRenderVoice,active[i]);
+    }
+    pool->wait();
+  } else {
+    for (int i=0; i<activeCount; i++) {
+      renderVoice(active[i]);
+    }
+  }
+
+  // mix
+  if (activeCount==1) {
+    memcpy(out,active[0]->out,size*sizeof(short));
+    return;
+  }
+  memset(out,0,size*sizeof(short));
+  for (int i=0; i<activeCount; i++) {
+    const short* vOut=active[i]->out;
+    for (size_t j=0; j<size; j++) {
+      int sum=out[j]+vOut[j];
+      if (sum<-32768) sum=-32768;
+      if (sum>32767) sum=32767;
+      out[j]=sum;
+    }
+  }
+}
+
+void DivPreviewPool::silence(size_t size) {
+  if (size>DIV_PREVIEW_BUF_SIZE) size=DIV_PREVIEW_BUF_SIZE;
+  memset(out,0,size*sizeof(short));
+}
+
+const short* DivPreviewPool::getOut() {
+  return out;
+}
+
+bool DivPreviewPool::isPlaying() {
+  for (int i=0; i<DIV_MAX_PREVIEW_VOICES; i++) {
+    if (voices[i].isActive()) return true;
+  }
+  return false;
+}
+
+bool DivPreviewPool::isPlayingSample(int sampleCount) {
+  if (lastSampleVoice<0) return false;
+  DivPreviewVoice& v=voices[lastSampleVoice];
+  return (v.sample>=0 && v.sample<sampleCount && v.pos!=v.pEnd);
+}
+
+int DivPreviewPool::getSample() {
+  if (lastSampleVoice<0) return -1;
+  return voices[lastSampleVoice].sample;
+}
+
+int DivPreviewPool::getPos() {
+  if (lastSampleVoice<0) return 0;
+  return voices[lastSampleVoice].pos;
+}
+
+double DivPreviewPool::getRate() {
+  if (lastSampleVoice<0) return 0.0;
+  return voices[lastSampleVoice].rate;
+}
+
+bool DivPreviewPool::init(double rate) {
+  outRate=rate;
+  for (int i=0; i<DIV_MAX_PREVIEW_VOICES; i++) {
+    DivPreviewVoice& v=voices[i];
+    v.parent=this;
+    v.bb=blip_new(DIV_PREVIEW_BUF_SIZE);
+    if (v.bb==NULL) {
+      logE("not enough memory!");
+      return false;
+    }
+    blip_set_dc(v.bb,0);
+    blip_set_rates(v.bb,44100,outRate);
+    v.out=new short[DIV_PREVIEW_BUF_SIZE];
+    memset(v.out,0,DIV_PREVIEW_BUF_SIZE*sizeof(short));
+  }
+  out=new short[DIV_PREVIEW_BUF_SIZE];
+  memset(out,0,DIV_PREVIEW_BUF_SIZE*sizeof(short));
+  return true;
+}
+
+void DivPreviewPool::setRate(double rate) {
+  outRate=rate;
+  for (int i=0; i<DIV_MAX_PREVIEW_VOICES; i++) {
+    voices[i].stop();
+  }
+}
+
+void DivPreviewPool::quit() {
+  for (int i=0; i<DIV_MAX_PREVIEW_VOICES; i++) {
+    DivPreviewVoice& v=voices[i];
+    v.stop();
+    if (v.bb!=NULL) {
+      blip_delete(v.bb);
+      v.bb=NULL;
+    }
+    if (v.out!=NULL) {
+      delete[] v.out;
+      v.out=NULL;
+    }
+  }
+  if (out!=NULL) {
+    delete[] out;
+    out=NULL;
+  }
+  lastSampleVoice=-1;
+}
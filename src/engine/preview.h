@@ -0,0 +1,212 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2026 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef _PREVIEW_H
+#define _PREVIEW_H
+
+#include "sample.h"
+#include "wavetable.h"
+#include "workPool.h"
+#include "blip_buf.h"
+#include <vector>
+#include <atomic>
+
+// maximum number of sample/wave previews playing at once
+#define DIV_MAX_PREVIEW_VOICES 8
+// size of the preview command queue
+#define DIV_PREVIEW_QUEUE_SIZE 64
+// maximum buffer size the preview pool can render
+#define DIV_PREVIEW_BUF_SIZE 32768
+
+enum DivPreviewCommands {
+  DIV_PREVIEW_CMD_SAMPLE=0,
+  DIV_PREVIEW_CMD_WAVE,
+  // stop the sample/wave preview playing the command's note
+  DIV_PREVIEW_CMD_STOP_SAMPLE,
+  DIV_PREVIEW_CMD_STOP_WAVE,
+  // stop every sample/wave preview
+  DIV_PREVIEW_CMD_STOP_ALL_SAMPLES,
+  DIV_PREVIEW_CMD_STOP_ALL_WAVES,
+  DIV_PREVIEW_CMD_STOP_ALL
+};
+
+struct DivPreviewCommand {
+  DivPreviewCommands cmd;
+  // sample or wave index
+  int index;
+  // voices are keyed by note. -1 is used by previews with no note (e.g. the play button).
+  int note;
+  int pBegin, pEnd;
+  // playback rate of the sample/wave
+  double rate;
+  DivPreviewCommand():
+    cmd(DIV_PREVIEW_CMD_STOP_ALL),
+    index(-1),
+    note(-1),
+    pBegin(-1),
+    pEnd(-1),
+    rate(0.0) {}
+  DivPreviewCommand(DivPreviewCommands c, int i, int n, double r, int pb=-1, int pe=-1):
+    cmd(c),
+    index(i),
+    note(n),
+    pBegin(pb),
+    pEnd(pe),
+    rate(r) {}
+};
+
+class DivPreviewPool;
+
+struct DivPreviewVoice {
+  DivPreviewPool* parent;
+  blip_buffer_t* bb;
+  short* out;
+  double rate;
+  int sample, wave, note;
+  int pos;
+  int pBegin, pEnd;
+  int rateMul, posSub;
+  int prevSample;
+  bool dir;
+  // used to steal the oldest voice when all of them are busy
+  unsigned int age;
+
+  bool isActive() {
+    return sample>=0 || wave>=0;
+  }
+  void stop() {
+    sample=-1;
+    wave=-1;
+    pos=0;
+    dir=false;
+  }
+
+  DivPreviewVoice():
+    parent(NULL),
+    bb(NULL),
+    out(NULL),
+    rate(0.0),
+    sample(-1),
+    wave(-1),
+    note(-1),
+    pos(0),
+    pBegin(-1),
+    pEnd(-1),
+    rateMul(1),
+    posSub(0),
+    prevSample(0),
+    dir(false),
+    age(0) {}
+};
+
+/**
+ * plays sample and wave previews (patchbay port 0xffd).
+ * preview requests are posted to a lock-free queue by the GUI thread and picked up by the audio thread,
+ * so starting or stopping a preview does not have to wait for the engine lock.
+ */
+class DivPreviewPool {
+  DivPreviewVoice voices[DIV_MAX_PREVIEW_VOICES];
+  DivPreviewCommand queue[DIV_PREVIEW_QUEUE_SIZE];
+  std::atomic<unsigned int> queueRead, queueWrite;
+  // the voice of the latest sample preview (reported to the sample editor)
+  int lastSampleVoice;
+  unsigned int ageCounter;
+  double outRate;
+  short* out;
+
+  // these are used by the render tasks
+  std::vector<DivSample*>* curSamples;
+  std::vector<DivWavetable*>* curWaves;
+  size_t curSize;
+
+  void renderVoice(DivPreviewVoice* v);
+  DivPreviewVoice* allocVoice(bool isWave, int note);
+
+  friend void _previewRenderVoice(void* v);
+  public:
+    /**
+     * queue a preview command. it will be executed by the audio thread on the next buffer.
+     * only one thread may post commands.
+     * @return whether the command was queued (false if the queue is full).
+     */
+    bool post(const DivPreviewCommand& cmd);
+
+    /**
+     * execute a preview command immediately.
+     * @warning only call this with the engine locked!
+     */
+    void execute(const DivPreviewCommand& cmd);
+
+    /**
+     * drop pending commands which would start a preview that the given stop command stops.
+     * call this before executing a stop command immediately, so that an older queued
+     * preview does not start (possibly with a stale index) after it.
+     * @warning only call this with the engine locked!
+     */
+    void cancelPending(const DivPreviewCommand& stop);
+
+    /**
+     * stop all previews and drop pending commands.
+     * @warning only call this with the engine locked!
+     */
+    void stopAll();
+
+    /**
+     * run pending commands and render all voices.
+     * @param samples the song's samples.
+     * @param waves the song's wavetables.
+     * @param size the buffer size.
+     * @param pool a work pool to render voices in, or NULL.
+     */
+    void render(std::vector<DivSample*>& samples, std::vector<DivWavetable*>& waves, size_t size, DivWorkPool* pool);
+
+    /**
+     * clear the output buffer (used when not rendering).
+     */
+    void silence(size_t size);
+
+    /**
+     * get the mixed output of the last render.
+     */
+    const short* getOut();
+
+    bool isPlaying();
+    bool isPlayingSample(int sampleCount);
+    int getSample();
+    int getPos();
+    double getRate();
+
+    bool init(double rate);
+    void setRate(double rate);
+    void quit();
+
+    DivPreviewPool():
+      queueRead(0),
+      queueWrite(0),
+      lastSampleVoice(-1),
+      ageCounter(0),
+      outRate(44100.0),
+      out(NULL),
+      curSamples(NULL),
+      curWaves(NULL),
+      curSize(0) {}
+};
+
+#endif
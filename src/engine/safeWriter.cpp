@@ -21,6 +21,8 @@
 #include "../ta-log.h"
 
 #define WRITER_BUF_SIZE 16384
+// write to the stream once this much data is pending
+#define WRITER_STREAM_SIZE 262144
 
 unsigned char* SafeWriter::getFinalBuf() {
   return buf;
@@ -43,11 +45,27 @@ void SafeWriter::checkSize(size_t amount) {
   }
 }
 
+bool SafeWriter::flush() {
+  if (stream==NULL) return true;
+  if (len>0) {
+    if (fwrite(buf,1,len,stream)!=len) {
+      streamError=errno;
+      logE("could not write to stream! %s",strerror(streamError));
+      streamFailed=true;
+    }
+    flushed+=len;
+  }
+  len=0;
+  curSeek=0;
+  return !streamFailed;
+}
+
 bool SafeWriter::seek(ssize_t where, int whence) {
   ssize_t supposed;
   switch (whence) {
     case SEEK_SET:
-      supposed=where;
+      supposed=where-(ssize_t)flushed;
+      if (supposed<0 && stream!=NULL) return false;
       break;
     case SEEK_CUR:
       supposed=curSeek+where;
@@ -65,15 +83,18 @@ bool SafeWriter::seek(ssize_t where, int whence) {
 }
 
 size_t SafeWriter::tell() {
-  return curSeek;
+  return flushed+curSeek;
 }
 
 size_t SafeWriter::size() {
-  return len;
+  return flushed+len;
 }
 
 int SafeWriter::write(const void* what, size_t count) {
   if (!operative) return 0;
+  if (stream!=NULL && curSeek==len && (len+count)>WRITER_STREAM_SIZE) {
+    flush();
+  }
   checkSize(count);
   memcpy(buf+curSeek,what,count);
   curSeek+=count;
@@ -214,15 +235,39 @@ void SafeWriter::init() {
   bufLen=WRITER_BUF_SIZE;
   len=0;
   curSeek=0;
+  // in case this writer was used in stream mode before
+  stream=NULL;
+  flushed=0;
+  streamFailed=false;
+  streamError=0;
   operative=true;
 }
 
+void SafeWriter::initStream(FILE* f) {
+  if (operative) return;
+  init();
+  stream=f;
+}
+
+bool SafeWriter::hasFailed() {
+  return streamFailed;
+}
+
+const char* SafeWriter::getError() {
+  if (!streamFailed) return "";
+  return strerror(streamError);
+}
+
 SafeReader* SafeWriter::toReader() {
   return new SafeReader(buf,len);
 }
 
 void SafeWriter::finish() {
   if (!operative) return;
+  if (stream!=NULL) {
+    flush();
+    stream=NULL;
+  }
   delete[] buf;
   buf=NULL;
   operative=false;
@@ -33,7 +33,16 @@ class SafeWriter {
 
   size_t curSeek;
 
+  // stream mode: data is written out to this file as the buffer fills up
+  FILE* stream;
+  // amount of data already written to the stream
+  size_t flushed;
+  bool streamFailed;
+  // errno of the failed write
+  int streamError;
+
   void checkSize(size_t amount);
+  bool flush();
 
   public:
     unsigned char* getFinalBuf();
@@ -60,6 +69,17 @@ class SafeWriter {
     int writeText(String val);
 
     void init();
+    /**
+     * initialize in stream mode. data is written to f in blocks instead of being kept in memory.
+     * seeking is only possible within the block that hasn't been written yet,
+     * and getFinalBuf()/toReader() only see that block.
+     * finish() writes the rest. the file is not closed.
+     */
+    void initStream(FILE* f);
+    // whether writing to the stream failed
+    bool hasFailed();
+    // the reason writing to the stream failed
+    const char* getError();
     SafeReader* toReader();
     void finish();
     void disown();
@@ -69,7 +89,11 @@ class SafeWriter {
       buf(NULL),
       bufLen(0),
       len(0),
-      curSeek(0) {}
+      curSeek(0),
+      stream(NULL),
+      flushed(0),
+      streamFailed(false),
+      streamError(0) {}
 };
 
 #endif
@@ -22,6 +22,7 @@
 #include "../fileutils.h"
 #include <math.h>
 #include <string.h>
+#include <limits.h>
 #ifdef HAVE_SNDFILE
 #include "sfWrapper.h"
 #endif
@@ -37,9 +38,27 @@ extern "C" {
 }
 #include "../../extern/adpcm-xq-s/adpcm-lib.h"
 #include "brrUtils.h"
+#include "workPool.h"
+
+size_t DivSampleHistory::getSize() {
+  size_t ret=sizeof(DivSampleHistory);
+  if (data!=NULL) {
+    if (chunks!=NULL) {
+      ret+=chunkCount*sizeof(unsigned int);
+      // the last chunk may be shorter
+      for (unsigned int i=0; i<chunkCount; i++) {
+        ret+=MIN(DIV_SAMPLE_UNDO_CHUNK,length-chunks[i]*DIV_SAMPLE_UNDO_CHUNK);
+      }
+    } else {
+      ret+=length;
+    }
+  }
+  return ret;
+}
 
 DivSampleHistory::~DivSampleHistory() {
   if (data!=NULL) delete[] data;
+  if (chunks!=NULL) delete[] chunks;
 }
 
 void DivSample::putSampleData(SafeWriter* w) {
@@ -90,6 +109,25 @@ void DivSample::putSampleData(SafeWriter* w) {
   w->seek(0,SEEK_END);
 }
 
+bool DivSample::copyOn(DivSample* dest) {
+  dest->name=name;
+  dest->centerRate=centerRate;
+  dest->loopStart=loopStart;
+  dest->loopEnd=loopEnd;
+  dest->loop=loop;
+  dest->loopMode=loopMode;
+  dest->brrEmphasis=brrEmphasis;
+  dest->brrNoFilter=brrNoFilter;
+  dest->dither=dither;
+  dest->depth=depth;
+  memcpy(dest->renderOn,renderOn,sizeof(renderOn));
+  if (!dest->init(samples)) return false;
+  if (getCurBuf()!=NULL && dest->getCurBuf()!=NULL) {
+    memcpy(dest->getCurBuf(),getCurBuf(),MIN(getCurBufLen(),dest->getCurBufLen()));
+  }
+  return true;
+}
+
 // Delek why
 static double samplePitchesSD[11]={
   0.1666666666, 0.2, 0.25, 0.333333333, 0.5,
@@ -606,6 +644,7 @@ bool DivSample::initInternal(DivSampleDepth d, int count) {
       // for padding X1-010 sample
       data8=new signed char[(count+4095)&(~0xfff)];
       memset(data8,0,(count+4095)&(~0xfff));
+      if (minMax8) invalidateMinMax();
       break;
     case DIV_SAMPLE_DEPTH_BRR: // BRR
       if (dataBRR!=NULL) delete[] dataBRR;
@@ -654,6 +693,7 @@ bool DivSample::initInternal(DivSampleDepth d, int count) {
       length16=count*2;
       data16=new short[(count+511)&(~0x1ff)];
       memset(data16,0,((count+511)&(~0x1ff))*sizeof(short));
+      if (!minMax8) invalidateMinMax();
       break;
     default:
       return false;
@@ -902,335 +942,347 @@ void DivSample::convert(DivSampleDepth newDepth, unsigned int formatMask) {
   render(formatMask|(1U<<newDepth));
 }
 
-#define RESAMPLE_BEGIN \
-  if (samples<1) return true; \
-  int finalCount=(double)samples*(tRate/sRate); \
-  signed char* oldData8=data8; \
-  short* oldData16=data16; \
-  if (depth==DIV_SAMPLE_DEPTH_16BIT) { \
-    if (data16!=NULL) { \
-      data16=NULL; \
-      initInternal(DIV_SAMPLE_DEPTH_16BIT,finalCount); \
-    } \
-  } else if (depth==DIV_SAMPLE_DEPTH_8BIT) {  \
-    if (data8!=NULL) { \
-      data8=NULL; \
-      initInternal(DIV_SAMPLE_DEPTH_8BIT,finalCount); \
-    } \
-  } else { \
-    return false; \
-  }
-
-#define RESAMPLE_END \
-  if (loopStart>=0) loopStart=(double)loopStart*(tRate/sRate); \
-  if (loopEnd>=0) loopEnd=(double)loopEnd*(tRate/sRate); \
-  centerRate=(int)((double)centerRate*(tRate/sRate)); \
-  samples=finalCount; \
-  if (depth==DIV_SAMPLE_DEPTH_16BIT) { \
-    delete[] oldData16; \
-  } else if (depth==DIV_SAMPLE_DEPTH_8BIT) { \
-    delete[] oldData8; \
-  }
-
-bool DivSample::resampleNone(double sRate, double tRate) {
-  RESAMPLE_BEGIN;
-
-  if (depth==DIV_SAMPLE_DEPTH_16BIT) {
-    for (int i=0; i<finalCount; i++) {
-      unsigned int pos=(unsigned int)((double)i*(sRate/tRate));
-      if (pos>=samples) {
-        data16[i]=0;
-      } else {
-        data16[i]=oldData16[pos];
-      }
-    }
-  } else if (depth==DIV_SAMPLE_DEPTH_8BIT) {
-    for (int i=0; i<finalCount; i++) {
-      unsigned int pos=(unsigned int)((double)i*(sRate/tRate));
-      if (pos>=samples) {
-        data8[i]=0;
-      } else {
-        data8[i]=oldData8[pos];
-      }
+DivSampleResampleJob::~DivSampleResampleJob() {
+  if (in!=NULL) {
+    delete[] in;
+    in=NULL;
+  }
+  if (result!=NULL) {
+    if (depth==DIV_SAMPLE_DEPTH_16BIT) {
+      delete[] (short*)result;
+    } else {
+      delete[] (signed char*)result;
     }
+    result=NULL;
   }
+}
 
-  RESAMPLE_END;
-  return true;
+// a range of output samples of a resampling job.
+// every output sample is computed from its own position, so chunks do not depend on each other.
+struct DivResampleChunk {
+  DivSampleResampleJob* job;
+  const float* in;
+  unsigned int inLen;
+  unsigned int finalCount;
+  unsigned int begin, end;
+  float loopSample;
+  int filter;
+};
+
+static inline float resampleGet(const float* in, unsigned int inLen, long long pos) {
+  return (pos<0 || pos>=(long long)inLen)?0:in[pos];
+}
+
+static void resampleChunkNone(const DivResampleChunk* c, float* out) {
+  double factor=c->job->sRate/c->job->tRate;
+  for (unsigned int i=c->begin; i<c->end; i++) {
+    unsigned int pos=(unsigned int)((double)i*factor);
+    *out++=(pos>=c->inLen)?0:c->in[pos];
+  }
 }
 
-bool DivSample::resampleLinear(double sRate, double tRate) {
-  RESAMPLE_BEGIN;
+static void resampleChunkLinear(const DivResampleChunk* c, float* out) {
+  double factor=c->job->sRate/c->job->tRate;
+  for (unsigned int i=c->begin; i<c->end; i++) {
+    double pos=(double)i*factor;
+    unsigned int posInt=(unsigned int)pos;
+    float posFrac=pos-(double)posInt;
+    float s1=(posInt>=c->inLen)?0:c->in[posInt];
+    float s2=(posInt+1>=c->inLen)?c->loopSample:c->in[posInt+1];
 
-  double posFrac=0;
-  unsigned int posInt=0;
-  double factor=sRate/tRate;
+    *out++=s1+(s2-s1)*posFrac;
+  }
+}
 
-  if (depth==DIV_SAMPLE_DEPTH_16BIT) {
-    for (int i=0; i<finalCount; i++) {
-      short s1=(posInt>=samples)?0:oldData16[posInt];
-      short s2=(posInt+1>=samples)?((loopStart>=0 && loopStart<(int)samples)?oldData16[loopStart]:0):oldData16[posInt+1];
+static void resampleChunkCubic(const DivResampleChunk* c, float* out) {
+  double factor=c->job->sRate/c->job->tRate;
+  float* cubicTable=DivFilterTables::getCubicTable();
+  for (unsigned int i=c->begin; i<c->end; i++) {
+    double pos=(double)i*factor;
+    unsigned int posInt=(unsigned int)pos;
+    unsigned int n=((unsigned int)((pos-(double)posInt)*1024.0))&1023;
+    const float* t=&cubicTable[n<<2];
+    float s[4];
+    s[0]=resampleGet(c->in,c->inLen,(long long)posInt-1);
+    s[1]=(posInt>=c->inLen)?0:c->in[posInt];
+    s[2]=(posInt+1>=c->inLen)?c->loopSample:c->in[posInt+1];
+    s[3]=(posInt+2>=c->inLen)?c->loopSample:c->in[posInt+2];
+
+    *out++=s[0]*t[0]+s[1]*t[1]+s[2]*t[2]+s[3]*t[3];
+  }
+}
 
-      data16[i]=s1+(float)(s2-s1)*posFrac;
+static void resampleChunkSinc(const DivResampleChunk* c, float* out) {
+  double factor=c->job->sRate/c->job->tRate;
+  float* sincTable=DivFilterTables::getSincTable();
+  float window[16];
+  float coef[16];
+  for (unsigned int i=c->begin; i<c->end; i++) {
+    // output i is centered 8 input steps behind its position
+    double pos=(double)(i+8)*factor;
+    unsigned int posInt=(unsigned int)pos;
+    unsigned int n=((unsigned int)((pos-(double)posInt)*8192.0))&8191;
+    const float* t1=&sincTable[(8191-n)<<3];
+    const float* t2=&sincTable[n<<3];
+    const float* w=window;
+
+    // the window covers input samples posInt-15 to posInt (the first sample is never part of it)
+    if (posInt>=16 && posInt<c->inLen) {
+      w=&c->in[posInt-15];
+    } else {
+      for (int j=0; j<16; j++) {
+        long long p=(long long)posInt-15+j;
+        window[j]=(p<1)?0:resampleGet(c->in,c->inLen,p);
+      }
+    }
+    for (int j=0; j<8; j++) {
+      coef[j]=t2[7-j];
+      coef[8+j]=t1[j];
+    }
 
-      posFrac+=factor;
-      while (posFrac>=1.0) {
-        posFrac-=1.0;
-        posInt++;
+    // four independent sums so that the dot product maps onto vector registers
+    float acc[4];
+    acc[0]=0; acc[1]=0; acc[2]=0; acc[3]=0;
+    for (int j=0; j<16; j+=4) {
+      for (int k=0; k<4; k++) {
+        acc[k]+=w[j+k]*coef[j+k];
       }
     }
-  } else if (depth==DIV_SAMPLE_DEPTH_8BIT) {
-    for (int i=0; i<finalCount; i++) {
-      short s1=(posInt>=samples)?0:oldData8[posInt];
-      short s2=(posInt+1>=samples)?((loopStart>=0 && loopStart<(int)samples)?oldData8[loopStart]:0):oldData8[posInt+1];
+    *out++=(acc[0]+acc[1])+(acc[2]+acc[3]);
+  }
+}
 
-      data8[i]=s1+(float)(s2-s1)*posFrac;
+static void resampleChunkBlep(const DivResampleChunk* c, float* out) {
+  double factor=c->job->tRate/c->job->sRate;
+  double invFactor=c->job->sRate/c->job->tRate;
+  float* sincITable=DivFilterTables::getSincIntegralTable();
+  unsigned int len=c->end-c->begin;
+
+  memset(out,0,len*sizeof(float));
+
+  // every input step spreads its delta over the 16 output samples around it.
+  // gather the steps which reach this chunk, in the same order as a sequential pass.
+  unsigned int from=(c->begin>8)?(c->begin-8):0;
+  unsigned int to=c->end+8;
+  if (to>c->finalCount) to=c->finalCount;
+  for (unsigned int i=from; i<to; i++) {
+    unsigned int kBegin=(i<1)?0:((unsigned int)((double)(i-1)*invFactor)+1);
+    unsigned int kEnd=(unsigned int)((double)i*invFactor)+1;
+    for (unsigned int k=kBegin+1; k<=kEnd; k++) {
+      double p=(double)(i+1)-(double)(k-1)*factor;
+      int n=(int)((p-1.0)*8192.0);
+      if (n<0) n=0;
+      if (n>8191) n=8191;
+
+      const float* t1=&sincITable[(8191-n)<<3];
+      const float* t2=&sincITable[n<<3];
+      float delta=resampleGet(c->in,c->inLen,k)-resampleGet(c->in,c->inLen,k-1);
 
-      posFrac+=factor;
-      while (posFrac>=1.0) {
-        posFrac-=1.0;
-        posInt++;
+      for (int j=0; j<8; j++) {
+        long long x=(long long)i-j;
+        if (x>0 && x>=c->begin && x<c->end) {
+          out[x-c->begin]+=t1[j]*-delta;
+        }
+        x=(long long)i+j+1;
+        if (x<c->finalCount && x>=c->begin && x<c->end) {
+          out[x-c->begin]+=t2[j]*delta;
+        }
       }
     }
   }
 
-  RESAMPLE_END;
-  return true;
+  // add the held input sample
+  for (unsigned int i=c->begin; i<c->end; i++) {
+    unsigned int posInt=(i<1)?0:((unsigned int)((double)(i-1)*invFactor)+1);
+    if (posInt<c->inLen) out[i-c->begin]+=c->in[posInt];
+  }
 }
 
-bool DivSample::resampleCubic(double sRate, double tRate) {
-  RESAMPLE_BEGIN;
+static void resampleChunk(void* arg) {
+  DivResampleChunk* c=(DivResampleChunk*)arg;
+  DivSampleResampleJob* job=c->job;
+  if (job->cancel) return;
 
-  double posFrac=0;
-  unsigned int posInt=0;
-  double factor=sRate/tRate;
-  float* cubicTable=DivFilterTables::getCubicTable();
+  unsigned int len=c->end-c->begin;
+  float* out=new float[len];
+  bool roundResult=false;
 
-  if (depth==DIV_SAMPLE_DEPTH_16BIT) {
-    for (int i=0; i<finalCount; i++) {
-      unsigned int n=((unsigned int)(posFrac*1024.0))&1023;
-      float* t=&cubicTable[n<<2];
-      float s0=(posInt<1)?0:oldData16[posInt-1];
-      float s1=(posInt>=samples)?0:oldData16[posInt];
-      float s2=(posInt+1>=samples)?((loopStart>=0 && loopStart<(int)samples)?oldData16[loopStart]:0):oldData16[posInt+1];
-      float s3=(posInt+2>=samples)?((loopStart>=0 && loopStart<(int)samples)?oldData16[loopStart]:0):oldData16[posInt+2];
-
-      float result=s0*t[0]+s1*t[1]+s2*t[2]+s3*t[3];
+  switch (c->filter) {
+    case DIV_RESAMPLE_NONE:
+      resampleChunkNone(c,out);
+      break;
+    case DIV_RESAMPLE_LINEAR:
+      resampleChunkLinear(c,out);
+      break;
+    case DIV_RESAMPLE_CUBIC:
+      resampleChunkCubic(c,out);
+      break;
+    case DIV_RESAMPLE_BLEP:
+      resampleChunkBlep(c,out);
+      roundResult=true;
+      break;
+    case DIV_RESAMPLE_SINC:
+      resampleChunkSinc(c,out);
+      break;
+  }
+
+  if (job->depth==DIV_SAMPLE_DEPTH_16BIT) {
+    short* dest=((short*)job->result)+c->begin;
+    for (unsigned int i=0; i<len; i++) {
+      float result=out[i];
       if (result<-32768) result=-32768;
       if (result>32767) result=32767;
-      data16[i]=result;
-
-      posFrac+=factor;
-      while (posFrac>=1.0) {
-        posFrac-=1.0;
-        posInt++;
-      }
+      dest[i]=roundResult?round(result):result;
     }
-  } else if (depth==DIV_SAMPLE_DEPTH_8BIT) {
-    for (int i=0; i<finalCount; i++) {
-      unsigned int n=((unsigned int)(posFrac*1024.0))&1023;
-      float* t=&cubicTable[n<<2];
-      float s0=(posInt<1)?0:oldData8[posInt-1];
-      float s1=(posInt>=samples)?0:oldData8[posInt];
-      float s2=(posInt+1>=samples)?((loopStart>=0 && loopStart<(int)samples)?oldData8[loopStart]:0):oldData8[posInt+1];
-      float s3=(posInt+2>=samples)?((loopStart>=0 && loopStart<(int)samples)?oldData8[loopStart]:0):oldData8[posInt+2];
-
-      float result=s0*t[0]+s1*t[1]+s2*t[2]+s3*t[3];
+  } else {
+    signed char* dest=((signed char*)job->result)+c->begin;
+    for (unsigned int i=0; i<len; i++) {
+      float result=out[i];
       if (result<-128) result=-128;
       if (result>127) result=127;
-      data8[i]=result;
-
-      posFrac+=factor;
-      while (posFrac>=1.0) {
-        posFrac-=1.0;
-        posInt++;
-      }
+      dest[i]=roundResult?round(result):result;
     }
   }
+  delete[] out;
 
-  RESAMPLE_END;
-  return true;
+  job->done+=len;
 }
 
-bool DivSample::resampleBlep(double sRate, double tRate) {
-  RESAMPLE_BEGIN;
-
-  double posFrac=0;
-  unsigned int posInt=0;
-  double factor=tRate/sRate;
-  float* sincITable=DivFilterTables::getSincIntegralTable();
+bool DivSample::resamplePrepare(DivSampleResampleJob* job) {
+  if (depth!=DIV_SAMPLE_DEPTH_8BIT && depth!=DIV_SAMPLE_DEPTH_16BIT) return false;
+  if (job->tRate<100) return false;
+  if (job->filter<DIV_RESAMPLE_NONE || job->filter>DIV_RESAMPLE_BEST) return false;
+  if (job->in!=NULL) return false;
 
-  float* floatData=new float[finalCount];
-  memset(floatData,0,finalCount*sizeof(float));
+  job->depth=depth;
+  job->loopStart=loopStart;
+  job->inLen=0;
+  if (samples<1) return true;
 
   if (depth==DIV_SAMPLE_DEPTH_16BIT) {
-    memset(data16,0,finalCount*sizeof(short));
-    for (int i=0; i<finalCount; i++) {
-      if (posInt<samples) {
-        data16[i]=oldData16[posInt];
-      }
-      
-      posFrac+=1.0;
-      while (posFrac>=1.0) {
-        unsigned int n=((unsigned int)(posFrac*8192.0))&8191;
-        posFrac-=factor;
-        posInt++;
-
-        float* t1=&sincITable[(8191-n)<<3];
-        float* t2=&sincITable[n<<3];
-        float delta=oldData16[posInt]-oldData16[posInt-1];
-
-        for (int j=0; j<8; j++) {
-          if (i-j>0) {
-            floatData[i-j]+=t1[j]*-delta;
-          }
-          if (i+j+1<finalCount) {
-            floatData[i+j+1]+=t2[j]*delta;
-          }
-        }
-      }
-    }
-    for (int i=0; i<finalCount; i++) {
-      float result=floatData[i]+data16[i];
-      if (result<-32768) result=-32768;
-      if (result>32767) result=32767;
-      data16[i]=round(result);
-    }
-  } else if (depth==DIV_SAMPLE_DEPTH_8BIT) {
-    memset(data8,0,finalCount);
-    for (int i=0; i<finalCount; i++) {
-      if (posInt<samples) {
-        data8[i]=oldData8[posInt];
-      }
-      
-      posFrac+=1.0;
-      while (posFrac>=1.0) {
-        unsigned int n=((unsigned int)(posFrac*8192.0))&8191;
-        posFrac-=factor;
-        posInt++;
-
-        float* t1=&sincITable[(8191-n)<<3];
-        float* t2=&sincITable[n<<3];
-        float delta=oldData8[posInt]-oldData8[posInt-1];
-
-        for (int j=0; j<8; j++) {
-          if (i-j>0) {
-            floatData[i-j]+=t1[j]*-delta;
-          }
-          if (i+j+1<finalCount) {
-            floatData[i+j+1]+=t2[j]*delta;
-          }
-        }
-      }
-    }
-    for (int i=0; i<finalCount; i++) {
-      float result=floatData[i]+data8[i];
-      if (result<-128) result=-128;
-      if (result>127) result=127;
-      data8[i]=round(result);
-    }
+    if (data16==NULL) return false;
+  } else {
+    if (data8==NULL) return false;
   }
-  delete[] floatData;
 
-  RESAMPLE_END;
+  // the kernels work on floats regardless of depth
+  job->in=new float[samples];
+  job->inLen=samples;
+  if (depth==DIV_SAMPLE_DEPTH_16BIT) {
+    for (unsigned int i=0; i<samples; i++) job->in[i]=data16[i];
+  } else {
+    for (unsigned int i=0; i<samples; i++) job->in[i]=data8[i];
+  }
   return true;
 }
 
-bool DivSample::resampleSinc(double sRate, double tRate) {
-  RESAMPLE_BEGIN;
+bool DivSample::resampleRender(DivSampleResampleJob* job) {
+  if (job->inLen<1 || job->in==NULL) {
+    job->finalCount=0;
+    return true;
+  }
 
-  double posFrac=0;
-  unsigned int posInt=0;
-  double factor=sRate/tRate;
-  float* sincTable=DivFilterTables::getSincTable();
-  float s[16];
+  int filter=job->filter;
+  if (filter==DIV_RESAMPLE_BEST) {
+    filter=(job->tRate>job->sRate)?DIV_RESAMPLE_SINC:DIV_RESAMPLE_BLEP;
+  }
 
-  memset(s,0,16*sizeof(float));
+  const float* in=job->in;
+  unsigned int samples=job->inLen;
+  int loopStart=job->loopStart;
+  unsigned int finalCount=(double)samples*(job->tRate/job->sRate);
+  job->finalCount=finalCount;
+  job->total=finalCount;
+  job->done=0;
+  // the sample is resampled down to nothing
+  if (finalCount==0) {
+    delete[] job->in;
+    job->in=NULL;
+    return true;
+  }
+  if (job->depth==DIV_SAMPLE_DEPTH_16BIT) {
+    job->result=new short[finalCount];
+  } else {
+    job->result=new signed char[finalCount];
+  }
 
-  if (depth==DIV_SAMPLE_DEPTH_16BIT) {
-    for (int i=0; i<finalCount+8; i++) {
-      unsigned int n=((unsigned int)(posFrac*8192.0))&8191;
-      float result=0;
-      float* t1=&sincTable[(8191-n)<<3];
-      float* t2=&sincTable[n<<3];
-      for (int j=0; j<8; j++) {
-        result+=s[j]*t2[7-j];
-        result+=s[8+j]*t1[j];
-      }
-      if (result<-32768) result=-32768;
-      if (result>32767) result=32767;
-      if (i>=8) {
-        data16[i-8]=result;
-      }
-      
-      posFrac+=factor;
-      while (posFrac>=1.0) {
-        posFrac-=1.0;
-        posInt++;
-
-        for (int j=0; j<15; j++) s[j]=s[j+1];
-        s[15]=(posInt>=samples)?0:oldData16[posInt];
+  unsigned int chunkCount=(finalCount+DIV_RESAMPLE_CHUNK-1)/DIV_RESAMPLE_CHUNK;
+  DivResampleChunk* chunks=new DivResampleChunk[chunkCount];
+  for (unsigned int i=0; i<chunkCount; i++) {
+    DivResampleChunk& c=chunks[i];
+    c.job=job;
+    c.in=in;
+    c.inLen=samples;
+    c.finalCount=finalCount;
+    c.begin=i*DIV_RESAMPLE_CHUNK;
+    c.end=c.begin+DIV_RESAMPLE_CHUNK;
+    if (c.end>finalCount) c.end=finalCount;
+    c.loopSample=(loopStart>=0 && loopStart<(int)samples)?in[loopStart]:0;
+    c.filter=filter;
+  }
+
+  if (chunkCount>1) {
+    int threads=(int)std::thread::hardware_concurrency()-1;
+    if (threads>(int)chunkCount-1) threads=chunkCount-1;
+    if (threads<0) threads=0;
+    logV("resampling %d samples in %d chunks (%d threads)",finalCount,chunkCount,threads+1);
+    DivWorkPool pool(threads);
+    for (unsigned int i=0; i<chunkCount; i+=DIV_WORK_POOL_MAX_TASKS) {
+      for (unsigned int j=i; j<chunkCount && j<i+DIV_WORK_POOL_MAX_TASKS; j++) {
+        pool.push(resampleChunk,&chunks[j],chunks[j].end-chunks[j].begin);
       }
+      pool.wait();
+      if (job->cancel) break;
     }
+  } else {
+    resampleChunk(&chunks[0]);
+  }
+
+  delete[] chunks;
+  delete[] job->in;
+  job->in=NULL;
+
+  if (job->cancel) {
+    logV("resampling cancelled");
+    return false;
+  }
+  return true;
+}
+
+bool DivSample::resampleApply(DivSampleResampleJob* job) {
+  if (job->depth!=depth) return false;
+  // a NULL result is only valid if the sample became empty
+  if (job->result==NULL && job->finalCount!=0) return false;
+
+  double ratio=job->tRate/job->sRate;
+  if (depth==DIV_SAMPLE_DEPTH_16BIT) {
+    short* oldData16=data16;
+    data16=NULL;
+    initInternal(DIV_SAMPLE_DEPTH_16BIT,job->finalCount);
+    if (job->finalCount>0) memcpy(data16,job->result,job->finalCount*sizeof(short));
+    delete[] oldData16;
   } else if (depth==DIV_SAMPLE_DEPTH_8BIT) {
-    for (int i=0; i<finalCount+8; i++) {
-      unsigned int n=((unsigned int)(posFrac*8192.0))&8191;
-      float result=0;
-      float* t1=&sincTable[(8191-n)<<3];
-      float* t2=&sincTable[n<<3];
-      for (int j=0; j<8; j++) {
-        result+=s[j]*t2[7-j];
-        result+=s[8+j]*t1[j];
-      }
-      if (result<-128) result=-128;
-      if (result>127) result=127;
-      if (i>=8) {
-        data8[i-8]=result;
-      }
-      
-      posFrac+=factor;
-      while (posFrac>=1.0) {
-        posFrac-=1.0;
-        posInt++;
-
-        for (int j=0; j<15; j++) s[j]=s[j+1];
-        s[15]=(posInt>=samples)?0:oldData8[posInt];
-      }
-    }
+    signed char* oldData8=data8;
+    data8=NULL;
+    initInternal(DIV_SAMPLE_DEPTH_8BIT,job->finalCount);
+    if (job->finalCount>0) memcpy(data8,job->result,job->finalCount);
+    delete[] oldData8;
+  } else {
+    return false;
   }
 
-  RESAMPLE_END;
+  if (loopStart>=0) loopStart=(double)loopStart*ratio;
+  if (loopEnd>=0) loopEnd=(double)loopEnd*ratio;
+  centerRate=(int)((double)centerRate*ratio);
+  samples=job->finalCount;
   return true;
 }
 
 bool DivSample::resample(double sRate, double tRate, int filter) {
-  if (depth!=DIV_SAMPLE_DEPTH_8BIT && depth!=DIV_SAMPLE_DEPTH_16BIT) return false;
-  if (tRate<100) return false;
-  switch (filter) {
-    case DIV_RESAMPLE_NONE:
-      return resampleNone(sRate,tRate);
-      break;
-    case DIV_RESAMPLE_LINEAR:
-      return resampleLinear(sRate,tRate);
-      break;
-    case DIV_RESAMPLE_CUBIC:
-      return resampleCubic(sRate,tRate);
-      break;
-    case DIV_RESAMPLE_BLEP:
-      return resampleBlep(sRate,tRate);
-      break;
-    case DIV_RESAMPLE_SINC:
-      return resampleSinc(sRate,tRate);
-      break;
-    case DIV_RESAMPLE_BEST:
-      if (tRate>sRate) {
-        return resampleSinc(sRate,tRate);
-      } else {
-        return resampleBlep(sRate,tRate);
-      }
-      break;
-  }
-  return false;
+  DivSampleResampleJob job(sRate,tRate,filter);
+  if (!resamplePrepare(&job)) return false;
+  if (!resampleRender(&job)) return false;
+  return resampleApply(&job);
 }
 
 #define NOT_IN_FORMAT(x) (depth!=x && formatMask&(1U<<(unsigned int)x))
@@ -1663,17 +1715,224 @@ unsigned int DivSample::getCurBufLen() {
   return 0;
 }
 
+void DivSample::invalidateMinMax(unsigned int begin, unsigned int end) {
+  if (begin>=end) return;
+  if (minMaxDirtyBegin>=minMaxDirtyEnd) {
+    minMaxDirtyBegin=begin;
+    minMaxDirtyEnd=end;
+    return;
+  }
+  if (begin<minMaxDirtyBegin) minMaxDirtyBegin=begin;
+  if (end>minMaxDirtyEnd) minMaxDirtyEnd=end;
+}
+
+void DivSample::refreshMinMax() {
+  bool use8=(depth==DIV_SAMPLE_DEPTH_8BIT);
+  if ((use8?(void*)data8:(void*)data16)==NULL || samples==0) {
+    if (minMax!=NULL) {
+      delete[] minMax;
+      minMax=NULL;
+    }
+    minMaxLevels=0;
+    minMaxLen=0;
+    minMaxDirtyBegin=0;
+    minMaxDirtyEnd=0;
+    return;
+  }
+
+  // (re)allocate if the layout changed
+  if (minMax==NULL || minMaxLen!=samples || minMax8!=use8) {
+    if (minMax!=NULL) delete[] minMax;
+    unsigned int total=0;
+    minMaxLevels=0;
+    for (int i=0; i<DIV_SAMPLE_MINMAX_LEVELS; i++) {
+      unsigned int shift=DIV_SAMPLE_MINMAX_SHIFT+i*DIV_SAMPLE_MINMAX_STEP;
+      unsigned int blocks=(samples+(1U<<shift)-1)>>shift;
+      minMaxLevelPos[i]=total;
+      total+=blocks<<1;
+      minMaxLevels++;
+      if (blocks<=1) break;
+    }
+    logV("allocating min/max pyramid (%d levels, %d entries)",minMaxLevels,total);
+    minMax=new short[total];
+    minMaxLen=samples;
+    minMax8=use8;
+    minMaxDirtyBegin=0;
+    minMaxDirtyEnd=samples;
+  }
+
+  if (minMaxDirtyEnd>minMaxLen) minMaxDirtyEnd=minMaxLen;
+  if (minMaxDirtyBegin>=minMaxDirtyEnd) {
+    minMaxDirtyBegin=0;
+    minMaxDirtyEnd=0;
+    return;
+  }
+  unsigned int begin=minMaxDirtyBegin;
+  unsigned int end=minMaxDirtyEnd;
+  minMaxDirtyBegin=0;
+  minMaxDirtyEnd=0;
+
+  // finest level from the sample data
+  short* out=&minMax[minMaxLevelPos[0]];
+  for (unsigned int i=begin>>DIV_SAMPLE_MINMAX_SHIFT; i<=((end-1)>>DIV_SAMPLE_MINMAX_SHIFT); i++) {
+    unsigned int pos=i<<DIV_SAMPLE_MINMAX_SHIFT;
+    unsigned int posEnd=MIN(pos+(1U<<DIV_SAMPLE_MINMAX_SHIFT),minMaxLen);
+    short lo, hi;
+    if (use8) {
+      lo=hi=data8[pos];
+      for (pos++; pos<posEnd; pos++) {
+        if (lo>data8[pos]) lo=data8[pos];
+        if (hi<data8[pos]) hi=data8[pos];
+      }
+    } else {
+      lo=hi=data16[pos];
+      for (pos++; pos<posEnd; pos++) {
+        if (lo>data16[pos]) lo=data16[pos];
+        if (hi<data16[pos]) hi=data16[pos];
+      }
+    }
+    out[i<<1]=lo;
+    out[(i<<1)|1]=hi;
+  }
+
+  // coarser levels from the previous one
+  for (unsigned int level=1; level<minMaxLevels; level++) {
+    unsigned int shift=DIV_SAMPLE_MINMAX_SHIFT+level*DIV_SAMPLE_MINMAX_STEP;
+    unsigned int prevShift=shift-DIV_SAMPLE_MINMAX_STEP;
+    unsigned int prevBlocks=(minMaxLen+(1U<<prevShift)-1)>>prevShift;
+    short* in=&minMax[minMaxLevelPos[level-1]];
+    out=&minMax[minMaxLevelPos[level]];
+    for (unsigned int i=begin>>shift; i<=((end-1)>>shift); i++) {
+      unsigned int child=i<<DIV_SAMPLE_MINMAX_STEP;
+      unsigned int childEnd=MIN(child+(1U<<DIV_SAMPLE_MINMAX_STEP),prevBlocks);
+      short lo=in[child<<1];
+      short hi=in[(child<<1)|1];
+      for (child++; child<childEnd; child++) {
+        if (lo>in[child<<1]) lo=in[child<<1];
+        if (hi<in[(child<<1)|1]) hi=in[(child<<1)|1];
+      }
+      out[i<<1]=lo;
+      out[(i<<1)|1]=hi;
+    }
+  }
+}
+
+bool DivSample::getMinMax(unsigned int begin, unsigned int end, short& outMin, short& outMax) {
+  refreshMinMax();
+  if (end>minMaxLen) end=minMaxLen;
+  if (minMax==NULL || begin>=end) return false;
+
+  short lo=SHRT_MAX;
+  short hi=SHRT_MIN;
+  unsigned int pos=begin;
+  while (pos<end) {
+    // use the coarsest block which starts here and fits in the range
+    int level=-1;
+    for (int i=minMaxLevels-1; i>=0; i--) {
+      unsigned int shift=DIV_SAMPLE_MINMAX_SHIFT+i*DIV_SAMPLE_MINMAX_STEP;
+      if (pos&((1U<<shift)-1)) continue;
+      if (MIN(pos+(1U<<shift),minMaxLen)>end) continue;
+      level=i;
+      break;
+    }
+    if (level<0) {
+      // not aligned to a block - read samples up to the next one
+      unsigned int next=MIN((pos|((1U<<DIV_SAMPLE_MINMAX_SHIFT)-1))+1,end);
+      if (minMax8) {
+        for (; pos<next; pos++) {
+          if (lo>data8[pos]) lo=data8[pos];
+          if (hi<data8[pos]) hi=data8[pos];
+        }
+      } else {
+        for (; pos<next; pos++) {
+          if (lo>data16[pos]) lo=data16[pos];
+          if (hi<data16[pos]) hi=data16[pos];
+        }
+      }
+      continue;
+    }
+    unsigned int shift=DIV_SAMPLE_MINMAX_SHIFT+level*DIV_SAMPLE_MINMAX_STEP;
+    const short* m=&minMax[minMaxLevelPos[level]+((pos>>shift)<<1)];
+    if (lo>m[0]) lo=m[0];
+    if (hi<m[1]) hi=m[1];
+    pos+=1U<<shift;
+  }
+  outMin=lo;
+  outMax=hi;
+  return true;
+}
+
+void DivSample::settleUndo() {
+  unsigned char* buf=(unsigned char*)getCurBuf();
+  unsigned int bufLen=(buf==NULL)?0:getCurBufLen();
+
+  if (undoBase==NULL || buf==NULL || undoBaseLen!=bufLen || undoBaseDepth!=depth) {
+    // the layout changed (or there is no base yet). the pending step takes the whole old buffer.
+    if (undoPending!=NULL) {
+      undoPending->data=undoBase;
+      undoPending->length=undoBaseLen;
+    } else if (undoBase!=NULL) {
+      delete[] undoBase;
+    }
+    undoBase=NULL;
+    undoBaseLen=0;
+    if (buf!=NULL) {
+      undoBase=new unsigned char[bufLen];
+      memcpy(undoBase,buf,bufLen);
+      undoBaseLen=bufLen;
+    }
+    undoBaseDepth=depth;
+    undoPending=NULL;
+    return;
+  }
+
+  // find the chunks which changed since the base was taken
+  unsigned int chunkTotal=(bufLen+DIV_SAMPLE_UNDO_CHUNK-1)/DIV_SAMPLE_UNDO_CHUNK;
+  unsigned int* changed=new unsigned int[MAX(chunkTotal,1)];
+  unsigned int changedCount=0;
+  unsigned int changedLen=0;
+  for (unsigned int i=0; i<chunkTotal; i++) {
+    unsigned int pos=i*DIV_SAMPLE_UNDO_CHUNK;
+    unsigned int len=MIN(DIV_SAMPLE_UNDO_CHUNK,bufLen-pos);
+    if (memcmp(undoBase+pos,buf+pos,len)!=0) {
+      changed[changedCount++]=i;
+      changedLen+=len;
+    }
+  }
+
+  // the pending step keeps the old contents of those chunks
+  if (undoPending!=NULL) {
+    undoPending->chunks=new unsigned int[MAX(changedCount,1)];
+    undoPending->chunkCount=changedCount;
+    undoPending->data=(changedLen>0)?(new unsigned char[changedLen]):NULL;
+    undoPending->length=bufLen;
+    unsigned char* out=undoPending->data;
+    for (unsigned int i=0; i<changedCount; i++) {
+      unsigned int pos=changed[i]*DIV_SAMPLE_UNDO_CHUNK;
+      unsigned int len=MIN(DIV_SAMPLE_UNDO_CHUNK,bufLen-pos);
+      undoPending->chunks[i]=changed[i];
+      memcpy(out,undoBase+pos,len);
+      out+=len;
+    }
+    undoPending=NULL;
+  }
+
+  // bring the base up to date
+  for (unsigned int i=0; i<changedCount; i++) {
+    unsigned int pos=changed[i]*DIV_SAMPLE_UNDO_CHUNK;
+    unsigned int len=MIN(DIV_SAMPLE_UNDO_CHUNK,bufLen-pos);
+    memcpy(undoBase+pos,buf+pos,len);
+  }
+  delete[] changed;
+}
+
 DivSampleHistory* DivSample::prepareUndo(bool data, bool doNotPush) {
   DivSampleHistory* h;
   if (data) {
-    unsigned char* duplicate;
-    if (getCurBuf()==NULL) {
-      duplicate=NULL;
-    } else {
-      duplicate=new unsigned char[getCurBufLen()];
-      memcpy(duplicate,getCurBuf(),getCurBufLen());
-    }
-    h=new DivSampleHistory(duplicate,getCurBufLen(),samples,depth,centerRate,loopStart,loopEnd,loop,brrEmphasis,brrNoFilter,dither,loopMode);
+    settleUndo();
+    // the data is filled in by settleUndo() once the change has been made
+    h=new DivSampleHistory(NULL,undoBaseLen,samples,depth,centerRate,loopStart,loopEnd,loop,brrEmphasis,brrNoFilter,dither,loopMode);
+    if (!doNotPush) undoPending=h;
   } else {
     h=new DivSampleHistory(depth,centerRate,loopStart,loopEnd,loop,brrEmphasis,brrNoFilter,dither,loopMode);
   }
@@ -1683,63 +1942,135 @@ DivSampleHistory* DivSample::prepareUndo(bool data, bool doNotPush) {
       delete h;
       redoHist.pop_back();
     }
-    if (undoHist.size()>100) undoHist.pop_front();
+    // drop the oldest steps if there are too many or they take too much memory.
+    // the base copy the delta steps are made against counts as well.
+    size_t undoSize=undoBaseLen;
+    for (size_t i=0; i<undoHist.size(); i++) {
+      undoSize+=undoHist[i]->getSize();
+    }
+    while (!undoHist.empty() && (undoHist.size()>100 || undoSize>DIV_SAMPLE_UNDO_MAX_SIZE)) {
+      DivSampleHistory* old=undoHist.front();
+      undoSize-=old->getSize();
+      delete old;
+      undoHist.pop_front();
+    }
     undoHist.push_back(h);
   }
   return h;
 }
 
-#define applyHistory \
-  depth=h->depth; \
-  if (h->hasSample) { \
-    initInternal(h->depth,h->samples); \
-    samples=h->samples; \
-\
-    if (h->length!=getCurBufLen()) logW("undo buffer length not equal to current buffer length! %d != %d",h->length,getCurBufLen()); \
-\
-    void* buf=getCurBuf(); \
-\
-    if (buf!=NULL && h->data!=NULL) { \
-      memcpy(buf,h->data,h->length); \
-    } \
-  } \
-  centerRate=h->centerRate; \
-  loopStart=h->loopStart; \
-  loopEnd=h->loopEnd; \
-  loop=h->loop; \
-  brrEmphasis=h->brrEmphasis; \
-  brrNoFilter=h->brrNoFilter; \
-  dither=h->dither; \
+void DivSample::swapHistory(DivSampleHistory* h) {
+  DivSampleHistory prev(depth,centerRate,loopStart,loopEnd,loop,brrEmphasis,brrNoFilter,dither,loopMode);
+  unsigned int prevSamples=samples;
+
+  if (h->hasSample) {
+    unsigned char* buf=(unsigned char*)getCurBuf();
+    unsigned int bufLen=(buf==NULL)?0:getCurBufLen();
+    if (h->chunks!=NULL && buf!=NULL && h->depth==depth && h->samples==samples && h->length==bufLen) {
+      // delta step: exchange the stored chunks with the current ones
+      unsigned char* stored=h->data;
+      for (unsigned int i=0; i<h->chunkCount; i++) {
+        unsigned int pos=h->chunks[i]*DIV_SAMPLE_UNDO_CHUNK;
+        unsigned int len=MIN(DIV_SAMPLE_UNDO_CHUNK,bufLen-pos);
+        for (unsigned int j=0; j<len; j++) {
+          unsigned char t=buf[pos+j];
+          buf[pos+j]=stored[j];
+          stored[j]=t;
+        }
+        memcpy(undoBase+pos,buf+pos,len);
+        if (depth==DIV_SAMPLE_DEPTH_16BIT) {
+          invalidateMinMax(pos>>1,(pos+len+1)>>1);
+        } else if (depth==DIV_SAMPLE_DEPTH_8BIT) {
+          invalidateMinMax(pos,pos+len);
+        }
+        stored+=len;
+      }
+    } else {
+      if (h->chunks!=NULL) {
+        logW("delta undo step does not match the sample! restoring nothing.");
+        h->depth=depth;
+      }
+      // full step: the base (which is equal to the current buffer) becomes the opposite step
+      unsigned char* prevData=undoBase;
+      unsigned int prevLen=undoBaseLen;
+      undoBase=NULL;
+      undoBaseLen=0;
+
+      if (h->chunks==NULL) {
+        depth=h->depth;
+        initInternal(h->depth,h->samples);
+        samples=h->samples;
+
+        if (h->length!=getCurBufLen()) logW("undo buffer length not equal to current buffer length! %d != %d",h->length,getCurBufLen());
+
+        buf=(unsigned char*)getCurBuf();
+        if (buf!=NULL && h->data!=NULL) {
+          memcpy(buf,h->data,MIN(h->length,getCurBufLen()));
+        }
+
+        // ...and the restored buffer becomes the base
+        undoBase=h->data;
+        undoBaseLen=h->length;
+        undoBaseDepth=depth;
+        h->data=NULL;
+      }
+
+      if (h->data!=NULL) delete[] h->data;
+      if (h->chunks!=NULL) delete[] h->chunks;
+      h->data=prevData;
+      h->length=prevLen;
+      h->chunks=NULL;
+      h->chunkCount=0;
+    }
+    h->samples=prevSamples;
+  }
+
+  depth=h->depth;
+  centerRate=h->centerRate;
+  loopStart=h->loopStart;
+  loopEnd=h->loopEnd;
+  loop=h->loop;
+  brrEmphasis=h->brrEmphasis;
+  brrNoFilter=h->brrNoFilter;
+  dither=h->dither;
   loopMode=h->loopMode;
 
+  h->depth=prev.depth;
+  h->centerRate=prev.centerRate;
+  h->loopStart=prev.loopStart;
+  h->loopEnd=prev.loopEnd;
+  h->loop=prev.loop;
+  h->brrEmphasis=prev.brrEmphasis;
+  h->brrNoFilter=prev.brrNoFilter;
+  h->dither=prev.dither;
+  h->loopMode=prev.loopMode;
+}
 
 int DivSample::undo() {
   if (undoHist.empty()) return 0;
+  settleUndo();
   DivSampleHistory* h=undoHist.back();
-  DivSampleHistory* redo=prepareUndo(h->hasSample,true);
+  undoHist.pop_back();
 
   int ret=h->hasSample?2:1;
 
-  applyHistory;
+  swapHistory(h);
 
-  redoHist.push_back(redo);
-  delete h;
-  undoHist.pop_back();
+  redoHist.push_back(h);
   return ret;
 }
 
 int DivSample::redo() {
   if (redoHist.empty()) return 0;
+  settleUndo();
   DivSampleHistory* h=redoHist.back();
-  DivSampleHistory* undo=prepareUndo(h->hasSample,true);
+  redoHist.pop_back();
 
   int ret=h->hasSample?2:1;
 
-  applyHistory;
+  swapHistory(h);
 
-  undoHist.push_back(undo);
-  delete h;
-  redoHist.pop_back();
+  undoHist.push_back(h);
   return ret;
 }
 
@@ -1770,4 +2101,6 @@ DivSample::~DivSample() {
   if (dataIMA) delete[] dataIMA;
   if (data12) delete[] data12;
   if (data4) delete[] data4;
+  if (minMax) delete[] minMax;
+  if (undoBase) delete[] undoBase;
 }
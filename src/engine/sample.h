@@ -25,6 +25,7 @@
 #include "safeWriter.h"
 #include "dataErrors.h"
 #include "../fixedQueue.h"
+#include <atomic>
 
 enum DivSampleLoopMode: unsigned char {
   DIV_SAMPLE_LOOP_FORWARD=0,
@@ -62,7 +63,23 @@ enum DivResampleFilters {
   DIV_RESAMPLE_BEST
 };
 
+// the finest level of the waveform min/max pyramid covers blocks of 1<<DIV_SAMPLE_MINMAX_SHIFT samples.
+// each following level merges 1<<DIV_SAMPLE_MINMAX_STEP blocks of the previous one.
+#define DIV_SAMPLE_MINMAX_SHIFT 4
+#define DIV_SAMPLE_MINMAX_STEP 2
+#define DIV_SAMPLE_MINMAX_LEVELS 11
+
+// undo steps only store the chunks of the sample buffer which were changed.
+#define DIV_SAMPLE_UNDO_CHUNK 4096
+// maximum memory used by the undo history of a sample, including its base copy (the oldest steps are dropped past this).
+// if the base copy alone is larger, only the latest step is kept.
+#define DIV_SAMPLE_UNDO_MAX_SIZE (64*1024*1024)
+
+// resampling is split into chunks of this many output samples, which are processed in parallel.
+#define DIV_RESAMPLE_CHUNK 65536
+
 struct DivSampleHistory {
+  // the whole buffer, or the stored chunks one after another if this is a delta step (chunks!=NULL)
   unsigned char* data;
   unsigned int length, samples;
   DivSampleDepth depth;
@@ -70,6 +87,15 @@ struct DivSampleHistory {
   bool loop, brrEmphasis, brrNoFilter, dither;
   DivSampleLoopMode loopMode;
   bool hasSample;
+  // indices of the stored chunks (in units of DIV_SAMPLE_UNDO_CHUNK)
+  unsigned int* chunks;
+  unsigned int chunkCount;
+
+  /**
+   * get the memory used by this step.
+   * @return the size in bytes.
+   */
+  size_t getSize();
   DivSampleHistory(void* d, unsigned int l, unsigned int s, DivSampleDepth de, int cr, int ls, int le, bool lp, bool be, bool bf, bool di, DivSampleLoopMode lm):
     data((unsigned char*)d),
     length(l),
@@ -83,7 +109,9 @@ struct DivSampleHistory {
     brrNoFilter(bf),
     dither(di),
     loopMode(lm),
-    hasSample(true) {}
+    hasSample(true),
+    chunks(NULL),
+    chunkCount(0) {}
   DivSampleHistory(DivSampleDepth de, int cr, int ls, int le, bool lp, bool be, bool bf, bool di, DivSampleLoopMode lm):
     data(NULL),
     length(0),
@@ -97,10 +125,46 @@ struct DivSampleHistory {
     brrNoFilter(bf),
     dither(di),
     loopMode(lm),
-    hasSample(false) {}
+    hasSample(false),
+    chunks(NULL),
+    chunkCount(0) {}
   ~DivSampleHistory();
 };
 
+// a resampling operation which may run outside of a synchronized block.
+// see DivSample::resampleRender() and DivSample::resampleApply().
+struct DivSampleResampleJob {
+  double sRate, tRate;
+  int filter;
+  DivSampleDepth depth;
+  // a copy of the input taken by resamplePrepare(), so that rendering doesn't touch the sample
+  float* in;
+  unsigned int inLen;
+  int loopStart;
+  // output length and data (in the depth above) after rendering
+  unsigned int finalCount;
+  void* result;
+  // progress in output samples
+  std::atomic<unsigned int> done, total;
+  // set to abort rendering
+  std::atomic<bool> cancel;
+
+  DivSampleResampleJob(double s, double t, int f):
+    sRate(s),
+    tRate(t),
+    filter(f),
+    depth(DIV_SAMPLE_DEPTH_16BIT),
+    in(NULL),
+    inLen(0),
+    loopStart(-1),
+    finalCount(0),
+    result(NULL),
+    done(0),
+    total(0),
+    cancel(false) {}
+  ~DivSampleResampleJob();
+};
+
 struct DivSample {
   String name;
   int centerRate, loopStart, loopEnd;
@@ -153,15 +217,38 @@ struct DivSample {
 
   unsigned int samples;
 
+  // min/max pyramid of the displayed waveform (data8 for 8-bit samples, data16 otherwise).
+  // built on first use by getMinMax() and refreshed in parts after invalidateMinMax().
+  short* minMax;
+  unsigned int minMaxLevelPos[DIV_SAMPLE_MINMAX_LEVELS];
+  unsigned int minMaxLevels, minMaxLen;
+  unsigned int minMaxDirtyBegin, minMaxDirtyEnd;
+  bool minMax8;
+
   FixedQueue<DivSampleHistory*,128> undoHist;
   FixedQueue<DivSampleHistory*,128> redoHist;
 
+  // copy of the buffer as of the last undo step, used to find out what changed.
+  unsigned char* undoBase;
+  unsigned int undoBaseLen;
+  DivSampleDepth undoBaseDepth;
+  // the latest undo step with data, which is filled in by settleUndo().
+  DivSampleHistory* undoPending;
+
   /**
    * put sample data.
    * @param w a SafeWriter.
    */
   void putSampleData(SafeWriter* w);
 
+  /**
+   * copy this sample's data and the properties which are saved to another sample.
+   * undo history and rendered data are not copied.
+   * @param dest the destination sample.
+   * @return whether the copy succeeded.
+   */
+  bool copyOn(DivSample* dest);
+
   /**
    * read sample data.
    * @param reader the reader.
@@ -205,15 +292,6 @@ struct DivSample {
    */
   void setSampleCount(unsigned int count);
 
-  /**
-   * @warning DO NOT USE - internal functions
-   */
-  bool resampleNone(double sRate, double tRate);
-  bool resampleLinear(double sRate, double tRate);
-  bool resampleCubic(double sRate, double tRate);
-  bool resampleBlep(double sRate, double tRate);
-  bool resampleSinc(double sRate, double tRate);
-
   /**
    * save this sample to a file.
    * @param path a path.
@@ -289,6 +367,29 @@ struct DivSample {
    */
   bool resample(double sRate, double tRate, int filter);
 
+  /**
+   * copy the sample data into a resampling job, so that it can be rendered later.
+   * @param job the job.
+   * @return whether it was successful.
+   */
+  bool resamplePrepare(DivSampleResampleJob* job);
+
+  /**
+   * render a prepared resampling job.
+   * this only touches the job, so it may be called from another thread while the sample is edited or deleted.
+   * @param job the job. its progress is updated as chunks are finished.
+   * @return whether it was successful (false if the job was cancelled).
+   */
+  static bool resampleRender(DivSampleResampleJob* job);
+
+  /**
+   * replace the sample data with the result of a rendered resampling job.
+   * @warning do not attempt to do this outside of a synchronized block!
+   * @param job the job.
+   * @return whether it was successful.
+   */
+  bool resampleApply(DivSampleResampleJob* job);
+
   /**
    * convert sample depth.
    * @warning do not attempt to do this outside of a synchronized block!
@@ -313,14 +414,53 @@ struct DivSample {
    */
   unsigned int getCurBufLen();
 
+  /**
+   * get the lowest and highest value of the displayed waveform within a range.
+   * this is data8 for 8-bit samples and data16 otherwise.
+   * runs in logarithmic time using the min/max pyramid.
+   * @param begin the first sample.
+   * @param end the sample after the last one.
+   * @param outMin the lowest value.
+   * @param outMax the highest value.
+   * @return whether the range contains any data.
+   */
+  bool getMinMax(unsigned int begin, unsigned int end, short& outMin, short& outMax);
+
+  /**
+   * mark part of the min/max pyramid as outdated.
+   * call this after writing to data8/data16 directly (not needed after init/resize/strip/trim/insert/undo/redo).
+   * @param begin the first modified sample.
+   * @param end the sample after the last modified one.
+   */
+  void invalidateMinMax(unsigned int begin=0, unsigned int end=0xffffffff);
+
+  /**
+   * @warning DO NOT USE - internal function
+   * rebuild the outdated part of the min/max pyramid.
+   */
+  void refreshMinMax();
+
   /**
    * prepare an undo step for this sample.
+   * if data is included, only the chunks which change before the next undo step (or undo/redo) are stored.
    * @param data whether to include sample data.
    * @param doNotPush if this is true, don't push the DivSampleHistory to the undo history.
    * @return the undo step.
    */
   DivSampleHistory* prepareUndo(bool data, bool doNotPush=false);
 
+  /**
+   * @warning DO NOT USE - internal function
+   * store the changes made since the last undo step and update the undo base.
+   */
+  void settleUndo();
+
+  /**
+   * @warning DO NOT USE - internal function
+   * exchange the state in an undo/redo step with the current one.
+   */
+  void swapHistory(DivSampleHistory* h);
+
   /**
    * undo. you may need to call DivEngine::renderSamples afterwards.
    * @warning do not attempt to undo outside of a synchronized block!
@@ -378,12 +518,23 @@ struct DivSample {
     lengthIMA(0),
     length12(0),
     length4(0),
-    samples(0) {
+    samples(0),
+    minMax(NULL),
+    minMaxLevels(0),
+    minMaxLen(0),
+    minMaxDirtyBegin(0),
+    minMaxDirtyEnd(0),
+    minMax8(false),
+    undoBase(NULL),
+    undoBaseLen(0),
+    undoBaseDepth(DIV_SAMPLE_DEPTH_16BIT),
+    undoPending(NULL) {
     for (int i=0; i<DIV_MAX_CHIPS; i++) {
       for (int j=0; j<DIV_MAX_SAMPLE_TYPE; j++) {
         renderOn[j][i]=true;
       }
     }
+    memset(minMaxLevelPos,0,DIV_SAMPLE_MINMAX_LEVELS*sizeof(unsigned int));
   }
   ~DivSample();
 };
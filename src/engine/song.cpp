@@ -38,11 +38,50 @@ DivSongTimestamps::DivSongTimestamps():
   totalTicks(0),
   totalRows(0),
   isLoopDefined(false),
-  isLoopable(true) {
+  isLoopable(true),
+  cache(NULL) {
   memset(orders,0,DIV_MAX_PATTERNS*sizeof(void*));
   memset(maxRow,0,DIV_MAX_PATTERNS);
 }
 
+DivSongTimestamps::DivSongTimestamps(const DivSongTimestamps& other):
+  cache(NULL) {
+  memset(orders,0,DIV_MAX_PATTERNS*sizeof(void*));
+  *this=other;
+}
+
+DivSongTimestamps& DivSongTimestamps::operator=(const DivSongTimestamps& other) {
+  if (this==&other) return *this;
+  totalTime=other.totalTime;
+  totalTicks=other.totalTicks;
+  totalRows=other.totalRows;
+  loopStart=other.loopStart;
+  loopEnd=other.loopEnd;
+  isLoopDefined=other.isLoopDefined;
+  isLoopable=other.isLoopable;
+  loopStartTime=other.loopStartTime;
+  memcpy(maxRow,other.maxRow,DIV_MAX_PATTERNS);
+
+  for (int i=0; i<DIV_MAX_PATTERNS; i++) {
+    if (other.orders[i]==NULL) {
+      if (orders[i]) {
+        delete[] orders[i];
+        orders[i]=NULL;
+      }
+      continue;
+    }
+    if (orders[i]==NULL) orders[i]=new TimeMicros[DIV_MAX_ROWS];
+    memcpy(orders[i],other.orders[i],DIV_MAX_ROWS*sizeof(TimeMicros));
+  }
+
+  // the cache belongs to the sub-song it was built for
+  if (cache) {
+    delete cache;
+    cache=NULL;
+  }
+  return *this;
+}
+
 DivSongTimestamps::~DivSongTimestamps() {
   for (int i=0; i<DIV_MAX_PATTERNS; i++) {
     if (orders[i]) {
@@ -50,34 +89,193 @@ DivSongTimestamps::~DivSongTimestamps() {
       orders[i]=NULL;
     }
   }
+  if (cache) {
+    delete cache;
+    cache=NULL;
+  }
 }
 
-void DivSubSong::calcTimestamps(int chans, std::vector<DivGroovePattern>& grooves, int jumpTreatment, int ignoreJumpAtEnd, int brokenSpeedSel, int delayBehavior, int firstPat) {
+bool DivTimestampWalkState::sameAs(const DivTimestampWalkState& other, int chans) const {
+  if (row!=other.row) return false;
+  if (prevOrder!=other.prevOrder || prevRow!=other.prevRow) return false;
+  if (totalRows!=other.totalRows || totalTicks!=other.totalTicks) return false;
+  if (totalTime.seconds!=other.totalTime.seconds || totalTime.micros!=other.totalTime.micros) return false;
+  if (totalMicrosOff!=other.totalMicrosOff || divider!=other.divider) return false;
+  if (curSpeeds.len!=other.curSpeeds.len) return false;
+  if (memcmp(curSpeeds.val,other.curSpeeds.val,sizeof(curSpeeds.val))!=0) return false;
+  if (curVirtualTempoN!=other.curVirtualTempoN || curVirtualTempoD!=other.curVirtualTempoD) return false;
+  if (nextSpeed!=other.nextSpeed || ticks!=other.ticks) return false;
+  if (tempoAccum!=other.tempoAccum || curSpeed!=other.curSpeed) return false;
+  if (changeOrd!=other.changeOrd || changePos!=other.changePos) return false;
+  if (shallStopSched!=other.shallStopSched || songWillEnd!=other.songWillEnd) return false;
+  if (isLoopDefined!=other.isLoopDefined) return false;
+  if (loopEndOrder!=other.loopEndOrder || loopEndRow!=other.loopEndRow) return false;
+  if (walkedHash!=other.walkedHash) return false;
+  for (int i=0; i<chans; i++) {
+    if (rowDelay[i]!=other.rowDelay[i]) return false;
+    // the delay position is only read while a delay is pending
+    if (rowDelay[i]>0) {
+      if (delayOrder[i]!=other.delayOrder[i] || delayRow[i]!=other.delayRow[i]) return false;
+    }
+  }
+  return true;
+}
+
+DivTimestampCache::DivTimestampCache():
+  valid(false),
+  chans(0),
+  jumpTreatment(0),
+  ignoreJumpAtEnd(0),
+  brokenSpeedSel(0),
+  delayBehavior(0),
+  firstPat(0),
+  virtualTempoN(150),
+  virtualTempoD(150),
+  hz(60.0f),
+  patLen(0),
+  ordersLen(0) {
+  memset(effectCols,0,DIV_MAX_CHANS);
+  memset(entry,0,DIV_MAX_PATTERNS*sizeof(void*));
+  for (int i=0; i<DIV_MAX_PATTERNS; i++) {
+    lastVisit[i]=-1;
+  }
+}
+
+DivTimestampCache::~DivTimestampCache() {
+  for (int i=0; i<DIV_MAX_PATTERNS; i++) {
+    if (entry[i]) {
+      delete entry[i];
+      entry[i]=NULL;
+    }
+  }
+}
+
+// key of a walked row for the walked set hash (splitmix64)
+static inline uint64_t walkedKey(unsigned int pos) {
+  uint64_t z=(uint64_t)pos+0x9e3779b97f4a7c15ULL;
+  z=(z^(z>>30))*0xbf58476d1ce4e5b9ULL;
+  z=(z^(z>>27))*0x94d049bb133111ebULL;
+  return z^(z>>31);
+}
+
+static bool groovesEqual(const DivGroovePattern& a, const DivGroovePattern& b) {
+  return (a.len==b.len && memcmp(a.val,b.val,sizeof(a.val))==0);
+}
+
+void DivSubSong::calcTimestamps(int chans, std::vector<DivGroovePattern>& grooves, int jumpTreatment, int ignoreJumpAtEnd, int brokenSpeedSel, int delayBehavior, int firstPat, const bool* changedOrders) {
   // reduced version of the playback routine for calculation.
   std::chrono::high_resolution_clock::time_point timeStart=std::chrono::high_resolution_clock::now();
 
-  // reset state
-  ts.totalTime=TimeMicros(0,0);
-  ts.totalTicks=0;
-  ts.totalRows=0;
-  ts.isLoopDefined=true;
-  ts.isLoopable=true;
+  if (ts.cache==NULL) ts.cache=new DivTimestampCache;
+  DivTimestampCache* cache=ts.cache;
+
+  // check whether the previous walk may be reused
+  bool canResume=(changedOrders!=NULL && cache->valid);
+  if (canResume) {
+    if (cache->chans!=chans || cache->jumpTreatment!=jumpTreatment || cache->ignoreJumpAtEnd!=ignoreJumpAtEnd ||
+        cache->brokenSpeedSel!=brokenSpeedSel || cache->delayBehavior!=delayBehavior || cache->firstPat!=firstPat) {
+      canResume=false;
+    } else if (cache->virtualTempoN!=virtualTempoN || cache->virtualTempoD!=virtualTempoD || cache->hz!=hz ||
+               cache->patLen!=patLen || cache->ordersLen!=ordersLen || !groovesEqual(cache->speeds,speeds)) {
+      canResume=false;
+    } else if (cache->grooves.size()!=grooves.size()) {
+      canResume=false;
+    } else {
+      for (size_t i=0; i<grooves.size(); i++) {
+        if (!groovesEqual(cache->grooves[i],grooves[i])) {
+          canResume=false;
+          break;
+        }
+      }
+      for (int i=0; i<chans; i++) {
+        if (cache->effectCols[i]!=pat[i].effectCols) {
+          canResume=false;
+          break;
+        }
+      }
+    }
+  }
+
+  // find the order to resume from.
+  // this is the changed order that was entered first during the previous walk.
+  bool changed[DIV_MAX_PATTERNS];
+  int resumeOrder=-1;
+  int resumeIndex=-1;
+  int maxAffectedVisit=-1;
+  if (canResume) {
+    for (int i=0; i<DIV_MAX_PATTERNS; i++) {
+      changed[i]=changedOrders[i];
+      // an order table change counts as a change as well
+      for (int j=0; j<chans; j++) {
+        if (cache->orders.ord[j][i]!=orders.ord[j][i]) {
+          changed[i]=true;
+          break;
+        }
+      }
+      if (!changed[i]) continue;
+      if (cache->lastVisit[i]<0) continue;
+      if (cache->lastVisit[i]>maxAffectedVisit) maxAffectedVisit=cache->lastVisit[i];
+      DivTimestampWalkState* e=cache->entry[i];
+      if (e==NULL || !e->valid) {
+        // this should not happen
+        canResume=false;
+        break;
+      }
+      if (resumeIndex<0 || e->totalRows<resumeIndex) {
+        resumeIndex=e->totalRows;
+        resumeOrder=i;
+      }
+    }
 
-  memset(ts.maxRow,0,DIV_MAX_PATTERNS);
-  
-  for (int i=0; i<DIV_MAX_PATTERNS; i++) {
-    if (ts.orders[i]) {
-      delete[] ts.orders[i];
-      ts.orders[i]=NULL;
+    if (canResume && resumeOrder<0) {
+      // none of the changed orders are ever reached. nothing to do.
+      memcpy(&cache->orders,&orders,sizeof(DivOrders));
+      return;
     }
+    // the walked set can't be rebuilt after the song has wrapped around
+    if (canResume && cache->entry[resumeOrder]->songWillEnd) canResume=false;
+  }
+  if (!canResume) {
+    resumeOrder=-1;
+    resumeIndex=-1;
   }
 
+  // the previous result (restored if the walk converges)
+  TimeMicros oldTotalTime=ts.totalTime;
+  uint64_t oldTotalTicks=ts.totalTicks;
+  int oldTotalRows=ts.totalRows;
+  bool oldIsLoopDefined=ts.isLoopDefined;
+  bool oldIsLoopable=ts.isLoopable;
+  DivSongTimestamps::Position oldLoopStart=ts.loopStart;
+  DivSongTimestamps::Position oldLoopEnd=ts.loopEnd;
+  TimeMicros oldLoopStartTime=ts.loopStartTime;
+  TimeMicros resumeTime(0,0);
+  unsigned char oldMaxRow[DIV_MAX_PATTERNS];
+  int oldLastVisit[DIV_MAX_PATTERNS];
+
+  // set to true when an order is first entered during this walk
+  bool entered[DIV_MAX_PATTERNS];
+  // set to true when the entry state of an order is stored during this walk
+  bool refreshed[DIV_MAX_PATTERNS];
+  // rows written during this walk
+  unsigned char touched[8192];
+  memset(refreshed,0,DIV_MAX_PATTERNS*sizeof(bool));
+  memset(touched,0,8192);
+
   // walking state
   unsigned char wsWalked[8192];
-  memset(wsWalked,0,8192);
-  if (firstPat>0) {
-    memset(wsWalked,255,32*firstPat);
-  }
+  uint64_t walkedHash=0;
+  auto resetWalked=[&]() {
+    memset(wsWalked,0,8192);
+    walkedHash=0;
+    if (firstPat>0) {
+      memset(wsWalked,255,32*firstPat);
+      for (int i=0; i<256*firstPat; i++) {
+        walkedHash^=walkedKey(i);
+      }
+    }
+  };
+  resetWalked();
   int curOrder=firstPat;
   int curRow=0;
   int prevOrder=firstPat;
@@ -107,11 +305,125 @@ void DivSubSong::calcTimestamps(int chans, std::vector<DivGroovePattern>& groove
   memset(delayRow,0,DIV_MAX_CHANS);
   if (divider<1) divider=1;
 
+  if (canResume) {
+    // resume from the entry state of the first changed order
+    DivTimestampWalkState* e=cache->entry[resumeOrder];
+    logV("resuming timestamp walk from order %d (row %d of the walk)",resumeOrder,resumeIndex);
+
+    memcpy(oldMaxRow,ts.maxRow,DIV_MAX_PATTERNS);
+    memcpy(oldLastVisit,cache->lastVisit,DIV_MAX_PATTERNS*sizeof(int));
+
+    curOrder=resumeOrder;
+    curRow=e->row;
+    prevOrder=e->prevOrder;
+    prevRow=e->prevRow;
+    curSpeeds=e->curSpeeds;
+    curVirtualTempoN=e->curVirtualTempoN;
+    curVirtualTempoD=e->curVirtualTempoD;
+    nextSpeed=e->nextSpeed;
+    divider=e->divider;
+    totalMicrosOff=e->totalMicrosOff;
+    ticks=e->ticks;
+    tempoAccum=e->tempoAccum;
+    curSpeed=e->curSpeed;
+    changeOrd=e->changeOrd;
+    changePos=e->changePos;
+    shallStopSched=e->shallStopSched;
+    songWillEnd=e->songWillEnd;
+    memcpy(rowDelay,e->rowDelay,DIV_MAX_CHANS);
+    memcpy(delayOrder,e->delayOrder,DIV_MAX_CHANS);
+    memcpy(delayRow,e->delayRow,DIV_MAX_CHANS);
+
+    ts.totalTime=e->totalTime;
+    ts.totalTicks=e->totalTicks;
+    ts.totalRows=e->totalRows;
+    ts.isLoopDefined=e->isLoopDefined;
+    ts.isLoopable=true;
+    ts.loopEnd.order=e->loopEndOrder;
+    ts.loopEnd.row=e->loopEndRow;
+    memcpy(ts.maxRow,e->maxRow,DIV_MAX_PATTERNS);
+    resumeTime=e->totalTime;
+
+    // rebuild the walked set out of the rows logged before this point
+    for (int i=0; i<DIV_MAX_PATTERNS; i++) {
+      if (ts.orders[i]==NULL) continue;
+      for (int j=0; j<256; j++) {
+        if (ts.orders[i][j].seconds==-1) continue;
+        if (ts.orders[i][j]>=resumeTime) continue;
+        int pos=((i<<5)+(j>>3))&8191;
+        if (!(wsWalked[pos]&(1<<(j&7)))) {
+          wsWalked[pos]|=1<<(j&7);
+          walkedHash^=walkedKey((pos<<3)|(j&7));
+        }
+      }
+    }
+    if (walkedHash!=e->walkedHash) {
+      logW("walked set mismatch! doing a full walk.");
+      canResume=false;
+    }
+  }
+
+  if (canResume) {
+    for (int i=0; i<DIV_MAX_PATTERNS; i++) {
+      DivTimestampWalkState* e=cache->entry[i];
+      entered[i]=(e!=NULL && e->valid && e->totalRows<resumeIndex);
+      if (cache->lastVisit[i]>=resumeIndex) cache->lastVisit[i]=-1;
+    }
+    entered[resumeOrder]=true;
+    refreshed[resumeOrder]=true;
+  } else {
+    // reset state
+    resumeOrder=-1;
+    resumeIndex=-1;
+    curOrder=firstPat;
+    curRow=0;
+    prevOrder=firstPat;
+    prevRow=0;
+    curSpeeds=speeds;
+    curVirtualTempoN=virtualTempoN;
+    curVirtualTempoD=virtualTempoD;
+    nextSpeed=curSpeeds.val[0];
+    divider=hz;
+    if (divider<1) divider=1;
+    totalMicrosOff=0.0;
+    ticks=1;
+    tempoAccum=0;
+    curSpeed=0;
+    changeOrd=-1;
+    changePos=0;
+    shallStopSched=false;
+    songWillEnd=false;
+    memset(rowDelay,0,DIV_MAX_CHANS);
+    memset(delayOrder,0,DIV_MAX_CHANS);
+    memset(delayRow,0,DIV_MAX_CHANS);
+
+    ts.totalTime=TimeMicros(0,0);
+    ts.totalTicks=0;
+    ts.totalRows=0;
+    ts.isLoopDefined=true;
+    ts.isLoopable=true;
+
+    memset(ts.maxRow,0,DIV_MAX_PATTERNS);
+
+    for (int i=0; i<DIV_MAX_PATTERNS; i++) {
+      if (ts.orders[i]) {
+        delete[] ts.orders[i];
+        ts.orders[i]=NULL;
+      }
+      if (cache->entry[i]) cache->entry[i]->valid=false;
+      cache->lastVisit[i]=-1;
+      entered[i]=false;
+    }
+
+    resetWalked();
+  }
+
   auto tinyProcessRow=[&,this](int i, bool afterDelay) {
     // if this is after delay, use the order/row where delay occurred
     int whatOrder=afterDelay?delayOrder[i]:curOrder;
     int whatRow=afterDelay?delayRow[i]:curRow;
     DivPattern* p=pat[i].getPattern(orders.ord[i][whatOrder],false);
+    cache->lastVisit[whatOrder]=ts.totalRows;
     // pre effects
     if (!afterDelay) {
       // set to true if we found an EDxx effect
@@ -265,7 +577,11 @@ void DivSubSong::calcTimestamps(int chans, std::vector<DivGroovePattern>& groove
     }
 
     // mark this row as "walked" over
-    wsWalked[((curOrder<<5)+(curRow>>3))&8191]|=1<<(curRow&7);
+    int walkedPos=((curOrder<<5)+(curRow>>3))&8191;
+    if (!(wsWalked[walkedPos]&(1<<(curRow&7)))) {
+      wsWalked[walkedPos]|=1<<(curRow&7);
+      walkedHash^=walkedKey((walkedPos<<3)|(curRow&7));
+    }
 
     // commit a pending jump if there is one
     // otherwise, advance row position
@@ -284,6 +600,7 @@ void DivSubSong::calcTimestamps(int chans, std::vector<DivGroovePattern>& groove
         ts.isLoopDefined=false;
         songWillEnd=true;
         memset(wsWalked,0,8192);
+        walkedHash=0;
       }
       changeOrd=-1;
     } else if (++curRow>=patLen) {
@@ -302,6 +619,7 @@ void DivSubSong::calcTimestamps(int chans, std::vector<DivGroovePattern>& groove
           // since we've reached the end, we are guaranteed to loop here, so
           // just reset it.
           memset(wsWalked,0,8192);
+          walkedHash=0;
           curOrder=0;
         }
       }
@@ -316,6 +634,7 @@ void DivSubSong::calcTimestamps(int chans, std::vector<DivGroovePattern>& groove
       logV("loop reached");
       songWillEnd=true;
       memset(wsWalked,0,8192);
+      walkedHash=0;
     }
     // perform speed alternation
     // COMPAT FLAG: broken speed alternation
@@ -349,8 +668,68 @@ void DivSubSong::calcTimestamps(int chans, std::vector<DivGroovePattern>& groove
     }
   };
 
+  // the walk state at this point can be stored (or compared against the previous walk).
+  auto storeEntry=[&](DivTimestampWalkState* e) {
+    e->valid=true;
+    e->row=curRow;
+    e->prevOrder=prevOrder;
+    e->prevRow=prevRow;
+    e->totalRows=ts.totalRows;
+    e->totalTicks=ts.totalTicks;
+    e->totalTime=ts.totalTime;
+    e->totalMicrosOff=totalMicrosOff;
+    e->divider=divider;
+    e->curSpeeds=curSpeeds;
+    e->curVirtualTempoN=curVirtualTempoN;
+    e->curVirtualTempoD=curVirtualTempoD;
+    e->nextSpeed=nextSpeed;
+    e->ticks=ticks;
+    e->tempoAccum=tempoAccum;
+    e->curSpeed=curSpeed;
+    e->changeOrd=changeOrd;
+    e->changePos=changePos;
+    e->shallStopSched=shallStopSched;
+    e->songWillEnd=songWillEnd;
+    e->isLoopDefined=ts.isLoopDefined;
+    e->loopEndOrder=ts.loopEnd.order;
+    e->loopEndRow=ts.loopEnd.row;
+    e->walkedHash=walkedHash;
+    memcpy(e->rowDelay,rowDelay,DIV_MAX_CHANS);
+    memcpy(e->delayOrder,delayOrder,DIV_MAX_CHANS);
+    memcpy(e->delayRow,delayRow,DIV_MAX_CHANS);
+    memcpy(e->maxRow,ts.maxRow,DIV_MAX_PATTERNS);
+  };
+
+  bool converged=false;
+  TimeMicros convergeTime(0,0);
+  int convergeIndex=-1;
+
   // MAKE IT WORK
   while (!endOfSong) {
+    // store the state upon entering an order
+    if (!entered[curOrder]) {
+      DivTimestampWalkState* e=cache->entry[curOrder];
+      if (canResume && e!=NULL && e->valid && !refreshed[curOrder] && e->totalRows>resumeIndex && maxAffectedVisit<e->totalRows) {
+        // if the state matches the one of the previous walk, the rest of the walk is the same
+        DivTimestampWalkState cur;
+        storeEntry(&cur);
+        if (cur.sameAs(*e,chans)) {
+          converged=true;
+          convergeTime=e->totalTime;
+          convergeIndex=e->totalRows;
+          refreshed[curOrder]=true;
+          break;
+        }
+      }
+      if (e==NULL) {
+        e=new DivTimestampWalkState;
+        cache->entry[curOrder]=e;
+      }
+      storeEntry(e);
+      entered[curOrder]=true;
+      refreshed[curOrder]=true;
+    }
+
     // if the virtual tempo nominator is zero, the song will go on forever.
     if (curVirtualTempoN<1) {
       ts.totalTime.seconds=INT_MAX;
@@ -423,6 +802,7 @@ void DivSubSong::calcTimestamps(int chans, std::vector<DivGroovePattern>& groove
         }
       }
       ts.orders[prevOrder][prevRow]=ts.totalTime;
+      touched[((prevOrder<<5)+(prevRow>>3))&8191]|=1<<(prevRow&7);
       rowChanged=false;
     }
 
@@ -447,16 +827,78 @@ void DivSubSong::calcTimestamps(int chans, std::vector<DivGroovePattern>& groove
     if (ts.maxRow[curOrder]<curRow) ts.maxRow[curOrder]=curRow;
   }
 
-  ts.totalRows--;
-  ts.loopStart.order=prevOrder;
-  ts.loopStart.row=prevRow;
-  ts.loopStartTime=ts.getTimes(ts.loopStart.order,ts.loopStart.row);
+  if (converged) {
+    // the rest of the walk is the same as before
+    logV("timestamp walk converged at order %d",curOrder);
+    ts.totalTime=oldTotalTime;
+    ts.totalTicks=oldTotalTicks;
+    ts.totalRows=oldTotalRows;
+    ts.isLoopDefined=oldIsLoopDefined;
+    ts.isLoopable=oldIsLoopable;
+    ts.loopStart=oldLoopStart;
+    ts.loopEnd=oldLoopEnd;
+    ts.loopStartTime=oldLoopStartTime;
+    for (int i=0; i<DIV_MAX_PATTERNS; i++) {
+      if (oldLastVisit[i]>=convergeIndex) {
+        cache->lastVisit[i]=oldLastVisit[i];
+        if (ts.maxRow[i]<oldMaxRow[i]) ts.maxRow[i]=oldMaxRow[i];
+      }
+    }
+  } else {
+    ts.totalRows--;
+    ts.loopStart.order=prevOrder;
+    ts.loopStart.row=prevRow;
+  }
+
+  if (canResume) {
+    // forget about rows and orders which are no longer reached
+    for (int i=0; i<DIV_MAX_PATTERNS; i++) {
+      DivTimestampWalkState* e=cache->entry[i];
+      if (e!=NULL && e->valid && !refreshed[i] && e->totalRows>=resumeIndex) {
+        if (!converged || e->totalRows<convergeIndex) e->valid=false;
+      }
+      if (ts.orders[i]==NULL) continue;
+      for (int j=0; j<256; j++) {
+        TimeMicros& t=ts.orders[i][j];
+        if (t.seconds==-1) continue;
+        if (touched[((i<<5)+(j>>3))&8191]&(1<<(j&7))) continue;
+        if (t<resumeTime) continue;
+        if (converged && t>=convergeTime) continue;
+        t.seconds=-1;
+      }
+    }
+  }
+
+  if (!converged) {
+    ts.loopStartTime=ts.getTimes(ts.loopStart.order,ts.loopStart.row);
+  }
+
+  // update the cache
+  cache->chans=chans;
+  cache->jumpTreatment=jumpTreatment;
+  cache->ignoreJumpAtEnd=ignoreJumpAtEnd;
+  cache->brokenSpeedSel=brokenSpeedSel;
+  cache->delayBehavior=delayBehavior;
+  cache->firstPat=firstPat;
+  cache->grooves=grooves;
+  cache->speeds=speeds;
+  cache->virtualTempoN=virtualTempoN;
+  cache->virtualTempoD=virtualTempoD;
+  cache->hz=hz;
+  cache->patLen=patLen;
+  cache->ordersLen=ordersLen;
+  for (int i=0; i<chans; i++) {
+    cache->effectCols[i]=pat[i].effectCols;
+  }
+  memcpy(&cache->orders,&orders,sizeof(DivOrders));
+  cache->valid=true;
 
   std::chrono::high_resolution_clock::time_point timeEnd=std::chrono::high_resolution_clock::now();
   logV("calcTimestamps() took %dµs",std::chrono::duration_cast<std::chrono::microseconds>(timeEnd-timeStart).count());
   logV("song length: %s; %" PRIu64 " ticks",ts.totalTime.toString(6,TA_TIME_FORMAT_AUTO),ts.totalTicks);
 }
 
+
 bool DivSubSong::readData(SafeReader& reader, int version, int chans) {
   unsigned char magic[4];
 
@@ -1066,6 +1508,40 @@ void DivSong::unload() {
   subsong.clear();
 }
 
+DivSong* DivSong::makeSnapshot(bool copySamples) {
+  DivSong* ret=new DivSong;
+  // the constructor creates a sub-song
+  ret->unload();
+  *ret=*this;
+
+  for (DivInstrument*& i: ret->ins) {
+    DivInstrument* theCopy=new DivInstrument;
+    *theCopy=*i;
+    i=theCopy;
+  }
+  for (DivWavetable*& i: ret->wave) {
+    i=new DivWavetable(*i);
+  }
+  for (DivSample*& i: ret->sample) {
+    DivSample* theCopy=new DivSample;
+    if (copySamples) i->copyOn(theCopy);
+    i=theCopy;
+  }
+  for (DivSubSong*& i: ret->subsong) {
+    DivSubSong* theCopy=new DivSubSong;
+    *theCopy=*i;
+    for (int j=0; j<DIV_MAX_CHANS; j++) {
+      for (int k=0; k<DIV_MAX_PATTERNS; k++) {
+        if (i->pat[j].data[k]==NULL) continue;
+        theCopy->pat[j].data[k]=new DivPattern;
+        i->pat[j].data[k]->copyOn(theCopy->pat[j].data[k]);
+      }
+    }
+    i=theCopy;
+  }
+  return ret;
+}
+
 void DivGroovePattern::checkBounds() {
   if (len<1) len=1;
   if (len>16) len=16;
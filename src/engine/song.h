@@ -72,6 +72,60 @@ struct DivGroovePattern {
   }
 };
 
+/**
+ * the state of the timestamp walker when it enters an order for the first time.
+ * this allows calcTimestamps() to resume a walk from the first changed order.
+ */
+struct DivTimestampWalkState {
+  bool valid;
+  int row, prevOrder, prevRow;
+  // number of rows walked so far. used to sort states by walk order.
+  int totalRows;
+  uint64_t totalTicks;
+  TimeMicros totalTime;
+  double totalMicrosOff, divider;
+  DivGroovePattern curSpeeds;
+  int curVirtualTempoN, curVirtualTempoD;
+  int nextSpeed, ticks, tempoAccum, curSpeed;
+  int changeOrd, changePos;
+  bool shallStopSched, songWillEnd, isLoopDefined;
+  int loopEndOrder, loopEndRow;
+  // hash of the set of walked rows
+  uint64_t walkedHash;
+  unsigned char rowDelay[DIV_MAX_CHANS];
+  unsigned char delayOrder[DIV_MAX_CHANS];
+  unsigned char delayRow[DIV_MAX_CHANS];
+  unsigned char maxRow[DIV_MAX_PATTERNS];
+
+  // whether the walk would continue identically from both states.
+  bool sameAs(const DivTimestampWalkState& other, int chans) const;
+};
+
+/**
+ * the walk cache kept by calcTimestamps().
+ */
+struct DivTimestampCache {
+  // whether the cache reflects the last walk
+  bool valid;
+  // parameters of the last walk. if any of these changes, a full walk is done.
+  int chans, jumpTreatment, ignoreJumpAtEnd, brokenSpeedSel, delayBehavior, firstPat;
+  std::vector<DivGroovePattern> grooves;
+  DivGroovePattern speeds;
+  short virtualTempoN, virtualTempoD;
+  float hz;
+  int patLen, ordersLen;
+  unsigned char effectCols[DIV_MAX_CHANS];
+  DivOrders orders;
+
+  // walk state on entry of each order (NULL if never entered)
+  DivTimestampWalkState* entry[DIV_MAX_PATTERNS];
+  // the value of totalRows when each order was last processed (-1 if never)
+  int lastVisit[DIV_MAX_PATTERNS];
+
+  DivTimestampCache();
+  ~DivTimestampCache();
+};
+
 struct DivSongTimestamps {
   // song duration (in seconds and microseconds)
   TimeMicros totalTime;
@@ -101,6 +155,13 @@ struct DivSongTimestamps {
   // call this function to get the timestamp of a row.
   TimeMicros getTimes(int order, int row);
 
+  // used by DivSubSong::calcTimestamps() for incremental recalculation.
+  DivTimestampCache* cache;
+
+  // copies own their timestamp arrays. the cache is not copied (it is rebuilt on the next walk).
+  DivSongTimestamps(const DivSongTimestamps& other);
+  DivSongTimestamps& operator=(const DivSongTimestamps& other);
+
   DivSongTimestamps();
   ~DivSongTimestamps();
 };
@@ -130,8 +191,12 @@ struct DivSubSong {
 
   /**
    * calculate timestamps (loop position, song length and more).
+   * @param changedOrders if not NULL, an array of DIV_MAX_PATTERNS elements which marks the orders
+   * whose pattern data has changed since the last call.
+   * the walk then resumes from the first changed order and stops as soon as it matches the previous walk.
+   * if NULL, the whole song is walked.
    */
-  void calcTimestamps(int chans, std::vector<DivGroovePattern>& grooves, int jumpTreatment, int ignoreJumpAtEnd, int brokenSpeedSel, int delayBehavior, int firstPat=0);
+  void calcTimestamps(int chans, std::vector<DivGroovePattern>& grooves, int jumpTreatment, int ignoreJumpAtEnd, int brokenSpeedSel, int delayBehavior, int firstPat=0, const bool* changedOrders=NULL);
 
   /**
    * read sub-song data.
@@ -397,6 +462,15 @@ struct DivSong {
    */
   void unload();
 
+  /**
+   * make a deep copy of the song which can be serialized while the original is being edited.
+   * only the data which is saved is copied (no undo history or rendered samples).
+   * @param copySamples whether to copy the samples. if false, the copy gets empty samples
+   * which have to be filled in with DivSample::copyOn().
+   * @return the copy. unload() and delete it when done.
+   */
+  DivSong* makeSnapshot(bool copySamples=true);
+
   DivSong():
     version(0),
     isDMF(false),
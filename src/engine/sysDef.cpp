@@ -22,11 +22,14 @@
 #include "instrument.h"
 #include "song.h"
 #include "../ta-log.h"
+#include <mutex>
 
 DivSysDef* DivEngine::sysDefs[DIV_MAX_CHIP_DEFS];
 DivSystem DivEngine::sysFileMapFur[DIV_MAX_CHIP_DEFS];
 DivSystem DivEngine::sysFileMapDMF[DIV_MAX_CHIP_DEFS];
 
+static std::once_flag sysDefsOnce;
+
 DivSystem DivEngine::systemFromFileFur(unsigned char val) {
   return sysFileMapFur[val];
 }
@@ -452,6 +455,10 @@ template<int type, DivInstrumentType insType, DivInstrumentType insType2=DIV_INS
 };
 
 void DivEngine::registerSystems() {
+  std::call_once(sysDefsOnce,initSystemDefs);
+}
+
+void DivEngine::initSystemDefs() {
   logD("registering systems...");
 
   // Common effect handler maps
@@ -2791,6 +2798,4 @@ void DivEngine::registerSystems() {
       sysFileMapDMF[sysDefs[i]->id_DMF]=(DivSystem)i;
     }
   }
-
-  systemsRegistered=true;
 }
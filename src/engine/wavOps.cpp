@@ -578,7 +578,7 @@ bool DivEngine::shallSwitchCores() {
   return true;
 }
 
-bool DivEngine::saveAudio(const char* path, DivAudioExportOptions options) {
+bool DivEngine::prepareAudioExport(const char* path, const DivAudioExportOptions& options) {
 #ifndef HAVE_SNDFILE
   logE("Furnace was not compiled with libsndfile. cannot export!");
   return false;
@@ -637,11 +637,16 @@ bool DivEngine::saveAudio(const char* path, DivAudioExportOptions options) {
   if (exportOutputs>DIV_MAX_OUTPUTS) exportOutputs=DIV_MAX_OUTPUTS;
 
   exportLoopCount=options.loops+1;
-  exportThread=new std::thread(_runExportThread,this);
   return true;
 #endif
 }
 
+bool DivEngine::saveAudio(const char* path, DivAudioExportOptions options) {
+  if (!prepareAudioExport(path,options)) return false;
+  exportThread=new std::thread(_runExportThread,this);
+  return true;
+}
+
 void DivEngine::waitAudioFile() {
   if (exportThread!=NULL) {
     exportThread->join();
@@ -53,12 +53,20 @@ bool DivWaveSynth::activeChanged() {
 bool DivWaveSynth::tick(bool skipSubDiv) {
   bool updated=first;
   first=false;
-  if (--subDivCounter>0 && !skipSubDiv) {
+  // the channel may not be ticked on every sub-tick, so count how many have passed since the last call.
+  int elapsed=(int)(e->subTickClock-lastSubTickClock);
+  lastSubTickClock=e->subTickClock;
+  if (elapsed<1) elapsed=1;
+  subDivCounter-=elapsed;
+  if (subDivCounter>0 && !skipSubDiv) {
+    if (state.enabled) e->wakeDispatchIn(subDivCounter);
     return updated;
   }
 
-  subDivCounter=e->tickMult;
+  subDivCounter+=e->tickMult;
+  if (subDivCounter<=0 || skipSubDiv) subDivCounter=e->tickMult;
   if (!state.enabled) return updated;
+  e->wakeDispatchIn(subDivCounter);
   if (width<1) return false;
 
   if (--divCounter<=0) {
@@ -328,6 +336,7 @@ void DivWaveSynth::init(DivInstrument* which, int w, int h, bool insChanged) {
     stageDir=false;
     divCounter=0;
     subDivCounter=0;
+    lastSubTickClock=e->subTickClock-1;
 
     changeWave1(state.wave1,true);
     changeWave2(state.wave2);
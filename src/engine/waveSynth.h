@@ -29,6 +29,7 @@ class DivWaveSynth {
   DivEngine* e;
   DivInstrumentWaveSynth state;
   int pos, stage, divCounter, width, height, subDivCounter;
+  unsigned int lastSubTickClock;
   bool first, activeChangedB, stageDir;
   unsigned char wave1[256];
   unsigned char wave2[256];
@@ -80,6 +81,7 @@ class DivWaveSynth {
       width(32),
       height(31),
       subDivCounter(0),
+      lastSubTickClock(0),
       first(false),
       activeChangedB(false),
       stageDir(false) {
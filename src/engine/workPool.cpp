@@ -19,93 +19,162 @@
 
 #include "workPool.h"
 #include "../ta-log.h"
+#include "../rtAlloc.h"
 #include <thread>
+#include <limits.h>
 
-void* _workThread(void* inst) {
-  ((DivWorkThread*)inst)->run();
-  return NULL;
-}
+#ifdef __linux__
+#include <unistd.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
 
-void DivWorkThread::run() {
-  //std::unique_lock<std::mutex> unique(selfLock);
-  DivPendingTask task;
-  bool setFuckingPromise=false;
+#ifdef _WIN32
+#include <windows.h>
+#endif
 
-  logV("running work thread");
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define WORK_POOL_RELAX _mm_pause()
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define WORK_POOL_RELAX __builtin_ia32_pause()
+#else
+#define WORK_POOL_RELAX
+#endif
 
-  while (true) {
+// how many times to check for work before sleeping.
+// the audio thread dispatches a batch on every tick, so the next one usually arrives soon.
+#define WORK_POOL_SPIN 2048
+
+void DivWorkEvent::wait(unsigned int prev, int spinCount) {
+  for (int i=0; i<spinCount; i++) {
+    if (seq.load(std::memory_order_acquire)!=prev) return;
+    WORK_POOL_RELAX;
+  }
+#ifdef __linux__
+  sleepers++;
+  while (seq.load()==prev) {
+    syscall(SYS_futex,(unsigned int*)&seq,FUTEX_WAIT_PRIVATE,prev,NULL,NULL,0);
+  }
+  sleepers--;
+#else
+  std::unique_lock<std::mutex> unique(lock);
+  sleepers++;
+  while (seq.load()==prev) {
+    cond.wait(unique);
+  }
+  sleepers--;
+#endif
+}
+
+void DivWorkEvent::signal() {
+  seq++;
+  // only make a system call if someone is sleeping
+  if (sleepers.load()>0) {
+#ifdef __linux__
+    syscall(SYS_futex,(unsigned int*)&seq,FUTEX_WAKE_PRIVATE,INT_MAX,NULL,NULL,0);
+#else
     lock.lock();
-    if (tasks.empty()) {
-      lock.unlock();
-      isBusy=false;
-      if (setFuckingPromise) {
-        parent->notify.set_value();
-        setFuckingPromise=false;
-        //std::this_thread::yield();
-      }
-      if (terminate) {
-        break;
-      }
-      std::future<void> future=notify.get_future();
-      future.wait();
-      lock.lock();
-      notify=std::promise<void>();
-      promiseAlreadySet=false;
-      lock.unlock();
-      continue;
-    } else {
-      task=tasks.front();
-      tasks.pop();
-      lock.unlock();
+    lock.unlock();
+    cond.notify_all();
+#endif
+  }
+}
 
-      task.func(task.funcArg);
+void DivWorkQueue::acquireLock() {
+  while (lock.exchange(true,std::memory_order_acquire)) {
+    WORK_POOL_RELAX;
+  }
+}
 
-      int busyCount=--parent->busyCount;
-      if (busyCount<0) {
-        logE("oh no PROBLEM...");
-      }
-      if (busyCount==0) {
-        setFuckingPromise=true;
-      }
-    }
+void DivWorkQueue::releaseLock() {
+  lock.store(false,std::memory_order_release);
+}
+
+bool DivWorkQueue::push(const DivPendingTask& task) {
+  acquireLock();
+  if (tail>=DIV_WORK_POOL_MAX_TASKS) {
+    releaseLock();
+    return false;
   }
+  tasks[tail++]=task;
+  releaseLock();
+  return true;
 }
 
-bool DivWorkThread::assign(void (*what)(void*), void* arg) {
-  lock.lock();
-  if (tasks.size()>=30) {
-    lock.unlock();
+bool DivWorkQueue::pop(DivPendingTask& task) {
+  acquireLock();
+  if (head>=tail) {
+    releaseLock();
     return false;
   }
-  tasks.push(DivPendingTask(what,arg));
-  parent->busyCount++;
-  isBusy=true;
-  lock.unlock();
+  task=tasks[head++];
+  if (head>=tail) {
+    head=0;
+    tail=0;
+  }
+  releaseLock();
   return true;
 }
 
-void DivWorkThread::wait() {
-  if (!isBusy) return;
+bool DivWorkQueue::steal(DivPendingTask& task) {
+  acquireLock();
+  if (head>=tail) {
+    releaseLock();
+    return false;
+  }
+  task=tasks[--tail];
+  if (head>=tail) {
+    head=0;
+    tail=0;
+  }
+  releaseLock();
+  return true;
 }
 
-bool DivWorkThread::busy() {
-  return isBusy;
+void* _workThread(void* inst) {
+  ((DivWorkThread*)inst)->run();
+  return NULL;
 }
 
-void DivWorkThread::finish() {
-  lock.lock();
-  terminate=true;
-  try {
-    notify.set_value();
-  } catch (std::future_error& e) {
-    logE("future error! beware!");
+void DivWorkThread::run() {
+  logV("running work thread");
+
+  if (parent->hasAffinity()) {
+    // leave the first core to the calling thread
+    unsigned int cores=std::thread::hardware_concurrency();
+    if (cores>1) {
+      unsigned int core=1+(index%(cores-1));
+#if defined(__linux__)
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(core,&set);
+      if (sched_setaffinity(0,sizeof(cpu_set_t),&set)!=0) {
+        logW("could not pin work thread %d to core %d!",index,core);
+      }
+#elif defined(_WIN32)
+      if (core<sizeof(DWORD_PTR)*8) {
+        if (SetThreadAffinityMask(GetCurrentThread(),((DWORD_PTR)1)<<core)==0) {
+          logW("could not pin work thread %d to core %d!",index,core);
+        }
+      }
+#endif
+    }
+  }
+
+  while (true) {
+    // read the batch counter before looking for work, so that a batch started in between wakes us up
+    unsigned int batch=parent->start.seq.load();
+    while (parent->runOne(index)) {}
+    if (parent->terminate) break;
+    parent->start.wait(batch,WORK_POOL_SPIN);
   }
-  lock.unlock();
-  thread->join();
 }
 
-bool DivWorkThread::init(DivWorkPool* p) {
+bool DivWorkThread::init(DivWorkPool* p, unsigned int i) {
   parent=p;
+  index=i;
   try {
     thread=new std::thread(_workThread,this);
   } catch (std::system_error& e) {
@@ -116,73 +185,122 @@ bool DivWorkThread::init(DivWorkPool* p) {
   return true;
 }
 
-void DivWorkPool::push(void (*what)(void*), void* arg) {
+bool DivWorkPool::runOne(unsigned int self) {
+  DivPendingTask task;
+  if (!queues[self].pop(task)) {
+    // nothing left in our queue. steal from the others
+    bool found=false;
+    for (unsigned int i=1; i<=count; i++) {
+      if (queues[(self+i)%(count+1)].steal(task)) {
+        found=true;
+        break;
+      }
+    }
+    if (!found) return false;
+  }
+
+  {
+    TARealTimeGuard rtGuard(realTime);
+    task.func(task.funcArg);
+  }
+
+  int left=--remaining;
+  if (left<0) {
+    logE("oh no PROBLEM...");
+  }
+  if (left==0) {
+    done.signal();
+  }
+  return true;
+}
+
+void DivWorkPool::push(void (*what)(void*), void* arg, unsigned int cost) {
   // if no work threads, just execute
   if (!threaded) {
     what(arg);
     return;
   }
 
-  for (unsigned int tryCount=0; tryCount<count; tryCount++) {
-    if (pos>=count) pos=0;
-    if (workThreads[pos++].assign(what,arg)) return;
+  if (pendingLen>=DIV_WORK_POOL_MAX_TASKS) {
+    logW("DivWorkPool: too many jobs!");
+    what(arg);
+    return;
   }
-
-  // all threads are busy
-  logW("DivWorkPool: all work threads busy!");
-  what(arg);
+  pending[pendingLen++]=DivPendingTask(what,arg,cost);
 }
 
 bool DivWorkPool::busy() {
   if (!threaded) return false;
-  for (unsigned int i=0; i<count; i++) {
-    if (workThreads[i].busy()) return true;
-  }
-  return false;
+  return (pendingLen>0 || remaining>0);
 }
 
 void DivWorkPool::wait() {
   if (!threaded) return;
+  if (pendingLen==0) return;
 
-  if (busyCount==0) {
-    return;
+  // sort jobs by cost (heaviest first)
+  for (unsigned int i=1; i<pendingLen; i++) {
+    DivPendingTask t=pending[i];
+    unsigned int j=i;
+    while (j>0 && pending[j-1].cost<t.cost) {
+      pending[j]=pending[j-1];
+      j--;
+    }
+    pending[j]=t;
   }
 
-  std::future<void> future=notify.get_future();
-
-  // start running
-  for (unsigned int i=0; i<count; i++) {
-    if (!workThreads[i].promiseAlreadySet && !workThreads[i].tasks.empty()) {
-      try {
-        workThreads[i].lock.lock();
-        workThreads[i].promiseAlreadySet=true;
-        workThreads[i].notify.set_value();
-        workThreads[i].lock.unlock();
-      } catch (std::exception& e) {
-        logE("ERROR IN THREAD SYNC! %s",e.what());
-        abort();
-      }
+  // place each job in the least loaded queue
+  for (unsigned int i=0; i<=count; i++) {
+    queues[i].load=0;
+  }
+  remaining=pendingLen;
+  for (unsigned int i=0; i<pendingLen; i++) {
+    unsigned int best=0;
+    for (unsigned int j=1; j<=count; j++) {
+      if (queues[j].load<queues[best].load) best=j;
+    }
+    if (!queues[best].push(pending[i])) {
+      // this should not happen
+      logE("DivWorkPool: queue full!");
+      pending[i].func(pending[i].funcArg);
+      remaining--;
+      continue;
     }
+    queues[best].load+=(pending[i].cost>0)?pending[i].cost:1;
   }
-  //std::this_thread::yield();
+  pendingLen=0;
 
-  // wait
-  future.wait();
+  // start running
+  start.signal();
 
-  notify=std::promise<void>();
+  // help out
+  while (runOne(count)) {}
 
-  pos=0;
+  // wait
+  while (remaining>0) {
+    unsigned int doneSeq=done.seq.load();
+    if (remaining<=0) break;
+    done.wait(doneSeq,WORK_POOL_SPIN);
+  }
 }
 
-DivWorkPool::DivWorkPool(unsigned int threads):
+DivWorkPool::DivWorkPool(unsigned int threads, bool rt, bool pin):
   threaded(threads>0),
+  realTime(rt),
+  affinity(pin),
   count(threads),
-  pos(0),
-  busyCount(0) {
+  workThreads(NULL),
+  queues(NULL),
+  pending(NULL),
+  pendingLen(0),
+  remaining(0),
+  terminate(false) {
   if (threaded) {
+    queues=new DivWorkQueue[count+1];
+    pending=new DivPendingTask[DIV_WORK_POOL_MAX_TASKS];
     workThreads=new DivWorkThread[threads];
     for (unsigned int i=0; i<count; i++) {
-      if (!workThreads[i].init(this)) { 
+      if (!workThreads[i].init(this,i)) { 
         count=i;
         break;
       }
@@ -190,21 +308,31 @@ DivWorkPool::DivWorkPool(unsigned int threads):
     if (count<=0) {
       logE("DivWorkPool: couldn't start any threads! falling back to non-threaded mode.");
       delete[] workThreads;
+      delete[] queues;
+      delete[] pending;
       threaded=false;
       workThreads=NULL;
+      queues=NULL;
+      pending=NULL;
     }
-  } else {
-    workThreads=NULL;
   }
 }
 
 DivWorkPool::~DivWorkPool() {
   if (threaded) {
+    wait();
+    terminate=true;
+    start.signal();
     if (workThreads!=NULL) {
       for (unsigned int i=0; i<count; i++) {
-        workThreads[i].finish();
+        if (workThreads[i].thread!=NULL) {
+          workThreads[i].thread->join();
+          delete workThreads[i].thread;
+        }
       }
       delete[] workThreads;
     }
+    delete[] queues;
+    delete[] pending;
   }
 }
@@ -24,64 +24,133 @@
 #include <atomic>
 #include <functional>
 #include <future>
+#include <mutex>
+#include <condition_variable>
+#include <stdint.h>
 
-#include "../fixedQueue.h"
+// maximum number of tasks in a single batch
+#define DIV_WORK_POOL_MAX_TASKS 256
 
 class DivWorkPool;
 
 struct DivPendingTask {
   void (*func)(void*);
   void* funcArg;
-  DivPendingTask(void (*f)(void*), void* arg):
+  unsigned int cost;
+  DivPendingTask(void (*f)(void*), void* arg, unsigned int c):
     func(f),
-    funcArg(arg) {}
+    funcArg(arg),
+    cost(c) {}
   DivPendingTask():
     func(NULL),
-    funcArg(NULL) {}
+    funcArg(NULL),
+    cost(0) {}
+};
+
+/**
+ * a wait/wake primitive which doesn't allocate.
+ * waiting spins for a while before going to sleep (on a futex on Linux).
+ */
+struct DivWorkEvent {
+  std::atomic<unsigned int> seq;
+  std::atomic<int> sleepers;
+#ifndef __linux__
+  std::mutex lock;
+  std::condition_variable cond;
+#endif
+
+  /**
+   * wait until seq is no longer prev.
+   */
+  void wait(unsigned int prev, int spinCount);
+
+  /**
+   * increase seq and wake up waiting threads.
+   */
+  void signal();
+
+  DivWorkEvent():
+    seq(0),
+    sleepers(0) {}
+};
+
+/**
+ * a task queue owned by a thread.
+ * the owner takes tasks from the front, while other threads steal from the back.
+ */
+struct DivWorkQueue {
+  std::atomic<bool> lock;
+  DivPendingTask tasks[DIV_WORK_POOL_MAX_TASKS];
+  unsigned int head, tail;
+  // sum of the cost of tasks placed in this queue during the current batch
+  uint64_t load;
+
+  bool push(const DivPendingTask& task);
+  bool pop(DivPendingTask& task);
+  bool steal(DivPendingTask& task);
+  void acquireLock();
+  void releaseLock();
+
+  DivWorkQueue():
+    lock(false),
+    head(0),
+    tail(0),
+    load(0) {}
 };
 
 struct DivWorkThread {
   DivWorkPool* parent;
-  std::mutex lock;
   std::thread* thread;
-  std::promise<void> notify;
-  FixedQueue<DivPendingTask,32> tasks;
-  std::atomic<bool> isBusy;
-  bool terminate;
-  bool promiseAlreadySet;
+  unsigned int index;
 
   void run();
-  bool assign(void (*what)(void*), void* arg);
-  void wait();
-  bool busy();
-  void finish();
-
-  bool init(DivWorkPool* p);
+  bool init(DivWorkPool* p, unsigned int i);
   DivWorkThread():
     parent(NULL),
-    isBusy(false),
-    terminate(false),
-    promiseAlreadySet(false) {}
+    thread(NULL),
+    index(0) {}
 };
 
 /**
  * this class provides an implementation of a "thread pool" for executing tasks in parallel.
  * it is highly recommended to use `new` when allocating a DivWorkPool.
+ *
+ * jobs are pushed and then run on wait(). the calling thread takes part as well.
+ * jobs are placed by cost (longest first, to the least loaded thread), and idle threads steal work from busy ones.
  */
 class DivWorkPool {
   bool threaded;
+  bool realTime;
+  bool affinity;
   unsigned int count;
-  unsigned int pos;
   DivWorkThread* workThreads;
+  // one per work thread, plus one for the calling thread
+  DivWorkQueue* queues;
+  DivPendingTask* pending;
+  unsigned int pendingLen;
+  std::atomic<int> remaining;
+  std::atomic<bool> terminate;
+  DivWorkEvent start, done;
+
+  friend struct DivWorkThread;
+
+  // run a task from our queue or steal one. returns false if there is nothing to do.
+  bool runOne(unsigned int self);
   public:
-    std::promise<void> notify;
-    std::atomic<int> busyCount;
+    bool isRealTime() {
+      return realTime;
+    }
+
+    bool hasAffinity() {
+      return affinity;
+    }
     
     /**
      * push a new job to this work pool.
-     * if all work threads are busy, this will block until one is free.
+     * the job will run on the next call to wait().
+     * @param cost the estimated cost of this job. heavier jobs are scheduled first.
      */
-    void push(void (*what)(void*), void* arg);
+    void push(void (*what)(void*), void* arg, unsigned int cost=0);
     
     /**
      * check whether this work pool is busy.
@@ -89,11 +158,16 @@ class DivWorkPool {
     bool busy();
 
     /**
-     * wait for all work threads to finish.
+     * run all pushed jobs and wait for them to finish.
      */
     void wait();
 
-    DivWorkPool(unsigned int threads=0);
+    /**
+     * @param threads the number of work threads, or 0 to run jobs in the calling thread.
+     * @param rt whether jobs run in the audio path (see TARealTimeGuard).
+     * @param pin whether to pin each work thread to a CPU core.
+     */
+    DivWorkPool(unsigned int threads=0, bool rt=false, bool pin=false);
     ~DivWorkPool();
 };
 
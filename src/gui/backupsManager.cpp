@@ -31,6 +31,340 @@
 #include <unistd.h>
 #include <dirent.h>
 #endif
+#include <unordered_set>
+
+// backups are stored as a small manifest (the .furbak file in the backups directory) which lists
+// content-addressed chunks in the chunks directory.
+// each block of the module (song info, instruments, samples, patterns...) becomes a chunk, so
+// data which did not change since the last backup is not written again.
+#define BACKUP_MAGIC "-Furnace backup-"
+#define BACKUP_VERSION 1
+#define BACKUP_CHUNKS_DIR "chunks"
+// largest module a manifest may describe. anything bigger is considered damaged.
+#define BACKUP_MAX_SIZE 0x7fffffffULL
+
+struct FurnaceGUIBackupChunk {
+  uint64_t hashA, hashB;
+  unsigned int len;
+};
+
+static inline uint64_t backupRotL(uint64_t x, int r) {
+  return (x<<r)|(x>>(64-r));
+}
+
+// two independent 64-bit hashes with the length in the name should be plenty for a backup store
+static void hashBackupChunk(const unsigned char* data, size_t len, FurnaceGUIBackupChunk& chunk) {
+  uint64_t a=0xcbf29ce484222325ULL;
+  uint64_t b=0x9e3779b97f4a7c15ULL^len;
+  size_t i=0;
+  for (; i+8<=len; i+=8) {
+    uint64_t word;
+    memcpy(&word,&data[i],8);
+    a=backupRotL(a^word,29)*0x100000001b3ULL;
+    b=(b+word)*0xff51afd7ed558ccdULL;
+    b^=b>>31;
+  }
+  uint64_t tail=0;
+  for (size_t j=0; i<len; i++, j+=8) {
+    tail|=((uint64_t)data[i])<<j;
+  }
+  a=backupRotL(a^tail,29)*0x100000001b3ULL;
+  b=(b+tail)*0xff51afd7ed558ccdULL;
+  // finalize
+  a^=a>>33;
+  a*=0xc4ceb9fe1a85ec53ULL;
+  a^=a>>33;
+  b^=b>>29;
+  b*=0x94d049bb133111ebULL;
+  b^=b>>32;
+  chunk.hashA=a;
+  chunk.hashB=b;
+  chunk.len=len;
+}
+
+static String backupChunkName(const FurnaceGUIBackupChunk& chunk) {
+  return fmt::sprintf("%.16" PRIx64 "%.16" PRIx64 "-%x",chunk.hashA,chunk.hashB,chunk.len);
+}
+
+// split a module into blocks (header, then every block with a 4-byte ID and 32-bit size).
+// if the structure is not recognized, the rest of the file becomes a single chunk.
+static void splitBackupModule(const unsigned char* buf, size_t len, std::vector<std::pair<size_t,size_t>>& blocks) {
+  size_t pos=MIN(len,(size_t)32);
+  blocks.push_back(std::pair<size_t,size_t>(0,pos));
+  while (pos<len) {
+    if (len-pos<8) break;
+    size_t blockLen=buf[pos+4]|(buf[pos+5]<<8)|(buf[pos+6]<<16)|((size_t)buf[pos+7]<<24);
+    if (blockLen>len-pos-8) break;
+    blocks.push_back(std::pair<size_t,size_t>(pos,blockLen+8));
+    pos+=blockLen+8;
+  }
+  if (pos<len) {
+    blocks.push_back(std::pair<size_t,size_t>(pos,len-pos));
+  }
+}
+
+// list files in a directory along with their sizes
+static void listBackupDir(const String& path, std::vector<std::pair<String,uint64_t>>& files) {
+#ifdef _WIN32
+  String findPath=path+String(DIR_SEPARATOR_STR)+String("*");
+  WIN32_FIND_DATAW next;
+  HANDLE dir=FindFirstFileW(utf8To16(findPath.c_str()).c_str(),&next);
+  if (dir!=INVALID_HANDLE_VALUE) {
+    do {
+      if (next.dwFileAttributes&FILE_ATTRIBUTE_DIRECTORY) continue;
+      files.push_back(std::pair<String,uint64_t>(utf16To8(next.cFileName),(((uint64_t)next.nFileSizeHigh)<<32)|next.nFileSizeLow));
+    } while (FindNextFileW(dir,&next)!=0);
+    FindClose(dir);
+  }
+#else
+  DIR* dir=opendir(path.c_str());
+  if (dir==NULL) return;
+  while (true) {
+    struct stat nextStat;
+    struct dirent* next=readdir(dir);
+    if (next==NULL) break;
+    if (strcmp(next->d_name,".")==0) continue;
+    if (strcmp(next->d_name,"..")==0) continue;
+    String nextPath=path+DIR_SEPARATOR_STR+next->d_name;
+    if (stat(nextPath.c_str(),&nextStat)<0) continue;
+    if (S_ISDIR(nextStat.st_mode)) continue;
+    files.push_back(std::pair<String,uint64_t>(String(next->d_name),nextStat.st_size));
+  }
+  closedir(dir);
+#endif
+}
+
+// read the chunk list of a manifest. returns false if this is not a manifest.
+static bool readBackupManifest(const unsigned char* buf, size_t len, std::vector<FurnaceGUIBackupChunk>& chunks, size_t& totalLen) {
+  if (len<16) return false;
+  if (memcmp(buf,BACKUP_MAGIC,16)!=0) return false;
+  SafeReader reader(buf,len);
+  try {
+    reader.seek(16,SEEK_SET);
+    unsigned short version=reader.readS();
+    if (version>BACKUP_VERSION) {
+      logW("backup manifest version too new (%d)",version);
+      return false;
+    }
+    reader.readS();
+    unsigned int count=reader.readI();
+    uint64_t manifestLen=(uint64_t)reader.readL();
+    if (count>(len/20)) return false;
+    if (manifestLen>BACKUP_MAX_SIZE) {
+      logW("backup manifest size is out of range (%" PRIu64 ")",manifestLen);
+      return false;
+    }
+    uint64_t chunkSum=0;
+    chunks.reserve(count);
+    for (unsigned int i=0; i<count; i++) {
+      FurnaceGUIBackupChunk chunk;
+      chunk.hashA=reader.readL();
+      chunk.hashB=reader.readL();
+      chunk.len=reader.readI();
+      chunkSum+=chunk.len;
+      chunks.push_back(chunk);
+    }
+    // the chunks must add up to the module
+    if (chunkSum!=manifestLen) {
+      logW("backup manifest size does not match its chunks!");
+      return false;
+    }
+    totalLen=(size_t)manifestLen;
+  } catch (EndOfFileException& e) {
+    logW("backup manifest is truncated!");
+    return false;
+  }
+  return true;
+}
+
+// check only the header of a file for the manifest magic
+static bool isBackupManifestFile(const String& path) {
+  char magic[16];
+  FILE* f=ps_fopen(path.c_str(),"rb");
+  if (f==NULL) return false;
+  bool ret=(fread(magic,1,16,f)==16 && memcmp(magic,BACKUP_MAGIC,16)==0);
+  fclose(f);
+  return ret;
+}
+
+static unsigned char* readWholeFile(const String& path, size_t& len) {
+  FILE* f=ps_fopen(path.c_str(),"rb");
+  if (f==NULL) return NULL;
+  if (fseek(f,0,SEEK_END)<0) {
+    fclose(f);
+    return NULL;
+  }
+  ssize_t fileLen=ftell(f);
+  if (fileLen<0 || fseek(f,0,SEEK_SET)<0) {
+    fclose(f);
+    return NULL;
+  }
+  unsigned char* buf=new unsigned char[fileLen>0?fileLen:1];
+  if (fread(buf,1,fileLen,f)!=(size_t)fileLen) {
+    fclose(f);
+    delete[] buf;
+    return NULL;
+  }
+  fclose(f);
+  len=fileLen;
+  return buf;
+}
+
+bool FurnaceGUI::writeBackup(SafeWriter* w, String path) {
+  String chunksPath=backupPath+String(DIR_SEPARATOR_STR)+String(BACKUP_CHUNKS_DIR);
+  if (!dirExists(chunksPath.c_str())) {
+    if (!makeDir(chunksPath.c_str())) {
+      logW("could not create backup chunks directory!");
+      return false;
+    }
+  }
+
+  const unsigned char* buf=w->getFinalBuf();
+  size_t len=w->size();
+  std::vector<std::pair<size_t,size_t>> blocks;
+  splitBackupModule(buf,len,blocks);
+
+  SafeWriter manifest;
+  manifest.init();
+  manifest.write(BACKUP_MAGIC,16);
+  manifest.writeS(BACKUP_VERSION);
+  manifest.writeS(0);
+  manifest.writeI(blocks.size());
+  manifest.writeL(len);
+
+  size_t newChunks=0;
+  size_t newBytes=0;
+  for (std::pair<size_t,size_t>& i: blocks) {
+    FurnaceGUIBackupChunk chunk;
+    hashBackupChunk(&buf[i.first],i.second,chunk);
+    manifest.writeL(chunk.hashA);
+    manifest.writeL(chunk.hashB);
+    manifest.writeI(chunk.len);
+
+    String chunkPath=chunksPath+String(DIR_SEPARATOR_STR)+backupChunkName(chunk);
+    if (fileExists(chunkPath.c_str())==1) continue;
+
+    // write to a temporary file first so that a partial chunk is never picked up
+    String tempPath=chunkPath+".tmp";
+    FILE* outFile=ps_fopen(tempPath.c_str(),"wb");
+    if (outFile==NULL) {
+      logW("could not save backup chunk: %s!",strerror(errno));
+      manifest.finish();
+      return false;
+    }
+    if (fwrite(&buf[i.first],1,i.second,outFile)!=i.second) {
+      logW("did not write backup chunk entirely: %s!",strerror(errno));
+      fclose(outFile);
+      deleteFile(tempPath.c_str());
+      manifest.finish();
+      return false;
+    }
+    fclose(outFile);
+    if (!moveFiles(tempPath.c_str(),chunkPath.c_str())) {
+      logW("could not move backup chunk!");
+      deleteFile(tempPath.c_str());
+      manifest.finish();
+      return false;
+    }
+    newChunks++;
+    newBytes+=i.second;
+  }
+  logD("backup: %d chunks (%d new, %d bytes written)",(int)blocks.size(),(int)newChunks,(int)newBytes);
+
+  bool ret=true;
+  FILE* outFile=ps_fopen(path.c_str(),"wb");
+  if (outFile!=NULL) {
+    if (fwrite(manifest.getFinalBuf(),1,manifest.size(),outFile)!=manifest.size()) {
+      logW("did not write backup entirely: %s!",strerror(errno));
+      ret=false;
+    }
+    fclose(outFile);
+  } else {
+    logW("could not save backup: %s!",strerror(errno));
+    ret=false;
+  }
+  manifest.finish();
+  return ret;
+}
+
+unsigned char* FurnaceGUI::restoreBackup(const unsigned char* buf, size_t len, size_t& outLen) {
+  std::vector<FurnaceGUIBackupChunk> chunks;
+  size_t totalLen=0;
+  if (!readBackupManifest(buf,len,chunks,totalLen)) {
+    lastError=_("backup is damaged (invalid manifest)");
+    return NULL;
+  }
+
+  String chunksPath=backupPath+String(DIR_SEPARATOR_STR)+String(BACKUP_CHUNKS_DIR);
+  unsigned char* ret=new unsigned char[totalLen>0?totalLen:1];
+  size_t pos=0;
+  for (FurnaceGUIBackupChunk& i: chunks) {
+    String chunkPath=chunksPath+String(DIR_SEPARATOR_STR)+backupChunkName(i);
+    size_t chunkLen=0;
+    unsigned char* chunkData=readWholeFile(chunkPath,chunkLen);
+    if (chunkData==NULL || chunkLen!=i.len || pos+chunkLen>totalLen) {
+      logE("backup chunk %s is missing or damaged!",backupChunkName(i));
+      lastError=_("backup is damaged (missing chunk)");
+      if (chunkData!=NULL) delete[] chunkData;
+      delete[] ret;
+      return NULL;
+    }
+    memcpy(&ret[pos],chunkData,chunkLen);
+    pos+=chunkLen;
+    delete[] chunkData;
+  }
+  if (pos!=totalLen) {
+    logE("backup size mismatch!");
+    lastError=_("backup is damaged (size mismatch)");
+    delete[] ret;
+    return NULL;
+  }
+  outLen=totalLen;
+  return ret;
+}
+
+bool FurnaceGUI::isBackupManifest(const unsigned char* buf, size_t len) {
+  if (len<16) return false;
+  return memcmp(buf,BACKUP_MAGIC,16)==0;
+}
+
+// delete chunks which are no longer referenced by any backup.
+// backupLock must be held.
+void FurnaceGUI::purgeBackupChunks() {
+  std::vector<std::pair<String,uint64_t>> files;
+  std::unordered_set<String> used;
+  listBackupDir(backupPath,files);
+  for (std::pair<String,uint64_t>& i: files) {
+    std::vector<FurnaceGUIBackupChunk> chunks;
+    size_t totalLen=0;
+    size_t len=0;
+    // manifests are small. skip anything that is clearly a full module.
+    if (i.second>(64<<20)) continue;
+    String nextPath=backupPath+String(DIR_SEPARATOR_STR)+i.first;
+    // old backups are full modules. only read files which are manifests.
+    if (!isBackupManifestFile(nextPath)) continue;
+    unsigned char* buf=readWholeFile(nextPath,len);
+    if (buf==NULL) continue;
+    if (readBackupManifest(buf,len,chunks,totalLen)) {
+      for (FurnaceGUIBackupChunk& j: chunks) {
+        used.insert(backupChunkName(j));
+      }
+    }
+    delete[] buf;
+  }
+
+  String chunksPath=backupPath+String(DIR_SEPARATOR_STR)+String(BACKUP_CHUNKS_DIR);
+  std::vector<std::pair<String,uint64_t>> chunkFiles;
+  listBackupDir(chunksPath,chunkFiles);
+  int deleted=0;
+  for (std::pair<String,uint64_t>& i: chunkFiles) {
+    if (used.find(i.first)!=used.end()) continue;
+    String toDelete=chunksPath+String(DIR_SEPARATOR_STR)+i.first;
+    deleteFile(toDelete.c_str());
+    deleted++;
+  }
+  if (deleted>0) logD("deleted %d unused backup chunks",deleted);
+}
 
 bool FurnaceGUI::splitBackupName(const char* input, String& backupName, struct tm& backupTime) {
   size_t len=strlen(input);
@@ -40,8 +374,10 @@ bool FurnaceGUI::splitBackupName(const char* input, String& backupName, struct t
   const char* secondHyphen=NULL;
   bool whichHyphen=false;
   bool isDateValid=true;
-  // -YYYYMMDD-hhmmss.fur
-  if (strcmp(&input[len-4],".fur")!=0) return false;
+  // -YYYYMMDD-hhmmss.furbak (or .fur for old backups)
+  size_t extLen=strlen(BACKUP_EXT);
+  bool isManifest=(len>=extLen && strcmp(&input[len-extLen],BACKUP_EXT)==0);
+  if (!isManifest && strcmp(&input[len-4],".fur")!=0) return false;
   // find two hyphens
   for (const char* i=input+len; i!=input; i--) {
     if ((*i)=='-') {
@@ -129,7 +465,7 @@ bool FurnaceGUI::splitBackupName(const char* input, String& backupName, struct t
 
 void FurnaceGUI::purgeBackups(int year, int month, int day) {
 #ifdef _WIN32
-  String findPath=backupPath+String(DIR_SEPARATOR_STR)+String("*.fur");
+  String findPath=backupPath+String(DIR_SEPARATOR_STR)+String("*.fur*");
   WString findPathW=utf8To16(findPath.c_str());
   WIN32_FIND_DATAW next;
   HANDLE backDir=FindFirstFileW(findPathW.c_str(),&next);
@@ -191,6 +527,9 @@ void FurnaceGUI::purgeBackups(int year, int month, int day) {
   }
   closedir(backDir);
 #endif
+  backupLock.lock();
+  purgeBackupChunks();
+  backupLock.unlock();
   refreshBackups=true;
 }
 
@@ -352,7 +691,7 @@ void FurnaceGUI::drawBackupsManager() {
         backupEntryLock.unlock();
 
 #ifdef _WIN32
-        String findPath=backupPath+String(DIR_SEPARATOR_STR)+String("*.fur");
+        String findPath=backupPath+String(DIR_SEPARATOR_STR)+String("*.fur*");
         WString findPathW=utf8To16(findPath.c_str());
         WIN32_FIND_DATAW next;
         HANDLE backDir=FindFirstFileW(findPathW.c_str(),&next);
@@ -400,8 +739,17 @@ void FurnaceGUI::drawBackupsManager() {
         closedir(backDir);
 #endif
 
+        // add the size of the chunk store
+        std::vector<std::pair<String,uint64_t>> chunkFiles;
+        listBackupDir(backupPath+String(DIR_SEPARATOR_STR)+String(BACKUP_CHUNKS_DIR),chunkFiles);
+        uint64_t chunksSize=0;
+        for (std::pair<String,uint64_t>& i: chunkFiles) {
+          chunksSize+=i.second;
+        }
+
         // sort and merge
         backupEntryLock.lock();
+        totalBackupSize+=chunksSize;
         std::sort(backupEntries.begin(),backupEntries.end(),[](const FurnaceGUIBackupEntry& a, const FurnaceGUIBackupEntry& b) -> bool {
           int sc=strcmp(a.name.c_str(),b.name.c_str());
           if (sc==0) {
@@ -0,0 +1,124 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2026 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "gui.h"
+#include "../ta-log.h"
+#include <algorithm>
+
+// song time advanced per GUI frame (1/BENCH_GUI_RATE seconds)
+#define BENCH_GUI_RATE 60
+// frames rendered before measuring (font atlas, first layout, texture uploads...)
+#define BENCH_GUI_WARMUP 30
+
+void FurnaceGUI::enableBenchmark(int frames) {
+  benchFrames=frames;
+}
+
+void FurnaceGUI::benchmarkBegin() {
+  logI("starting GUI benchmark (%d frames).",benchFrames);
+
+  // the scripted set of windows
+  patternOpen=true;
+  chanOscOpen=true;
+  spectrumOpen=true;
+  sampleEditOpen=true;
+  pianoOpen=true;
+  if (curSample<0 || curSample>=(int)e->song.sample.size()) curSample=0;
+
+  benchFrame=0;
+  benchFrameTimes.clear();
+  benchFrameTimes.reserve(benchFrames);
+  benchWindowTimes.clear();
+
+  // there is no audio thread (the benchmark uses the dummy backend), so the GUI thread drives the engine
+  unsigned int rate=e->getAudioDescGot().rate;
+  if (rate<1) rate=44100;
+  benchBufLen=rate/BENCH_GUI_RATE;
+  for (int i=0; i<2; i++) {
+    if (benchBuf[i]!=NULL) delete[] benchBuf[i];
+    benchBuf[i]=new float[benchBufLen];
+  }
+
+  e->play();
+}
+
+void FurnaceGUI::benchmarkStep() {
+  e->nextBuf(NULL,benchBuf,0,2,benchBufLen);
+}
+
+void FurnaceGUI::benchmarkFrame(uint64_t frameTime) {
+  if (benchFrame++<BENCH_GUI_WARMUP) return;
+
+  benchFrameTimes.push_back(frameTime);
+  for (int i=0; i<perfMetricsLen; i++) {
+    benchWindowTimes[perfMetrics[i].name]+=perfMetrics[i].elapsed;
+  }
+  benchWindowTimes["(layout)"]+=layoutTimeDelta;
+  benchWindowTimes["(render)"]+=renderTimeDelta;
+  benchWindowTimes["(draw)"]+=drawTimeDelta;
+  benchWindowTimes["(present)"]+=swapTimeDelta;
+  benchWindowTimes["(events)"]+=eventTimeDelta;
+
+  if ((int)benchFrameTimes.size()>=benchFrames) {
+    benchmarkReport();
+    // leave the configuration and layout untouched
+    quitNoSave=true;
+    quit=true;
+  }
+}
+
+void FurnaceGUI::benchmarkReport() {
+  e->stop();
+  for (int i=0; i<2; i++) {
+    if (benchBuf[i]!=NULL) {
+      delete[] benchBuf[i];
+      benchBuf[i]=NULL;
+    }
+  }
+
+  if (benchFrameTimes.empty()) return;
+
+  double toMs=1000.0/(double)SDL_GetPerformanceFrequency();
+  std::vector<uint64_t> sorted=benchFrameTimes;
+  std::sort(sorted.begin(),sorted.end());
+
+  uint64_t total=0;
+  for (uint64_t i: sorted) total+=i;
+  size_t count=sorted.size();
+  double avg=toMs*(double)total/(double)count;
+
+  printf("[RESULT] %d frames at %dx%d: average %fms, p50 %fms, p90 %fms, p99 %fms, max %fms\n",
+    (int)count,canvasW,canvasH,
+    avg,
+    toMs*(double)sorted[count/2],
+    toMs*(double)sorted[MIN(count-1,count*9/10)],
+    toMs*(double)sorted[MIN(count-1,count*99/100)],
+    toMs*(double)sorted[count-1]
+  );
+
+  // per-window time, most expensive first
+  std::vector<std::pair<uint64_t,String>> windows;
+  for (auto& i: benchWindowTimes) {
+    windows.push_back(std::pair<uint64_t,String>(i.second,i.first));
+  }
+  std::sort(windows.begin(),windows.end());
+  for (auto i=windows.rbegin(); i!=windows.rend(); i++) {
+    printf("[RESULT] %s: %fms per frame (%.1f%%)\n",i->second.c_str(),toMs*(double)i->first/(double)count,100.0*(double)i->first/(double)total);
+  }
+}
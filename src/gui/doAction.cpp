@@ -1338,6 +1338,7 @@ void FurnaceGUI::doAction(int what) {
             sample->data16[pos+i]=sampleClipboard[i];
           }
         }
+        sample->invalidateMinMax(pos,pos+sampleClipboardLen);
         e->renderSamples(curSample);
       });
       sampleSelStart=pos;
@@ -1376,6 +1377,7 @@ void FurnaceGUI::doAction(int what) {
             sample->data16[pos+i]=val;
           }
         }
+        sample->invalidateMinMax(pos,pos+sampleClipboardLen);
         e->renderSamples(curSample);
       });
       sampleSelStart=pos;
@@ -1447,6 +1449,7 @@ void FurnaceGUI::doAction(int what) {
           }
         }
 
+        sample->invalidateMinMax(start,end);
         updateSampleTex=true;
         notifySampleChange=true;
 
@@ -1479,6 +1482,7 @@ void FurnaceGUI::doAction(int what) {
           }
         }
 
+        sample->invalidateMinMax(start,end);
         updateSampleTex=true;
         notifySampleChange=true;
 
@@ -1511,6 +1515,7 @@ void FurnaceGUI::doAction(int what) {
           }
         }
 
+        sample->invalidateMinMax(start,end);
         updateSampleTex=true;
         notifySampleChange=true;
 
@@ -1541,6 +1546,7 @@ void FurnaceGUI::doAction(int what) {
           }
         }
 
+        sample->invalidateMinMax(start,end);
         updateSampleTex=true;
         notifySampleChange=true;
 
@@ -1613,6 +1619,7 @@ void FurnaceGUI::doAction(int what) {
           }
         }
 
+        sample->invalidateMinMax(start,end);
         updateSampleTex=true;
         notifySampleChange=true;
 
@@ -1641,6 +1648,7 @@ void FurnaceGUI::doAction(int what) {
           }
         }
 
+        sample->invalidateMinMax(start,end);
         updateSampleTex=true;
         notifySampleChange=true;
 
@@ -1667,6 +1675,7 @@ void FurnaceGUI::doAction(int what) {
           }
         }
 
+        sample->invalidateMinMax(start,end);
         updateSampleTex=true;
         notifySampleChange=true;
 
@@ -129,6 +129,17 @@ void FurnaceGUI::prepareUndo(ActionType action, UndoRegion region) {
   }
 }
 
+// whether an effect affects song timing
+static inline bool isSpeedEffect(short effect) {
+  switch (effect) {
+    case 0x09: case 0x0b: case 0x0d: case 0x0f:
+    case 0xc0: case 0xc1: case 0xc2: case 0xc3:
+    case 0xed: case 0xf0: case 0xfd: case 0xfe: case 0xff:
+      return true;
+  }
+  return false;
+}
+
 void FurnaceGUI::makeUndo(ActionType action, UndoRegion region) {
   bool doPush=false;
   UndoStep s;
@@ -230,28 +241,20 @@ void FurnaceGUI::makeUndo(ActionType action, UndoRegion region) {
 
                 if (k>=DIV_PAT_FX(0) && k<DIV_PAT_NOTE_BUFFER) {
                   int fxCol=(k&1)?k:(k-1);
-                  if (op->newData[j][fxCol]==0x09 ||
-                      op->newData[j][fxCol]==0x0b ||
-                      op->newData[j][fxCol]==0x0d ||
-                      op->newData[j][fxCol]==0x0f ||
-                      op->newData[j][fxCol]==0xc0 ||
-                      op->newData[j][fxCol]==0xc1 ||
-                      op->newData[j][fxCol]==0xc2 ||
-                      op->newData[j][fxCol]==0xc3 ||
-                      op->newData[j][fxCol]==0xf0 ||
-                      op->newData[j][fxCol]==0xff ||
-                      p->newData[j][fxCol]==0x09 ||
-                      p->newData[j][fxCol]==0x0b ||
-                      p->newData[j][fxCol]==0x0d ||
-                      p->newData[j][fxCol]==0x0f ||
-                      p->newData[j][fxCol]==0xc0 ||
-                      p->newData[j][fxCol]==0xc1 ||
-                      p->newData[j][fxCol]==0xc2 ||
-                      p->newData[j][fxCol]==0xc3 ||
-                      p->newData[j][fxCol]==0xf0 ||
-                      p->newData[j][fxCol]==0xff) {
+                  if (isSpeedEffect(op->newData[j][fxCol]) || isSpeedEffect(p->newData[j][fxCol])) {
                     logV("recalcTimestamps due to speed effect.");
-                    recalcTimestamps=true;
+                    if (!recalcTimestampsPartial) {
+                      recalcTimestampsPartial=true;
+                      recalcOrdBegin=h;
+                      recalcOrdEnd=h;
+                      recalcChanBegin=i;
+                      recalcChanEnd=i;
+                    } else {
+                      if (h<recalcOrdBegin) recalcOrdBegin=h;
+                      if (h>recalcOrdEnd) recalcOrdEnd=h;
+                      if (i<recalcChanBegin) recalcChanBegin=i;
+                      if (i>recalcChanEnd) recalcChanEnd=i;
+                    }
                   }
                 }
 
@@ -156,6 +156,12 @@ void FurnaceGUI::drawExportAudio(bool onWindow) {
   if (ImGui::InputDouble(_("Fade out (seconds)"),&audioExportOptions.fadeOut,1.0,2.0,"%.1f")) {
     if (audioExportOptions.fadeOut<0.0) audioExportOptions.fadeOut=0.0;
   }
+  if (e->song.subsong.size()>1) {
+    ImGui::Checkbox(_("Export all sub-songs"),&audioExportAllSubSongs);
+    if (ImGui::IsItemHovered()) {
+      ImGui::SetTooltip(_("each sub-song is rendered to its own file (name_s01, name_s02...) in parallel."));
+    }
+  }
 
   bool isOneOn=false;
   if (audioExportOptions.mode==DIV_EXPORT_MODE_MANY_CHAN) {
@@ -512,12 +518,68 @@ void FurnaceGUI::drawExportROM(bool onWindow) {
   }
 }
 
+// order/channel range for text/JSON export (-1 means all)
+void FurnaceGUI::drawExportRange(int& orderBegin, int& orderEnd, int& chanBegin, int& chanEnd) {
+  bool allOrders=(orderBegin<0 && orderEnd<0);
+  if (ImGui::Checkbox(_("All orders"),&allOrders)) {
+    if (allOrders) {
+      orderBegin=-1;
+      orderEnd=-1;
+    } else {
+      orderBegin=0;
+      orderEnd=e->curSubSong->ordersLen-1;
+    }
+  }
+  if (!allOrders) {
+    ImGui::Indent();
+    if (ImGui::InputInt(_("First order"),&orderBegin,1,16)) {
+      if (orderBegin<0) orderBegin=0;
+      if (orderBegin>DIV_MAX_PATTERNS-1) orderBegin=DIV_MAX_PATTERNS-1;
+      if (orderEnd<orderBegin) orderEnd=orderBegin;
+    }
+    if (ImGui::InputInt(_("Last order"),&orderEnd,1,16)) {
+      if (orderEnd<orderBegin) orderEnd=orderBegin;
+      if (orderEnd>DIV_MAX_PATTERNS-1) orderEnd=DIV_MAX_PATTERNS-1;
+    }
+    ImGui::Unindent();
+  }
+
+  bool allChans=(chanBegin<0 && chanEnd<0);
+  if (ImGui::Checkbox(_("All channels"),&allChans)) {
+    if (allChans) {
+      chanBegin=-1;
+      chanEnd=-1;
+    } else {
+      chanBegin=0;
+      chanEnd=e->getTotalChannelCount()-1;
+    }
+  }
+  if (!allChans) {
+    ImGui::Indent();
+    int first=chanBegin+1;
+    int last=chanEnd+1;
+    if (ImGui::InputInt(_("First channel"),&first,1,4)) {
+      if (first<1) first=1;
+      if (first>DIV_MAX_CHANS) first=DIV_MAX_CHANS;
+      chanBegin=first-1;
+      if (chanEnd<chanBegin) chanEnd=chanBegin;
+    }
+    if (ImGui::InputInt(_("Last channel"),&last,1,4)) {
+      if (last<first) last=first;
+      if (last>DIV_MAX_CHANS) last=DIV_MAX_CHANS;
+      chanEnd=last-1;
+    }
+    ImGui::Unindent();
+  }
+}
+
 void FurnaceGUI::drawExportText(bool onWindow) {
   exitDisabledTimer=1;
 
   ImGui::Text(
     _("this option exports the song to a text file.\n")
   );
+  drawExportRange(textExportOptions.orderBegin,textExportOptions.orderEnd,textExportOptions.chanBegin,textExportOptions.chanEnd);
   if (onWindow) {
     ImGui::Separator();
     if (ImGui::Button(_("Cancel"),ImVec2(200.0f*dpiScale,0))) ImGui::CloseCurrentPopup();
@@ -562,6 +624,9 @@ void FurnaceGUI::drawExportJSON(bool onWindow) {
   ImGui::Checkbox(_("Optimize patterns"), &jsonExportOptions.optimizePatterns);
   ImGui::EndDisabled();
   ImGui::Checkbox(_("Export compatibility flags"), &jsonExportOptions.exportCompatFlags);
+  ImGui::BeginDisabled(!jsonExportOptions.exportOrders && !jsonExportOptions.exportPatterns);
+  drawExportRange(jsonExportOptions.orderBegin,jsonExportOptions.orderEnd,jsonExportOptions.chanBegin,jsonExportOptions.chanEnd);
+  ImGui::EndDisabled();
   if (onWindow) {
     ImGui::Separator();
     if (ImGui::Button(_("Cancel"),ImVec2(200.0f*dpiScale,0))) ImGui::CloseCurrentPopup();
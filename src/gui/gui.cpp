@@ -1863,6 +1863,8 @@ void FurnaceGUI::keyDown(SDL_Event& ev) {
   if (introPos<11.0 && !shortIntro) return;
   if (aboutOpen) return;
   if (cvOpen) return;
+  // a sample is being resampled in the background
+  if (resampleThread!=NULL) return;
 
   int mapped=ev.key.keysym.sym;
   if (ev.key.keysym.mod&KMOD_CTRL) {
@@ -2216,7 +2218,7 @@ void FurnaceGUI::openFileDialog(FurnaceGUIFileDialogs type) {
       }
       hasOpened=fileDialog->openLoad(
         _("Restore Backup"),
-        {_("Furnace song"), "*.fur"},
+        {_("Furnace backup"), "*" BACKUP_EXT " *.fur"},
         backupPath+String(DIR_SEPARATOR_STR),
         dpiScale
       );
@@ -2932,6 +2934,20 @@ int FurnaceGUI::load(String path) {
       return 1;
     }
     fclose(f);
+    // rebuild the module if this is a backup manifest
+    if (isBackupManifest(file,len)) {
+      size_t restoredLen=0;
+      backupLock.lock();
+      unsigned char* restored=restoreBackup(file,len,restoredLen);
+      backupLock.unlock();
+      delete[] file;
+      if (restored==NULL) {
+        logE("could not restore backup!");
+        return 1;
+      }
+      file=restored;
+      len=restoredLen;
+    }
     if (!e->load(file,(size_t)len,path.c_str())) {
       lastError=e->getLastError();
       logE("could not open file!");
@@ -3027,7 +3043,7 @@ void FurnaceGUI::pushRecentSys(const char* path) {
 void FurnaceGUI::delFirstBackup(String name) {
   std::vector<String> listOfFiles;
 #ifdef _WIN32
-  String findPath=backupPath+String(DIR_SEPARATOR_STR)+name+String("*.fur");
+  String findPath=backupPath+String(DIR_SEPARATOR_STR)+name+String("*.fur*");
   WIN32_FIND_DATAW next;
   HANDLE backDir=FindFirstFileW(utf8To16(findPath.c_str()).c_str(),&next);
   if (backDir!=INVALID_HANDLE_VALUE) {
@@ -3060,6 +3076,7 @@ void FurnaceGUI::delFirstBackup(String name) {
     String toDelete=backupPath+String(DIR_SEPARATOR_STR)+listOfFiles[i];
     deleteFile(toDelete.c_str());
   }
+  if (totalDelete>0) purgeBackupChunks();
 }
 
 int FurnaceGUI::loadStream(String path) {
@@ -3121,6 +3138,11 @@ int FurnaceGUI::loadStream(String path) {
 
 
 void FurnaceGUI::exportAudio(String path, DivAudioExportModes mode) {
+  if (audioExportAllSubSongs && e->song.subsong.size()>1) {
+    exportAudioBatch(path);
+    return;
+  }
+
   e->calcSongTimestamps();
   DivSongTimestamps& ts=e->curSubSong->ts;
 
@@ -3145,6 +3167,40 @@ void FurnaceGUI::exportAudio(String path, DivAudioExportModes mode) {
   displayExporting=true;
 }
 
+void FurnaceGUI::exportAudioBatch(String path) {
+  if (pendingAudioBatch!=NULL) return;
+
+  // the batch loads its own copy of the song
+  SafeWriter* w=e->saveFur();
+  if (w==NULL) {
+    showError(fmt::sprintf(_("could not export audio! (%s)"),e->getLastError()));
+    return;
+  }
+  pendingAudioBatch=new DivAudioExportBatch(e);
+  int songIndex=pendingAudioBatch->addSong("song.fur",w->getFinalBuf(),w->size());
+  w->finish();
+  delete w;
+
+  String pathBase=path;
+  String pathExt="";
+  size_t extPos=path.rfind('.');
+  if (extPos!=String::npos) {
+    pathBase=path.substr(0,extPos);
+    pathExt=path.substr(extPos);
+  }
+  for (size_t i=0; i<e->song.subsong.size(); i++) {
+    pendingAudioBatch->addJob(songIndex,i,fmt::sprintf("%s_s%02d%s",pathBase,i+1,pathExt),audioExportOptions);
+  }
+
+  if (!pendingAudioBatch->go()) {
+    delete pendingAudioBatch;
+    pendingAudioBatch=NULL;
+    showError(_("could not start export!"));
+    return;
+  }
+  displayExportingBatch=true;
+}
+
 void FurnaceGUI::exportCmdStream(bool target, String path) {
   csExportPath=path;
   csExportTarget=target;
@@ -3157,6 +3213,27 @@ void FurnaceGUI::exportCmdStream(bool target, String path) {
   displayExportingCS=true;
 }
 
+void FurnaceGUI::resampleSample(int index, double sRate, double tRate, int filter) {
+  if (resampleThread!=NULL) return;
+  DivSample* sample=e->getSample(index);
+  resampleJob=new DivSampleResampleJob(sRate,tRate,filter);
+  // render from a copy of the data, as the sample may be changed or deleted (e.g. by loading a file) meanwhile
+  if (!sample->resamplePrepare(resampleJob)) {
+    delete resampleJob;
+    resampleJob=NULL;
+    showError(_("couldn't resample! make sure your sample is 8 or 16-bit and that the target rate is at least 100Hz."));
+    return;
+  }
+  resampleJobSample=index;
+  resampleJobDone=false;
+  resampleJobOK=false;
+  resampleThread=new std::thread([this]() {
+    resampleJobOK=DivSample::resampleRender(resampleJob);
+    resampleJobDone=true;
+  });
+  displayResampling=true;
+}
+
 void FurnaceGUI::editStr(String* which) {
   editString=which;
   displayEditString=true;
@@ -3646,6 +3723,8 @@ void FurnaceGUI::processDrags(int dragX, int dragY) {
           if (val>127) val=127;
           for (int i=x; i<=x1; i++) ((signed char*)sampleDragTarget)[i]=val;
         }
+        DivSample* sample=e->getSample(curSample);
+        if (sample!=NULL) sample->invalidateMinMax(x,x1+1);
         updateSampleTex=true;
         notifySampleChange=true;
       }
@@ -4290,13 +4369,13 @@ int FurnaceGUI::processEvent(SDL_Event* ev) {
     if (wavePreviewOn) {
       if (ev->key.keysym.scancode==wavePreviewKey) {
         wavePreviewOn=false;
-        e->stopWavePreview();
+        e->stopWavePreview(wavePreviewNote+60);
       }
     }
     if (samplePreviewOn) {
       if (ev->key.keysym.scancode==samplePreviewKey) {
         samplePreviewOn=false;
-        e->stopSamplePreview();
+        e->stopSamplePreview(samplePreviewNote+60);
       }
     }
   }
@@ -4641,9 +4720,13 @@ bool FurnaceGUI::loop() {
     settingsOpen=true;
   }
 
+  if (benchFrames>0) benchmarkBegin();
+
   while (!quit) {
     SDL_Event ev;
     SelectionPoint prevCursor=cursor;
+    if (benchFrames>0) benchmarkStep();
+    uint64_t frameTimeBegin=SDL_GetPerformanceCounter();
     if (e->isPlaying()) {
       WAKE_UP;
     }
@@ -4813,7 +4896,8 @@ bool FurnaceGUI::loop() {
           break;
         case SDL_DROPFILE:
           if (ev.drop.file!=NULL) {
-            if (introPos<11.0) {
+            // don't load anything while a sample is being resampled in the background
+            if (introPos<11.0 || resampleThread!=NULL) {
               SDL_free(ev.drop.file);
               break;
             }
@@ -6770,45 +6854,64 @@ bool FurnaceGUI::loop() {
               break;
             }
             case GUI_FILE_EXPORT_TEXT: {
-              SafeWriter* w=e->saveText(false);
-              if (w!=NULL) {
-                FILE* f=ps_fopen(copyOfName.c_str(),"wb");
-                if (f!=NULL) {
-                  fwrite(w->getFinalBuf(),1,w->size(),f);
-                  fclose(f);
+              FILE* f=ps_fopen(copyOfName.c_str(),"wb");
+              if (f!=NULL) {
+                // written to the file as it goes
+                SafeWriter w;
+                w.initStream(f);
+                bool success=e->saveText(&w,textExportOptions);
+                w.finish();
+                String writeError;
+                if (w.hasFailed()) {
+                  success=false;
+                  writeError=w.getError();
+                }
+                // fclose() writes out what's left in the FILE buffer, so it can fail too
+                if (fclose(f)!=0 && success) {
+                  success=false;
+                  writeError=strerror(errno);
+                }
+                if (success) {
                   pushRecentSys(copyOfName.c_str());
+                  if (!e->getWarnings().empty()) {
+                    showWarning(e->getWarnings(),GUI_WARN_GENERIC);
+                  }
                 } else {
-                  showError(_("could not open file!"));
-                }
-                w->finish();
-                delete w;
-                if (!e->getWarnings().empty()) {
-                  showWarning(e->getWarnings(),GUI_WARN_GENERIC);
+                  showError(fmt::sprintf(_("could not write text! (%s)"),writeError));
                 }
               } else {
-                showError(fmt::sprintf(_("could not write text! (%s)"),e->getLastError()));
+                showError(_("could not open file!"));
               }
               break;
             }
 #ifdef WITH_JSON
             case GUI_FILE_EXPORT_JSON: {
-              SafeWriter* w=e->saveJSON(&jsonExportOptions);
-              if (w!=NULL) {
-                FILE* f=ps_fopen(copyOfName.c_str(),"wb");
-                if (f!=NULL) {
-                  fwrite(w->getFinalBuf(),1,w->size(),f);
-                  fclose(f);
+              FILE* f=ps_fopen(copyOfName.c_str(),"wb");
+              if (f!=NULL) {
+                // written to the file as it goes
+                SafeWriter w;
+                w.initStream(f);
+                bool success=e->saveJSON(&w,&jsonExportOptions);
+                w.finish();
+                String writeError;
+                if (w.hasFailed()) {
+                  success=false;
+                  writeError=w.getError();
+                }
+                if (fclose(f)!=0 && success) {
+                  success=false;
+                  writeError=strerror(errno);
+                }
+                if (success) {
                   pushRecentSys(copyOfName.c_str());
+                  if (!e->getWarnings().empty()) {
+                    showWarning(e->getWarnings(),GUI_WARN_GENERIC);
+                  }
                 } else {
-                  showError(_("could not open file!"));
-                }
-                w->finish();
-                delete w;
-                if (!e->getWarnings().empty()) {
-                  showWarning(e->getWarnings(),GUI_WARN_GENERIC);
+                  showError(fmt::sprintf(_("could not write JSON data! (%s)"),writeError));
                 }
               } else {
-                showError(fmt::sprintf(_("could not write JSON data! (%s)"),e->getLastError()));
+                showError(_("could not open file!"));
               }
               break;
             }
@@ -6966,6 +7069,16 @@ bool FurnaceGUI::loop() {
       ImGui::OpenPopup(_("CmdStream Export Progress"));
     }
 
+    if (displayExportingBatch) {
+      displayExportingBatch=false;
+      ImGui::OpenPopup(_("Rendering sub-songs..."));
+    }
+
+    if (displayResampling) {
+      displayResampling=false;
+      ImGui::OpenPopup(_("Resampling"));
+    }
+
     if (displayNew) {
       newSongQuery="";
       newSongFirstFrame=true;
@@ -7056,6 +7169,36 @@ bool FurnaceGUI::loop() {
       ImGui::EndPopup();
     }
 
+    centerNextWindow(_("Rendering sub-songs..."),canvasW,canvasH);
+    if (ImGui::BeginPopupModal(_("Rendering sub-songs..."),NULL,ImGuiWindowFlags_NoResize|ImGuiWindowFlags_NoMove|ImGuiWindowFlags_NoSavedSettings)) {
+      if (pendingAudioBatch==NULL) {
+        ImGui::CloseCurrentPopup();
+      } else {
+        WAKE_UP;
+        ImGui::Text(_("%d of %d done"),pendingAudioBatch->getJobsDone(),pendingAudioBatch->getJobCount());
+        for (int i=0; i<pendingAudioBatch->getJobCount(); i++) {
+          DivAudioExportJobProgress p=pendingAudioBatch->getProgress(i);
+          ImGui::ProgressBar(p.amount,ImVec2(320.0f*dpiScale,0),(p.state==DIV_EXPORT_JOB_FAILED)?_("failed"):fmt::sprintf(_("sub-song %d: %.2f%%"),i+1,p.amount*100.0f).c_str());
+        }
+
+        if (ImGui::Button(_("Abort"))) {
+          pendingAudioBatch->abort();
+          delete pendingAudioBatch;
+          pendingAudioBatch=NULL;
+          ImGui::CloseCurrentPopup();
+        } else if (!pendingAudioBatch->isRunning()) {
+          pendingAudioBatch->wait();
+          if (pendingAudioBatch->hasFailed()) {
+            showError(_("could not export some sub-songs! open Log Viewer for more information."));
+          }
+          delete pendingAudioBatch;
+          pendingAudioBatch=NULL;
+          ImGui::CloseCurrentPopup();
+        }
+      }
+      ImGui::EndPopup();
+    }
+
     ImVec2 romExportMinSize=mobileUI?ImVec2(canvasW-(portrait?0:(60.0*dpiScale)),canvasH-60.0*dpiScale):ImVec2(400.0f*dpiScale,200.0f*dpiScale);
     ImVec2 romExportMaxSize=ImVec2(canvasW-((mobileUI && !portrait)?(60.0*dpiScale):0),canvasH-(mobileUI?(60.0*dpiScale):0));
 
@@ -7217,6 +7360,56 @@ bool FurnaceGUI::loop() {
       ImGui::EndPopup();
     }
 
+    centerNextWindow(_("Resampling"),canvasW,canvasH);
+    if (ImGui::BeginPopupModal(_("Resampling"),NULL,ImGuiWindowFlags_AlwaysAutoResize)) {
+      if (resampleThread==NULL) {
+        ImGui::CloseCurrentPopup();
+      } else {
+        WAKE_UP;
+        unsigned int resampleTotal=resampleJob->total;
+        float resampleProgress=(resampleTotal>0)?((float)resampleJob->done/(float)resampleTotal):0.0f;
+        ImGui::ProgressBar(resampleProgress,ImVec2(320.0f*dpiScale,0),fmt::sprintf("%.2f%%",resampleProgress*100.0f).c_str());
+        ImGui::BeginDisabled(resampleJob->cancel);
+        if (ImGui::Button(_("Cancel"))) {
+          resampleJob->cancel=true;
+        }
+        ImGui::EndDisabled();
+
+        // check whether we're done
+        if (resampleJobDone) {
+          resampleThread->join();
+          delete resampleThread;
+          resampleThread=NULL;
+
+          if (!resampleJob->cancel) {
+            if (resampleJobOK) {
+              DivSample* sample=e->getSample(resampleJobSample);
+              sample->prepareUndo(true);
+              e->lockEngine([this,sample]() {
+                if (!sample->resampleApply(resampleJob)) {
+                  showError(_("couldn't resample! make sure your sample is 8 or 16-bit and that the target rate is at least 100Hz."));
+                }
+                e->renderSamples(resampleJobSample);
+              });
+              e->notifySampleChange(resampleJobSample);
+              updateSampleTex=true;
+              notifySampleChange=true;
+              sampleSelStart=-1;
+              sampleSelEnd=-1;
+              MARK_MODIFIED;
+            } else {
+              showError(_("couldn't resample! make sure your sample is 8 or 16-bit and that the target rate is at least 100Hz."));
+            }
+          }
+          delete resampleJob;
+          resampleJob=NULL;
+
+          ImGui::CloseCurrentPopup();
+        }
+      }
+      ImGui::EndPopup();
+    }
+
     drawTutorial();
 
     ImVec2 newSongMinSize=mobileUI?ImVec2(canvasW-(portrait?0:(60.0*dpiScale)),canvasH-60.0*dpiScale):ImVec2(400.0f*dpiScale,200.0f*dpiScale);
@@ -8032,30 +8225,23 @@ bool FurnaceGUI::loop() {
 #ifdef _WIN32
               struct tm* tempTM=localtime(&curTime);
               if (tempTM==NULL) {
-                backupFileName+="-unknownTime.fur";
+                backupFileName+="-unknownTime" BACKUP_EXT;
               } else {
                 curTM=*tempTM;
-                backupFileName+=fmt::sprintf("-%d%.2d%.2d-%.2d%.2d%.2d.fur",curTM.tm_year+1900,curTM.tm_mon+1,curTM.tm_mday,curTM.tm_hour,curTM.tm_min,curTM.tm_sec);
+                backupFileName+=fmt::sprintf("-%d%.2d%.2d-%.2d%.2d%.2d" BACKUP_EXT,curTM.tm_year+1900,curTM.tm_mon+1,curTM.tm_mday,curTM.tm_hour,curTM.tm_min,curTM.tm_sec);
               }
 #else
               if (localtime_r(&curTime,&curTM)==NULL) {
-                backupFileName+="-unknownTime.fur";
+                backupFileName+="-unknownTime" BACKUP_EXT;
               } else {
-                backupFileName+=fmt::sprintf("-%d%.2d%.2d-%.2d%.2d%.2d.fur",curTM.tm_year+1900,curTM.tm_mon+1,curTM.tm_mday,curTM.tm_hour,curTM.tm_min,curTM.tm_sec);
+                backupFileName+=fmt::sprintf("-%d%.2d%.2d-%.2d%.2d%.2d" BACKUP_EXT,curTM.tm_year+1900,curTM.tm_mon+1,curTM.tm_mday,curTM.tm_hour,curTM.tm_min,curTM.tm_sec);
               }
 #endif
 
               String finalPath=backupPath+String(DIR_SEPARATOR_STR)+backupFileName;
-              
-              FILE* outFile=ps_fopen(finalPath.c_str(),"wb");
-              if (outFile!=NULL) {
-                if (fwrite(w->getFinalBuf(),1,w->size(),outFile)!=w->size()) {
-                  logW("did not write backup entirely: %s!",strerror(errno));
-                }
-                fclose(outFile);
-              } else {
-                logW("could not save backup: %s!",strerror(errno));
-              }
+
+              // only new chunks are written
+              writeBackup(w,finalPath);
               w->finish();
 
               // delete previous backup if there are too many
@@ -8074,6 +8260,11 @@ bool FurnaceGUI::loop() {
       logV("need to recalc timestamps...");
       e->calcSongTimestamps();
       recalcTimestamps=false;
+      recalcTimestampsPartial=false;
+    } else if (recalcTimestampsPartial) {
+      logV("need to recalc timestamps (orders %d-%d, channels %d-%d)...",recalcOrdBegin,recalcOrdEnd,recalcChanBegin,recalcChanEnd);
+      e->calcSongTimestampsPartial(recalcOrdBegin,recalcOrdEnd,recalcChanBegin,recalcChanEnd);
+      recalcTimestampsPartial=false;
     }
 
     if (!e->isPlaying() && e->getFilePlayerSync()) {
@@ -8198,6 +8389,8 @@ bool FurnaceGUI::loop() {
     swapTimeDelta=swapTimeEnd-swapTimeBegin;
     eventTimeDelta=eventTimeEnd-eventTimeBegin;
 
+    if (benchFrames>0) benchmarkFrame(SDL_GetPerformanceCounter()-frameTimeBegin);
+
     soloTimeout-=ImGui::GetIO().DeltaTime;
     if (soloTimeout<0) {
       soloTimeout=0;
@@ -8291,10 +8484,22 @@ bool FurnaceGUI::init() {
   syncSettings();
   syncTutorial();
 
+  if (benchFrames>0) {
+    // keep the benchmark reproducible and never wait for anything
+    settings.renderBackend="Software";
+    settings.dpiScale=1.0f;
+    settings.vsync=false;
+    settings.frameRateLimit=0;
+    settings.powerSave=false;
+    settings.disableFadeIn=true;
+    fullScreen=false;
+    tutorial.protoWelcome=true;
+  }
+
   // sync the recent files list
   recentFile.clear();
   for (int i=0; i<settings.maxRecentFile; i++) {
-    String r=e->getConfString(fmt::sprintf("recentFile%d",i),"");
+    String r=e->getConfString(fmt::sprintf("recentFile%d",i).c_str(),"");
     if (!r.empty()) {
       recentFile.push_back(r);
     }
@@ -8382,6 +8587,11 @@ bool FurnaceGUI::init() {
   // This sets the icon in wayland
   SDL_setenv("SDL_VIDEO_WAYLAND_WMCLASS", FURNACE_APP_ID, 0);
 
+  if (benchFrames>0) {
+    // render into an offscreen framebuffer so that no display is needed
+    SDL_SetHint(SDL_HINT_VIDEODRIVER,"offscreen");
+  }
+
   // initialize SDL
   logD("initializing video...");
   if (SDL_Init(SDL_INIT_VIDEO)!=0) {
@@ -8448,6 +8658,13 @@ bool FurnaceGUI::init() {
   scrY=scrConfY=e->getConfInt("lastWindowY",SDL_WINDOWPOS_CENTERED);
   scrMax=e->getConfBool("lastWindowMax",false);
 #endif
+  if (benchFrames>0) {
+    scrW=scrConfW=GUI_WIDTH_DEFAULT;
+    scrH=scrConfH=GUI_HEIGHT_DEFAULT;
+    scrX=scrConfX=SDL_WINDOWPOS_CENTERED;
+    scrY=scrConfY=SDL_WINDOWPOS_CENTERED;
+    scrMax=false;
+  }
   portrait=(scrW<scrH);
   logV("portrait: %d (%dx%d)",portrait,scrW,scrH);
 
@@ -8798,7 +9015,7 @@ bool FurnaceGUI::init() {
         wavePreviewNote=msg.data[0]-12;
       } else if ((msg.type&0xf0)==TA_MIDI_NOTE_OFF) {
         if (wavePreviewNote==msg.data[0]-12) {
-          e->stopWavePreviewNoLock();
+          e->stopWavePreviewNoLock(msg.data[0]-12+60);
         }
       }
       return -3;
@@ -8810,7 +9027,7 @@ bool FurnaceGUI::init() {
         samplePreviewNote=msg.data[0]-12;
       } else if ((msg.type&0xf0)==TA_MIDI_NOTE_OFF) {
         if (samplePreviewNote==msg.data[0]-12) {
-          e->stopSamplePreviewNoLock();
+          e->stopSamplePreviewNoLock(msg.data[0]-12+60);
         }
       }
       return -3;
@@ -9314,6 +9531,19 @@ void FurnaceGUI::commitState(DivConfig& conf) {
 }
 
 bool FurnaceGUI::finish(bool saveConfig) {
+  clearPatCache();
+  if (pendingAudioBatch!=NULL) {
+    delete pendingAudioBatch;
+    pendingAudioBatch=NULL;
+  }
+  if (resampleThread!=NULL) {
+    resampleJob->cancel=true;
+    resampleThread->join();
+    delete resampleThread;
+    resampleThread=NULL;
+    delete resampleJob;
+    resampleJob=NULL;
+  }
   if (!quitNoSave) {
     commitState(e->getConfObject());
     if (userPresetsOpen) {
@@ -9451,6 +9681,11 @@ FurnaceGUI::FurnaceGUI():
   notifyWaveChange(false),
   notifySampleChange(false),
   recalcTimestamps(true),
+  recalcTimestampsPartial(false),
+  recalcOrdBegin(0),
+  recalcOrdEnd(0),
+  recalcChanBegin(0),
+  recalcChanEnd(0),
   wantScrollListIns(false),
   wantScrollListWave(false),
   wantScrollListSample(false),
@@ -9464,6 +9699,7 @@ FurnaceGUI::FurnaceGUI():
   replacePendingSample(false),
   displayExportingROM(false),
   displayExportingCS(false),
+  displayExportingBatch(false),
   quitNoSave(false),
   changeCoarse(false),
   orderLock(false),
@@ -9704,6 +9940,7 @@ FurnaceGUI::FurnaceGUI():
   curWindowLast(GUI_WINDOW_NOTHING),
   curWindowThreadSafe(GUI_WINDOW_NOTHING),
   failedNoteOn(false),
+  patCacheOneDigitEffects(-1),
   patLineHeight(24.0f),
   lastPatternWidth(0.0f),
   longThreshold(0.48f),
@@ -9823,6 +10060,10 @@ FurnaceGUI::FurnaceGUI():
   eventTimeDelta(0),
   nextPresentTime(0),
   perfMetricsLen(0),
+  perfMetricsLastLen(0),
+  benchFrames(0),
+  benchFrame(0),
+  benchBufLen(0),
   chanToMove(-1),
   sysToMove(-1),
   sysToDelete(-1),
@@ -9860,6 +10101,12 @@ FurnaceGUI::FurnaceGUI():
   silenceSize(1024),
   resampleTarget(32000),
   resampleStrat(5),
+  resampleThread(NULL),
+  resampleJob(NULL),
+  resampleJobSample(-1),
+  resampleJobDone(false),
+  resampleJobOK(false),
+  displayResampling(false),
   sampleFixLoopTarget(0),
   amplifyVol(100.0),
   amplifyOff(0.0),
@@ -10009,6 +10256,8 @@ FurnaceGUI::FurnaceGUI():
   csExportResult(NULL),
   csExportTarget(false),
   csExportDone(false),
+  audioExportAllSubSongs(false),
+  pendingAudioBatch(NULL),
   audioExportFilterName("???"),
   audioExportFilterExt("*"),
   dmfExportVersion(0),
@@ -10073,6 +10322,7 @@ FurnaceGUI::FurnaceGUI():
   memset(patChanSlideY,0,sizeof(float)*(DIV_MAX_CHANS+1));
   memset(lastIns,-1,sizeof(int)*DIV_MAX_CHANS);
   memset(oscValues,0,sizeof(void*)*DIV_MAX_OUTPUTS);
+  memset(benchBuf,0,sizeof(float*)*2);
 
   memset(chanOscLP0,0,sizeof(float)*DIV_MAX_CHANS);
   memset(chanOscLP1,0,sizeof(float)*DIV_MAX_CHANS);
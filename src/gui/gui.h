@@ -21,6 +21,7 @@
 #define _FUR_GUI_H
 
 #include "../engine/engine.h"
+#include "../engine/exportBatch.h"
 #include "../engine/workPool.h"
 #include "../engine/waveSynth.h"
 #include "imgui.h"
@@ -81,6 +82,10 @@
 
 #define FM_PREVIEW_SIZE 512
 
+// extension of backup manifests. these are not modules, so they must not use .fur.
+// (older backups are full modules with the .fur extension.)
+#define BACKUP_EXT ".furbak"
+
 #define CHECK_HIDDEN_SYSTEM(x) \
   (x==DIV_SYSTEM_YMU759 || x==DIV_SYSTEM_DUMMY || x==DIV_SYSTEM_PONG || x==DIV_SYSTEM_UPD1771C)
 
@@ -1670,6 +1675,25 @@ struct FurnaceGUIBackupEntry {
   }
 };
 
+// formatted text of a pattern row, which is reused until the row's data changes
+struct FurnaceGUIPatCacheRow {
+  // the data this row was formatted from
+  short data[DIV_MAX_COLS];
+  char ins[2], vol[2];
+  char fx[DIV_MAX_EFFECTS][2];
+  char fxVal[DIV_MAX_EFFECTS][2];
+  bool valid;
+};
+
+struct FurnaceGUIPatCache {
+  FurnaceGUIPatCacheRow rows[DIV_MAX_ROWS];
+  FurnaceGUIPatCache() {
+    for (int i=0; i<DIV_MAX_ROWS; i++) {
+      rows[i].valid=false;
+    }
+  }
+};
+
 enum FurnaceGUIBlendMode {
   GUI_BLEND_MODE_NONE=0,
   GUI_BLEND_MODE_BLEND,
@@ -1827,11 +1851,13 @@ class FurnaceGUI {
   bool displayNew, displayExport, displayPalette, fullScreen, sysFullScreen, preserveChanPos, sysDupCloneChannels, sysDupEnd;
   unsigned char noteInputMode;
   bool notifyWaveChange, notifySampleChange;
-  bool recalcTimestamps;
+  bool recalcTimestamps, recalcTimestampsPartial;
+  // region of the patterns edited since the last partial timestamp recalculation
+  int recalcOrdBegin, recalcOrdEnd, recalcChanBegin, recalcChanEnd;
   bool wantScrollListIns, wantScrollListWave, wantScrollListSample;
   bool displayPendingIns, pendingInsSingle, displayPendingRawSample, snesFilterHex, modTableHex, displayEditString;
   bool displayPendingSamples, replacePendingSample;
-  bool displayExportingROM, displayExportingCS;
+  bool displayExportingROM, displayExportingCS, displayExportingBatch;
   bool quitNoSave;
   bool changeCoarse;
   bool orderLock;
@@ -1945,6 +1971,7 @@ class FurnaceGUI {
 
   struct Settings {
     bool audioHiPass;
+    bool insShadow;
     bool pullDeleteBehavior;
     bool allowEditDocking;
     bool overflowHighlight;
@@ -2148,6 +2175,7 @@ class FurnaceGUI {
     int exportOptionsLayout;
     int chanOscThreads;
     int renderPoolThreads;
+    bool renderPoolAffinity;
     int fontBackend;
     int fontHinting;
     int fontAutoHint;
@@ -2162,6 +2190,7 @@ class FurnaceGUI {
     int glDepthSize;
     int glStencilSize;
     int glBufferSize;
+    int swRenderThreads;
     int backupInterval;
     int backupMaxCopies;
     int autoMacroStepSize;
@@ -2195,6 +2224,7 @@ class FurnaceGUI {
 
     Settings():
       audioHiPass(true),
+      insShadow(true),
       pullDeleteBehavior(true),
       allowEditDocking(true),
       overflowHighlight(false),
@@ -2399,6 +2429,7 @@ class FurnaceGUI {
       exportOptionsLayout(1),
       chanOscThreads(0),
       renderPoolThreads(0),
+      renderPoolAffinity(false),
       fontBackend(1),
       fontHinting(0),
       fontAutoHint(1),
@@ -2413,6 +2444,7 @@ class FurnaceGUI {
       glDepthSize(24),
       glStencilSize(0),
       glBufferSize(32),
+      swRenderThreads(0),
       backupInterval(30),
       backupMaxCopies(5),
       autoMacroStepSize(0),
@@ -2562,6 +2594,9 @@ class FurnaceGUI {
   std::atomic<bool> failedNoteOn;
   float peak[DIV_MAX_OUTPUTS];
   float patChanX[DIV_MAX_CHANS+1];
+  // formatted pattern cells, per pattern
+  std::unordered_map<const DivPattern*,FurnaceGUIPatCache*> patCache;
+  int patCacheOneDigitEffects;
   float patChanSlideY[DIV_MAX_CHANS+1];
   float patLineHeight;
   float lastPatternWidth, longThreshold;
@@ -2732,6 +2767,13 @@ class FurnaceGUI {
   FurnaceGUIPerfMetric perfMetricsLast[64];
   int perfMetricsLastLen;
 
+  // GUI benchmark (-benchmark gui)
+  int benchFrames, benchFrame;
+  unsigned int benchBufLen;
+  float* benchBuf[2];
+  std::vector<uint64_t> benchFrameTimes;
+  std::map<String,uint64_t> benchWindowTimes;
+
   std::map<FurnaceGUIImages,FurnaceGUIImage*> images;
 
   int chanToMove, sysToMove, sysToDelete, opToMove;
@@ -2770,6 +2812,12 @@ class FurnaceGUI {
   int resizeSize, silenceSize;
   double resampleTarget;
   int resampleStrat;
+  // resampling runs in the background while a progress dialog is shown
+  std::thread* resampleThread;
+  DivSampleResampleJob* resampleJob;
+  int resampleJobSample;
+  std::atomic<bool> resampleJobDone;
+  bool resampleJobOK, displayResampling;
   int sampleFixLoopTarget;
   float amplifyVol, amplifyOff;
   float trimSideNoiseThreshold;
@@ -3038,11 +3086,15 @@ class FurnaceGUI {
 
   // export options
   DivAudioExportOptions audioExportOptions;
+  // export every sub-song through an export batch
+  bool audioExportAllSubSongs;
+  DivAudioExportBatch* pendingAudioBatch;
   String audioExportFilterName, audioExportFilterExt;
   int dmfExportVersion;
   FurnaceGUIExportTypes curExportType;
   DivCSOptions csExportOptions;
   DivCSProgress csProgress;
+  DivTextExportOptions textExportOptions;
 
 #ifdef WITH_JSON
   // JSON export specific
@@ -3091,6 +3143,7 @@ class FurnaceGUI {
   void drawExportAudio(bool onWindow=false);
   void drawExportVGM(bool onWindow=false);
   void drawExportROM(bool onWindow=false);
+  void drawExportRange(int& orderBegin, int& orderEnd, int& chanBegin, int& chanEnd);
   void drawExportText(bool onWindow=false);
 #ifdef WITH_JSON
   void drawExportJSON(bool onWindow=false);
@@ -3217,6 +3270,9 @@ class FurnaceGUI {
   void drawGrooves();
   void drawOrders();
   void drawPattern();
+  FurnaceGUIPatCache* getPatCache(const DivPattern* pat);
+  const FurnaceGUIPatCacheRow* getPatCacheRow(FurnaceGUIPatCache* cache, const DivPattern* pat, int row);
+  void clearPatCache();
   void drawPatternNew();
   void drawInsList(bool asChild=false);
   void drawInsEdit();
@@ -3286,6 +3342,10 @@ class FurnaceGUI {
 
   bool splitBackupName(const char* input, String& backupName, struct tm& backupTime);
   void purgeBackups(int year, int month, int day);
+  bool writeBackup(SafeWriter* w, String path);
+  bool isBackupManifest(const unsigned char* buf, size_t len);
+  unsigned char* restoreBackup(const unsigned char* buf, size_t len, size_t& outLen);
+  void purgeBackupChunks();
 
   void readConfig(DivConfig& conf, FurnaceGUISettingGroups groups=GUI_SETTINGS_ALL);
   void writeConfig(DivConfig& conf, FurnaceGUISettingGroups groups=GUI_SETTINGS_ALL);
@@ -3370,6 +3430,11 @@ class FurnaceGUI {
   void stop();
   void endIntroTune();
 
+  void benchmarkBegin();
+  void benchmarkStep();
+  void benchmarkFrame(uint64_t frameTime);
+  void benchmarkReport();
+
   void previewNote(int refChan, int note, bool autoNote=false);
   void stopPreviewNote(SDL_Scancode scancode, bool autoNote=false);
 
@@ -3388,7 +3453,9 @@ class FurnaceGUI {
   void pushRecentFile(String path);
   void pushRecentSys(const char* path);
   void exportAudio(String path, DivAudioExportModes mode);
+  void exportAudioBatch(String path);
   void exportCmdStream(bool target, String path);
+  void resampleSample(int index, double sRate, double tRate, int filter);
   void delFirstBackup(String name);
 
   bool parseSysEx(unsigned char* data, size_t len);
@@ -3436,6 +3503,7 @@ class FurnaceGUI {
     bool decodeNote(const char* what, short& note);
     void bindEngine(DivEngine* eng);
     void enableSafeMode();
+    void enableBenchmark(int frames);
     void updateScroll(int amount);
     void updateScrollRaw(float amount);
     void addScroll(int amount);
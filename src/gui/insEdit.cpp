@@ -9321,6 +9321,9 @@ void FurnaceGUI::checkRecordInstrumentUndoStep() {
   if (insEditOpen && curIns>=0 && curIns<(int)e->song.ins.size()) {
     DivInstrument* ins=e->song.ins[curIns];
 
+    // macros may have been edited, so have the engine rebuild its compact view of this instrument
+    if (insEditMayBeDirty) ins->invalidateView();
+
     // invalidate cachedCurIns/any possible changes if the cachedCurIns was referencing a different
     // instrument altgoether
     bool insChanged=ins!=cachedCurInsPtr;
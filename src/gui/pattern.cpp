@@ -81,6 +81,59 @@ void FurnaceGUI::popPartBlend() {
   rend->setBlendMode(GUI_BLEND_MODE_BLEND);
 }
 
+// maximum number of patterns in the cell cache before it is flushed
+#define PAT_CACHE_MAX 1024
+
+void FurnaceGUI::clearPatCache() {
+  for (auto& i: patCache) {
+    delete i.second;
+  }
+  patCache.clear();
+}
+
+FurnaceGUIPatCache* FurnaceGUI::getPatCache(const DivPattern* pat) {
+  if (patCacheOneDigitEffects!=settings.oneDigitEffects) {
+    clearPatCache();
+    patCacheOneDigitEffects=settings.oneDigitEffects;
+  }
+  auto it=patCache.find(pat);
+  if (it!=patCache.end()) return it->second;
+  if (patCache.size()>=PAT_CACHE_MAX) clearPatCache();
+  FurnaceGUIPatCache* cache=new FurnaceGUIPatCache;
+  patCache[pat]=cache;
+  return cache;
+}
+
+// the cached row is checked against the pattern data, so edits (and reused pattern pointers)
+// only cause the changed rows to be formatted again.
+const FurnaceGUIPatCacheRow* FurnaceGUI::getPatCacheRow(FurnaceGUIPatCache* cache, const DivPattern* pat, int row) {
+  FurnaceGUIPatCacheRow& r=cache->rows[row];
+  const short* data=pat->newData[row];
+  if (r.valid && memcmp(r.data,data,sizeof(r.data))==0) return &r;
+
+  char id[16];
+  memcpy(r.data,data,sizeof(r.data));
+  snprintf(id,15,"%.2X",data[DIV_PAT_INS]);
+  memcpy(r.ins,id,2);
+  snprintf(id,15,"%.2X",data[DIV_PAT_VOL]);
+  memcpy(r.vol,id,2);
+  for (int k=0; k<DIV_MAX_EFFECTS; k++) {
+    short fx=data[DIV_PAT_FX(k)];
+    if (fx>0xff) {
+      snprintf(id,15,"??");
+    } else if (fx>=0x10 || settings.oneDigitEffects==0) {
+      snprintf(id,15,"%.2X",(unsigned char)fx);
+    } else {
+      snprintf(id,15," %.1X",(unsigned char)fx);
+    }
+    memcpy(r.fx[k],id,2);
+    snprintf(id,15,"%.2X",data[DIV_PAT_FXVAL(k)]);
+    memcpy(r.fxVal[k],id,2);
+  }
+  r.valid=true;
+  return &r;
+}
+
 void FurnaceGUI::drawPattern() {
   if (nextWindow==GUI_WINDOW_PATTERN) {
     patternOpen=true;
@@ -1316,6 +1369,7 @@ void FurnaceGUI::drawPattern() {
         }
 
         const DivPattern* pat=e->curSubSong->pat[i].getPattern(e->curOrders->ord[i][ord&0xff],true);
+        FurnaceGUIPatCache* cache=getPatCache(pat);
 
         unsigned int maxFreq=e->getMaxFreqChan(i);
 
@@ -1399,21 +1453,23 @@ void FurnaceGUI::drawPattern() {
             }
           }
 
+          // formatted cells
+          const FurnaceGUIPatCacheRow* cachedRow=getPatCacheRow(cache,pat,row);
+
           // instrument
           if (e->curSubSong->chanCollapse[i]<3) {
             pos.x+=noteCellSize.x;
             if (pat->newData[row][DIV_PAT_INS]==-1) {
               dl->AddText(pos,inactiveColor,emptyLabel2,emptyLabel2+2);
             } else {
-              snprintf(id,63,"%.2X",pat->newData[row][DIV_PAT_INS]);
               if (pat->newData[row][DIV_PAT_INS]<0 || pat->newData[row][DIV_PAT_INS]>=e->song.insLen) {
-                dl->AddText(pos,ImGui::GetColorU32(uiColors[GUI_COLOR_PATTERN_INS_ERROR]),id,id+2);
+                dl->AddText(pos,ImGui::GetColorU32(uiColors[GUI_COLOR_PATTERN_INS_ERROR]),cachedRow->ins,cachedRow->ins+2);
               } else {
                 DivInstrumentType t=e->song.ins[pat->newData[row][DIV_PAT_INS]]->type;
                 if (t!=DIV_INS_AMIGA && t!=e->getPreferInsType(i)) {
-                  dl->AddText(pos,ImGui::GetColorU32(uiColors[GUI_COLOR_PATTERN_INS_WARN]),id,id+2);
+                  dl->AddText(pos,ImGui::GetColorU32(uiColors[GUI_COLOR_PATTERN_INS_WARN]),cachedRow->ins,cachedRow->ins+2);
                 } else {
-                  dl->AddText(pos,ImGui::GetColorU32(uiColors[GUI_COLOR_PATTERN_INS]),id,id+2);
+                  dl->AddText(pos,ImGui::GetColorU32(uiColors[GUI_COLOR_PATTERN_INS]),cachedRow->ins,cachedRow->ins+2);
                 }
               }
             }
@@ -1428,8 +1484,7 @@ void FurnaceGUI::drawPattern() {
               int volColor=(pat->newData[row][DIV_PAT_VOL]*127)/chanVolMax;
               if (volColor>127) volColor=127;
               if (volColor<0) volColor=0;
-              snprintf(id,63,"%.2X",pat->newData[row][DIV_PAT_VOL]);
-              dl->AddText(pos,ImGui::GetColorU32(volColors[volColor]),id,id+2);
+              dl->AddText(pos,ImGui::GetColorU32(volColors[volColor]),cachedRow->vol,cachedRow->vol+2);
             }
           }
 
@@ -1446,18 +1501,12 @@ void FurnaceGUI::drawPattern() {
                 dl->AddText(pos,inactiveColor,emptyLabel2,emptyLabel2+2);
               } else {
                 if (pat->newData[row][index]>0xff) {
-                  snprintf(id,63,"??");
                   effectColor=ImGui::GetColorU32(uiColors[GUI_COLOR_PATTERN_EFFECT_INVALID]);
                 } else {
                   const unsigned char data=pat->newData[row][index];
                   effectColor=ImGui::GetColorU32(uiColors[fxColors[data]]);
-                  if (pat->newData[row][index]>=0x10 || settings.oneDigitEffects==0) {
-                    snprintf(id,63,"%.2X",data);
-                  } else {
-                    snprintf(id,63," %.1X",data);
-                  }
                 }
-                dl->AddText(pos,effectColor,id,id+2);
+                dl->AddText(pos,effectColor,cachedRow->fx[k],cachedRow->fx[k]+2);
               }
 
               // effect value
@@ -1478,8 +1527,7 @@ void FurnaceGUI::drawPattern() {
               } else if (pat->newData[row][indexVal]==-1) {
                 dl->AddText(pos,effectColor,emptyLabel2,emptyLabel2+2);
               } else {
-                snprintf(id,63,"%.2X",pat->newData[row][indexVal]);
-                dl->AddText(pos,effectColor,id,id+2);
+                dl->AddText(pos,effectColor,cachedRow->fxVal[k],cachedRow->fxVal[k]+2);
               }
             }
           }
@@ -1489,6 +1537,7 @@ void FurnaceGUI::drawPattern() {
             row=0;
             ord++;
             pat=e->curSubSong->pat[i].getPattern(e->curOrders->ord[i][ord&0xff],true);
+            cache=getPatCache(pat);
           }
           pos.x=thisTop.x;
           pos.y+=patLineHeight;
@@ -537,11 +537,11 @@ void FurnaceGUI::drawPiano() {
               switch (curWindow) {
                 case GUI_WINDOW_WAVE_LIST:
                 case GUI_WINDOW_WAVE_EDIT:
-                  e->stopWavePreview();
+                  e->stopWavePreview(note);
                   break;
                 case GUI_WINDOW_SAMPLE_LIST:
                 case GUI_WINDOW_SAMPLE_EDIT:
-                  e->stopSamplePreview();
+                  e->stopSamplePreview(note);
                   break;
                 default:
                   e->synchronized([this,note]() {
@@ -19,6 +19,7 @@
 
 #include "renderSoftware.h"
 #include "imgui_sw.hpp"
+#include "../../engine/workPool.h"
 #include "../../ta-log.h"
 
 class FurnaceSoftwareTexture: public FurnaceGUITexture {
@@ -49,6 +50,8 @@ bool FurnaceGUIRenderSoftware::lockTexture(FurnaceGUITexture* which, void** data
 }
 
 bool FurnaceGUIRenderSoftware::unlockTexture(FurnaceGUITexture* which) {
+  FurnaceSoftwareTexture* t=(FurnaceSoftwareTexture*)which;
+  ImGui_ImplSW_TouchTexture(t->tex);
   return true;
 }
 
@@ -56,6 +59,7 @@ bool FurnaceGUIRenderSoftware::updateTexture(FurnaceGUITexture* which, void* dat
   FurnaceSoftwareTexture* t=(FurnaceSoftwareTexture*)which;
   if (!t->tex->managed) return false;
   memcpy(t->tex->pixels,data,pitch*t->tex->height);
+  ImGui_ImplSW_TouchTexture(t->tex);
   return true;
 }
 
@@ -66,6 +70,7 @@ FurnaceGUITexture* FurnaceGUIRenderSoftware::createTexture(bool dynamic, int wid
   }
   FurnaceSoftwareTexture* ret=new FurnaceSoftwareTexture;
   ret->tex=new SWTexture(width,height);
+  ImGui_ImplSW_TouchTexture(ret->tex);
   ret->format=format;
   return ret;
 }
@@ -86,11 +91,18 @@ void FurnaceGUIRenderSoftware::setBlendMode(FurnaceGUIBlendMode mode) {
   // TODO
 }
 
+// clearing is deferred to renderGUI(), where it is done per tile.
+// if nothing is rendered before present(), the whole surface is cleared there.
 void FurnaceGUIRenderSoftware::clear(ImVec4 color) {
+  ImU32 clearToWhat=ImGui::ColorConvertFloat4ToU32(color);
+  clearColor=(clearToWhat&0xff00ff00)|((clearToWhat&0xff)<<16)|((clearToWhat&0xff0000)>>16);
+  clearPending=true;
+}
+
+void FurnaceGUIRenderSoftware::clearSurface() {
   SDL_Surface* surf=SDL_GetWindowSurface(sdlWin);
   if (!surf) return;
-  ImU32 clearToWhat=ImGui::ColorConvertFloat4ToU32(color);
-  clearToWhat=(clearToWhat&0xff00ff00)|((clearToWhat&0xff)<<16)|((clearToWhat&0xff0000)>>16);
+  ImU32 clearToWhat=clearColor;
 
   bool mustLock=SDL_MUSTLOCK(surf);
   if (mustLock) {
@@ -113,8 +125,20 @@ bool FurnaceGUIRenderSoftware::canVSync() {
   return false;
 }
 
+static void _runTileJobs(void (*job)(void*), void** args, const unsigned int* costs, int count, void* user) {
+  DivWorkPool* pool=(DivWorkPool*)user;
+  for (int i=0; i<count; i+=DIV_WORK_POOL_MAX_TASKS) {
+    int batch=MIN(count-i,DIV_WORK_POOL_MAX_TASKS);
+    for (int j=0; j<batch; j++) {
+      pool->push(job,args[i+j],costs[i+j]);
+    }
+    pool->wait();
+  }
+}
+
 void FurnaceGUIRenderSoftware::renderGUI() {
-  ImGui_ImplSW_RenderDrawData(ImGui::GetDrawData());
+  ImGui_ImplSW_RenderDrawData(ImGui::GetDrawData(),clearPending,clearColor);
+  clearPending=false;
 }
 
 void FurnaceGUIRenderSoftware::wipe(float alpha) {
@@ -122,6 +146,12 @@ void FurnaceGUIRenderSoftware::wipe(float alpha) {
 }
 
 void FurnaceGUIRenderSoftware::present() {
+  if (clearPending) {
+    // cleared after rendering
+    clearSurface();
+    ImGui_ImplSW_InvalidateTiles();
+    clearPending=false;
+  }
   SDL_UpdateWindowSurface(sdlWin);
 }
 
@@ -169,6 +199,7 @@ void FurnaceGUIRenderSoftware::setSwapInterval(int swapInterval) {
 }
 
 void FurnaceGUIRenderSoftware::preInit(const DivConfig& conf) {
+  tileThreads=conf.getInt("swRenderThreads",0);
 }
 
 bool FurnaceGUIRenderSoftware::init(SDL_Window* win, int swapInterval) {
@@ -180,10 +211,28 @@ void FurnaceGUIRenderSoftware::initGUI(SDL_Window* win) {
   // hack
   ImGui_ImplSDL2_InitForMetal(win);
   ImGui_ImplSW_Init(win);
+
+  int threads=tileThreads;
+  if (threads<1) {
+    // automatic: use all cores (the GUI thread takes part as well)
+    threads=(int)std::thread::hardware_concurrency()-1;
+    if (threads>15) threads=15;
+  } else {
+    threads--;
+  }
+  if (threads>0) {
+    logV("software renderer: using %d threads",threads+1);
+    tilePool=new DivWorkPool(threads);
+    ImGui_ImplSW_SetJobRunner(_runTileJobs,tilePool);
+  }
 }
 
 void FurnaceGUIRenderSoftware::quitGUI() {
   ImGui_ImplSW_Shutdown();
+  if (tilePool!=NULL) {
+    delete tilePool;
+    tilePool=NULL;
+  }
 }
 
 bool FurnaceGUIRenderSoftware::quit() {
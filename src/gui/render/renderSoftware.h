@@ -19,8 +19,16 @@
 
 #include "../gui.h"
 
+class DivWorkPool;
+
 class FurnaceGUIRenderSoftware: public FurnaceGUIRender {
   SDL_Window* sdlWin;
+  DivWorkPool* tilePool;
+  int tileThreads;
+  unsigned int clearColor;
+  bool clearPending;
+
+  void clearSurface();
   public:
     ImTextureID getTextureID(FurnaceGUITexture* which);
     FurnaceGUITextureFormat getTextureFormat(FurnaceGUITexture* which);
@@ -53,5 +61,9 @@ class FurnaceGUIRenderSoftware: public FurnaceGUIRender {
     void quitGUI();
     bool quit();
     FurnaceGUIRenderSoftware():
-      sdlWin(NULL) {}
+      sdlWin(NULL),
+      tilePool(NULL),
+      tileThreads(0),
+      clearColor(0xff000000),
+      clearPending(false) {}
 };
@@ -1178,19 +1178,7 @@ void FurnaceGUI::drawSampleEdit() {
         }
         ImGui::Combo(_("Filter"),&resampleStrat,LocalizedComboGetter,resampleStrats,6);
         if (ImGui::Button(_("Resample"))) {
-          sample->prepareUndo(true);
-          e->lockEngine([this,sample,targetRate]() {
-            if (!sample->resample(targetRate,resampleTarget,resampleStrat)) {
-              showError(_("couldn't resample! make sure your sample is 8 or 16-bit and that the target rate is at least 100Hz."));
-            }
-            e->renderSamples(curSample);
-          });
-          e->notifySampleChange(curSample);
-          updateSampleTex=true;
-          notifySampleChange=true;
-          sampleSelStart=-1;
-          sampleSelEnd=-1;
-          MARK_MODIFIED;
+          resampleSample(curSample,targetRate,resampleTarget,resampleStrat);
           ImGui::CloseCurrentPopup();
         }
         ImGui::EndPopup();
@@ -1263,6 +1251,7 @@ void FurnaceGUI::drawSampleEdit() {
               }
             }
 
+            sample->invalidateMinMax(start,end);
             updateSampleTex=true;
             notifySampleChange=true;
 
@@ -1518,6 +1507,7 @@ void FurnaceGUI::drawSampleEdit() {
               }
             }
 
+            sample->invalidateMinMax(start,end);
             updateSampleTex=true;
             notifySampleChange=true;
 
@@ -1599,6 +1589,7 @@ void FurnaceGUI::drawSampleEdit() {
                   crossFadeOutput++;
                 }
               }
+              sample->invalidateMinMax(sample->loopEnd-sampleCrossFadeLoopLength,sample->loopEnd);
               updateSampleTex=true;
               notifySampleChange=true;
 
@@ -1878,34 +1869,17 @@ void FurnaceGUI::drawSampleEdit() {
             for (unsigned int i=0; i<(unsigned int)availX; i++) {
               if (xCoarse>=sample->samples) break;
               int y1, y2;
-              int candMin=INT_MAX;
-              int candMax=INT_MIN;
-              int totalAdvance=0;
-              if (sample->depth==DIV_SAMPLE_DEPTH_8BIT) {
-                if (candMin>sample->data8[xCoarse]) candMin=sample->data8[xCoarse];
-                if (candMax<sample->data8[xCoarse]) candMax=sample->data8[xCoarse];
-              } else {
-                if (candMin>sample->data16[xCoarse]) candMin=sample->data16[xCoarse];
-                if (candMax<sample->data16[xCoarse]) candMax=sample->data16[xCoarse];
-              }
+              short candMin, candMax;
+              unsigned int totalAdvance=0;
               xFine+=xAdvanceFine;
               if (xFine>=16777216) {
                 xFine-=16777216;
                 totalAdvance++;
               }
               totalAdvance+=xAdvanceCoarse;
-              if (xCoarse>=sample->samples) break;
-              do {
-                if (xCoarse>=sample->samples) break;
-                if (sample->depth==DIV_SAMPLE_DEPTH_8BIT) {
-                  if (candMin>sample->data8[xCoarse]) candMin=sample->data8[xCoarse];
-                  if (candMax<sample->data8[xCoarse]) candMax=sample->data8[xCoarse];
-                } else {
-                  if (candMin>sample->data16[xCoarse]) candMin=sample->data16[xCoarse];
-                  if (candMax<sample->data16[xCoarse]) candMax=sample->data16[xCoarse];
-                }
-                if (totalAdvance>0) xCoarse++;
-              } while ((totalAdvance--)>0);
+              // a column spans from its first sample to the first one of the next column
+              if (!sample->getMinMax(xCoarse,xCoarse+totalAdvance+1,candMin,candMax)) break;
+              xCoarse+=totalAdvance;
               if (sample->depth==DIV_SAMPLE_DEPTH_8BIT) {
                 y1=(((unsigned char)candMin^0x80)*availY)>>8;
                 y2=(((unsigned char)candMax^0x80)*availY)>>8;
@@ -246,7 +246,8 @@ void FurnaceGUI::commitSettings() {
     settings.pnQuality!=e->getConfInt("pnQuality",3) ||
     settings.saaQuality!=e->getConfInt("saaQuality",3) ||
     settings.audioQuality!=e->getConfInt("audioQuality",0) ||
-    settings.audioHiPass!=e->getConfBool("audioHiPass",1)
+    settings.audioHiPass!=e->getConfBool("audioHiPass",1) ||
+    settings.insShadow!=e->getConfBool("insShadow",1)
   );
 
   writeConfig(e->getConfObject());
@@ -454,7 +455,7 @@ bool FurnaceGUI::importConfig(String path) {
 
   recentFile.clear();
   for (int i=0; i<settings.maxRecentFile; i++) {
-    String r=e->getConfString(fmt::sprintf("recentFile%d",i),"");
+    String r=e->getConfString(fmt::sprintf("recentFile%d",i).c_str(),"");
     if (!r.empty()) {
       recentFile.push_back(r);
     }
@@ -534,6 +534,15 @@ void FurnaceGUI::initSettings() {
             }
 
             ImGui::TextWrapped(_("the following values are common (in red, green, blue, alpha order):\n- 24 bits: 8, 8, 8, 0\n- 16 bits: 5, 6, 5, 0\n- 32 bits (with alpha): 8, 8, 8, 8\n- 30 bits (deep): 10, 10, 10, 0"));
+          } else if (curRenderBackend=="Software") {
+            if (ImGui::InputInt(_("Render threads"),&settings.swRenderThreads)) {
+              if (settings.swRenderThreads<0) settings.swRenderThreads=0;
+              if (settings.swRenderThreads>16) settings.swRenderThreads=16;
+              ret=true;
+            }
+            if (ImGui::IsItemHovered()) {
+              ImGui::SetTooltip(_("0 means automatic.\nyou may need to restart Furnace for this setting to take effect."));
+            }
           } else {
             ImGui::Text(_("nothing to configure"));
           }
@@ -1082,6 +1091,13 @@ void FurnaceGUI::initSettings() {
             }
           }
           popWarningColor();
+
+          if (ImGui::Checkbox(_("Pin threads to CPU cores"),&settings.renderPoolAffinity)) {
+            ret=true;
+          }
+          if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip(_("keeps each render thread on its own CPU core.\nmay reduce stutter, but may also hurt performance if other programs are busy."));
+          }
         }
         return ret;
       }),
@@ -1618,7 +1634,11 @@ void FurnaceGUI::initSettings() {
           {_N("KIOCSOUND on standard output"),3},
           {_N("outb()"),4},
         }
-      )
+      ),
+      SETTING_CHECKBOX(
+        _N("Skip reloading identical instruments"),
+        insShadow
+      ).Tooltip(_("when switching to an instrument with the same parameters, don't write them to the chip again.\nthis avoids redundant register writes. disable if you suspect it is causing issues."))
     }),
     SUBCATEGORY(_N("Sample ROMs"),{
       SettingEntry::Path(
@@ -135,6 +135,7 @@ void FurnaceGUI::readConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
     settings.glSetBS=conf.getBool("glSetBS",0);
     settings.glStencilSize=conf.getInt("glStencilSize",0);
     settings.glBufferSize=conf.getInt("glBufferSize",32);
+    settings.swRenderThreads=conf.getInt("swRenderThreads",0);
     settings.glDoubleBuffer=conf.getBool("glDoubleBuffer",1);
 
     settings.vsync=conf.getBool("vsync",1);
@@ -143,6 +144,7 @@ void FurnaceGUI::readConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
 
     settings.chanOscThreads=conf.getInt("chanOscThreads",0);
     settings.renderPoolThreads=conf.getInt("renderPoolThreads",0);
+    settings.renderPoolAffinity=conf.getBool("renderPoolAffinity",0);
     settings.shaderOsc=conf.getBool("shaderOsc",0);
     settings.writeInsNames=conf.getBool("writeInsNames",0);
     settings.readInsNames=conf.getBool("readInsNames",1);
@@ -475,6 +477,7 @@ void FurnaceGUI::readConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
     settings.saaQualityRender=conf.getInt("saaQualityRender",3);
 
     settings.pcSpeakerOutMethod=conf.getInt("pcSpeakerOutMethod",0);
+    settings.insShadow=conf.getBool("insShadow",1);
 
     settings.yrw801Path=conf.getString("yrw801Path","");
     settings.tg100Path=conf.getString("tg100Path","");
@@ -606,6 +609,7 @@ void FurnaceGUI::readConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
   clampSetting(settings.glDepthSize,0,128);
   clampSetting(settings.glStencilSize,0,32);
   clampSetting(settings.glBufferSize,0,128);
+  clampSetting(settings.swRenderThreads,0,16);
   clampSetting(settings.backupInterval,10,86400);
   clampSetting(settings.backupMaxCopies,1,100);
   clampSetting(settings.autoMacroStepSize,0,2);
@@ -645,6 +649,7 @@ void FurnaceGUI::writeConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
     conf.set("glSetBS",settings.glSetBS);
     conf.set("glStencilSize",settings.glStencilSize);
     conf.set("glBufferSize",settings.glBufferSize);
+    conf.set("swRenderThreads",settings.swRenderThreads);
     conf.set("glDoubleBuffer",settings.glDoubleBuffer);
 
     conf.set("vsync",settings.vsync);
@@ -653,6 +658,7 @@ void FurnaceGUI::writeConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
 
     conf.set("chanOscThreads",settings.chanOscThreads);
     conf.set("renderPoolThreads",settings.renderPoolThreads);
+    conf.set("renderPoolAffinity",settings.renderPoolAffinity);
     conf.set("shaderOsc",settings.shaderOsc);
     conf.set("writeInsNames",settings.writeInsNames);
     conf.set("readInsNames",settings.readInsNames);
@@ -973,6 +979,7 @@ void FurnaceGUI::writeConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
     conf.set("saaQualityRender",settings.saaQualityRender);
 
     conf.set("pcSpeakerOutMethod",settings.pcSpeakerOutMethod);
+    conf.set("insShadow",settings.insShadow);
 
     conf.set("yrw801Path",settings.yrw801Path);
     conf.set("tg100Path",settings.tg100Path);
@@ -0,0 +1,290 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2026 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+// example.c: example and smoke test for the furnace-engine C API.
+// usage: furnace-engine-example file.fur
+// - loads the module from memory and renders a few seconds
+// - seeks and checks the reported position
+// - plays until the song loops or stops
+// - renders on two engine instances from separate threads at once
+// returns 0 if everything went fine.
+
+#include "furnace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#define EXAMPLE_RATE 44100
+#define EXAMPLE_FRAMES 1024
+// give up waiting for a loop after this many seconds of audio
+#define EXAMPLE_MAX_SECONDS 1800
+
+static const unsigned char* modData=NULL;
+static size_t modLen=0;
+
+struct ExampleThread {
+  int index;
+  int failed;
+  float peak;
+};
+
+static int readFile(const char* path) {
+  FILE* f=fopen(path,"rb");
+  long len;
+  unsigned char* buf;
+  if (f==NULL) {
+    perror(path);
+    return 0;
+  }
+  if (fseek(f,0,SEEK_END)!=0 || (len=ftell(f))<=0 || fseek(f,0,SEEK_SET)!=0) {
+    fprintf(stderr,"%s: could not get size\n",path);
+    fclose(f);
+    return 0;
+  }
+  buf=(unsigned char*)malloc(len);
+  if (buf==NULL) {
+    fprintf(stderr,"%s: out of memory\n",path);
+    fclose(f);
+    return 0;
+  }
+  if (fread(buf,1,len,f)!=(size_t)len) {
+    fprintf(stderr,"%s: could not read\n",path);
+    free(buf);
+    fclose(f);
+    return 0;
+  }
+  fclose(f);
+  modData=buf;
+  modLen=len;
+  return 1;
+}
+
+// create an instance and load the module into it.
+static FurnaceEngine* openModule(const char* nameHint) {
+  FurnaceEngine* f=furnace_create();
+  if (f==NULL) {
+    fprintf(stderr,"could not create engine\n");
+    return NULL;
+  }
+  if (furnace_load(f,modData,modLen,nameHint)!=FURNACE_OK) {
+    fprintf(stderr,"could not load module: %s\n",furnace_get_last_error(f));
+    furnace_destroy(f);
+    return NULL;
+  }
+  return f;
+}
+
+// render the given number of frames. returns the peak level, or -1 on error.
+static float renderFrames(FurnaceEngine* f, size_t frames) {
+  float bufL[EXAMPLE_FRAMES];
+  float bufR[EXAMPLE_FRAMES];
+  float* out[2];
+  float peak=0.0f;
+  size_t i;
+  out[0]=bufL;
+  out[1]=bufR;
+  while (frames>0) {
+    size_t count=frames<EXAMPLE_FRAMES?frames:EXAMPLE_FRAMES;
+    if (furnace_render(f,out,count)!=count) return -1.0f;
+    for (i=0; i<count; i++) {
+      if (fabsf(bufL[i])>peak) peak=fabsf(bufL[i]);
+      if (fabsf(bufR[i])>peak) peak=fabsf(bufR[i]);
+    }
+    frames-=count;
+  }
+  return peak;
+}
+
+static int testRender(const char* nameHint) {
+  FurnaceEngine* f=openModule(nameHint);
+  double seconds=0.0;
+  float peak;
+  if (f==NULL) return 0;
+  if (furnace_get_subsong_count(f)<1) {
+    fprintf(stderr,"[FAIL] render: no subsongs\n");
+    furnace_destroy(f);
+    return 0;
+  }
+  peak=renderFrames(f,EXAMPLE_RATE*4);
+  furnace_get_position(f,NULL,NULL,&seconds);
+  if (peak<0.0f) {
+    fprintf(stderr,"[FAIL] render: short render\n");
+    furnace_destroy(f);
+    return 0;
+  }
+  if (furnace_is_playing(f) && seconds<=0.0) {
+    fprintf(stderr,"[FAIL] render: playback time did not advance\n");
+    furnace_destroy(f);
+    return 0;
+  }
+  printf("[OK] render: 4 seconds, peak %.3f, time %.2f\n",peak,seconds);
+  furnace_destroy(f);
+  return 1;
+}
+
+static int testSeek(const char* nameHint) {
+  FurnaceEngine* f=openModule(nameHint);
+  int order=-1;
+  int row=-1;
+  if (f==NULL) return 0;
+  // seek past the first row, then let the engine process it
+  if (furnace_seek(f,0,1)!=FURNACE_OK) {
+    // the first pattern may only have one row
+    if (furnace_seek(f,0,0)!=FURNACE_OK) {
+      fprintf(stderr,"[FAIL] seek: %s\n",furnace_get_last_error(f));
+      furnace_destroy(f);
+      return 0;
+    }
+  }
+  renderFrames(f,1);
+  furnace_get_position(f,&order,&row,NULL);
+  if (order!=0 || row<0 || row>1) {
+    fprintf(stderr,"[FAIL] seek: position is %d:%d after seeking to the start\n",order,row);
+    furnace_destroy(f);
+    return 0;
+  }
+  // invalid positions must be rejected
+  if (furnace_seek(f,-1,0)==FURNACE_OK || furnace_seek(f,0,-1)==FURNACE_OK) {
+    fprintf(stderr,"[FAIL] seek: invalid position accepted\n");
+    furnace_destroy(f);
+    return 0;
+  }
+  printf("[OK] seek: position %d:%d\n",order,row);
+  furnace_destroy(f);
+  return 1;
+}
+
+static int testLoop(const char* nameHint) {
+  FurnaceEngine* f=openModule(nameHint);
+  int seconds=0;
+  if (f==NULL) return 0;
+  if (furnace_get_loop_count(f)!=0) {
+    fprintf(stderr,"[FAIL] loop: loop count is not 0 after loading\n");
+    furnace_destroy(f);
+    return 0;
+  }
+  while (seconds<EXAMPLE_MAX_SECONDS) {
+    if (furnace_get_loop_count(f)>0) break;
+    if (!furnace_is_playing(f)) break;
+    if (renderFrames(f,EXAMPLE_RATE)<0.0f) {
+      fprintf(stderr,"[FAIL] loop: short render\n");
+      furnace_destroy(f);
+      return 0;
+    }
+    seconds++;
+  }
+  if (seconds>=EXAMPLE_MAX_SECONDS) {
+    fprintf(stderr,"[FAIL] loop: song neither looped nor stopped after %d seconds\n",seconds);
+    furnace_destroy(f);
+    return 0;
+  }
+  if (furnace_is_playing(f)) {
+    printf("[OK] loop: looped after %d seconds\n",seconds);
+  } else {
+    printf("[OK] loop: stopped after %d seconds\n",seconds);
+  }
+  furnace_destroy(f);
+  return 1;
+}
+
+#ifdef _WIN32
+static DWORD WINAPI threadFunc(LPVOID arg) {
+#else
+static void* threadFunc(void* arg) {
+#endif
+  struct ExampleThread* t=(struct ExampleThread*)arg;
+  FurnaceEngine* f=openModule(NULL);
+  t->failed=1;
+  if (f!=NULL) {
+    t->peak=renderFrames(f,EXAMPLE_RATE*10);
+    if (t->peak>=0.0f) t->failed=0;
+    furnace_destroy(f);
+  }
+#ifdef _WIN32
+  return 0;
+#else
+  return NULL;
+#endif
+}
+
+static int testThreads(void) {
+  struct ExampleThread t[2];
+  int i;
+  int created=0;
+  int ok=1;
+#ifdef _WIN32
+  HANDLE handle[2];
+#else
+  pthread_t handle[2];
+#endif
+  for (i=0; i<2; i++) {
+    t[i].index=i;
+    t[i].failed=1;
+    t[i].peak=0.0f;
+#ifdef _WIN32
+    handle[i]=CreateThread(NULL,0,threadFunc,&t[i],0,NULL);
+    if (handle[i]==NULL) {
+#else
+    if (pthread_create(&handle[i],NULL,threadFunc,&t[i])!=0) {
+#endif
+      fprintf(stderr,"[FAIL] threads: could not create thread %d\n",i);
+      ok=0;
+      break;
+    }
+    created++;
+  }
+  for (i=0; i<created; i++) {
+#ifdef _WIN32
+    WaitForSingleObject(handle[i],INFINITE);
+    CloseHandle(handle[i]);
+#else
+    pthread_join(handle[i],NULL);
+#endif
+    if (t[i].failed) {
+      fprintf(stderr,"[FAIL] threads: instance %d failed\n",t[i].index);
+      ok=0;
+    }
+  }
+  if (ok) printf("[OK] threads: 2 instances, peak %.3f and %.3f\n",t[0].peak,t[1].peak);
+  return ok;
+}
+
+int main(int argc, char** argv) {
+  int ok=1;
+  if (argc<2) {
+    fprintf(stderr,"usage: %s file.fur\n",argv[0]);
+    return 1;
+  }
+  if (!readFile(argv[1])) return 1;
+
+  if (!testRender(argv[1])) ok=0;
+  if (!testSeek(argv[1])) ok=0;
+  if (!testLoop(argv[1])) ok=0;
+  if (!testThreads()) ok=0;
+
+  free((void*)modData);
+  return ok?0:1;
+}
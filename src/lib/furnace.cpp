@@ -0,0 +1,195 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2026 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "furnace.h"
+#include "../engine/engine.h"
+#include "../ta-log.h"
+#include <mutex>
+
+// render in pieces no larger than this
+#define FURNACE_LIB_BUFSIZE 1024
+
+struct FurnaceEngine {
+  DivEngine e;
+  String lastError;
+  bool loaded;
+  FurnaceEngine():
+    loaded(false) {}
+};
+
+static std::once_flag furnaceLibLogInit;
+
+// re-initialize dispatches (so that the render cores are used) and start playing.
+static void furnaceRestart(FurnaceEngine* f) {
+  f->e.quitDispatch();
+  f->e.initDispatch(true);
+  f->e.renderSamplesP();
+  f->e.play();
+}
+
+FurnaceEngine* furnace_create(void) {
+  std::call_once(furnaceLibLogInit,[]() {
+    initLog(stderr);
+    logLevel=LOGLEVEL_ERROR;
+  });
+
+  FurnaceEngine* f=new FurnaceEngine;
+  // the dummy audio backend takes these as they are, so the dispatches are
+  // initialized at the output rate from the start.
+  f->e.setConf("audioRate",44100);
+  f->e.setConf("audioChans",2);
+  if (!f->e.initEmbedded()) {
+    delete f;
+    return NULL;
+  }
+  return f;
+}
+
+void furnace_destroy(FurnaceEngine* f) {
+  if (f==NULL) return;
+  f->e.quit(false);
+  delete f;
+}
+
+int furnace_load(FurnaceEngine* f, const void* data, size_t len, const char* nameHint) {
+  if (f==NULL) return FURNACE_ERROR;
+  if (data==NULL || len==0) {
+    f->lastError="no data";
+    return FURNACE_ERROR;
+  }
+  // the engine takes ownership of the buffer
+  unsigned char* copy=new unsigned char[len];
+  memcpy(copy,data,len);
+  if (!f->e.load(copy,len,nameHint)) {
+    f->lastError=f->e.getLastError();
+    f->loaded=false;
+    return FURNACE_ERROR;
+  }
+  f->loaded=true;
+  f->e.changeSongP(0);
+  furnaceRestart(f);
+  return FURNACE_OK;
+}
+
+int furnace_get_subsong_count(FurnaceEngine* f) {
+  if (f==NULL) return 0;
+  if (!f->loaded) return 0;
+  return (int)f->e.song.subsong.size();
+}
+
+int furnace_select_subsong(FurnaceEngine* f, int index) {
+  if (f==NULL) return FURNACE_ERROR;
+  if (!f->loaded) {
+    f->lastError="no module loaded";
+    return FURNACE_ERROR;
+  }
+  if (index<0 || index>=(int)f->e.song.subsong.size()) {
+    f->lastError="invalid subsong";
+    return FURNACE_ERROR;
+  }
+  f->e.changeSongP(index);
+  f->e.play();
+  return FURNACE_OK;
+}
+
+int furnace_set_output(FurnaceEngine* f, unsigned int rate, int channels) {
+  if (f==NULL) return FURNACE_ERROR;
+  if (rate<1000 || rate>384000) {
+    f->lastError="invalid rate";
+    return FURNACE_ERROR;
+  }
+  if (channels<1 || channels>DIV_MAX_OUTPUTS) {
+    f->lastError="invalid channel count";
+    return FURNACE_ERROR;
+  }
+  TAAudioDesc& got=f->e.getAudioDescGot();
+  got.rate=rate;
+  got.outChans=channels;
+  if (f->loaded) {
+    furnaceRestart(f);
+  } else {
+    f->e.quitDispatch();
+    f->e.initDispatch(true);
+  }
+  return FURNACE_OK;
+}
+
+size_t furnace_render(FurnaceEngine* f, float** out, size_t frames) {
+  if (f==NULL || out==NULL) return 0;
+  int chans=f->e.getAudioDescGot().outChans;
+  float* outPos[DIV_MAX_OUTPUTS];
+  size_t done=0;
+  while (done<frames) {
+    size_t count=MIN(frames-done,FURNACE_LIB_BUFSIZE);
+    for (int i=0; i<chans; i++) {
+      outPos[i]=out[i]+done;
+    }
+    f->e.nextBuf(NULL,outPos,0,chans,count,true);
+    done+=count;
+  }
+  return done;
+}
+
+int furnace_seek(FurnaceEngine* f, int order, int row) {
+  if (f==NULL) return FURNACE_ERROR;
+  if (!f->loaded) {
+    f->lastError="no module loaded";
+    return FURNACE_ERROR;
+  }
+  if (order<0 || order>=f->e.curSubSong->ordersLen) {
+    f->lastError="invalid order";
+    return FURNACE_ERROR;
+  }
+  if (row<0 || row>=f->e.curSubSong->patLen) {
+    f->lastError="invalid row";
+    return FURNACE_ERROR;
+  }
+  f->e.setOrder(order);
+  f->e.playToRow(row);
+  return FURNACE_OK;
+}
+
+int furnace_get_position(FurnaceEngine* f, int* order, int* row, double* seconds) {
+  if (f==NULL) return FURNACE_ERROR;
+  int curOrder=0;
+  int curRow=0;
+  f->e.getPlayPos(curOrder,curRow);
+  if (order!=NULL) *order=curOrder;
+  if (row!=NULL) *row=curRow;
+  if (seconds!=NULL) {
+    *seconds=f->e.getCurTime().toDouble();
+  }
+  return FURNACE_OK;
+}
+
+int furnace_get_loop_count(FurnaceEngine* f) {
+  if (f==NULL) return 0;
+  return f->e.getPlayLoopCount();
+}
+
+int furnace_is_playing(FurnaceEngine* f) {
+  if (f==NULL) return 0;
+  return f->e.isPlaying()?1:0;
+}
+
+const char* furnace_get_last_error(FurnaceEngine* f) {
+  if (f==NULL) return "no instance";
+  return f->lastError.c_str();
+}
@@ -0,0 +1,121 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2026 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+// furnace.h: C API for the embeddable engine library (furnace-engine).
+// each FurnaceEngine is independent, so several may be used from different
+// threads at once. a single FurnaceEngine must not be used by more than one
+// thread at a time.
+
+#ifndef _FURNACE_LIB_H
+#define _FURNACE_LIB_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FURNACE_OK 0
+#define FURNACE_ERROR (-1)
+
+typedef struct FurnaceEngine FurnaceEngine;
+
+/**
+ * create an engine instance.
+ * the instance uses default settings and does not read or write any files.
+ * @return the instance, or NULL on failure.
+ */
+FurnaceEngine* furnace_create(void);
+
+/**
+ * destroy an engine instance.
+ */
+void furnace_destroy(FurnaceEngine* f);
+
+/**
+ * load a module from memory. any format supported by Furnace is accepted.
+ * the data is copied. playback of the first subsong starts from the beginning.
+ * @param nameHint a file name used to detect the format, or NULL.
+ * @return FURNACE_OK on success.
+ */
+int furnace_load(FurnaceEngine* f, const void* data, size_t len, const char* nameHint);
+
+/**
+ * get the number of subsongs in the loaded module.
+ */
+int furnace_get_subsong_count(FurnaceEngine* f);
+
+/**
+ * select a subsong and restart playback from its beginning.
+ * @return FURNACE_OK on success.
+ */
+int furnace_select_subsong(FurnaceEngine* f, int index);
+
+/**
+ * set the output sample rate and number of output channels (1 to 16).
+ * the default is 44100Hz stereo.
+ * this restarts playback from the beginning of the current subsong.
+ * @return FURNACE_OK on success.
+ */
+int furnace_set_output(FurnaceEngine* f, unsigned int rate, int channels);
+
+/**
+ * render audio.
+ * @param out an array of one buffer per output channel, each with room for at least frames samples.
+ * @param frames how many frames to render.
+ * @return the number of frames rendered. once playback has stopped (e.g. after a stop song effect), the rest is silence.
+ */
+size_t furnace_render(FurnaceEngine* f, float** out, size_t frames);
+
+/**
+ * seek to a position and continue playing from there.
+ * @return FURNACE_OK on success.
+ */
+int furnace_seek(FurnaceEngine* f, int order, int row);
+
+/**
+ * get the current playback position.
+ * any of order, row and seconds may be NULL.
+ * @return FURNACE_OK on success.
+ */
+int furnace_get_position(FurnaceEngine* f, int* order, int* row, double* seconds);
+
+/**
+ * get how many times the current subsong has looped.
+ */
+int furnace_get_loop_count(FurnaceEngine* f);
+
+/**
+ * check whether the song is playing.
+ * this returns 0 after the song has stopped itself (e.g. through a stop song effect).
+ */
+int furnace_is_playing(FurnaceEngine* f);
+
+/**
+ * get a description of the last error.
+ * the string is valid until the next call on this instance.
+ */
+const char* furnace_get_last_error(FurnaceEngine* f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -19,6 +19,7 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <chrono>
 #include "pch.h"
 #ifdef HAVE_SDL2
 #include "SDL_events.h"
@@ -26,6 +27,7 @@
 #include "ta-log.h"
 #include "fileutils.h"
 #include "engine/engine.h"
+#include "engine/exportBatch.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -92,8 +94,10 @@ String cmdOutName;
 String romOutName;
 String txtOutName;
 int benchMode=0;
+int benchFrames=600;
 int subsong=-1;
 DivCSOptions csExportOptions;
+DivTextExportOptions txtExportOptions;
 DivAudioExportOptions exportOptions;
 DivConfig romExportConfig;
 
@@ -429,6 +433,10 @@ TAParamResult pLoops(String val) {
 }
 
 TAParamResult pSubSong(String val) {
+  if (val=="all") {
+    subsong=-2;
+    return TA_PARAM_SUCCESS;
+  }
   try {
     int v=std::stoi(val);
     if (v<0) {
@@ -545,14 +553,35 @@ TAParamResult pBenchmark(String val) {
     benchMode=2;
   } else if (val=="walk") {
     benchMode=3;
+  } else if (val=="direct") {
+    benchMode=4;
+  } else if (val=="gui") {
+    benchMode=5;
+  } else if (val=="walkcheck") {
+    benchMode=6;
   } else {
-    logE("invalid value for benchmark! valid values are: render, seek and walk.");
+    logE("invalid value for benchmark! valid values are: render, seek, walk, direct, gui and walkcheck.");
     return TA_PARAM_ERROR;
   }
   e.setAudio(DIV_AUDIO_DUMMY);
   return TA_PARAM_SUCCESS;
 }
 
+TAParamResult pBenchFrames(String val) {
+  try {
+    int count=std::stoi(val);
+    if (count<1) {
+      logE("frame count shall be 1 or higher.");
+      return TA_PARAM_ERROR;
+    }
+    benchFrames=count;
+  } catch (std::exception& e) {
+    logE("frame count shall be a number.");
+    return TA_PARAM_ERROR;
+  }
+  return TA_PARAM_SUCCESS;
+}
+
 TAParamResult pOutput(String val) {
   outName=val;
   e.setAudio(DIV_AUDIO_DUMMY);
@@ -619,6 +648,38 @@ TAParamResult pTxtOut(String val) {
   return TA_PARAM_SUCCESS;
 }
 
+// parse "first-last"
+static bool parseRange(String val, int& first, int& last) {
+  size_t dash=val.find('-');
+  if (dash==String::npos) return false;
+  try {
+    first=std::stoi(val.substr(0,dash));
+    last=std::stoi(val.substr(dash+1));
+  } catch (std::exception& e) {
+    return false;
+  }
+  return (first>=0 && last>=first);
+}
+
+TAParamResult pTxtOrders(String val) {
+  if (!parseRange(val,txtExportOptions.orderBegin,txtExportOptions.orderEnd)) {
+    logE("invalid order range. it shall be <first>-<last>, e.g. 0-15.");
+    return TA_PARAM_ERROR;
+  }
+  return TA_PARAM_SUCCESS;
+}
+
+TAParamResult pTxtChans(String val) {
+  int first, last;
+  if (!parseRange(val,first,last) || first<1) {
+    logE("invalid channel range. it shall be <first>-<last>, e.g. 1-4.");
+    return TA_PARAM_ERROR;
+  }
+  txtExportOptions.chanBegin=first-1;
+  txtExportOptions.chanEnd=last-1;
+  return TA_PARAM_SUCCESS;
+}
+
 bool needsValue(String param) {
   for (size_t i=0; i<params.size(); i++) {
     if (params[i].name==param) {
@@ -645,6 +706,8 @@ void initParams() {
   params.push_back(TAParam("r","romout",true,pROMOut,"<filename|path>","export ROM file, or path for multi-file export"));
   params.push_back(TAParam("R","romconf",true,pROMConf,"<key>=<value>","set configuration parameter for ROM export"));
   params.push_back(TAParam("t","txtout",true,pTxtOut,"<filename>","export as text file"));
+  params.push_back(TAParam("","txtorders",true,pTxtOrders,"<first>-<last>","only export this range of orders to text"));
+  params.push_back(TAParam("","txtchans",true,pTxtChans,"<first>-<last>","only export this range of channels to text (starting from 1)"));
   params.push_back(TAParam("L","loglevel",true,pLogLevel,"debug|info|warning|error","set the log level (info by default)"));
   params.push_back(TAParam("v","view",true,pView,"pattern|commands|nothing","set visualization (nothing by default)"));
   params.push_back(TAParam("i","info",false,pInfo,"","get info about a song"));
@@ -654,12 +717,13 @@ void initParams() {
   params.push_back(TAParam("N","nocontrols",false,pNoControls,"","disable standard input controls in console mode"));
 
   params.push_back(TAParam("l","loops",true,pLoops,"<count>","set number of loops"));
-  params.push_back(TAParam("s","subsong",true,pSubSong,"<number>","set sub-song"));
+  params.push_back(TAParam("s","subsong",true,pSubSong,"<number>|all","set sub-song (all exports every sub-song to its own file)"));
   params.push_back(TAParam("o","outmode",true,pOutMode,"one|persys|perchan","set file output mode"));
   params.push_back(TAParam("S","safemode",false,pSafeMode,"","enable safe mode (software rendering and no audio)"));
   params.push_back(TAParam("A","safeaudio",false,pSafeModeAudio,"","enable safe mode (with audio"));
 
-  params.push_back(TAParam("B","benchmark",true,pBenchmark,"render|seek|walk","run performance test"));
+  params.push_back(TAParam("B","benchmark",true,pBenchmark,"render|seek|walk|direct|gui|walkcheck","run performance test"));
+  params.push_back(TAParam("F","benchframes",true,pBenchFrames,"<count>","set number of frames to measure in the GUI benchmark (600 by default)"));
 
   params.push_back(TAParam("V","version",false,pVersion,"","view information about Furnace."));
   params.push_back(TAParam("W","warranty",false,pWarranty,"","view warranty disclaimer."));
@@ -1031,13 +1095,27 @@ int main(int argc, char** argv) {
     }
   }
 
-  if (subsong!=-1) {
+  if (subsong>=0) {
     e.changeSongP(subsong);
   }
 
-  if (benchMode) {
+  // the GUI benchmark runs inside the GUI (see below)
+  if (benchMode && benchMode!=5) {
     logI("starting benchmark!");
-    if (benchMode==3) {
+    if (benchMode==6) {
+      if (!e.checkWalk()) {
+        finishLogFile();
+        return 1;
+      }
+    } else if (benchMode==4) {
+      // fails if acquireDirect() doesn't match acquire(), so that it can be used as a test
+      bool failed=false;
+      e.benchmarkDirect(&failed);
+      if (failed) {
+        finishLogFile();
+        return 1;
+      }
+    } else if (benchMode==3) {
       e.benchmarkWalk();
     } else if (benchMode==2) {
       e.benchmarkSeek();
@@ -1081,7 +1159,43 @@ int main(int argc, char** argv) {
         reportError(_("could not write VGM!"));
       }
     }
-    if (outName!="") {
+    if (outName!="" && subsong==-2) {
+      // export every sub-song in parallel (name_s01.wav, name_s02.wav...)
+      DivAudioExportBatch batch(&e);
+      int songIndex=batch.addSong(fileName);
+      if (songIndex<0) {
+        reportError(_("could not open file!"));
+      } else {
+        String outBase=outName;
+        String outExt="";
+        size_t extPos=outName.rfind('.');
+        if (extPos!=String::npos) {
+          outBase=outName.substr(0,extPos);
+          outExt=outName.substr(extPos);
+        }
+        for (size_t i=0; i<e.song.subsong.size(); i++) {
+          batch.addJob(songIndex,i,fmt::sprintf("%s_s%02d%s",outBase,i+1,outExt),exportOptions);
+        }
+        if (batch.go()) {
+          int lastDone=-1;
+          while (batch.isRunning()) {
+            int done=batch.getJobsDone();
+            if (done!=lastDone) {
+              logI("exporting... (%d/%d)",done,batch.getJobCount());
+              lastDone=done;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+          }
+          batch.wait();
+          for (int i=0; i<batch.getJobCount(); i++) {
+            DivAudioExportJobProgress p=batch.getProgress(i);
+            if (p.state==DIV_EXPORT_JOB_FAILED) {
+              reportError(fmt::sprintf(_("could not export %s!"),p.name));
+            }
+          }
+        }
+      }
+    } else if (outName!="") {
       e.setConsoleMode(true);
       e.saveAudio(outName.c_str(),exportOptions);
       e.waitAudioFile();
@@ -1145,19 +1259,26 @@ int main(int argc, char** argv) {
     }
     if (txtOutName!="") {
       e.setConsoleMode(true);
-      SafeWriter* w=e.saveText(false);
-      if (w!=NULL) {
-        FILE* f=ps_fopen(txtOutName.c_str(),"wb");
-        if (f!=NULL) {
-          fwrite(w->getFinalBuf(),1,w->size(),f);
-          fclose(f);
-        } else {
-          reportError(fmt::sprintf(_("could not open file! (%s)"),strerror(errno)));
+      FILE* f=ps_fopen(txtOutName.c_str(),"wb");
+      if (f!=NULL) {
+        SafeWriter w;
+        w.initStream(f);
+        bool success=e.saveText(&w,txtExportOptions);
+        w.finish();
+        String writeError;
+        if (w.hasFailed()) {
+          success=false;
+          writeError=w.getError();
+        }
+        if (fclose(f)!=0 && success) {
+          success=false;
+          writeError=strerror(errno);
+        }
+        if (!success) {
+          reportError(fmt::sprintf(_("could not write text! (%s)"),writeError));
         }
-        w->finish();
-        delete w;
       } else {
-        reportError(_("could not write text!"));
+        reportError(fmt::sprintf(_("could not open file! (%s)"),strerror(errno)));
       }
     }
     finishLogFile();
@@ -1210,6 +1331,7 @@ int main(int argc, char** argv) {
 
 #ifdef HAVE_GUI
   if (safeMode) g.enableSafeMode();
+  if (benchMode==5) g.enableBenchmark(benchFrames);
   g.bindEngine(&e);
   if (!g.init()) {
     reportError(g.getLastError());
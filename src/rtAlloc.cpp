@@ -0,0 +1,149 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2026 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "rtAlloc.h"
+
+#ifdef FURNACE_RT_ALLOC_GUARD
+#include <stdio.h>
+#include <stdlib.h>
+#include <new>
+#include "ta-log.h"
+#ifdef HAVE_BACKWARD
+#include "../extern/backward/backward.hpp"
+#endif
+
+// on glibc, malloc()/free() are replaced as well, so that allocations made by C code
+// (e.g. emulation cores) are caught. the real ones are reached through __libc_*.
+#ifdef __GLIBC__
+#define RT_ALLOC_HOOK_MALLOC
+extern "C" {
+  void* __libc_malloc(size_t size);
+  void* __libc_calloc(size_t num, size_t size);
+  void* __libc_realloc(void* ptr, size_t size);
+  void __libc_free(void* ptr);
+}
+#endif
+
+static thread_local int rtGuardDepth=0;
+// prevents recursion, as logging allocates too
+static thread_local bool rtGuardReporting=false;
+
+TARealTimeGuard::TARealTimeGuard(bool enable):
+  enabled(enable) {
+  if (enabled) rtGuardDepth++;
+}
+
+TARealTimeGuard::~TARealTimeGuard() {
+  if (enabled) rtGuardDepth--;
+}
+
+static void reportRealTimeAlloc(const char* what, size_t size) {
+  rtGuardReporting=true;
+  if (size>0) {
+    logW("%s of %d bytes on real-time thread!",what,(int)size);
+  } else {
+    logW("%s on real-time thread!",what);
+  }
+#ifdef HAVE_BACKWARD
+  backward::StackTrace st;
+  st.load_here(32);
+  st.skip_n_firsts(3);
+  backward::Printer p;
+  p.print(st,stderr);
+#endif
+  rtGuardReporting=false;
+}
+
+#ifdef RT_ALLOC_HOOK_MALLOC
+extern "C" void* malloc(size_t size) {
+  if (rtGuardDepth>0 && !rtGuardReporting) reportRealTimeAlloc("allocation",size);
+  return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t num, size_t size) {
+  if (rtGuardDepth>0 && !rtGuardReporting) reportRealTimeAlloc("allocation",num*size);
+  return __libc_calloc(num,size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size) {
+  if (rtGuardDepth>0 && !rtGuardReporting) reportRealTimeAlloc("reallocation",size);
+  return __libc_realloc(ptr,size);
+}
+
+extern "C" void free(void* ptr) {
+  if (ptr==NULL) return;
+  if (rtGuardDepth>0 && !rtGuardReporting) reportRealTimeAlloc("deallocation",0);
+  __libc_free(ptr);
+}
+
+// malloc()/free() report by themselves
+#define RT_ALLOC(size) malloc(size)
+#define RT_FREE(ptr) free(ptr)
+#else
+static inline void* rtAlloc(size_t size) {
+  if (rtGuardDepth>0 && !rtGuardReporting) reportRealTimeAlloc("allocation",size);
+  return malloc(size);
+}
+
+static inline void rtFree(void* ptr) {
+  if (rtGuardDepth>0 && !rtGuardReporting) reportRealTimeAlloc("deallocation",0);
+  free(ptr);
+}
+
+#define RT_ALLOC(size) rtAlloc(size)
+#define RT_FREE(ptr) rtFree(ptr)
+#endif
+
+void* operator new(size_t size) {
+  void* ret=RT_ALLOC(size?size:1);
+  if (ret==NULL) throw std::bad_alloc();
+  return ret;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return RT_ALLOC(size?size:1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& nt) noexcept {
+  return operator new(size,nt);
+}
+
+void operator delete(void* ptr) noexcept {
+  if (ptr==NULL) return;
+  RT_FREE(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  operator delete(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+  operator delete(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+  operator delete(ptr);
+}
+
+#endif
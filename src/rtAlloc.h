@@ -0,0 +1,44 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2026 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+// rtAlloc.h: real-time allocation guard (debug only).
+
+#ifndef _RTALLOC_H
+#define _RTALLOC_H
+
+/**
+ * marks the current thread as real-time for the lifetime of this object.
+ * if Furnace is built with WITH_RT_ALLOC_GUARD, every operator new/delete
+ * performed while a thread is marked gets logged along with a backtrace
+ * (when backward-cpp is available).
+ * on glibc, malloc/calloc/realloc/free (e.g. from C emulation cores) are caught as well.
+ * otherwise this does nothing.
+ */
+struct TARealTimeGuard {
+#ifdef FURNACE_RT_ALLOC_GUARD
+  bool enabled;
+  TARealTimeGuard(bool enable=true);
+  ~TARealTimeGuard();
+#else
+  TARealTimeGuard(bool enable=true) {}
+#endif
+};
+
+#endif